@@ -20,6 +20,7 @@ LOCAL_C_INCLUDES += $(LOCAL_PATH)/../../ouzel \
 
 LOCAL_SRC_FILES := ../../ouzel/assets/BmfLoader.cpp \
 	../../ouzel/assets/Bundle.cpp \
+	../../ouzel/assets/BakeCache.cpp \
 	../../ouzel/assets/Cache.cpp \
     ../../ouzel/assets/ColladaLoader.cpp \
 	../../ouzel/assets/GltfLoader.cpp \
@@ -78,6 +79,7 @@ LOCAL_SRC_FILES := ../../ouzel/assets/BmfLoader.cpp \
     ../../ouzel/graphics/Renderer.cpp \
     ../../ouzel/graphics/RenderDevice.cpp \
 	../../ouzel/graphics/RenderTarget.cpp \
+	../../ouzel/graphics/RenderGraph.cpp \
     ../../ouzel/graphics/Shader.cpp \
     ../../ouzel/graphics/Texture.cpp \
     ../../ouzel/gui/BMFont.cpp \
@@ -92,6 +94,7 @@ LOCAL_SRC_FILES := ../../ouzel/assets/BmfLoader.cpp \
 	../../ouzel/input/GamepadDevice.cpp \
 	../../ouzel/input/InputDevice.cpp \
     ../../ouzel/input/InputManager.cpp \
+    ../../ouzel/input/InputLog.cpp \
     ../../ouzel/input/InputSystem.cpp \
 	../../ouzel/input/Keyboard.cpp \
 	../../ouzel/input/KeyboardDevice.cpp \
@@ -114,6 +117,7 @@ LOCAL_SRC_FILES := ../../ouzel/assets/BmfLoader.cpp \
     ../../ouzel/scene/Layer.cpp \
     ../../ouzel/scene/Light.cpp \
     ../../ouzel/scene/ParticleSystem.cpp \
+    ../../ouzel/scene/ParticleWorld.cpp \
     ../../ouzel/scene/Scene.cpp \
     ../../ouzel/scene/SceneManager.cpp \
     ../../ouzel/scene/ShapeRenderer.cpp \
@@ -122,9 +126,15 @@ LOCAL_SRC_FILES := ../../ouzel/assets/BmfLoader.cpp \
     ../../ouzel/scene/StaticMeshRenderer.cpp \
     ../../ouzel/scene/TextRenderer.cpp \
 	../../ouzel/storage/Archive.cpp \
+	../../ouzel/storage/Compression.cpp \
     ../../ouzel/storage/File.cpp \
+    ../../ouzel/storage/FileMonitor.cpp \
+    ../../ouzel/storage/MappedFile.cpp \
+    ../../ouzel/storage/Pack.cpp \
     ../../ouzel/storage/FileSystem.cpp \
     ../../ouzel/utils/Log.cpp \
+    ../../ouzel/utils/Profiler.cpp \
+    ../../ouzel/utils/Metrics.cpp \
     ../../ouzel/utils/Obf.cpp \
     ../../ouzel/utils/Utils.cpp
 
@@ -0,0 +1,107 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_ASSETS_ASSETID_HPP
+#define OUZEL_ASSETS_ASSETID_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace assets
+    {
+        // Asset name with a precomputed hash. Names convert implicitly, but an id that is created once
+        // and reused (e.g. when spawning many actors from the same asset) skips hashing on every lookup.
+        class AssetId final
+        {
+        public:
+            // 64-bit FNV-1a, the same hash that packed bundles store for their entries
+            static inline uint64_t hash(const char* name, size_t length)
+            {
+                return fnv1aHash(name, length);
+            }
+
+            AssetId() = default;
+
+            AssetId(const std::string& initName):
+                hashValue(hash(initName.data(), initName.size())), name(initName)
+            {
+            }
+
+            AssetId(std::string&& initName):
+                hashValue(hash(initName.data(), initName.size())), name(std::move(initName))
+            {
+            }
+
+            AssetId(const char* initName):
+                hashValue(hash(initName, std::strlen(initName))), name(initName)
+            {
+            }
+
+            // the hash must be the FNV-1a hash of the name
+            AssetId(uint64_t initHash, const std::string& initName):
+                hashValue(initHash), name(initName)
+            {
+            }
+
+            inline uint64_t getHash() const { return hashValue; }
+            inline const std::string& getName() const { return name; }
+
+            inline bool operator==(const AssetId& other) const
+            {
+                return hashValue == other.hashValue && name == other.name;
+            }
+
+            inline bool operator!=(const AssetId& other) const
+            {
+                return hashValue != other.hashValue || name != other.name;
+            }
+
+        private:
+            uint64_t hashValue = 14695981039346656037ULL;
+            std::string name;
+        };
+
+        // Name and hash of an asset that refer to the caller's string or id instead of copying the name.
+        // The asset getters take it, so passing a name to them doesn't allocate. It must not be stored.
+        class AssetIdRef final
+        {
+        public:
+            AssetIdRef(const AssetId& id):
+                hashValue(id.getHash()), name(id.getName().data()), length(id.getName().size())
+            {
+            }
+
+            AssetIdRef(const std::string& initName):
+                hashValue(AssetId::hash(initName.data(), initName.size())), name(initName.data()), length(initName.size())
+            {
+            }
+
+            AssetIdRef(const char* initName):
+                name(initName), length(std::strlen(initName))
+            {
+                hashValue = AssetId::hash(name, length);
+            }
+
+            inline uint64_t getHash() const { return hashValue; }
+            inline const char* getName() const { return name; }
+            inline size_t getLength() const { return length; }
+
+            inline bool operator==(const AssetId& id) const
+            {
+                return hashValue == id.getHash() && id.getName().compare(0, std::string::npos, name, length) == 0;
+            }
+
+        private:
+            uint64_t hashValue;
+            const char* name;
+            size_t length;
+        };
+    } // namespace assets
+} // namespace ouzel
+
+#endif // OUZEL_ASSETS_ASSETID_HPP
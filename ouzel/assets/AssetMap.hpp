@@ -0,0 +1,167 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_ASSETS_ASSETMAP_HPP
+#define OUZEL_ASSETS_ASSETMAP_HPP
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "assets/AssetId.hpp"
+
+namespace ouzel
+{
+    namespace assets
+    {
+        // Open addressing hash map keyed by asset ids, probed linearly. The table stores the hash next to
+        // the entry pointer, so a lookup usually costs one probe and one name compare. Entries are allocated
+        // separately, so pointers to the values stay valid until the entry is erased.
+        template <class T>
+        class AssetMap final
+        {
+        public:
+            AssetMap() = default;
+
+            AssetMap(const AssetMap&) = delete;
+            AssetMap& operator=(const AssetMap&) = delete;
+
+            AssetMap(AssetMap&&) = default;
+            AssetMap& operator=(AssetMap&&) = default;
+
+            inline size_t size() const { return count; }
+            inline bool empty() const { return count == 0; }
+
+            const T* find(const AssetIdRef& id) const
+            {
+                if (slots.empty()) return nullptr;
+
+                const size_t mask = slots.size() - 1;
+
+                for (size_t index = static_cast<size_t>(id.getHash()) & mask;; index = (index + 1) & mask)
+                {
+                    const Slot& slot = slots[index];
+                    if (!slot.entry) return nullptr;
+
+                    if (slot.hash == id.getHash() && id == slot.entry->id)
+                        return &slot.entry->value;
+                }
+            }
+
+            T* find(const AssetIdRef& id)
+            {
+                return const_cast<T*>(static_cast<const AssetMap&>(*this).find(id));
+            }
+
+            // returns the value of the id, inserts a default constructed value if the id is not in the map
+            T& operator[](const AssetId& id)
+            {
+                if (T* value = find(id)) return *value;
+
+                // keep the load factor under one half, so that the probe sequences stay short
+                if ((count + 1) * 2 > slots.size())
+                    rehash(slots.empty() ? 16 : slots.size() * 2);
+
+                Slot& slot = slots[findFreeSlot(id.getHash())];
+                slot.hash = id.getHash();
+                slot.entry.reset(new Entry(id));
+                ++count;
+
+                return slot.entry->value;
+            }
+
+            bool erase(const AssetIdRef& id)
+            {
+                if (slots.empty()) return false;
+
+                const size_t mask = slots.size() - 1;
+                size_t index = static_cast<size_t>(id.getHash()) & mask;
+
+                for (;; index = (index + 1) & mask)
+                {
+                    const Slot& slot = slots[index];
+                    if (!slot.entry) return false;
+
+                    if (slot.hash == id.getHash() && id == slot.entry->id)
+                        break;
+                }
+
+                slots[index].entry.reset();
+                --count;
+
+                // shift back the following entries of the cluster instead of leaving a tombstone
+                for (size_t next = (index + 1) & mask; slots[next].entry; next = (next + 1) & mask)
+                {
+                    const size_t home = static_cast<size_t>(slots[next].hash) & mask;
+
+                    // the entry can move only if its home slot is not cyclically in (index, next]
+                    const bool between = (index <= next) ?
+                        (index < home && home <= next) :
+                        (index < home || home <= next);
+
+                    if (!between)
+                    {
+                        slots[index] = std::move(slots[next]);
+                        index = next;
+                    }
+                }
+
+                return true;
+            }
+
+            void clear()
+            {
+                slots.clear();
+                count = 0;
+            }
+
+            // calls the function with the id and the value of every entry, in no particular order
+            template <class F>
+            void forEach(F function) const
+            {
+                for (const Slot& slot : slots)
+                    if (slot.entry) function(slot.entry->id, slot.entry->value);
+            }
+
+        private:
+            struct Entry final
+            {
+                explicit Entry(const AssetId& initId): id(initId) {}
+
+                AssetId id;
+                T value;
+            };
+
+            struct Slot final
+            {
+                uint64_t hash = 0;
+                std::unique_ptr<Entry> entry;
+            };
+
+            size_t findFreeSlot(uint64_t hash) const
+            {
+                const size_t mask = slots.size() - 1;
+                size_t index = static_cast<size_t>(hash) & mask;
+
+                while (slots[index].entry)
+                    index = (index + 1) & mask;
+
+                return index;
+            }
+
+            void rehash(size_t newSize)
+            {
+                std::vector<Slot> oldSlots(newSize);
+                oldSlots.swap(slots);
+
+                for (Slot& slot : oldSlots)
+                    if (slot.entry)
+                        slots[findFreeSlot(slot.hash)] = std::move(slot);
+            }
+
+            std::vector<Slot> slots; // size is always zero or a power of two
+            size_t count = 0;
+        };
+    } // namespace assets
+} // namespace ouzel
+
+#endif // OUZEL_ASSETS_ASSETMAP_HPP
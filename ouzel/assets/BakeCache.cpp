@@ -0,0 +1,225 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <cstdio>
+#include "BakeCache.hpp"
+#include "core/Engine.hpp"
+#include "utils/Log.hpp"
+
+// header: magic, format version, key (uint64), payload size, reserved, payload hash (uint64)
+static constexpr uint32_t MAGIC = 0x4B425A4F; // "OZBK"
+static constexpr uint32_t FORMAT_VERSION = 1;
+static constexpr size_t HEADER_SIZE = 4 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+// index: magic, format version, use counter (uint64), entry count, then key (uint64), size (uint64) and last use (uint64) of every file
+static constexpr uint32_t INDEX_MAGIC = 0x49425A4F; // "OZBI"
+static constexpr uint32_t INDEX_FORMAT_VERSION = 1;
+static constexpr size_t INDEX_HEADER_SIZE = 3 * sizeof(uint32_t) + sizeof(uint64_t);
+static constexpr size_t INDEX_ENTRY_SIZE = 3 * sizeof(uint64_t);
+
+namespace ouzel
+{
+    namespace assets
+    {
+        uint64_t BakeCache::getKey(uint32_t loaderType, uint32_t loaderVersion, uint32_t flags,
+                                   const std::vector<uint8_t>& source)
+        {
+            uint8_t parameters[3 * sizeof(uint32_t)];
+            encodeLittleEndian<uint32_t>(parameters, loaderType);
+            encodeLittleEndian<uint32_t>(parameters + 4, loaderVersion);
+            encodeLittleEndian<uint32_t>(parameters + 8, flags);
+
+            uint64_t hash = fnv1aHash(parameters, sizeof(parameters));
+            return fnv1aHash(source.data(), source.size(), hash);
+        }
+
+        BakeCache::~BakeCache()
+        {
+            // the last use of the files that were only read in this session
+            if (indexDirty && engine) saveIndex();
+        }
+
+        bool BakeCache::load(uint64_t key, std::vector<uint8_t>& data)
+        {
+            if (!enabled) return false;
+
+            loadIndex();
+
+            storage::FileSystem& fileSystem = engine->getFileSystem();
+            const std::string filename = getFilename(key);
+
+            if (!fileSystem.fileExists(filename)) return false;
+
+            try
+            {
+                storage::MappedFile file = fileSystem.mapFile(filename, false);
+
+                if (file.size() < HEADER_SIZE ||
+                    decodeLittleEndian<uint32_t>(file.data()) != MAGIC ||
+                    decodeLittleEndian<uint32_t>(file.data() + 4) != FORMAT_VERSION ||
+                    decodeLittleEndian<uint64_t>(file.data() + 8) != key)
+                    return false;
+
+                const uint32_t size = decodeLittleEndian<uint32_t>(file.data() + 16);
+                const uint64_t hash = decodeLittleEndian<uint64_t>(file.data() + 24);
+
+                // a truncated or partially written file is treated as a miss
+                if (file.size() - HEADER_SIZE != size ||
+                    fnv1aHash(file.data() + HEADER_SIZE, size) != hash)
+                    return false;
+
+                data.assign(file.data() + HEADER_SIZE, file.data() + HEADER_SIZE + size);
+                use(key, file.size());
+            }
+            catch (const std::exception& e)
+            {
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to read baked asset: " << e.what();
+                return false;
+            }
+
+            return true;
+        }
+
+        void BakeCache::save(uint64_t key, const std::vector<uint8_t>& data)
+        {
+            if (!enabled) return;
+
+            loadIndex();
+
+            std::vector<uint8_t> file(HEADER_SIZE + data.size());
+            encodeLittleEndian<uint32_t>(file.data(), MAGIC);
+            encodeLittleEndian<uint32_t>(file.data() + 4, FORMAT_VERSION);
+            encodeLittleEndian<uint64_t>(file.data() + 8, key);
+            encodeLittleEndian<uint32_t>(file.data() + 16, static_cast<uint32_t>(data.size()));
+            encodeLittleEndian<uint32_t>(file.data() + 20, 0);
+            encodeLittleEndian<uint64_t>(file.data() + 24, fnv1aHash(data.data(), data.size()));
+            std::copy(data.begin(), data.end(), file.begin() + HEADER_SIZE);
+
+            try
+            {
+                engine->getFileSystem().writeFile(getFilename(key), file);
+            }
+            catch (const std::exception& e)
+            {
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to save baked asset: " << e.what();
+                return;
+            }
+
+            use(key, file.size());
+            evict();
+            saveIndex();
+        }
+
+        std::string BakeCache::getFilename(uint64_t key) const
+        {
+            return engine->getFileSystem().getStorageDirectory() + storage::FileSystem::DIRECTORY_SEPARATOR +
+                "asset" + hexToString(key, 16) + ".bin";
+        }
+
+        std::string BakeCache::getIndexFilename() const
+        {
+            return engine->getFileSystem().getStorageDirectory() + storage::FileSystem::DIRECTORY_SEPARATOR + "assetindex.bin";
+        }
+
+        void BakeCache::use(uint64_t key, uint64_t size)
+        {
+            IndexEntry& entry = index[key];
+            totalSize -= entry.size;
+            totalSize += size;
+
+            entry.size = size;
+            entry.lastUse = ++useCounter;
+            indexDirty = true;
+        }
+
+        void BakeCache::loadIndex()
+        {
+            if (indexLoaded) return;
+            indexLoaded = true;
+
+            storage::FileSystem& fileSystem = engine->getFileSystem();
+            const std::string filename = getIndexFilename();
+
+            if (!fileSystem.fileExists(filename)) return;
+
+            try
+            {
+                const std::vector<uint8_t> data = fileSystem.readFile(filename, false);
+
+                if (data.size() < INDEX_HEADER_SIZE ||
+                    decodeLittleEndian<uint32_t>(data.data()) != INDEX_MAGIC ||
+                    decodeLittleEndian<uint32_t>(data.data() + 4) != INDEX_FORMAT_VERSION)
+                    throw std::runtime_error("Invalid header");
+
+                useCounter = decodeLittleEndian<uint64_t>(data.data() + 8);
+                const uint32_t count = decodeLittleEndian<uint32_t>(data.data() + 16);
+
+                if ((data.size() - INDEX_HEADER_SIZE) / INDEX_ENTRY_SIZE < count)
+                    throw std::runtime_error("Invalid entry count");
+
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    const uint8_t* entryData = data.data() + INDEX_HEADER_SIZE + i * INDEX_ENTRY_SIZE;
+
+                    IndexEntry& entry = index[decodeLittleEndian<uint64_t>(entryData)];
+                    entry.size = decodeLittleEndian<uint64_t>(entryData + 8);
+                    entry.lastUse = decodeLittleEndian<uint64_t>(entryData + 16);
+                    totalSize += entry.size;
+                }
+            }
+            catch (const std::exception& e)
+            {
+                // the files that are used again are added back to the index
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to read baked asset index: " << e.what();
+                index.clear();
+                totalSize = 0;
+            }
+        }
+
+        void BakeCache::saveIndex()
+        {
+            std::vector<uint8_t> data(INDEX_HEADER_SIZE + index.size() * INDEX_ENTRY_SIZE);
+            encodeLittleEndian<uint32_t>(data.data(), INDEX_MAGIC);
+            encodeLittleEndian<uint32_t>(data.data() + 4, INDEX_FORMAT_VERSION);
+            encodeLittleEndian<uint64_t>(data.data() + 8, useCounter);
+            encodeLittleEndian<uint32_t>(data.data() + 16, static_cast<uint32_t>(index.size()));
+
+            uint8_t* entryData = data.data() + INDEX_HEADER_SIZE;
+            for (const auto& i : index)
+            {
+                encodeLittleEndian<uint64_t>(entryData, i.first);
+                encodeLittleEndian<uint64_t>(entryData + 8, i.second.size);
+                encodeLittleEndian<uint64_t>(entryData + 16, i.second.lastUse);
+                entryData += INDEX_ENTRY_SIZE;
+            }
+
+            try
+            {
+                engine->getFileSystem().writeFile(getIndexFilename(), data);
+                indexDirty = false;
+            }
+            catch (const std::exception& e)
+            {
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to save baked asset index: " << e.what();
+            }
+        }
+
+        void BakeCache::evict()
+        {
+            // the most recently used file is kept even if it is larger than the limit
+            while (maxSize && totalSize > maxSize && index.size() > 1)
+            {
+                auto leastRecentlyUsed = index.begin();
+                for (auto i = index.begin(); i != index.end(); ++i)
+                    if (i->second.lastUse < leastRecentlyUsed->second.lastUse)
+                        leastRecentlyUsed = i;
+
+                std::remove(getFilename(leastRecentlyUsed->first).c_str());
+
+                totalSize -= leastRecentlyUsed->second.size;
+                index.erase(leastRecentlyUsed);
+                indexDirty = true;
+            }
+        }
+    } // namespace assets
+} // namespace ouzel
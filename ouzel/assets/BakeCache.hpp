@@ -0,0 +1,168 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_ASSETS_BAKECACHE_HPP
+#define OUZEL_ASSETS_BAKECACHE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace assets
+    {
+        // Content-addressed cache of loader output, stored in the storage directory
+        // The key covers the source data, the loader type, the loader version and loader specific flags,
+        // so changing any of them results in a cache miss
+        // Only the image and OBJ loaders use it. The Collada and glTF loaders don't produce mesh data yet,
+        // and sprite and particle system files are small JSON documents that are cheaper to parse than to look up.
+        class BakeCache final
+        {
+        public:
+            class Writer final
+            {
+            public:
+                inline void writeUInt32(uint32_t value)
+                {
+                    const size_t offset = data.size();
+                    data.resize(offset + sizeof(value));
+                    encodeLittleEndian<uint32_t>(data.data() + offset, value);
+                }
+
+                inline void writeFloat(float value)
+                {
+                    uint32_t bits;
+                    std::memcpy(&bits, &value, sizeof(bits));
+                    writeUInt32(bits);
+                }
+
+                inline void writeBytes(const void* bytes, size_t size)
+                {
+                    const size_t offset = data.size();
+                    data.resize(offset + size);
+                    if (size) std::memcpy(data.data() + offset, bytes, size);
+                }
+
+                inline void writeString(const std::string& str)
+                {
+                    writeUInt32(static_cast<uint32_t>(str.size()));
+                    writeBytes(str.data(), str.size());
+                }
+
+                inline const std::vector<uint8_t>& getData() const { return data; }
+
+            private:
+                std::vector<uint8_t> data;
+            };
+
+            class Reader final
+            {
+            public:
+                explicit Reader(const std::vector<uint8_t>& initData): data(initData) {}
+
+                inline uint32_t readUInt32()
+                {
+                    check(sizeof(uint32_t));
+                    uint32_t result = decodeLittleEndian<uint32_t>(data.data() + offset);
+                    offset += sizeof(uint32_t);
+                    return result;
+                }
+
+                inline float readFloat()
+                {
+                    uint32_t bits = readUInt32();
+                    float result;
+                    std::memcpy(&result, &bits, sizeof(result));
+                    return result;
+                }
+
+                inline void readBytes(void* bytes, size_t size)
+                {
+                    check(size);
+                    if (size) std::memcpy(bytes, data.data() + offset, size);
+                    offset += size;
+                }
+
+                inline std::string readString()
+                {
+                    uint32_t size = readUInt32();
+                    check(size);
+                    std::string result(reinterpret_cast<const char*>(data.data() + offset), size);
+                    offset += size;
+                    return result;
+                }
+
+                // returns the number of elements of the given size that fit in the remaining data, used to validate counts
+                inline size_t getRemaining(size_t elementSize) const
+                {
+                    return (data.size() - offset) / elementSize;
+                }
+
+            private:
+                inline void check(size_t size) const
+                {
+                    if (size > data.size() - offset)
+                        throw std::runtime_error("Invalid baked asset");
+                }
+
+                const std::vector<uint8_t>& data;
+                size_t offset = 0;
+            };
+
+            static uint64_t getKey(uint32_t loaderType, uint32_t loaderVersion, uint32_t flags,
+                                   const std::vector<uint8_t>& source);
+
+            BakeCache() = default;
+            ~BakeCache();
+
+            BakeCache(const BakeCache&) = delete;
+            BakeCache& operator=(const BakeCache&) = delete;
+
+            BakeCache(BakeCache&&) = delete;
+            BakeCache& operator=(BakeCache&&) = delete;
+
+            inline bool isEnabled() const { return enabled; }
+            inline void setEnabled(bool newEnabled) { enabled = newEnabled; }
+
+            // size of the cached files in bytes, the least recently used files are deleted when it is exceeded, 0 for no limit
+            inline uint64_t getMaxSize() const { return maxSize; }
+            inline void setMaxSize(uint64_t newMaxSize) { maxSize = newMaxSize; }
+
+            // returns false on a cache miss or if the cached file is invalid
+            bool load(uint64_t key, std::vector<uint8_t>& data);
+            void save(uint64_t key, const std::vector<uint8_t>& data);
+
+        private:
+            struct IndexEntry final
+            {
+                uint64_t size = 0;
+                uint64_t lastUse = 0;
+            };
+
+            std::string getFilename(uint64_t key) const;
+            std::string getIndexFilename() const;
+
+            void use(uint64_t key, uint64_t size);
+            void loadIndex();
+            void saveIndex();
+            void evict();
+
+            bool enabled = true;
+            uint64_t maxSize = 256 * 1024 * 1024;
+
+            // the index of the cached files is read on the first access and written when a file is added
+            // or when the cache is destroyed, so that the least recently used files can be found without listing the directory
+            bool indexLoaded = false;
+            bool indexDirty = false;
+            uint64_t useCounter = 0;
+            uint64_t totalSize = 0;
+            std::map<uint64_t, IndexEntry> index;
+        };
+    } // namespace assets
+} // namespace ouzel
+
+#endif // OUZEL_ASSETS_BAKECACHE_HPP
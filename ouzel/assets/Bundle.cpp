@@ -1,11 +1,41 @@
 // Copyright 2015-2019 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include <cctype>
 #include <stdexcept>
 #include "Bundle.hpp"
 #include "Cache.hpp"
 #include "Loader.hpp"
-#include "utils/Json.hpp"
+#include "core/Engine.hpp"
+#include "storage/Pack.hpp"
+#include "utils/Log.hpp"
+#include "utils/JsonParser.hpp"
+
+static size_t getTextureSize(const ouzel::graphics::Texture& texture)
+{
+    const size_t pixelSize = ouzel::graphics::getPixelSize(texture.getPixelFormat()) * texture.getSampleCount();
+    const uint32_t mipmaps = texture.getMipmaps();
+
+    uint32_t width = texture.getSize().v[0];
+    uint32_t height = texture.getSize().v[1];
+    size_t result = pixelSize * width * height;
+
+    // mipmaps 0 means the full chain, the same as in Texture::calculateLevels
+    for (uint32_t levels = 1; (width > 1 || height > 1) && (mipmaps == 0 || levels < mipmaps); ++levels)
+    {
+        width = std::max(width >> 1, 1U);
+        height = std::max(height >> 1, 1U);
+        result += pixelSize * width * height;
+    }
+
+    return result;
+}
+
+static size_t getMeshSize(const ouzel::scene::StaticMeshData& meshData)
+{
+    return (meshData.indexBuffer ? meshData.indexBuffer->getSize() : 0) +
+        (meshData.vertexBuffer ? meshData.vertexBuffer->getSize() : 0);
+}
 
 namespace ouzel
 {
@@ -25,26 +55,103 @@ namespace ouzel
         void Bundle::loadAsset(uint32_t loaderType, const std::string& name,
                                const std::string& filename, bool mipmaps)
         {
+            Asset asset(loaderType, name, filename, mipmaps);
+
+            // entries of the loaded packs are found by name without going to the file system
+            if (const storage::Pack::Entry* entry = findPackEntry(filename))
+            {
+                std::vector<uint8_t> data(entry->data, entry->data + entry->size);
+                loadAssetData(asset, data);
+                return;
+            }
+
             std::vector<uint8_t> data = fileSystem.readFile(filename);
+            loadAssetData(asset, data);
 
-            auto loaders = cache.getLoaders();
+            if (cache.isHotReloadEnabled() && !reloading)
+            {
+                std::string path = fileSystem.getPath(filename);
 
-            for (auto i = loaders.rbegin(); i != loaders.rend(); ++i)
+                if (!path.empty())
+                {
+                    std::vector<Asset>& assets = fileAssets[path];
+
+                    auto i = std::find_if(assets.begin(), assets.end(), [loaderType, &name](const Asset& asset) {
+                        return asset.type == loaderType && asset.name == name;
+                    });
+
+                    if (i == assets.end())
+                        assets.push_back(asset);
+
+                    cache.fileMonitor.addFile(path);
+                }
+            }
+        }
+
+        void Bundle::reloadFile(const std::string& path)
+        {
+            auto i = fileAssets.find(path);
+            if (i == fileAssets.end()) return;
+
+            // textures and materials are replaced in place, so live references see the new data,
+            // shaders, fonts and sounds are replaced in the bundle only and existing handles keep the old ones
+            reloading = true;
+
+            for (const Asset& asset : i->second)
             {
-                Loader* loader = *i;
-                if (loader->getType() == loaderType &&
-                    loader->loadAsset(*this, name, data, mipmaps))
-                    return;
+                try
+                {
+                    std::vector<uint8_t> data = fileSystem.readFile(asset.filename);
+
+                    if (!loadAssetData(asset.type, asset.name, data, asset.mipmaps))
+                        throw std::runtime_error("No loader accepted the asset");
+
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "Reloaded asset " << asset.name;
+
+                    // sprites and particle systems copy their data, so they have to be told to take the new one
+                    std::unique_ptr<SystemEvent> reloadEvent(new SystemEvent());
+                    reloadEvent->type = Event::Type::ASSET_RELOAD;
+                    reloadEvent->filename = asset.name;
+                    engine->getEventDispatcher().dispatchEvent(std::move(reloadEvent));
+                }
+                catch (const std::exception& e)
+                {
+                    // keep the old asset, so that a broken file doesn't bring down the application
+                    OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to reload asset " << asset.name << ": " << e.what();
+                }
             }
 
-            throw std::runtime_error("Failed to load asset " + filename);
+            reloading = false;
         }
 
         void Bundle::loadAssets(const std::string& filename)
         {
-            json::Data data(fileSystem.readFile(filename));
+            storage::MappedFile file = fileSystem.mapFile(filename);
+
+            // packed bundles are loaded directly from the mapping without resolving any paths,
+            // the pack is kept, so that evicted assets can be restored from it by name
+            if (storage::Pack::isPack(file.data(), file.size()))
+            {
+                packs.push_back(std::unique_ptr<storage::Pack>(new storage::Pack(std::move(file))));
+                const storage::Pack& pack = *packs.back();
+
+                // the loaders take the data in a vector, so one buffer is reused for all the entries
+                std::vector<uint8_t> data;
+
+                for (const storage::Pack::Entry& entry : pack.getEntries())
+                {
+                    std::string name(entry.name, entry.nameLength);
+                    data.assign(entry.data, entry.data + entry.size);
+
+                    loadAssetData(Asset(entry.type, name, name, (entry.flags & storage::Pack::MIPMAPS) != 0), data);
+                }
+
+                return;
+            }
 
-            for (const json::Value& asset : data["assets"].as<json::Value::Array>())
+            json::Document data(file.begin(), file.end());
+
+            for (const json::Node asset : data["assets"])
             {
                 std::string file = asset["filename"].as<std::string>();
                 std::string name = asset.hasMember("name") ? asset["name"].as<std::string>() : file;
@@ -59,32 +166,224 @@ namespace ouzel
                 loadAsset(asset.type, asset.name, asset.filename, asset.mipmaps);
         }
 
-        std::shared_ptr<graphics::Texture> Bundle::getTexture(const std::string& name) const
+        const storage::Pack::Entry* Bundle::findPackEntry(const std::string& name) const
         {
-            auto i = textures.find(name);
+            // the packs loaded later take precedence
+            for (auto i = packs.rbegin(); i != packs.rend(); ++i)
+                if (const storage::Pack::Entry* entry = (*i)->find(name))
+                    return entry;
+
+            return nullptr;
+        }
+
+        void Bundle::loadAssetData(const Asset& asset, const std::vector<uint8_t>& data)
+        {
+            // loaders can load other assets, so the previous source has to be restored afterwards
+            const Asset* previousAsset = currentAsset;
+            currentAsset = &asset;
+
+            bool loaded;
+
+            try
+            {
+                loaded = loadAssetData(asset.type, asset.name, data, asset.mipmaps);
+            }
+            catch (...)
+            {
+                currentAsset = previousAsset;
+                throw;
+            }
+
+            currentAsset = previousAsset;
 
-            if (i != textures.end())
-                return i->second;
+            if (!loaded)
+                throw std::runtime_error("Failed to load asset " + asset.filename);
+        }
+
+        bool Bundle::loadAssetData(uint32_t loaderType, const std::string& name,
+                                   const std::vector<uint8_t>& data, bool mipmaps)
+        {
+            auto loaders = cache.getLoaders();
+
+            for (auto i = loaders.rbegin(); i != loaders.rend(); ++i)
+            {
+                Loader* loader = *i;
+                if (loader->getType() == loaderType &&
+                    loader->loadAsset(*this, name, data, mipmaps))
+                    return true;
+            }
+
+            return false;
+        }
+
+        size_t Bundle::getResidentSize(MemoryCategory category) const
+        {
+            auto i = residentSizes.find(category);
+            return (i != residentSizes.end()) ? i->second : 0;
+        }
+
+        void Bundle::setResidency(MemoryCategory category, const std::string& name, size_t size)
+        {
+            Residency& record = residency[category][name];
+            size_t& residentSize = residentSizes[category];
+
+            if (record.resident) residentSize -= record.size;
+            residentSize += size;
+
+            record.size = size;
+            record.lastUse = ++cache.useCounter;
+            record.resident = true;
+
+            // a reloaded asset keeps its source, an asset set by the user can not be reloaded
+            if (!reloading) record.source = currentAsset ? *currentAsset : Asset();
+        }
+
+        void Bundle::touch(MemoryCategory category, const AssetIdRef& id)
+        {
+            auto i = residency.find(category);
+            if (i == residency.end()) return;
+
+            if (Residency* record = i->second.find(id))
+                record->lastUse = ++cache.useCounter;
+        }
+
+        void Bundle::eraseResidency(MemoryCategory category, const std::string& name)
+        {
+            auto i = residency.find(category);
+            if (i == residency.end()) return;
+
+            Residency* record = i->second.find(name);
+            if (!record) return;
+
+            if (record->resident) residentSizes[category] -= record->size;
+            i->second.erase(name);
+        }
+
+        void Bundle::releaseResidency(MemoryCategory category)
+        {
+            residency.erase(category);
+            residentSizes.erase(category);
+        }
+
+        bool Bundle::isUnreferenced(MemoryCategory category, const AssetIdRef& id) const
+        {
+            switch (category)
+            {
+                case MemoryCategory::TEXTURE:
+                {
+                    const std::shared_ptr<graphics::Texture>* texture = textures.find(id);
+                    return texture && texture->use_count() == 1;
+                }
+                case MemoryCategory::SOUND:
+                {
+                    const std::shared_ptr<audio::Sound>* sound = sounds.find(id);
+                    return sound && sound->use_count() == 1;
+                }
+                case MemoryCategory::FONT:
+                {
+                    const std::shared_ptr<gui::Font>* font = fonts.find(id);
+                    return font && font->use_count() == 1;
+                }
+                default:
+                    // mesh data is handed out by pointer, so the bundle can not tell whether it is in use
+                    return false;
+            }
+        }
+
+        size_t Bundle::evict(MemoryCategory category, const AssetIdRef& id)
+        {
+            auto i = residency.find(category);
+            if (i == residency.end()) return 0;
+
+            Residency* record = i->second.find(id);
+            if (!record || !record->resident) return 0;
+
+            switch (category)
+            {
+                case MemoryCategory::TEXTURE: textures.erase(id); break;
+                case MemoryCategory::SOUND: sounds.erase(id); break;
+                case MemoryCategory::FONT: fonts.erase(id); break;
+                default: return 0;
+            }
+
+            const size_t size = record->size;
+            residentSizes[category] -= size;
+
+            // the record is kept, so that the asset can be restored from its source
+            record->size = 0;
+            record->resident = false;
+
+            return size;
+        }
+
+        bool Bundle::restore(MemoryCategory category, const AssetIdRef& id)
+        {
+            auto i = residency.find(category);
+            if (i == residency.end()) return false;
+
+            const Residency* record = i->second.find(id);
+            if (!record || record->resident || record->source.filename.empty())
+                return false;
+
+            // loading can modify the record
+            Asset source = record->source;
+
+            try
+            {
+                loadAsset(source.type, source.name, source.filename, source.mipmaps);
+            }
+            catch (const std::exception& e)
+            {
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to restore asset " << source.name << ": " << e.what();
+                return false;
+            }
+
+            return true;
+        }
+
+        std::shared_ptr<graphics::Texture> Bundle::getTexture(const AssetIdRef& id)
+        {
+            if (const std::shared_ptr<graphics::Texture>* texture = textures.find(id))
+            {
+                touch(MemoryCategory::TEXTURE, id);
+                return *texture;
+            }
 
             return nullptr;
         }
 
         void Bundle::setTexture(const std::string& name, const std::shared_ptr<graphics::Texture>& texture)
         {
+            if (reloading && texture)
+            {
+                std::shared_ptr<graphics::Texture>* existing = textures.find(name);
+
+                if (existing && *existing && *existing != texture)
+                {
+                    setResidency(MemoryCategory::TEXTURE, name, getTextureSize(*texture));
+                    **existing = std::move(*texture);
+                    return;
+                }
+            }
+
             textures[name] = texture;
+
+            if (texture)
+                setResidency(MemoryCategory::TEXTURE, name, getTextureSize(*texture));
+            else
+                eraseResidency(MemoryCategory::TEXTURE, name);
         }
 
         void Bundle::releaseTextures()
         {
             textures.clear();
+            releaseResidency(MemoryCategory::TEXTURE);
         }
 
-        std::shared_ptr<graphics::Shader> Bundle::getShader(const std::string& name) const
+        std::shared_ptr<graphics::Shader> Bundle::getShader(const AssetIdRef& id) const
         {
-            auto i = shaders.find(name);
-
-            if (i != shaders.end())
-                return i->second;
+            if (const std::shared_ptr<graphics::Shader>* shader = shaders.find(id))
+                return *shader;
 
             return nullptr;
         }
@@ -99,12 +398,10 @@ namespace ouzel
             shaders.clear();
         }
 
-        std::shared_ptr<graphics::BlendState> Bundle::getBlendState(const std::string& name) const
+        std::shared_ptr<graphics::BlendState> Bundle::getBlendState(const AssetIdRef& id) const
         {
-            auto i = blendStates.find(name);
-
-            if (i != blendStates.end())
-                return i->second;
+            if (const std::shared_ptr<graphics::BlendState>* blendState = blendStates.find(id))
+                return *blendState;
 
             return nullptr;
         }
@@ -119,12 +416,10 @@ namespace ouzel
             blendStates.clear();
         }
 
-        std::shared_ptr<graphics::DepthStencilState> Bundle::getDepthStencilState(const std::string& name) const
+        std::shared_ptr<graphics::DepthStencilState> Bundle::getDepthStencilState(const AssetIdRef& id) const
         {
-            auto i = depthStencilStates.find(name);
-
-            if (i != depthStencilStates.end())
-                return i->second;
+            if (const std::shared_ptr<graphics::DepthStencilState>* depthStencilState = depthStencilStates.find(id))
+                return *depthStencilState;
 
             return nullptr;
         }
@@ -191,14 +486,9 @@ namespace ouzel
                 loadAsset(Loader::SPRITE, filename, filename, mipmaps);
         }
 
-        const scene::SpriteData* Bundle::getSpriteData(const std::string& name) const
+        const scene::SpriteData* Bundle::getSpriteData(const AssetIdRef& id) const
         {
-            auto i = spriteData.find(name);
-
-            if (i != spriteData.end())
-                return &i->second;
-
-            return nullptr;
+            return spriteData.find(id);
         }
 
         void Bundle::setSpriteData(const std::string& name, const scene::SpriteData& newSpriteData)
@@ -211,14 +501,9 @@ namespace ouzel
             spriteData.clear();
         }
 
-        const scene::ParticleSystemData* Bundle::getParticleSystemData(const std::string& name) const
+        const scene::ParticleSystemData* Bundle::getParticleSystemData(const AssetIdRef& id) const
         {
-            auto i = particleSystemData.find(name);
-
-            if (i != particleSystemData.end())
-                return &i->second;
-
-            return nullptr;
+            return particleSystemData.find(id);
         }
 
         void Bundle::setParticleSystemData(const std::string& name, const scene::ParticleSystemData& newParticleSystemData)
@@ -231,12 +516,13 @@ namespace ouzel
             particleSystemData.clear();
         }
 
-        std::shared_ptr<gui::Font> Bundle::getFont(const std::string& name) const
+        std::shared_ptr<gui::Font> Bundle::getFont(const AssetIdRef& id)
         {
-            auto i = fonts.find(name);
-
-            if (i != fonts.end())
-                return i->second;
+            if (const std::shared_ptr<gui::Font>* font = fonts.find(id))
+            {
+                touch(MemoryCategory::FONT, id);
+                return *font;
+            }
 
             return nullptr;
         }
@@ -244,19 +530,26 @@ namespace ouzel
         void Bundle::setFont(const std::string& name, const std::shared_ptr<gui::Font>& font)
         {
             fonts[name] = font;
+
+            if (font)
+                setResidency(MemoryCategory::FONT, name, font->getSize());
+            else
+                eraseResidency(MemoryCategory::FONT, name);
         }
 
         void Bundle::releaseFonts()
         {
             fonts.clear();
+            releaseResidency(MemoryCategory::FONT);
         }
 
-        std::shared_ptr<audio::Sound> Bundle::getSound(const std::string& name) const
+        std::shared_ptr<audio::Sound> Bundle::getSound(const AssetIdRef& id)
         {
-            auto i = sounds.find(name);
-
-            if (i != sounds.end())
-                return i->second;
+            if (const std::shared_ptr<audio::Sound>* sound = sounds.find(id))
+            {
+                touch(MemoryCategory::SOUND, id);
+                return *sound;
+            }
 
             return nullptr;
         }
@@ -264,25 +557,47 @@ namespace ouzel
         void Bundle::setSound(const std::string& name, const std::shared_ptr<audio::Sound>& newSound)
         {
             sounds[name] = newSound;
+
+            if (newSound)
+                setResidency(MemoryCategory::SOUND, name, newSound->getSize());
+            else
+                eraseResidency(MemoryCategory::SOUND, name);
         }
 
         void Bundle::releaseSound()
         {
             sounds.clear();
+            releaseResidency(MemoryCategory::SOUND);
         }
 
-        std::shared_ptr<graphics::Material> Bundle::getMaterial(const std::string& name) const
+        std::shared_ptr<graphics::Material> Bundle::getMaterial(const AssetIdRef& id) const
         {
-            auto i = materials.find(name);
-
-            if (i != materials.end())
-                return i->second;
+            if (const std::shared_ptr<graphics::Material>* material = materials.find(id))
+                return *material;
 
             return nullptr;
         }
 
         void Bundle::setMaterial(const std::string& name, const std::shared_ptr<graphics::Material>& material)
         {
+            if (reloading && material)
+            {
+                std::shared_ptr<graphics::Material>* i = materials.find(name);
+
+                if (i && *i && *i != material)
+                {
+                    graphics::Material& existing = **i;
+                    existing.blendState = material->blendState;
+                    existing.shader = material->shader;
+                    for (uint32_t layer = 0; layer < graphics::Material::TEXTURE_LAYERS; ++layer)
+                        existing.textures[layer] = material->textures[layer];
+                    existing.cullMode = material->cullMode;
+                    existing.diffuseColor = material->diffuseColor;
+                    existing.opacity = material->opacity;
+                    return;
+                }
+            }
+
             materials[name] = material;
         }
 
@@ -291,14 +606,9 @@ namespace ouzel
             materials.clear();
         }
 
-        const scene::SkinnedMeshData* Bundle::getSkinnedMeshData(const std::string& name) const
+        const scene::SkinnedMeshData* Bundle::getSkinnedMeshData(const AssetIdRef& id) const
         {
-            auto i = skinnedMeshData.find(name);
-
-            if (i != skinnedMeshData.end())
-                return &i->second;
-
-            return nullptr;
+            return skinnedMeshData.find(id);
         }
 
         void Bundle::setSkinnedMeshData(const std::string& name, const scene::SkinnedMeshData& newSkinnedMeshData)
@@ -311,24 +621,23 @@ namespace ouzel
             skinnedMeshData.clear();
         }
 
-        const scene::StaticMeshData* Bundle::getStaticMeshData(const std::string& name) const
+        const scene::StaticMeshData* Bundle::getStaticMeshData(const AssetIdRef& id)
         {
-            auto i = staticMeshData.find(name);
-
-            if (i != staticMeshData.end())
-                return &i->second;
-
-            return nullptr;
+            const scene::StaticMeshData* result = staticMeshData.find(id);
+            if (result) touch(MemoryCategory::MESH, id);
+            return result;
         }
 
         void Bundle::setStaticMeshData(const std::string& name, const scene::StaticMeshData& newStaticMeshData)
         {
             staticMeshData[name] = newStaticMeshData;
+            setResidency(MemoryCategory::MESH, name, getMeshSize(newStaticMeshData));
         }
 
         void Bundle::releaseStaticMeshData()
         {
             staticMeshData.clear();
+            releaseResidency(MemoryCategory::MESH);
         }
     } // namespace assets
 } // namespace ouzel
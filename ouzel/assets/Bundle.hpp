@@ -6,6 +6,8 @@
 #include <map>
 #include <memory>
 #include <string>
+#include "assets/AssetId.hpp"
+#include "assets/AssetMap.hpp"
 #include "audio/Sound.hpp"
 #include "graphics/BlendState.hpp"
 #include "graphics/DepthStencilState.hpp"
@@ -18,6 +20,7 @@
 #include "scene/Sprite.hpp"
 #include "scene/ParticleSystem.hpp"
 #include "storage/FileSystem.hpp"
+#include "storage/Pack.hpp"
 
 namespace ouzel
 {
@@ -25,9 +28,19 @@ namespace ouzel
     {
         class Cache;
 
+        // memory categories with separate budgets in the cache
+        enum class MemoryCategory
+        {
+            TEXTURE,
+            SOUND,
+            MESH,
+            FONT
+        };
+
         class Asset final
         {
         public:
+            Asset() = default;
             Asset(uint32_t initType,
                   std::string initName,
                   std::string initFilename,
@@ -39,10 +52,10 @@ namespace ouzel
             {
             }
 
-            uint32_t type;
+            uint32_t type = 0;
             std::string name;
             std::string filename;
-            bool mipmaps;
+            bool mipmaps = true;
         };
 
         class Bundle final
@@ -65,68 +78,117 @@ namespace ouzel
 
             void clear();
 
-            std::shared_ptr<graphics::Texture> getTexture(const std::string& name) const;
+            std::shared_ptr<graphics::Texture> getTexture(const AssetIdRef& id);
             void setTexture(const std::string& name, const std::shared_ptr<graphics::Texture>& texture);
             void releaseTextures();
 
-            std::shared_ptr<graphics::Shader> getShader(const std::string& shaderName) const;
+            std::shared_ptr<graphics::Shader> getShader(const AssetIdRef& id) const;
             void setShader(const std::string& name, const std::shared_ptr<graphics::Shader>& shader);
             void releaseShaders();
 
-            std::shared_ptr<graphics::BlendState> getBlendState(const std::string& name) const;
+            std::shared_ptr<graphics::BlendState> getBlendState(const AssetIdRef& id) const;
             void setBlendState(const std::string& name, const std::shared_ptr<graphics::BlendState>& blendState);
             void releaseBlendStates();
 
-            std::shared_ptr<graphics::DepthStencilState> getDepthStencilState(const std::string& name) const;
+            std::shared_ptr<graphics::DepthStencilState> getDepthStencilState(const AssetIdRef& id) const;
             void setDepthStencilState(const std::string& name, const std::shared_ptr<graphics::DepthStencilState>& depthStencilState);
             void releaseDepthStencilStates();
 
             void preloadSpriteData(const std::string& filename, bool mipmaps = true,
                                    uint32_t spritesX = 1, uint32_t spritesY = 1,
                                    const Vector2F& pivot = Vector2F(0.5F, 0.5F));
-            const scene::SpriteData* getSpriteData(const std::string& name) const;
+            const scene::SpriteData* getSpriteData(const AssetIdRef& id) const;
             void setSpriteData(const std::string& name, const scene::SpriteData& newSpriteData);
             void releaseSpriteData();
 
-            const scene::ParticleSystemData* getParticleSystemData(const std::string& name) const;
+            const scene::ParticleSystemData* getParticleSystemData(const AssetIdRef& id) const;
             void setParticleSystemData(const std::string& name, const scene::ParticleSystemData& newParticleSystemData);
             void releaseParticleSystemData();
 
-            std::shared_ptr<gui::Font> getFont(const std::string& name) const;
+            std::shared_ptr<gui::Font> getFont(const AssetIdRef& id);
             void setFont(const std::string& name, const std::shared_ptr<gui::Font>& font);
             void releaseFonts();
 
-            std::shared_ptr<audio::Sound> getSound(const std::string& name) const;
+            std::shared_ptr<audio::Sound> getSound(const AssetIdRef& id);
             void setSound(const std::string& name, const std::shared_ptr<audio::Sound>& newSound);
             void releaseSound();
 
-            std::shared_ptr<graphics::Material> getMaterial(const std::string& name) const;
+            std::shared_ptr<graphics::Material> getMaterial(const AssetIdRef& id) const;
             void setMaterial(const std::string& name, const std::shared_ptr<graphics::Material>& material);
             void releaseMaterials();
 
-            const scene::SkinnedMeshData* getSkinnedMeshData(const std::string& name) const;
+            const scene::SkinnedMeshData* getSkinnedMeshData(const AssetIdRef& id) const;
             void setSkinnedMeshData(const std::string& name, const scene::SkinnedMeshData& newSkinnedMeshData);
             void releaseSkinnedMeshData();
 
-            const scene::StaticMeshData* getStaticMeshData(const std::string& name) const;
+            const scene::StaticMeshData* getStaticMeshData(const AssetIdRef& id);
             void setStaticMeshData(const std::string& name, const scene::StaticMeshData& newStaticMeshData);
             void releaseStaticMeshData();
 
+            // bytes held by the resident assets of the category
+            size_t getResidentSize(MemoryCategory category) const;
+
         private:
+            struct Residency final
+            {
+                size_t size = 0;
+                uint64_t lastUse = 0;
+                bool resident = false;
+                Asset source; // empty filename if the asset can not be reloaded
+            };
+
+            void setResidency(MemoryCategory category, const std::string& name, size_t size);
+            void touch(MemoryCategory category, const AssetIdRef& id);
+            void eraseResidency(MemoryCategory category, const std::string& name);
+            void releaseResidency(MemoryCategory category);
+
+            // returns true if nothing outside of the bundle holds a reference to the asset
+            bool isUnreferenced(MemoryCategory category, const AssetIdRef& id) const;
+
+            // releases the asset and returns the number of bytes freed
+            size_t evict(MemoryCategory category, const AssetIdRef& id);
+
+            // loads an evicted asset again from its source file or pack
+            bool restore(MemoryCategory category, const AssetIdRef& id);
+
+            // returns nullptr if none of the loaded packs contains the entry
+            const storage::Pack::Entry* findPackEntry(const std::string& name) const;
+
+            // loads the asset with the source recorded, throws if no loader accepted the data
+            void loadAssetData(const Asset& asset, const std::vector<uint8_t>& data);
+            bool loadAssetData(uint32_t loaderType, const std::string& name,
+                               const std::vector<uint8_t>& data, bool mipmaps);
+
+            // reloads all the assets loaded from the file, called by the cache at the start of a frame
+            void reloadFile(const std::string& path);
+
             Cache& cache;
             storage::FileSystem& fileSystem;
 
-            std::map<std::string, std::shared_ptr<graphics::Texture>> textures;
-            std::map<std::string, std::shared_ptr<graphics::Shader>> shaders;
-            std::map<std::string, scene::ParticleSystemData> particleSystemData;
-            std::map<std::string, std::shared_ptr<graphics::BlendState>> blendStates;
-            std::map<std::string, std::shared_ptr<graphics::DepthStencilState>> depthStencilStates;
-            std::map<std::string, scene::SpriteData> spriteData;
-            std::map<std::string, std::shared_ptr<gui::Font>> fonts;
-            std::map<std::string, std::shared_ptr<audio::Sound>> sounds;
-            std::map<std::string, std::shared_ptr<graphics::Material>> materials;
-            std::map<std::string, scene::SkinnedMeshData> skinnedMeshData;
-            std::map<std::string, scene::StaticMeshData> staticMeshData;
+            // packed bundles stay mapped for the lifetime of the bundle
+            std::vector<std::unique_ptr<storage::Pack>> packs;
+
+            // assets loaded from files on disk by path, used for hot-reload
+            std::map<std::string, std::vector<Asset>> fileAssets;
+            bool reloading = false;
+
+            // the asset currently being loaded from a file, recorded as the source of the assets set by loaders
+            const Asset* currentAsset = nullptr;
+            // keyed like the assets, so that touching an asset on every get costs one hash probe
+            std::map<MemoryCategory, AssetMap<Residency>> residency;
+            std::map<MemoryCategory, size_t> residentSizes;
+
+            AssetMap<std::shared_ptr<graphics::Texture>> textures;
+            AssetMap<std::shared_ptr<graphics::Shader>> shaders;
+            AssetMap<scene::ParticleSystemData> particleSystemData;
+            AssetMap<std::shared_ptr<graphics::BlendState>> blendStates;
+            AssetMap<std::shared_ptr<graphics::DepthStencilState>> depthStencilStates;
+            AssetMap<scene::SpriteData> spriteData;
+            AssetMap<std::shared_ptr<gui::Font>> fonts;
+            AssetMap<std::shared_ptr<audio::Sound>> sounds;
+            AssetMap<std::shared_ptr<graphics::Material>> materials;
+            AssetMap<scene::SkinnedMeshData> skinnedMeshData;
+            AssetMap<scene::StaticMeshData> staticMeshData;
         };
     } // namespace assets
 } // namespace ouzel
@@ -8,7 +8,6 @@
 #include "gui/BMFont.hpp"
 #include "gui/TTFont.hpp"
 #include "storage/FileSystem.hpp"
-#include "utils/Json.hpp"
 
 namespace ouzel
 {
@@ -43,6 +42,89 @@ namespace ouzel
                 bundles.erase(i);
         }
 
+        size_t Cache::getMemoryBudget(MemoryCategory category) const
+        {
+            auto i = memoryBudgets.find(category);
+            return (i != memoryBudgets.end()) ? i->second : 0;
+        }
+
+        void Cache::setMemoryBudget(MemoryCategory category, size_t budget)
+        {
+            if (budget)
+                memoryBudgets[category] = budget;
+            else
+                memoryBudgets.erase(category);
+        }
+
+        size_t Cache::getResidentSize(MemoryCategory category) const
+        {
+            size_t result = 0;
+
+            for (const Bundle* bundle : bundles)
+                result += bundle->getResidentSize(category);
+
+            return result;
+        }
+
+        void Cache::evict(MemoryCategory category, size_t targetSize)
+        {
+            size_t residentSize = getResidentSize(category);
+            if (residentSize <= targetSize) return;
+
+            struct Candidate final
+            {
+                Bundle* bundle;
+                const AssetId* id;
+                uint64_t lastUse;
+            };
+
+            std::vector<Candidate> candidates;
+
+            for (Bundle* bundle : bundles)
+            {
+                auto records = bundle->residency.find(category);
+                if (records == bundle->residency.end()) continue;
+
+                records->second.forEach([bundle, category, &candidates](const AssetId& id, const Bundle::Residency& record) {
+                    if (record.resident &&
+                        !record.source.filename.empty() &&
+                        bundle->isUnreferenced(category, id))
+                        candidates.push_back({bundle, &id, record.lastUse});
+                });
+            }
+
+            std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+                return a.lastUse < b.lastUse;
+            });
+
+            // evicted records stay in the map, so the id pointers remain valid
+            for (const Candidate& candidate : candidates)
+            {
+                if (residentSize <= targetSize) break;
+                residentSize -= candidate.bundle->evict(category, *candidate.id);
+            }
+        }
+
+        void Cache::trim()
+        {
+            for (MemoryCategory category : {MemoryCategory::TEXTURE,
+                                            MemoryCategory::SOUND,
+                                            MemoryCategory::MESH,
+                                            MemoryCategory::FONT})
+                evict(category, 0);
+        }
+
+        void Cache::update()
+        {
+            if (hotReload)
+                for (const std::string& path : fileMonitor.getModifiedFiles())
+                    for (Bundle* bundle : bundles)
+                        bundle->reloadFile(path);
+
+            for (const auto& memoryBudget : memoryBudgets)
+                evict(memoryBudget.first, memoryBudget.second);
+        }
+
         void Cache::addLoader(Loader* loader)
         {
             auto i = std::find(loaders.begin(), loaders.end(), loader);
@@ -57,100 +139,115 @@ namespace ouzel
                 loaders.erase(i);
         }
 
-        std::shared_ptr<graphics::Texture> Cache::getTexture(const std::string& name) const
+        std::shared_ptr<graphics::Texture> Cache::getTexture(const AssetIdRef& id)
         {
             for (Bundle* bundle : bundles)
-                if (std::shared_ptr<graphics::Texture> texture = bundle->getTexture(name))
+                if (std::shared_ptr<graphics::Texture> texture = bundle->getTexture(id))
                     return texture;
 
+            if (reloadOnDemand)
+                for (Bundle* bundle : bundles)
+                    if (bundle->restore(MemoryCategory::TEXTURE, id))
+                        return bundle->getTexture(id);
+
             return nullptr;
         }
 
-        std::shared_ptr<graphics::Shader> Cache::getShader(const std::string& name) const
+        std::shared_ptr<graphics::Shader> Cache::getShader(const AssetIdRef& id) const
         {
             for (Bundle* bundle : bundles)
-                if (std::shared_ptr<graphics::Shader> shader = bundle->getShader(name))
+                if (std::shared_ptr<graphics::Shader> shader = bundle->getShader(id))
                     return shader;
 
             return nullptr;
         }
 
-        std::shared_ptr<graphics::BlendState> Cache::getBlendState(const std::string& name) const
+        std::shared_ptr<graphics::BlendState> Cache::getBlendState(const AssetIdRef& id) const
         {
             for (Bundle* bundle : bundles)
-                if (std::shared_ptr<graphics::BlendState> blendState = bundle->getBlendState(name))
+                if (std::shared_ptr<graphics::BlendState> blendState = bundle->getBlendState(id))
                     return blendState;
 
             return nullptr;
         }
 
-        std::shared_ptr<graphics::DepthStencilState> Cache::getDepthStencilState(const std::string& name) const
+        std::shared_ptr<graphics::DepthStencilState> Cache::getDepthStencilState(const AssetIdRef& id) const
         {
             for (Bundle* bundle : bundles)
-                if (std::shared_ptr<graphics::DepthStencilState> depthStencilState = bundle->getDepthStencilState(name))
+                if (std::shared_ptr<graphics::DepthStencilState> depthStencilState = bundle->getDepthStencilState(id))
                     return depthStencilState;
 
             return nullptr;
         }
 
-        const scene::SpriteData* Cache::getSpriteData(const std::string& name) const
+        const scene::SpriteData* Cache::getSpriteData(const AssetIdRef& id) const
         {
             for (Bundle* bundle : bundles)
-                if (const scene::SpriteData* spriteData = bundle->getSpriteData(name))
+                if (const scene::SpriteData* spriteData = bundle->getSpriteData(id))
                     return spriteData;
 
             return nullptr;
         }
 
-        const scene::ParticleSystemData* Cache::getParticleSystemData(const std::string& name) const
+        const scene::ParticleSystemData* Cache::getParticleSystemData(const AssetIdRef& id) const
         {
             for (Bundle* bundle : bundles)
-                if (const scene::ParticleSystemData* particleSystemData = bundle->getParticleSystemData(name))
+                if (const scene::ParticleSystemData* particleSystemData = bundle->getParticleSystemData(id))
                     return particleSystemData;
 
             return nullptr;
         }
 
-        std::shared_ptr<gui::Font> Cache::getFont(const std::string& name) const
+        std::shared_ptr<gui::Font> Cache::getFont(const AssetIdRef& id)
         {
             for (Bundle* bundle : bundles)
-                if (std::shared_ptr<gui::Font> font = bundle->getFont(name))
+                if (std::shared_ptr<gui::Font> font = bundle->getFont(id))
                     return font;
 
+            if (reloadOnDemand)
+                for (Bundle* bundle : bundles)
+                    if (bundle->restore(MemoryCategory::FONT, id))
+                        return bundle->getFont(id);
+
             return nullptr;
         }
 
-        std::shared_ptr<audio::Sound> Cache::getSound(const std::string& name) const
+        std::shared_ptr<audio::Sound> Cache::getSound(const AssetIdRef& id)
         {
             for (Bundle* bundle : bundles)
-                if (std::shared_ptr<audio::Sound> sound = bundle->getSound(name))
+                if (std::shared_ptr<audio::Sound> sound = bundle->getSound(id))
                     return sound;
 
+            if (reloadOnDemand)
+                for (Bundle* bundle : bundles)
+                    if (bundle->restore(MemoryCategory::SOUND, id))
+                        return bundle->getSound(id);
+
             return nullptr;
         }
 
-        std::shared_ptr<graphics::Material> Cache::getMaterial(const std::string& name) const
+        std::shared_ptr<graphics::Material> Cache::getMaterial(const AssetIdRef& id) const
         {
             for (Bundle* bundle : bundles)
-                if (std::shared_ptr<graphics::Material> material = bundle->getMaterial(name))
+                if (std::shared_ptr<graphics::Material> material = bundle->getMaterial(id))
                     return material;
 
             return nullptr;
         }
 
-        const scene::SkinnedMeshData* Cache::getSkinnedMeshData(const std::string& name) const
+        const scene::SkinnedMeshData* Cache::getSkinnedMeshData(const AssetIdRef& id) const
         {
             for (Bundle* bundle : bundles)
-                if (const scene::SkinnedMeshData* meshData = bundle->getSkinnedMeshData(name))
+                if (const scene::SkinnedMeshData* meshData = bundle->getSkinnedMeshData(id))
                     return meshData;
 
             return nullptr;
         }
 
-        const scene::StaticMeshData* Cache::getStaticMeshData(const std::string& name) const
+        const scene::StaticMeshData* Cache::getStaticMeshData(const AssetIdRef& id) const
         {
             for (Bundle* bundle : bundles)
-                if (const scene::StaticMeshData* meshData = bundle->getStaticMeshData(name))
+                if (const scene::StaticMeshData* meshData = bundle->getStaticMeshData(id))
                     return meshData;
 
             return nullptr;
@@ -6,6 +6,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include "assets/BakeCache.hpp"
 #include "assets/Bundle.hpp"
 #include "assets/BmfLoader.hpp"
 #include "assets/ColladaLoader.hpp"
@@ -18,6 +19,7 @@
 #include "assets/TtfLoader.hpp"
 #include "assets/VorbisLoader.hpp"
 #include "assets/WaveLoader.hpp"
+#include "storage/FileMonitor.hpp"
 
 namespace ouzel
 {
@@ -42,17 +44,46 @@ namespace ouzel
             const std::vector<Bundle*>& getBundles() const { return bundles; }
             const std::vector<Loader*>& getLoaders() const { return loaders; }
 
-            std::shared_ptr<graphics::Texture> getTexture(const std::string& name) const;
-            std::shared_ptr<graphics::Shader> getShader(const std::string& name) const;
-            std::shared_ptr<graphics::BlendState> getBlendState(const std::string& name) const;
-            std::shared_ptr<graphics::DepthStencilState> getDepthStencilState(const std::string& name) const;
-            const scene::SpriteData* getSpriteData(const std::string& name) const;
-            const scene::ParticleSystemData* getParticleSystemData(const std::string& name) const;
-            std::shared_ptr<gui::Font> getFont(const std::string& name) const;
-            std::shared_ptr<audio::Sound> getSound(const std::string& name) const;
-            std::shared_ptr<graphics::Material> getMaterial(const std::string& name) const;
-            const scene::SkinnedMeshData* getSkinnedMeshData(const std::string& name) const;
-            const scene::StaticMeshData* getStaticMeshData(const std::string& name) const;
+            BakeCache& getBakeCache() { return bakeCache; }
+            const BakeCache& getBakeCache() const { return bakeCache; }
+
+            // watches the files of loaded assets and reloads them when they change
+            bool isHotReloadEnabled() const { return hotReload; }
+            void setHotReloadEnabled(bool newHotReload) { hotReload = newHotReload; }
+
+            // budget of the resident memory in bytes, 0 for no limit
+            size_t getMemoryBudget(MemoryCategory category) const;
+            void setMemoryBudget(MemoryCategory category, size_t budget);
+
+            // bytes held by the resident assets of all bundles
+            size_t getResidentSize(MemoryCategory category) const;
+
+            // loads evicted assets again when they are requested
+            bool isReloadOnDemandEnabled() const { return reloadOnDemand; }
+            void setReloadOnDemandEnabled(bool newReloadOnDemand) { reloadOnDemand = newReloadOnDemand; }
+
+            // evicts the least recently used assets that are not referenced outside of their bundle
+            // until the resident size is not larger than the target size, only assets loaded from files are evicted
+            void evict(MemoryCategory category, size_t targetSize);
+
+            // evicts all unreferenced assets, called on low memory
+            void trim();
+
+            // called once per frame before drawing
+            void update();
+
+            // the textures, fonts and sounds are marked as used and loaded again if they were evicted
+            std::shared_ptr<graphics::Texture> getTexture(const AssetIdRef& id);
+            std::shared_ptr<graphics::Shader> getShader(const AssetIdRef& id) const;
+            std::shared_ptr<graphics::BlendState> getBlendState(const AssetIdRef& id) const;
+            std::shared_ptr<graphics::DepthStencilState> getDepthStencilState(const AssetIdRef& id) const;
+            const scene::SpriteData* getSpriteData(const AssetIdRef& id) const;
+            const scene::ParticleSystemData* getParticleSystemData(const AssetIdRef& id) const;
+            std::shared_ptr<gui::Font> getFont(const AssetIdRef& id);
+            std::shared_ptr<audio::Sound> getSound(const AssetIdRef& id);
+            std::shared_ptr<graphics::Material> getMaterial(const AssetIdRef& id) const;
+            const scene::SkinnedMeshData* getSkinnedMeshData(const AssetIdRef& id) const;
+            const scene::StaticMeshData* getStaticMeshData(const AssetIdRef& id) const;
 
         private:
             void addBundle(Bundle* bundle);
@@ -64,6 +95,15 @@ namespace ouzel
             std::vector<Bundle*> bundles;
             std::vector<Loader*> loaders;
 
+            BakeCache bakeCache;
+
+            std::map<MemoryCategory, size_t> memoryBudgets;
+            bool reloadOnDemand = true;
+            uint64_t useCounter = 0;
+
+            bool hotReload = false;
+            storage::FileMonitor fileMonitor;
+
             BmfLoader loaderBMF;
             ColladaLoader loaderCollada;
             GltfLoader loaderGLTF;
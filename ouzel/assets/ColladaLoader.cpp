@@ -4,7 +4,7 @@
 #include "ColladaLoader.hpp"
 #include "Bundle.hpp"
 #include "scene/SkinnedMeshRenderer.hpp"
-#include "utils/Xml.hpp"
+#include "utils/XmlParser.hpp"
 
 namespace ouzel
 {
@@ -20,19 +20,24 @@ namespace ouzel
                                       const std::vector<uint8_t>& data,
                                       bool)
         {
-            xml::Data colladaData(data);
+            xml::Reader reader(data);
+            xml::Reader::Event event;
 
-            if (colladaData.getChildren().empty())
-                throw std::runtime_error("Invalid Collada file");
-
-            xml::Node rootNode = colladaData.getChildren().front();
+            // skip the XML declaration and comments
+            while ((event = reader.next()) == xml::Reader::Event::PROCESSING_INSTRUCTION ||
+                   event == xml::Reader::Event::COMMENT);
 
-            if (rootNode.getValue() != "COLLADA")
+            if (event != xml::Reader::Event::START_TAG ||
+                reader.getName() != "COLLADA")
                 throw std::runtime_error("Invalid Collada file");
 
             scene::SkinnedMeshData meshData;
 
             // TODO: load the model
+            reader.skip();
+
+            // make sure that the rest of the file is well-formed
+            while (reader.next() != xml::Reader::Event::END);
 
             bundle.setSkinnedMeshData(name, meshData);
 
@@ -1,14 +1,23 @@
 // Copyright 2015-2019 Elviss Strazdins. All rights reserved.
 
+#include <stdexcept>
 #include "GltfLoader.hpp"
 #include "Bundle.hpp"
 #include "scene/SkinnedMeshRenderer.hpp"
-#include "utils/Json.hpp"
+#include "utils/JsonParser.hpp"
 
 namespace ouzel
 {
     namespace assets
     {
+        static Vector3F readVector3(const json::Node& node)
+        {
+            if (node.getType() != json::Node::Type::ARRAY || node.getSize() != 3)
+                throw std::runtime_error("Expected a 3D vector");
+
+            return Vector3F(node[0].as<float>(), node[1].as<float>(), node[2].as<float>());
+        }
+
         GltfLoader::GltfLoader(Cache& initCache):
             Loader(initCache, TYPE)
         {
@@ -19,12 +28,38 @@ namespace ouzel
                                    const std::vector<uint8_t>& data,
                                    bool mipmaps)
         {
-            json::Data d(data);
+            json::Document d(data);
 
-            json::Value& nodesValue = d["nodes"];
-            json::Value& meshesValue = d["meshes"];
+            json::Node nodesValue = d["nodes"];
+            json::Node meshesValue = d["meshes"];
+            json::Node accessorsValue = d["accessors"];
 
             scene::SkinnedMeshData skinnedMeshData;
+
+            // glTF requires the bounds of the vertex positions, so the bounding box is found without reading the buffers
+            // TODO: apply the node transforms
+            for (const json::Node nodeValue : nodesValue)
+            {
+                if (!nodeValue.hasMember("mesh")) continue;
+
+                json::Node meshValue = meshesValue[nodeValue["mesh"].as<size_t>()];
+                if (meshValue.getType() != json::Node::Type::OBJECT)
+                    throw std::runtime_error("Invalid mesh index");
+
+                for (const json::Node primitiveValue : meshValue["primitives"])
+                {
+                    json::Node positionValue = primitiveValue["attributes"]["POSITION"];
+                    if (positionValue.getType() == json::Node::Type::NONE) continue;
+
+                    json::Node accessorValue = accessorsValue[positionValue.as<size_t>()];
+                    if (accessorValue.getType() != json::Node::Type::OBJECT)
+                        throw std::runtime_error("Invalid accessor index");
+
+                    skinnedMeshData.boundingBox.merge(Box3F(readVector3(accessorValue["min"]),
+                                                            readVector3(accessorValue["max"])));
+                }
+            }
+
             bundle.setSkinnedMeshData(name, skinnedMeshData);
 
             return true;
@@ -2,12 +2,16 @@
 
 #include <functional>
 #include <memory>
+#include <utility>
 #include <stdexcept>
 #include "ImageLoader.hpp"
 #include "Bundle.hpp"
+#include "Cache.hpp"
 #include "core/Engine.hpp"
-#include "graphics/Image.hpp"
 #include "graphics/Texture.hpp"
+#include "utils/Log.hpp"
+#include "utils/ObfSerializer.hpp"
+#include "utils/Profiler.hpp"
 
 #define STBI_NO_PSD
 #define STBI_NO_HDR
@@ -23,6 +27,87 @@ namespace ouzel
 {
     namespace assets
     {
+        struct BakedLevel final
+        {
+            uint32_t width = 0;
+            uint32_t height = 0;
+            uint32_t pitch = 0;
+            std::vector<uint8_t> data;
+
+            template<class Archive>
+            void serialize(Archive& archive)
+            {
+                archive(1, width);
+                archive(2, height);
+                archive(3, pitch);
+                archive(4, data);
+            }
+        };
+
+        struct BakedImage final
+        {
+            graphics::PixelFormat pixelFormat = graphics::PixelFormat::DEFAULT;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            std::vector<BakedLevel> levels;
+
+            template<class Archive>
+            void serialize(Archive& archive)
+            {
+                archive(1, pixelFormat);
+                archive(2, width);
+                archive(3, height);
+                archive(4, levels);
+            }
+        };
+
+        static std::vector<uint8_t> writeLevels(graphics::PixelFormat pixelFormat,
+                                                const Size2U& size,
+                                                const std::vector<graphics::Texture::Level>& levels)
+        {
+            BakedImage image;
+            image.pixelFormat = pixelFormat;
+            image.width = size.v[0];
+            image.height = size.v[1];
+
+            for (const graphics::Texture::Level& level : levels)
+            {
+                BakedLevel bakedLevel;
+                bakedLevel.width = level.size.v[0];
+                bakedLevel.height = level.size.v[1];
+                bakedLevel.pitch = level.pitch;
+                bakedLevel.data = level.data;
+                image.levels.push_back(std::move(bakedLevel));
+            }
+
+            std::vector<uint8_t> result;
+            obf::encode(image, result);
+            return result;
+        }
+
+        static void readLevels(const std::vector<uint8_t>& data,
+                               graphics::PixelFormat& pixelFormat,
+                               Size2U& size,
+                               std::vector<graphics::Texture::Level>& levels)
+        {
+            BakedImage image;
+            obf::decode(image, data);
+
+            if (image.levels.empty())
+                throw std::runtime_error("Invalid baked image");
+
+            pixelFormat = image.pixelFormat;
+            size = Size2U(image.width, image.height);
+            levels.resize(image.levels.size());
+
+            for (size_t i = 0; i < levels.size(); ++i)
+            {
+                levels[i].size = Size2U(image.levels[i].width, image.levels[i].height);
+                levels[i].pitch = image.levels[i].pitch;
+                levels[i].data = std::move(image.levels[i].data);
+            }
+        }
+
         ImageLoader::ImageLoader(Cache& initCache):
             Loader(initCache, TYPE)
         {
@@ -33,85 +118,117 @@ namespace ouzel
                                     const std::vector<uint8_t>& data,
                                     bool mipmaps)
         {
-            int width;
-            int height;
-            int comp;
-
-            stbi_uc* tempData = stbi_load_from_memory(data.data(), static_cast<int>(data.size()), &width, &height, &comp, STBI_default);
+            ProfileZone zone(engine->getProfiler(), "Image cache miss");
 
-            if (!tempData)
-                throw std::runtime_error("Failed to load texture, reason: " + std::string(stbi_failure_reason()));
+            BakeCache& bakeCache = cache.getBakeCache();
+            const uint64_t key = bakeCache.isEnabled() ? BakeCache::getKey(TYPE, VERSION, mipmaps ? 1 : 0, data) : 0;
 
-            size_t pixelSize;
             graphics::PixelFormat pixelFormat;
-            std::vector<uint8_t> imageData;
+            Size2U size;
+            std::vector<graphics::Texture::Level> levels;
 
-            switch (comp)
+            std::vector<uint8_t> baked;
+            bool loaded = false;
+
+            if (bakeCache.load(key, baked))
             {
-                case STBI_grey:
+                try
                 {
-                    pixelFormat = graphics::PixelFormat::R8_UNORM;
-                    pixelSize = 1;
-                    imageData.assign(tempData,
-                                     tempData + static_cast<size_t>(width * height) * pixelSize);
-                    stbi_image_free(tempData);
-                    break;
+                    readLevels(baked, pixelFormat, size, levels);
+                    loaded = true;
+                    zone.setName("Image cache hit");
                 }
-                case STBI_grey_alpha:
+                catch (const std::exception& e)
                 {
-                    pixelFormat = graphics::PixelFormat::RG8_UNORM;
-                    pixelSize = 2;
-                    imageData.assign(tempData,
-                                     tempData + static_cast<size_t>(width * height) * pixelSize);
-                    stbi_image_free(tempData);
-                    break;
+                    OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to load baked image " << name << ": " << e.what();
                 }
-                case STBI_rgb:
-                {
-                    pixelFormat = graphics::PixelFormat::RGBA8_UNORM;
-                    pixelSize = 4;
+            }
 
-                    imageData.resize(static_cast<size_t>(width * height * 4));
+            if (!loaded)
+            {
+                int width;
+                int height;
+                int comp;
+
+                stbi_uc* tempData = stbi_load_from_memory(data.data(), static_cast<int>(data.size()), &width, &height, &comp, STBI_default);
+
+                if (!tempData)
+                    throw std::runtime_error("Failed to load texture, reason: " + std::string(stbi_failure_reason()));
 
-                    for (int y = 0; y < height; ++y)
+                size_t pixelSize;
+                std::vector<uint8_t> imageData;
+
+                switch (comp)
+                {
+                    case STBI_grey:
                     {
-                        for (int x = 0; x < width; ++x)
+                        pixelFormat = graphics::PixelFormat::R8_UNORM;
+                        pixelSize = 1;
+                        imageData.assign(tempData,
+                                         tempData + static_cast<size_t>(width * height) * pixelSize);
+                        stbi_image_free(tempData);
+                        break;
+                    }
+                    case STBI_grey_alpha:
+                    {
+                        pixelFormat = graphics::PixelFormat::RG8_UNORM;
+                        pixelSize = 2;
+                        imageData.assign(tempData,
+                                         tempData + static_cast<size_t>(width * height) * pixelSize);
+                        stbi_image_free(tempData);
+                        break;
+                    }
+                    case STBI_rgb:
+                    {
+                        pixelFormat = graphics::PixelFormat::RGBA8_UNORM;
+                        pixelSize = 4;
+
+                        imageData.resize(static_cast<size_t>(width * height * 4));
+
+                        for (int y = 0; y < height; ++y)
                         {
-                            size_t sourceOffset = static_cast<size_t>((y * width + x) * 3);
-                            size_t destinationOffset = static_cast<size_t>((y * width + x) * 4);
-                            imageData[destinationOffset + 0] = tempData[sourceOffset + 0];
-                            imageData[destinationOffset + 1] = tempData[sourceOffset + 1];
-                            imageData[destinationOffset + 2] = tempData[sourceOffset + 2];
-                            imageData[destinationOffset + 3] = 255;
+                            for (int x = 0; x < width; ++x)
+                            {
+                                size_t sourceOffset = static_cast<size_t>((y * width + x) * 3);
+                                size_t destinationOffset = static_cast<size_t>((y * width + x) * 4);
+                                imageData[destinationOffset + 0] = tempData[sourceOffset + 0];
+                                imageData[destinationOffset + 1] = tempData[sourceOffset + 1];
+                                imageData[destinationOffset + 2] = tempData[sourceOffset + 2];
+                                imageData[destinationOffset + 3] = 255;
+                            }
                         }
+                        stbi_image_free(tempData);
+                        break;
                     }
-                    stbi_image_free(tempData);
-                    break;
+                    case STBI_rgb_alpha:
+                    {
+                        pixelFormat = graphics::PixelFormat::RGBA8_UNORM;
+                        pixelSize = 4;
+                        imageData.assign(tempData,
+                                         tempData + static_cast<size_t>(width * height) * pixelSize);
+                        stbi_image_free(tempData);
+                        break;
+                    }
+                    default:
+                        stbi_image_free(tempData);
+                        throw std::runtime_error("Unsupported pixel format");
                 }
-                case STBI_rgb_alpha:
+
+                size = Size2U(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+
+                // the mip chain is baked as well, so later loads don't have to downsample the image
+                levels = graphics::Texture::calculateLevels(size, imageData, mipmaps ? 0 : 1, pixelFormat);
+
+                if (bakeCache.isEnabled())
                 {
-                    pixelFormat = graphics::PixelFormat::RGBA8_UNORM;
-                    pixelSize = 4;
-                    imageData.assign(tempData,
-                                     tempData + static_cast<size_t>(width * height) * pixelSize);
-                    stbi_image_free(tempData);
-                    break;
+                    bakeCache.save(key, writeLevels(pixelFormat, size, levels));
                 }
-                default:
-                    stbi_image_free(tempData);
-                    throw std::runtime_error("Unsupported pixel format");
             }
 
-            graphics::Image image(pixelFormat,
-                                  Size2U(static_cast<uint32_t>(width),
-                                         static_cast<uint32_t>(height)),
-                                  imageData);
-
             std::shared_ptr<graphics::Texture> texture = std::make_shared<graphics::Texture>(*engine->getRenderer(),
-                                                                                             image.getData(),
-                                                                                             image.getSize(), 0,
-                                                                                             mipmaps ? 0 : 1,
-                                                                                             image.getPixelFormat());
+                                                                                             levels,
+                                                                                             size, 0,
+                                                                                             pixelFormat);
 
             bundle.setTexture(name, texture);
 
@@ -13,6 +13,7 @@ namespace ouzel
         {
         public:
             static constexpr uint32_t TYPE = Loader::IMAGE;
+            static constexpr uint32_t VERSION = 2; // must be increased when the baked output changes
 
             explicit ImageLoader(Cache& initCache);
             bool loadAsset(Bundle& bundle,
@@ -1,411 +1,775 @@
 // Copyright 2015-2019 Elviss Strazdins. All rights reserved.
 
-#include <cstdlib>
-#include <iterator>
-#include <map>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <functional>
 #include <stdexcept>
 #include <string>
-#include <tuple>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
 #include "ObjLoader.hpp"
 #include "Bundle.hpp"
 #include "Cache.hpp"
+#include "core/Engine.hpp"
 #include "graphics/Material.hpp"
+#include "utils/Log.hpp"
+#include "utils/Profiler.hpp"
 
 namespace ouzel
 {
     namespace assets
     {
-        static bool isWhitespace(uint8_t c)
+        // files larger than this are split into chunks that are parsed in parallel
+        static constexpr size_t CHUNK_SIZE = 1024 * 1024;
+
+        static inline bool isWhitespace(char c)
         {
             return c == ' ' || c == '\t';
         }
 
-        static bool isNewline(uint8_t c)
+        static inline bool isNewline(char c)
         {
             return c == '\r' || c == '\n';
         }
 
-        static bool isControlChar(uint8_t c)
+        static inline bool isControlChar(char c)
         {
-            return c <= 0x1F;
+            return static_cast<uint8_t>(c) <= 0x1F;
         }
 
-        static void skipWhitespaces(const std::vector<uint8_t>& str,
-                                    std::vector<uint8_t>::const_iterator& iterator)
+        static inline bool isDigit(char c)
         {
-            for (;;)
-            {
-                if (iterator == str.end()) break;
+            return c >= '0' && c <= '9';
+        }
 
-                if (isWhitespace(*iterator))
-                    ++iterator;
-                else
-                    break;
-            }
+        static inline void skipWhitespaces(const char*& iterator, const char* end)
+        {
+            while (iterator != end && isWhitespace(*iterator))
+                ++iterator;
         }
 
-        static void skipLine(const std::vector<uint8_t>& str,
-                             std::vector<uint8_t>::const_iterator& iterator)
+        static inline void skipLine(const char*& iterator, const char* end)
         {
-            for (;;)
-            {
-                if (iterator == str.end()) break;
+            while (iterator != end && !isNewline(*iterator))
+                ++iterator;
 
-                if (isNewline(*iterator))
-                {
-                    ++iterator;
-                    break;
-                }
+            if (iterator != end) ++iterator;
+        }
+
+        static inline size_t parseToken(const char*& iterator, const char* end)
+        {
+            const char* start = iterator;
 
+            while (iterator != end && !isControlChar(*iterator) && !isWhitespace(*iterator))
                 ++iterator;
-            }
+
+            return static_cast<size_t>(iterator - start);
         }
 
-        static std::string parseString(const std::vector<uint8_t>& str,
-                                       std::vector<uint8_t>::const_iterator& iterator)
+        template <size_t N>
+        static inline bool isKeyword(const char* keyword, size_t length, const char (&expected)[N])
         {
-            std::string result;
-
-            for (;;)
-            {
-                if (iterator == str.end() || isControlChar(*iterator) || isWhitespace(*iterator)) break;
+            return length == N - 1 && std::memcmp(keyword, expected, N - 1) == 0;
+        }
 
-                result.push_back(static_cast<char>(*iterator));
+        static std::string parseString(const char*& iterator, const char* end)
+        {
+            skipWhitespaces(iterator, end);
 
-                ++iterator;
-            }
+            const char* start = iterator;
+            const size_t length = parseToken(iterator, end);
 
-            if (result.empty())
+            if (!length)
                 throw std::runtime_error("Invalid string");
 
-            return result;
+            return std::string(start, length);
         }
 
-        static int32_t parseInt32(const std::vector<uint8_t>& str,
-                                  std::vector<uint8_t>::const_iterator& iterator)
+        static bool parseInt32(const char*& iterator, const char* end, int32_t& result)
         {
-            int32_t result;
-            std::string value;
-            uint32_t length = 1;
+            const char* start = iterator;
+            bool negative = false;
 
-            if (iterator != str.end() && *iterator == '-')
+            if (iterator != end && (*iterator == '-' || *iterator == '+'))
             {
-                value.push_back(static_cast<char>(*iterator));
-                ++length;
+                negative = (*iterator == '-');
                 ++iterator;
             }
 
-            for (;;)
+            if (iterator == end || !isDigit(*iterator))
             {
-                if (iterator == str.end() || *iterator < '0' || *iterator > '9') break;
+                iterator = start;
+                return false;
+            }
 
-                value.push_back(static_cast<char>(*iterator));
+            int64_t value = 0;
 
-                ++iterator;
-            }
+            for (; iterator != end && isDigit(*iterator); ++iterator)
+            {
+                value = value * 10 + (*iterator - '0');
 
-            if (value.length() < length) return false;
+                if (value > INT32_MAX)
+                    throw std::runtime_error("Integer out of range");
+            }
 
-            result = std::stoi(value);
+            result = static_cast<int32_t>(negative ? -value : value);
 
-            return result;
+            return true;
         }
 
-        static float parseFloat(const std::vector<uint8_t>& str,
-                               std::vector<uint8_t>::const_iterator& iterator)
+        // parses the decimal and scientific notations without copying the digits into a string
+        static bool parseFloat(const char*& iterator, const char* end, float& result)
         {
-            float result;
-            std::string value;
-            uint32_t length = 1;
+            static const double powers[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
 
-            if (iterator != str.end() && *iterator == '-')
+            const char* start = iterator;
+            bool negative = false;
+
+            if (iterator != end && (*iterator == '-' || *iterator == '+'))
             {
-                value.push_back(static_cast<char>(*iterator));
-                ++length;
+                negative = (*iterator == '-');
                 ++iterator;
             }
 
-            for (;;)
-            {
-                if (iterator == str.end() || *iterator < '0' || *iterator > '9') break;
+            uint64_t mantissa = 0;
+            uint32_t digits = 0;
+            int32_t exponent = 0;
+            bool hasDigits = false;
 
-                value.push_back(static_cast<char>(*iterator));
+            // only the first 19 significant digits fit in the mantissa, the rest only affect the exponent
+            for (; iterator != end && isDigit(*iterator); ++iterator)
+            {
+                hasDigits = true;
 
-                ++iterator;
+                if (digits < 19)
+                {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*iterator - '0');
+                    if (mantissa) ++digits;
+                }
+                else
+                    ++exponent;
             }
 
-            if (iterator != str.end() && *iterator == '.')
+            if (iterator != end && *iterator == '.')
             {
-                value.push_back(static_cast<char>(*iterator));
-                ++length;
                 ++iterator;
 
-                for (;;)
+                for (; iterator != end && isDigit(*iterator); ++iterator)
                 {
-                    if (iterator == str.end() || *iterator < '0' || *iterator > '9') break;
+                    hasDigits = true;
+
+                    if (digits < 19)
+                    {
+                        mantissa = mantissa * 10 + static_cast<uint64_t>(*iterator - '0');
+                        if (mantissa) ++digits;
+                        --exponent;
+                    }
+                }
+            }
+
+            if (!hasDigits)
+            {
+                iterator = start;
+                return false;
+            }
 
-                    value.push_back(static_cast<char>(*iterator));
+            if (iterator != end && (*iterator == 'e' || *iterator == 'E'))
+            {
+                const char* exponentStart = iterator;
+                ++iterator;
 
+                bool negativeExponent = false;
+                if (iterator != end && (*iterator == '-' || *iterator == '+'))
+                {
+                    negativeExponent = (*iterator == '-');
                     ++iterator;
                 }
-            }
 
-            if (value.length() < length) return false;
+                if (iterator != end && isDigit(*iterator))
+                {
+                    int32_t value = 0;
 
-            result = std::stof(value);
+                    for (; iterator != end && isDigit(*iterator); ++iterator)
+                        if (value < 10000) value = value * 10 + (*iterator - '0');
 
-            return result;
-        }
+                    exponent += negativeExponent ? -value : value;
+                }
+                else
+                    iterator = exponentStart; // not an exponent
+            }
 
-        static bool parseToken(const std::vector<uint8_t>& str,
-                               std::vector<uint8_t>::const_iterator& iterator,
-                               char token)
-        {
-            if (iterator == str.end() || *iterator != static_cast<uint8_t>(token)) return false;
+            double value = static_cast<double>(mantissa);
+
+            if (mantissa)
+            {
+                if (exponent >= 0 && exponent <= 22)
+                    value *= powers[exponent];
+                else if (exponent < 0 && exponent >= -22)
+                    value /= powers[-exponent];
+                else
+                    value *= std::pow(10.0, static_cast<double>(exponent));
+            }
 
-            ++iterator;
+            result = static_cast<float>(negative ? -value : value);
 
             return true;
         }
 
-        ObjLoader::ObjLoader(Cache& initCache):
-            Loader(initCache, TYPE)
+        struct ObjCommand final
         {
-        }
-
-        bool ObjLoader::loadAsset(Bundle& bundle,
-                                  const std::string& name,
-                                  const std::vector<uint8_t>& data,
-                                  bool mipmaps)
+            enum class Type
+            {
+                MATERIAL_LIBRARY,
+                MATERIAL,
+                OBJECT,
+                FACE
+            };
+
+            Type type;
+            uint32_t value; // index of the string or of the first face index
+            uint32_t count; // number of face vertices
+
+            // number of attributes parsed by the chunk before the face, used to resolve relative indices
+            uint32_t positionCount;
+            uint32_t texCoordCount;
+            uint32_t normalCount;
+        };
+
+        struct ObjChunk final
         {
-            std::string objectName = name;
-            std::shared_ptr<graphics::Material> material;
+            const char* begin = nullptr;
+            const char* end = nullptr;
+
             std::vector<Vector3F> positions;
             std::vector<Vector2F> texCoords;
             std::vector<Vector3F> normals;
-            std::vector<graphics::Vertex> vertices;
-            std::map<std::tuple<uint32_t, uint32_t, uint32_t>, uint32_t> vertexMap;
-            std::vector<uint32_t> indices;
-            Box3F boundingBox;
+            std::vector<int32_t> faceIndices; // position, texture coordinate and normal per face vertex, 0 if missing
+            std::vector<std::string> strings;
+            std::vector<ObjCommand> commands;
 
-            uint32_t objectCount = 0;
+            bool leadingContent = false; // a command before the first object
+            std::exception_ptr exception;
+        };
+
+        struct ObjVertexKey final
+        {
+            uint32_t position;
+            uint32_t texCoord;
+            uint32_t normal;
 
-            auto iterator = data.cbegin();
+            inline bool operator==(const ObjVertexKey& other) const
+            {
+                return position == other.position && texCoord == other.texCoord && normal == other.normal;
+            }
+        };
 
-            std::string keyword;
-            std::string value;
+        struct ObjVertexKeyHash final
+        {
+            inline size_t operator()(const ObjVertexKey& key) const
+            {
+                uint64_t result = key.position;
+                result = result * 0x9E3779B97F4A7C15ULL + key.texCoord;
+                result = result * 0x9E3779B97F4A7C15ULL + key.normal;
+                return static_cast<size_t>(result ^ (result >> 32));
+            }
+        };
 
-            for (;;)
+        static void parseChunk(ObjChunk& chunk)
+        {
+            try
             {
-                if (iterator == data.end()) break;
+                const char* iterator = chunk.begin;
+                const char* end = chunk.end;
+                bool hasObject = false;
 
-                if (isNewline(*iterator))
-                {
-                    // skip empty lines
-                    ++iterator;
-                }
-                else if (*iterator == '#')
-                {
-                    // skip the comment
-                    skipLine(data, iterator);
-                }
-                else
+                while (iterator != end)
                 {
-                    skipWhitespaces(data, iterator);
-                    keyword = parseString(data, iterator);
-
-                    if (keyword == "mtllib")
-                    {
-                        skipWhitespaces(data, iterator);
-                        value = parseString(data, iterator);
+                    skipWhitespaces(iterator, end);
 
-                        skipLine(data, iterator);
+                    if (iterator == end) break;
 
-                        //if (!cache.getMaterial(filename))
-                        // TODO don't load material lib every time
-                        bundle.loadAsset(Loader::MATERIAL, value, value, mipmaps);
-                    }
-                    else if (keyword == "usemtl")
+                    if (isNewline(*iterator))
                     {
-                        skipWhitespaces(data, iterator);
-                        value = parseString(data, iterator);
-
-                        skipLine(data, iterator);
-
-                        material = cache.getMaterial(value);
+                        // skip empty lines
+                        ++iterator;
+                        continue;
                     }
-                    else if (keyword == "o")
+                    else if (*iterator == '#')
                     {
-                        if (objectCount)
-                        {
-                            scene::StaticMeshData meshData(boundingBox, indices, vertices, material);
-                            bundle.setStaticMeshData(objectName, meshData);
-                        }
-
-                        skipWhitespaces(data, iterator);
-                        objectName = parseString(data, iterator);
+                        // skip the comment
+                        skipLine(iterator, end);
+                        continue;
+                    }
 
-                        skipLine(data, iterator);
+                    const char* keyword = iterator;
+                    const size_t keywordLength = parseToken(iterator, end);
 
-                        material.reset();
-                        vertices.clear();
-                        indices.clear();
-                        vertexMap.clear();
-                        boundingBox.reset();
-                        ++objectCount;
-                    }
-                    else if (keyword == "v")
+                    if (isKeyword(keyword, keywordLength, "v"))
                     {
                         Vector3F position;
 
-                        skipWhitespaces(data, iterator);
-                        position.v[0] = parseFloat(data, iterator);
-                        skipWhitespaces(data, iterator);
-                        position.v[1] = parseFloat(data, iterator);
-                        skipWhitespaces(data, iterator);
-                        position.v[2] = parseFloat(data, iterator);
-
-                        skipLine(data, iterator);
+                        for (float& v : position.v)
+                        {
+                            skipWhitespaces(iterator, end);
+                            if (!parseFloat(iterator, end, v)) v = 0.0F;
+                        }
 
-                        positions.push_back(position);
+                        chunk.positions.push_back(position);
                     }
-                    else if (keyword == "vt")
+                    else if (isKeyword(keyword, keywordLength, "vt"))
                     {
                         Vector2F texCoord;
 
-                        skipWhitespaces(data, iterator);
-                        texCoord.v[0] = parseFloat(data, iterator);
-                        skipWhitespaces(data, iterator);
-                        texCoord.v[1] = parseFloat(data, iterator);
-
-                        skipLine(data, iterator);
+                        for (float& v : texCoord.v)
+                        {
+                            skipWhitespaces(iterator, end);
+                            if (!parseFloat(iterator, end, v)) v = 0.0F;
+                        }
 
-                        texCoords.push_back(texCoord);
+                        chunk.texCoords.push_back(texCoord);
                     }
-                    else if (keyword == "vn")
+                    else if (isKeyword(keyword, keywordLength, "vn"))
                     {
                         Vector3F normal;
 
-                        skipWhitespaces(data, iterator);
-                        normal.v[0] = parseFloat(data, iterator);
-                        skipWhitespaces(data, iterator);
-                        normal.v[1] = parseFloat(data, iterator);
-                        skipWhitespaces(data, iterator);
-                        normal.v[2] = parseFloat(data, iterator);
-
-                        skipLine(data, iterator);
+                        for (float& v : normal.v)
+                        {
+                            skipWhitespaces(iterator, end);
+                            if (!parseFloat(iterator, end, v)) v = 0.0F;
+                        }
 
-                        normals.push_back(normal);
+                        chunk.normals.push_back(normal);
                     }
-                    else if (keyword == "f")
+                    else if (isKeyword(keyword, keywordLength, "f"))
                     {
-                        std::vector<uint32_t> vertexIndices;
-
-                        std::tuple<uint32_t, uint32_t, uint32_t> i = std::make_tuple(0, 0, 0);
-                        int32_t positionIndex = 0;
-                        int32_t texCoordIndex = 0;
-                        int32_t normalIndex = 0;
+                        ObjCommand command;
+                        command.type = ObjCommand::Type::FACE;
+                        command.value = static_cast<uint32_t>(chunk.faceIndices.size());
+                        command.count = 0;
+                        command.positionCount = static_cast<uint32_t>(chunk.positions.size());
+                        command.texCoordCount = static_cast<uint32_t>(chunk.texCoords.size());
+                        command.normalCount = static_cast<uint32_t>(chunk.normals.size());
 
                         for (;;)
                         {
-                            if (iterator == data.end() || isNewline(*iterator)) break;
-
-                            skipWhitespaces(data, iterator);
-                            positionIndex = parseInt32(data, iterator);
+                            skipWhitespaces(iterator, end);
+                            if (iterator == end || isNewline(*iterator) || *iterator == '#') break;
 
-                            if (positionIndex < 0)
-                                positionIndex = static_cast<int32_t>(positions.size()) + positionIndex + 1;
+                            int32_t positionIndex = 0;
+                            int32_t texCoordIndex = 0;
+                            int32_t normalIndex = 0;
 
-                            if (positionIndex < 1 || positionIndex > static_cast<int32_t>(positions.size()))
+                            if (!parseInt32(iterator, end, positionIndex))
                                 throw std::runtime_error("Invalid position index");
 
-                            std::get<0>(i) = static_cast<uint32_t>(positionIndex);
-
                             // has texture coordinates
-                            if (parseToken(data, iterator, '/'))
+                            if (iterator != end && *iterator == '/')
                             {
+                                ++iterator;
+
                                 // two slashes in a row indicates no texture coordinates
-                                if (iterator != data.end() && *iterator != '/')
+                                if (iterator != end && *iterator != '/' &&
+                                    !parseInt32(iterator, end, texCoordIndex))
+                                    throw std::runtime_error("Invalid texture coordinate index");
+
+                                // has normal
+                                if (iterator != end && *iterator == '/')
                                 {
-                                    texCoordIndex = parseInt32(data, iterator);
+                                    ++iterator;
 
-                                    if (texCoordIndex < 0)
-                                        texCoordIndex = static_cast<int32_t>(texCoords.size()) + texCoordIndex + 1;
+                                    if (!parseInt32(iterator, end, normalIndex))
+                                        throw std::runtime_error("Invalid normal index");
+                                }
+                            }
 
-                                    if (texCoordIndex < 1 || texCoordIndex > static_cast<int32_t>(texCoords.size()))
-                                        throw std::runtime_error("Invalid texture coordinate index");
+                            chunk.faceIndices.push_back(positionIndex);
+                            chunk.faceIndices.push_back(texCoordIndex);
+                            chunk.faceIndices.push_back(normalIndex);
+                            ++command.count;
+                        }
 
-                                    std::get<1>(i) = static_cast<uint32_t>(texCoordIndex);
-                                }
+                        if (command.count < 3)
+                            throw std::runtime_error("Invalid face count");
 
-                                // has normal
-                                if (parseToken(data, iterator, '/'))
-                                {
-                                    normalIndex = parseInt32(data, iterator);
+                        chunk.commands.push_back(command);
+                    }
+                    else if (isKeyword(keyword, keywordLength, "mtllib") ||
+                             isKeyword(keyword, keywordLength, "usemtl") ||
+                             isKeyword(keyword, keywordLength, "o"))
+                    {
+                        ObjCommand command = ObjCommand();
+                        command.type = (keyword[0] == 'm') ? ObjCommand::Type::MATERIAL_LIBRARY :
+                            (keyword[0] == 'u') ? ObjCommand::Type::MATERIAL : ObjCommand::Type::OBJECT;
+                        command.value = static_cast<uint32_t>(chunk.strings.size());
+                        chunk.strings.push_back(parseString(iterator, end));
+                        chunk.commands.push_back(command);
+
+                        if (command.type == ObjCommand::Type::OBJECT) hasObject = true;
+                    }
+                    else if (!keywordLength)
+                        throw std::runtime_error("Invalid string");
 
-                                    if (normalIndex < 0)
-                                        normalIndex = static_cast<int32_t>(normals.size()) + normalIndex + 1;
+                    // any command before the first object creates an object named after the file
+                    if (!hasObject) chunk.leadingContent = true;
 
-                                    if (normalIndex < 1 || normalIndex > static_cast<int32_t>(normals.size()))
-                                        throw std::runtime_error("Invalid normal index");
+                    // skip the rest of the line and all unknown commands
+                    skipLine(iterator, end);
+                }
+            }
+            catch (...)
+            {
+                chunk.exception = std::current_exception();
+            }
+        }
 
-                                    std::get<2>(i) = static_cast<uint32_t>(normalIndex);
-                                }
-                            }
+        static uint32_t resolveIndex(int32_t index, uint32_t offset, uint32_t count, const char* error)
+        {
+            // negative indices are relative to the last attribute parsed before the face
+            const int64_t result = (index < 0) ?
+                static_cast<int64_t>(offset) + count + index + 1 :
+                static_cast<int64_t>(index);
+
+            if (result < 1 || result > static_cast<int64_t>(offset) + count)
+                throw std::runtime_error(error);
+
+            return static_cast<uint32_t>(result);
+        }
+
+        static void writeMesh(BakeCache::Writer& writer,
+                              const std::string& objectName,
+                              const std::string& materialName,
+                              const Box3F& boundingBox,
+                              const std::vector<uint32_t>& indices,
+                              const std::vector<graphics::Vertex>& vertices)
+        {
+            writer.writeString(objectName);
+            writer.writeString(materialName);
+
+            for (float v : boundingBox.min.v) writer.writeFloat(v);
+            for (float v : boundingBox.max.v) writer.writeFloat(v);
+
+            writer.writeUInt32(static_cast<uint32_t>(indices.size()));
+            for (uint32_t index : indices) writer.writeUInt32(index);
+
+            writer.writeUInt32(static_cast<uint32_t>(vertices.size()));
+            for (const graphics::Vertex& vertex : vertices)
+            {
+                for (float v : vertex.position.v) writer.writeFloat(v);
+                writer.writeBytes(vertex.color.v, sizeof(vertex.color.v));
+                for (const Vector2F& texCoord : vertex.texCoords)
+                    for (float v : texCoord.v) writer.writeFloat(v);
+                for (float v : vertex.normal.v) writer.writeFloat(v);
+            }
+        }
+
+        static void readMeshes(BakeCache::Reader& reader,
+                               Bundle& bundle,
+                               Cache& cache,
+                               bool mipmaps)
+        {
+            uint32_t materialLibraryCount = reader.readUInt32();
+            if (materialLibraryCount > reader.getRemaining(sizeof(uint32_t)))
+                throw std::runtime_error("Invalid baked mesh");
+
+            std::vector<std::string> materialLibraries;
+            for (uint32_t i = 0; i < materialLibraryCount; ++i)
+                materialLibraries.push_back(reader.readString());
+
+            struct Mesh final
+            {
+                std::string objectName;
+                std::string materialName;
+                Box3F boundingBox;
+                std::vector<uint32_t> indices;
+                std::vector<graphics::Vertex> vertices;
+            };
+
+            // read everything before touching the bundle, so that a corrupt file doesn't leave partial results
+            uint32_t meshCount = reader.readUInt32();
+            if (meshCount > reader.getRemaining(4 * sizeof(uint32_t)))
+                throw std::runtime_error("Invalid baked mesh");
+
+            std::vector<Mesh> meshes(meshCount);
+
+            for (Mesh& mesh : meshes)
+            {
+                mesh.objectName = reader.readString();
+                mesh.materialName = reader.readString();
+
+                for (float& v : mesh.boundingBox.min.v) v = reader.readFloat();
+                for (float& v : mesh.boundingBox.max.v) v = reader.readFloat();
+
+                uint32_t indexCount = reader.readUInt32();
+                if (indexCount > reader.getRemaining(sizeof(uint32_t)))
+                    throw std::runtime_error("Invalid baked mesh");
+
+                mesh.indices.resize(indexCount);
+                for (uint32_t& index : mesh.indices) index = reader.readUInt32();
+
+                uint32_t vertexCount = reader.readUInt32();
+                if (vertexCount > reader.getRemaining(12 * sizeof(float) + 4))
+                    throw std::runtime_error("Invalid baked mesh");
+
+                mesh.vertices.resize(vertexCount);
+                for (graphics::Vertex& vertex : mesh.vertices)
+                {
+                    for (float& v : vertex.position.v) v = reader.readFloat();
+                    reader.readBytes(vertex.color.v, sizeof(vertex.color.v));
+                    for (Vector2F& texCoord : vertex.texCoords)
+                        for (float& v : texCoord.v) v = reader.readFloat();
+                    for (float& v : vertex.normal.v) v = reader.readFloat();
+                }
+
+                for (uint32_t index : mesh.indices)
+                    if (index >= vertexCount)
+                        throw std::runtime_error("Invalid baked mesh");
+            }
+
+            for (const std::string& materialLibrary : materialLibraries)
+                bundle.loadAsset(Loader::MATERIAL, materialLibrary, materialLibrary, mipmaps);
+
+            for (const Mesh& mesh : meshes)
+            {
+                std::shared_ptr<graphics::Material> material;
+                if (!mesh.materialName.empty()) material = cache.getMaterial(mesh.materialName);
+
+                scene::StaticMeshData meshData(mesh.boundingBox, mesh.indices, mesh.vertices, material);
+                bundle.setStaticMeshData(mesh.objectName, meshData);
+            }
+        }
+
+        ObjLoader::ObjLoader(Cache& initCache):
+            Loader(initCache, TYPE)
+        {
+        }
+
+        bool ObjLoader::loadAsset(Bundle& bundle,
+                                  const std::string& name,
+                                  const std::vector<uint8_t>& data,
+                                  bool mipmaps)
+        {
+            ProfileZone zone(engine->getProfiler(), "Mesh cache miss");
+
+            BakeCache& bakeCache = cache.getBakeCache();
+            const uint64_t key = bakeCache.isEnabled() ? BakeCache::getKey(TYPE, VERSION, mipmaps ? 1 : 0, data) : 0;
+
+            std::vector<uint8_t> baked;
+
+            if (bakeCache.load(key, baked))
+            {
+                try
+                {
+                    BakeCache::Reader reader(baked);
+                    readMeshes(reader, bundle, cache, mipmaps);
+                    zone.setName("Mesh cache hit");
+                    return true;
+                }
+                catch (const std::exception& e)
+                {
+                    OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to load baked mesh " << name << ": " << e.what();
+                }
+            }
+
+            const char* dataBegin = reinterpret_cast<const char*>(data.data());
+            const char* dataEnd = dataBegin + data.size();
 
-                            uint32_t index = 0;
+            // split the file at line boundaries
+            size_t chunkCount = 1;
+#if !defined(__EMSCRIPTEN__)
+            const size_t threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+            chunkCount = std::min(std::max(data.size() / CHUNK_SIZE, static_cast<size_t>(1)), threadCount);
+#endif
 
-                            auto vertexIterator = vertexMap.find(i);
-                            if (vertexIterator == vertexMap.end())
+            std::vector<ObjChunk> chunks(chunkCount);
+            const char* chunkBegin = dataBegin;
+
+            for (size_t i = 0; i < chunkCount; ++i)
+            {
+                const char* chunkEnd = (i == chunkCount - 1) ? dataEnd :
+                    std::max(chunkBegin, dataBegin + data.size() * (i + 1) / chunkCount);
+
+                while (chunkEnd != dataEnd && *chunkEnd != '\n') ++chunkEnd;
+                if (chunkEnd != dataEnd) ++chunkEnd;
+
+                chunks[i].begin = chunkBegin;
+                chunks[i].end = chunkEnd;
+                chunkBegin = chunkEnd;
+            }
+
+#if !defined(__EMSCRIPTEN__)
+            std::vector<std::thread> threads;
+
+            for (size_t i = 1; i < chunkCount; ++i)
+            {
+                try
+                {
+                    threads.push_back(std::thread(parseChunk, std::ref(chunks[i])));
+                }
+                catch (const std::system_error&)
+                {
+                    parseChunk(chunks[i]);
+                }
+            }
+#endif
+
+            parseChunk(chunks[0]);
+
+#if !defined(__EMSCRIPTEN__)
+            for (std::thread& thread : threads)
+                thread.join();
+#endif
+
+            for (const ObjChunk& chunk : chunks)
+                if (chunk.exception)
+                    std::rethrow_exception(chunk.exception);
+
+            // concatenate the attributes of all chunks
+            std::vector<Vector3F> positions;
+            std::vector<Vector2F> texCoords;
+            std::vector<Vector3F> normals;
+
+            for (ObjChunk& chunk : chunks)
+            {
+                positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+                texCoords.insert(texCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+                normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+            }
+
+            std::vector<std::string> materialLibraries;
+            std::string materialName;
+            BakeCache::Writer meshWriter;
+            uint32_t meshCount = 0;
+
+            std::string objectName = name;
+            std::shared_ptr<graphics::Material> material;
+            std::vector<graphics::Vertex> vertices;
+            std::unordered_map<ObjVertexKey, uint32_t, ObjVertexKeyHash> vertexMap;
+            std::vector<uint32_t> indices;
+            std::vector<uint32_t> vertexIndices;
+            Box3F boundingBox;
+
+            uint32_t objectCount = 0;
+            uint32_t positionOffset = 0;
+            uint32_t texCoordOffset = 0;
+            uint32_t normalOffset = 0;
+
+            for (ObjChunk& chunk : chunks)
+            {
+                // if we got at least one attribute, we have an object
+                if (chunk.leadingContent && !objectCount) ++objectCount;
+
+                for (const ObjCommand& command : chunk.commands)
+                {
+                    switch (command.type)
+                    {
+                        case ObjCommand::Type::MATERIAL_LIBRARY:
+                        {
+                            const std::string& value = chunk.strings[command.value];
+
+                            // TODO don't load material lib every time
+                            bundle.loadAsset(Loader::MATERIAL, value, value, mipmaps);
+                            materialLibraries.push_back(value);
+                            break;
+                        }
+                        case ObjCommand::Type::MATERIAL:
+                        {
+                            materialName = chunk.strings[command.value];
+                            material = cache.getMaterial(materialName);
+                            break;
+                        }
+                        case ObjCommand::Type::OBJECT:
+                        {
+                            if (objectCount)
                             {
-                                index = static_cast<uint32_t>(vertices.size());
-                                vertexMap[i] = index;
-
-                                graphics::Vertex vertex;
-                                if (std::get<0>(i) >= 1) vertex.position = positions[std::get<0>(i) - 1];
-                                if (std::get<1>(i) >= 1) vertex.texCoords[0] = texCoords[std::get<1>(i) - 1];
-                                vertex.color = Color::WHITE;
-                                if (std::get<2>(i) >= 1) vertex.normal = normals[std::get<2>(i) - 1];
-                                vertices.push_back(vertex);
-                                boundingBox.insertPoint(vertex.position);
+                                scene::StaticMeshData meshData(boundingBox, indices, vertices, material);
+                                bundle.setStaticMeshData(objectName, meshData);
+                                writeMesh(meshWriter, objectName, materialName, boundingBox, indices, vertices);
+                                ++meshCount;
                             }
-                            else
-                                index = vertexIterator->second;
 
-                            vertexIndices.push_back(index);
-                        }
+                            objectName = chunk.strings[command.value];
 
-                        if (vertexIndices.size() < 3)
-                            throw std::runtime_error("Invalid face count");
-                        else if (vertexIndices.size() == 3)
-                        {
-                            for (uint32_t vertexIndex : vertexIndices)
-                                indices.push_back(vertexIndex);
+                            material.reset();
+                            materialName.clear();
+                            vertices.clear();
+                            indices.clear();
+                            vertexMap.clear();
+                            boundingBox.reset();
+                            ++objectCount;
+                            break;
                         }
-                        else
+                        case ObjCommand::Type::FACE:
                         {
+                            vertexIndices.clear();
+
+                            for (uint32_t i = 0; i < command.count; ++i)
+                            {
+                                const int32_t* faceIndex = &chunk.faceIndices[command.value + i * 3];
+
+                                ObjVertexKey key;
+                                key.position = resolveIndex(faceIndex[0], positionOffset, command.positionCount,
+                                                            "Invalid position index");
+                                key.texCoord = faceIndex[1] ? resolveIndex(faceIndex[1], texCoordOffset, command.texCoordCount,
+                                                                           "Invalid texture coordinate index") : 0;
+                                key.normal = faceIndex[2] ? resolveIndex(faceIndex[2], normalOffset, command.normalCount,
+                                                                         "Invalid normal index") : 0;
+
+                                auto result = vertexMap.insert(std::make_pair(key, static_cast<uint32_t>(vertices.size())));
+
+                                if (result.second)
+                                {
+                                    graphics::Vertex vertex;
+                                    vertex.position = positions[key.position - 1];
+                                    if (key.texCoord) vertex.texCoords[0] = texCoords[key.texCoord - 1];
+                                    vertex.color = Color::WHITE;
+                                    if (key.normal) vertex.normal = normals[key.normal - 1];
+                                    vertices.push_back(vertex);
+                                    boundingBox.insertPoint(vertex.position);
+                                }
+
+                                vertexIndices.push_back(result.first->second);
+                            }
+
+                            // triangulate the polygon as a fan
                             for (uint32_t index = 0; index < vertexIndices.size() - 2; ++index)
                             {
                                 indices.push_back(vertexIndices[0]);
                                 indices.push_back(vertexIndices[index + 1]);
                                 indices.push_back(vertexIndices[index + 2]);
                             }
+                            break;
                         }
                     }
-                    else
-                    {
-                        // skip all unknown commands
-                        skipLine(data, iterator);
-                    }
-
-                    if (!objectCount) ++objectCount; // if we got at least one attribute, we have an object
                 }
+
+                positionOffset += static_cast<uint32_t>(chunk.positions.size());
+                texCoordOffset += static_cast<uint32_t>(chunk.texCoords.size());
+                normalOffset += static_cast<uint32_t>(chunk.normals.size());
             }
 
             if (objectCount)
             {
                 scene::StaticMeshData meshData(boundingBox, indices, vertices, material);
                 bundle.setStaticMeshData(objectName, meshData);
+                writeMesh(meshWriter, objectName, materialName, boundingBox, indices, vertices);
+                ++meshCount;
+            }
+
+            if (bakeCache.isEnabled())
+            {
+                BakeCache::Writer writer;
+                writer.writeUInt32(static_cast<uint32_t>(materialLibraries.size()));
+                for (const std::string& materialLibrary : materialLibraries)
+                    writer.writeString(materialLibrary);
+                writer.writeUInt32(meshCount);
+                writer.writeBytes(meshWriter.getData().data(), meshWriter.getData().size());
+                bakeCache.save(key, writer.getData());
             }
 
             return true;
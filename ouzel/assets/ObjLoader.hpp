@@ -13,6 +13,7 @@ namespace ouzel
         {
         public:
             static constexpr uint32_t TYPE = Loader::STATIC_MESH;
+            static constexpr uint32_t VERSION = 2; // must be increased when the baked output changes
 
             explicit ObjLoader(Cache& initCache);
             bool loadAsset(Bundle& bundle,
@@ -4,7 +4,7 @@
 #include "Bundle.hpp"
 #include "Cache.hpp"
 #include "scene/ParticleSystem.hpp"
-#include "utils/Json.hpp"
+#include "utils/JsonParser.hpp"
 
 namespace ouzel
 {
@@ -22,7 +22,7 @@ namespace ouzel
         {
             scene::ParticleSystemData particleSystemData;
 
-            json::Data d(data);
+            json::Document d(data);
 
             if (!d.hasMember("textureFileName") ||
                 !d.hasMember("configName"))
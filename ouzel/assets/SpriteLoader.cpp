@@ -5,7 +5,7 @@
 #include "Bundle.hpp"
 #include "Cache.hpp"
 #include "scene/Sprite.hpp"
-#include "utils/Json.hpp"
+#include "utils/JsonParser.hpp"
 
 namespace ouzel
 {
@@ -23,13 +23,13 @@ namespace ouzel
         {
             scene::SpriteData spriteData;
 
-            json::Data d(data);
+            json::Document d(data);
 
             if (!d.hasMember("meta") ||
                 !d.hasMember("frames"))
                 return false;
 
-            const json::Value& metaObject = d["meta"];
+            const json::Node metaObject = d["meta"];
 
             std::string imageFilename = metaObject["image"].as<std::string>();
             spriteData.texture = cache.getTexture(imageFilename);
@@ -45,34 +45,34 @@ namespace ouzel
             const Size2F textureSize(static_cast<float>(spriteData.texture->getSize().v[0]),
                                            static_cast<float>(spriteData.texture->getSize().v[1]));
 
-            const json::Value& framesArray = d["frames"];
+            const json::Node framesArray = d["frames"];
 
             scene::SpriteData::Animation animation;
 
             animation.frames.reserve(framesArray.getSize());
 
-            for (const json::Value& frameObject : framesArray.as<json::Value::Array>())
+            for (const json::Node frameObject : framesArray)
             {
                 std::string filename = frameObject["filename"].as<std::string>();
 
-                const json::Value& frameRectangleObject = frameObject["frame"];
+                const json::Node frameRectangleObject = frameObject["frame"];
 
                 RectF frameRectangle(static_cast<float>(frameRectangleObject["x"].as<int32_t>()),
                                            static_cast<float>(frameRectangleObject["y"].as<int32_t>()),
                                            static_cast<float>(frameRectangleObject["w"].as<int32_t>()),
                                            static_cast<float>(frameRectangleObject["h"].as<int32_t>()));
 
-                const json::Value& sourceSizeObject = frameObject["sourceSize"];
+                const json::Node sourceSizeObject = frameObject["sourceSize"];
 
                 Size2F sourceSize(static_cast<float>(sourceSizeObject["w"].as<int32_t>()),
                                         static_cast<float>(sourceSizeObject["h"].as<int32_t>()));
 
-                const json::Value& spriteSourceSizeObject = frameObject["spriteSourceSize"];
+                const json::Node spriteSourceSizeObject = frameObject["spriteSourceSize"];
 
                 Vector2F sourceOffset(static_cast<float>(spriteSourceSizeObject["x"].as<int32_t>()),
                                             static_cast<float>(spriteSourceSizeObject["y"].as<int32_t>()));
 
-                const json::Value& pivotObject = frameObject["pivot"];
+                const json::Node pivotObject = frameObject["pivot"];
 
                 Vector2F pivot(pivotObject["x"].as<float>(),
                                      pivotObject["y"].as<float>());
@@ -83,11 +83,11 @@ namespace ouzel
                 {
                     std::vector<uint16_t> indices;
 
-                    const json::Value& trianglesObject = frameObject["triangles"];
+                    const json::Node trianglesObject = frameObject["triangles"];
 
-                    for (const json::Value& triangleObject : trianglesObject.as<json::Value::Array>())
+                    for (const json::Node triangleObject : trianglesObject)
                     {
-                        for (const json::Value& indexObject : triangleObject.as<json::Value::Array>())
+                        for (const json::Node indexObject : triangleObject)
                             indices.push_back(static_cast<uint16_t>(indexObject.as<uint32_t>()));
                     }
 
@@ -96,16 +96,16 @@ namespace ouzel
 
                     std::vector<graphics::Vertex> vertices;
 
-                    const json::Value& verticesObject = frameObject["vertices"];
-                    const json::Value& verticesUVObject = frameObject["verticesUV"];
+                    const json::Node verticesObject = frameObject["vertices"];
+                    const json::Node verticesUVObject = frameObject["verticesUV"];
 
                     Vector2F finalOffset(-sourceSize.v[0] * pivot.v[0] + sourceOffset.v[0],
                                                -sourceSize.v[1] * pivot.v[1] + (sourceSize.v[1] - frameRectangle.size.v[1] - sourceOffset.v[1]));
 
                     for (size_t vertexIndex = 0; vertexIndex < verticesObject.getSize(); ++vertexIndex)
                     {
-                        const json::Value& vertexObject = verticesObject[vertexIndex];
-                        const json::Value& vertexUVObject = verticesUVObject[vertexIndex];
+                        const json::Node vertexObject = verticesObject[vertexIndex];
+                        const json::Node vertexUVObject = verticesUVObject[vertexIndex];
 
                         vertices.push_back(graphics::Vertex(Vector3F(static_cast<float>(vertexObject[0].as<int32_t>()) + finalOffset.v[0],
                                                                            -static_cast<float>(vertexObject[1].as<int32_t>()) - finalOffset.v[1],
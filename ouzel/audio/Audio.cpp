@@ -105,41 +105,41 @@ namespace ouzel
             {
 #if OUZEL_COMPILE_OPENAL
                 case Driver::OPENAL:
-                    engine->log(Log::Level::INFO) << "Using OpenAL audio driver";
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "Using OpenAL audio driver";
                     return std::unique_ptr<AudioDevice>(new OALAudioDevice(512, 44100, 0, dataGetter));
 #endif
 #if OUZEL_COMPILE_DIRECTSOUND
                 case Driver::DIRECTSOUND:
-                    engine->log(Log::Level::INFO) << "Using DirectSound audio driver";
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "Using DirectSound audio driver";
                     return std::unique_ptr<AudioDevice>(new DSAudioDevice(512, 44100, 0, dataGetter, window));
 #endif
 #if OUZEL_COMPILE_XAUDIO2
                 case Driver::XAUDIO2:
-                    engine->log(Log::Level::INFO) << "Using XAudio 2 audio driver";
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "Using XAudio 2 audio driver";
                     return std::unique_ptr<AudioDevice>(new XA2AudioDevice(512, 44100, 0, dataGetter, debugAudio));
 #endif
 #if OUZEL_COMPILE_OPENSL
                 case Driver::OPENSL:
-                    engine->log(Log::Level::INFO) << "Using OpenSL ES audio driver";
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "Using OpenSL ES audio driver";
                     return std::unique_ptr<AudioDevice>(new OSLAudioDevice(512, 44100, 0, dataGetter));
 #endif
 #if OUZEL_COMPILE_COREAUDIO
                 case Driver::COREAUDIO:
-                    engine->log(Log::Level::INFO) << "Using CoreAudio audio driver";
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "Using CoreAudio audio driver";
                     return std::unique_ptr<AudioDevice>(new CAAudioDevice(512, 44100, 0, dataGetter));
 #endif
 #if OUZEL_COMPILE_ALSA
                 case Driver::ALSA:
-                    engine->log(Log::Level::INFO) << "Using ALSA audio driver";
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "Using ALSA audio driver";
                     return std::unique_ptr<AudioDevice>(new ALSAAudioDevice(512, 44100, 0, dataGetter));
 #endif
 #if OUZEL_COMPILE_WASAPI
                 case Driver::WASAPI:
-                    engine->log(Log::Level::INFO) << "Using WASAPI audio driver";
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "Using WASAPI audio driver";
                     return std::unique_ptr<AudioDevice>(new WASAPIAudioDevice(512, 44100, 0, dataGetter));
 #endif
                 default:
-                    engine->log(Log::Level::INFO) << "Not using audio driver";
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "Not using audio driver";
                     (void)debugAudio;
                     (void)window;
                     return std::unique_ptr<AudioDevice>(new EmptyAudioDevice(512, 44100, 0, dataGetter));
@@ -154,6 +154,9 @@ namespace ouzel
                   std::bind(&Audio::eventCallback, this, std::placeholders::_1)),
             masterMix(*this)
         {
+            starvationCounter = &engine->getMetrics().addCounter("ouzel_audio_starvations_total", "Number of times the mixer ran out of samples");
+            playingVoiceGauge = &engine->getMetrics().addGauge("ouzel_audio_voices", "Number of playing voices");
+
             addCommand(std::unique_ptr<mixer::Command>(new mixer::SetMasterBusCommand(masterMix.getBusId())));
             device->start();
         }
@@ -213,12 +216,14 @@ namespace ouzel
 
         void Audio::getData(uint32_t frames, uint16_t channels, uint32_t sampleRate, std::vector<float>& samples)
         {
+            ProfileZone mixZone(engine->getProfiler(), "Mix");
             mixer.getData(frames, channels, sampleRate, samples);
         }
 
         void Audio::eventCallback(const mixer::Mixer::Event& event)
         {
-
+            if (event.type == mixer::Mixer::Event::Type::STARVATION)
+                starvationCounter->increment();
         }
     } // namespace audio
 } // namespace ouzel
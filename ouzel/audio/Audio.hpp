@@ -15,6 +15,7 @@
 #include "audio/mixer/Mixer.hpp"
 #include "math/Quaternion.hpp"
 #include "math/Vector.hpp"
+#include "utils/Metrics.hpp"
 
 namespace ouzel
 {
@@ -57,6 +58,8 @@ namespace ouzel
             uintptr_t initProcessor(std::unique_ptr<mixer::Processor>&& processor);
             void updateProcessor(uintptr_t processorId, const std::function<void(mixer::Processor*)>& updateFunction);
 
+            inline Metrics::Gauge& getPlayingVoiceGauge() { return *playingVoiceGauge; }
+
         private:
             void getData(uint32_t frames, uint16_t channels, uint32_t sampleRate, std::vector<float>& samples);
             void eventCallback(const mixer::Mixer::Event& event);
@@ -65,6 +68,9 @@ namespace ouzel
             mixer::Mixer mixer;
             mixer::CommandBuffer commandBuffer;
             Mix masterMix;
+
+            Metrics::Counter* starvationCounter = nullptr;
+            Metrics::Gauge* playingVoiceGauge = nullptr;
         };
     } // namespace audio
 } // namespace ouzel
@@ -102,6 +102,7 @@ namespace ouzel
                 return std::unique_ptr<mixer::Source>(new PcmData(channels, sampleRate, samples));
             }))
         {
+            size = samples.size() * sizeof(float);
         }
     } // namespace audio
 } // namespace ouzel
@@ -3,6 +3,7 @@
 #ifndef OUZEL_AUDIO_SOUND_HPP
 #define OUZEL_AUDIO_SOUND_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -29,9 +30,13 @@ namespace ouzel
 
             inline uintptr_t getSourceId() const { return sourceId; }
 
+            // approximate memory used by the sound data in bytes
+            inline size_t getSize() const { return size; }
+
         protected:
             Audio& audio;
             uintptr_t sourceId = 0;
+            size_t size = 0;
         };
     } // namespace audio
 } // namespace ouzel
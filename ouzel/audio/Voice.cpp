@@ -19,6 +19,8 @@ namespace ouzel
 
         Voice::~Voice()
         {
+            if (playing) audio.getPlayingVoiceGauge().add(-1.0);
+
             if (streamId)
                 audio.deleteObject(streamId);
         }
@@ -27,6 +29,7 @@ namespace ouzel
         {
             audio.addCommand(std::unique_ptr<mixer::Command>(new mixer::PlayStreamCommand(streamId)));
 
+            if (!playing) audio.getPlayingVoiceGauge().add(1.0);
             playing = true;
 
             std::unique_ptr<SoundEvent> startEvent(new SoundEvent());
@@ -39,6 +42,7 @@ namespace ouzel
         {
             audio.addCommand(std::unique_ptr<mixer::Command>(new mixer::StopStreamCommand(streamId, false)));
 
+            if (playing) audio.getPlayingVoiceGauge().add(-1.0);
             playing = false;
         }
 
@@ -46,6 +50,7 @@ namespace ouzel
         {
             audio.addCommand(std::unique_ptr<mixer::Command>(new mixer::StopStreamCommand(streamId, true)));
 
+            if (playing) audio.getPlayingVoiceGauge().add(-1.0);
             playing = false;
         }
 
@@ -151,6 +151,7 @@ namespace ouzel
                 return std::unique_ptr<mixer::Source>(new VorbisData(initData));
             }))
         {
+            size = initData.size();
         }
     } // namespace audio
 } // namespace ouzel
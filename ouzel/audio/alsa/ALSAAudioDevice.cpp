@@ -21,13 +21,14 @@ namespace ouzel
                                                                   uint16_t channels,
                                                                   uint32_t sampleRate,
                                                                   std::vector<float>& samples)>& initDataGetter):
-            AudioDevice(Driver::ALSA, initBufferSize, initSampleRate, initChannels, initDataGetter)
+            AudioDevice(Driver::ALSA, initBufferSize, initSampleRate, initChannels, initDataGetter),
+            underrunCounter(&engine->getMetrics().addCounter("ouzel_audio_underruns_total", "Number of buffer underruns reported by ALSA"))
         {
             int result;
             if ((result = snd_pcm_open(&playbackHandle, "default", SND_PCM_STREAM_PLAYBACK, 0)) < 0)
                 throw std::system_error(result, std::system_category(), "Failed to connect to audio interface");
 
-            engine->log(Log::Level::INFO) << "Using " << snd_pcm_name(playbackHandle) << " for audio";
+            OUZEL_LOG(*engine, Log::Level::INFO) << "Using " << snd_pcm_name(playbackHandle) << " for audio";
 
             if ((result = snd_pcm_hw_params_malloc(&hwParams)) < 0)
                 throw std::system_error(result, std::system_category(), "Failed to allocate memory for hardware parameters");
@@ -137,7 +138,8 @@ namespace ouzel
                     {
                         if (frames == -EPIPE)
                         {
-                            engine->log(Log::Level::WARN) << "Buffer underrun occurred";
+                            OUZEL_LOG(*engine, Log::Level::WARN) << "Buffer underrun occurred";
+                            underrunCounter->increment();
 
                             if ((result = snd_pcm_prepare(playbackHandle)) < 0)
                                 throw std::system_error(result, std::system_category(), "Failed to prepare audio interface");
@@ -150,7 +152,7 @@ namespace ouzel
 
                     if (static_cast<snd_pcm_uframes_t>(frames) > periods * periodSize)
                     {
-                        engine->log(Log::Level::WARN) << "Buffer size exceeded, error: " << frames;
+                        OUZEL_LOG(*engine, Log::Level::WARN) << "Buffer size exceeded, error: " << frames;
                         snd_pcm_reset(playbackHandle);
                         continue;
                     }
@@ -164,7 +166,8 @@ namespace ouzel
                     {
                         if (result == -EPIPE)
                         {
-                            engine->log(Log::Level::WARN) << "Buffer underrun occurred";
+                            OUZEL_LOG(*engine, Log::Level::WARN) << "Buffer underrun occurred";
+                            underrunCounter->increment();
 
                             if ((result = snd_pcm_prepare(playbackHandle)) < 0)
                                 throw std::system_error(result, std::system_category(), "Failed to prepare audio interface");
@@ -175,7 +178,7 @@ namespace ouzel
                 }
                 catch (const std::exception& e)
                 {
-                    engine->log(Log::Level::ERR) << e.what();
+                    OUZEL_LOG(*engine, Log::Level::ERR) << e.what();
                 }
             }
         }
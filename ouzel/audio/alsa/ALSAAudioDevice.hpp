@@ -12,6 +12,7 @@
 #include <alsa/asoundlib.h>
 
 #include "audio/AudioDevice.hpp"
+#include "utils/Metrics.hpp"
 
 namespace ouzel
 {
@@ -43,6 +44,9 @@ namespace ouzel
 
             std::vector<uint8_t> data;
 
+            // registered up front, so that the audio thread doesn't look it up by name
+            Metrics::Counter* underrunCounter = nullptr;
+
             std::atomic_bool running{false};
             std::thread audioThread;
         };
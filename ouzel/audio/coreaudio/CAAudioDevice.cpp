@@ -168,7 +168,7 @@ namespace ouzel
                 }
                 CFRelease(tempStringRef);
 
-                engine->log(Log::Level::INFO) << "Using " << name << " for audio";
+                OUZEL_LOG(*engine, Log::Level::INFO) << "Using " << name << " for audio";
             }
 #endif
 
@@ -227,7 +227,7 @@ namespace ouzel
                                                kAudioUnitProperty_StreamFormat,
                                                kAudioUnitScope_Input, bus, &streamDescription, sizeof(streamDescription))) != noErr)
             {
-                engine->log(Log::Level::WARN) << "Failed to set CoreAudio unit stream format to float, error: " << result;
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to set CoreAudio unit stream format to float, error: " << result;
 
                 streamDescription.mFormatFlags = kLinearPCMFormatFlagIsPacked | kAudioFormatFlagIsSignedInteger;
                 streamDescription.mBitsPerChannel = sizeof(int16_t) * 8;
@@ -252,7 +252,7 @@ namespace ouzel
                 }
                 catch (const std::exception& e)
                 {
-                    engine->log(Log::Level::ERR) << e.what();
+                    OUZEL_LOG(*engine, Log::Level::ERR) << e.what();
                 }
             }
         }
@@ -93,7 +93,7 @@ namespace ouzel
 
             const ALCchar* deviceName = alcGetString(nullptr, ALC_DEFAULT_DEVICE_SPECIFIER);
 
-            engine->log(Log::Level::INFO) << "Using " << reinterpret_cast<const char*>(deviceName) << " for audio";
+            OUZEL_LOG(*engine, Log::Level::INFO) << "Using " << reinterpret_cast<const char*>(deviceName) << " for audio";
 
             device = alcOpenDevice(deviceName);
 
@@ -124,19 +124,19 @@ namespace ouzel
             ALenum error;
 
             if ((error = alGetError()) != AL_NO_ERROR || !audioRenderer)
-                engine->log(Log::Level::WARN) << "Failed to get OpenAL renderer, error: " + std::to_string(error);
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to get OpenAL renderer, error: " + std::to_string(error);
             else
-                engine->log(Log::Level::INFO) << "Using " << reinterpret_cast<const char*>(audioRenderer) << " audio renderer";
+                OUZEL_LOG(*engine, Log::Level::INFO) << "Using " << reinterpret_cast<const char*>(audioRenderer) << " audio renderer";
 
             std::vector<std::string> extensions;
             const ALchar* extensionsPtr = alGetString(AL_EXTENSIONS);
 
             if ((error = alGetError()) != AL_NO_ERROR || !extensionsPtr)
-                engine->log(Log::Level::WARN) << "Failed to get OpenGL extensions";
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to get OpenGL extensions";
             else
                 extensions = explodeString(reinterpret_cast<const char*>(extensionsPtr), ' ');
 
-            engine->log(Log::Level::ALL) << "Supported OpenAL extensions: " << extensions;
+            OUZEL_LOG(*engine, Log::Level::ALL) << "Supported OpenAL extensions: " << extensions;
 
             bool float32Supported = false;
             for (const std::string& extension : extensions)
@@ -152,7 +152,7 @@ namespace ouzel
             format71 = alGetEnumValue("AL_FORMAT_71CHN16");
 
             if ((error = alGetError()) != AL_NO_ERROR)
-                engine->log(Log::Level::WARN) << "Failed to get OpenAL enum values";
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to get OpenAL enum values";
 #endif
 
             alGenSources(1, &sourceId);
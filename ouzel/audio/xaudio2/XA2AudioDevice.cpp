@@ -88,7 +88,7 @@ namespace ouzel
             }
             else
             {
-                engine->log(Log::Level::INFO) << "Failed to load " << XAUDIO2_DLL_28;
+                OUZEL_LOG(*engine, Log::Level::INFO) << "Failed to load " << XAUDIO2_DLL_28;
 
                 xAudio2Library = LoadLibraryA(XAUDIO2_DLL_27);
 
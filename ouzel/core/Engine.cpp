@@ -82,9 +82,33 @@ namespace ouzel
     Engine* engine = nullptr;
 
     Engine::Engine():
-        fileSystem(*this), assetBundle(cache, fileSystem)
+        fileSystem(*this), metrics(fileSystem), assetBundle(cache, fileSystem)
     {
         engine = this;
+
+        updateTimeHistogram = &metrics.addHistogram("ouzel_update_time_seconds", "Time spent in an update (without waiting for the next frame)",
+                                                    {0.001, 0.002, 0.004, 0.008, 0.016, 0.033, 0.05, 0.1, 0.25});
+
+        // sampled when the metrics are exported on the update thread
+        metrics.addGauge("ouzel_events_dispatched", "Number of queued events dispatched in the last update", [this]() {
+            return static_cast<double>(eventDispatcher.getDispatchedEventCount());
+        });
+        metrics.addGauge("ouzel_asset_cache_bytes", "Bytes held by the resident assets", [this]() {
+            size_t size = 0;
+            for (assets::MemoryCategory category : {assets::MemoryCategory::TEXTURE,
+                assets::MemoryCategory::SOUND,
+                assets::MemoryCategory::MESH,
+                assets::MemoryCategory::FONT})
+                size += cache.getResidentSize(category);
+            return static_cast<double>(size);
+        });
+
+        // release the assets that are not in use, they get reloaded when requested again
+        lowMemoryHandler.systemHandler = [this](const SystemEvent& event) {
+            if (event.type == Event::Type::LOW_MEMORY) cache.trim();
+            return false;
+        };
+        eventDispatcher.addEventHandler(&lowMemoryHandler);
     }
 
     Engine::~Engine()
@@ -108,6 +132,28 @@ namespace ouzel
             updateThread.join();
         }
 #endif
+
+        if (inputManager && inputManager->isRecording())
+        {
+            try
+            {
+                fileSystem.writeFile(inputRecordFilename, inputManager->stopRecording());
+            }
+            catch (const std::exception& e)
+            {
+                OUZEL_LOG(*this, Log::Level::ERR) << "Failed to write input log: " << e.what();
+            }
+        }
+
+        // the sampled gauges read the subsystems, so the final export is written before they are destroyed
+        try
+        {
+            metrics.stopExport();
+        }
+        catch (const std::exception& e)
+        {
+            OUZEL_LOG(*this, Log::Level::ERR) << "Failed to export metrics: " << e.what();
+        }
     }
 
     void Engine::init()
@@ -136,7 +182,7 @@ namespace ouzel
         }
         catch (const std::exception&)
         {
-            log(Log::Level::INFO) << "User settings not provided";
+            OUZEL_LOG(*this, Log::Level::INFO) << "User settings not provided";
         }
 
         const ini::Section& userEngineSection = userSettings.getSection("engine");
@@ -200,6 +246,53 @@ namespace ouzel
         std::string debugAudioValue = userEngineSection.getValue("debugAudio", defaultEngineSection.getValue("debugAudio"));
         if (!debugAudioValue.empty()) debugAudio = (debugAudioValue == "true" || debugAudioValue == "1" || debugAudioValue == "yes");
 
+        std::string profilerValue = userEngineSection.getValue("profiler", defaultEngineSection.getValue("profiler"));
+        if (!profilerValue.empty()) profiler.setEnabled(profilerValue == "true" || profilerValue == "1" || profilerValue == "yes");
+
+        std::string assetCacheValue = userEngineSection.getValue("assetCache", defaultEngineSection.getValue("assetCache"));
+        if (!assetCacheValue.empty()) cache.getBakeCache().setEnabled(assetCacheValue == "true" || assetCacheValue == "1" || assetCacheValue == "yes");
+
+        std::string assetCacheSizeValue = userEngineSection.getValue("assetCacheSize", defaultEngineSection.getValue("assetCacheSize"));
+        if (!assetCacheSizeValue.empty()) cache.getBakeCache().setMaxSize(static_cast<uint64_t>(std::stoull(assetCacheSizeValue)));
+
+        std::string hotReloadValue = userEngineSection.getValue("hotReload", defaultEngineSection.getValue("hotReload"));
+        if (!hotReloadValue.empty()) cache.setHotReloadEnabled(hotReloadValue == "true" || hotReloadValue == "1" || hotReloadValue == "yes");
+
+        std::string updateRateValue = userEngineSection.getValue("updateRate", defaultEngineSection.getValue("updateRate"));
+        if (!updateRateValue.empty()) updateRate = static_cast<uint32_t>(std::stoul(updateRateValue));
+
+        std::string metricsFileValue = userEngineSection.getValue("metricsFile", defaultEngineSection.getValue("metricsFile"));
+        if (!metricsFileValue.empty())
+        {
+            std::string metricsFormatValue = userEngineSection.getValue("metricsFormat", defaultEngineSection.getValue("metricsFormat"));
+            std::string metricsIntervalValue = userEngineSection.getValue("metricsInterval", defaultEngineSection.getValue("metricsInterval"));
+
+            Metrics::Format metricsFormat;
+            if (metricsFormatValue.empty() || metricsFormatValue == "json")
+                metricsFormat = Metrics::Format::JSON;
+            else if (metricsFormatValue == "prometheus")
+                metricsFormat = Metrics::Format::PROMETHEUS;
+            else
+                throw std::runtime_error("Invalid metrics format specified");
+
+            // in seconds
+            std::chrono::milliseconds metricsInterval(10000);
+            if (!metricsIntervalValue.empty())
+                metricsInterval = std::chrono::milliseconds(static_cast<int64_t>(std::stod(metricsIntervalValue) * 1000.0));
+
+            metrics.startExport(metricsFileValue, metricsFormat, metricsInterval);
+        }
+
+        if (std::find(args.begin(), args.end(), "--headless") != args.end())
+            headless = true;
+
+        if (headless)
+        {
+            OUZEL_LOG(*this, Log::Level::INFO) << "Running headless";
+            graphicsDriverValue = "empty";
+            audioDriverValue = "empty";
+        }
+
         graphics::Driver graphicsDriver = graphics::Renderer::getDriver(graphicsDriverValue);
 
         window.reset(new Window(*this,
@@ -228,6 +321,24 @@ namespace ouzel
 
         inputManager.reset(new input::InputManager());
 
+        // --record <file> records the input until the engine stops, --replay <file> replays a recorded log
+        for (size_t i = 1; i < args.size(); ++i)
+        {
+            if (args[i] == "--record" || args[i] == "--replay")
+            {
+                if (i + 1 >= args.size())
+                    throw std::runtime_error("No input log specified for " + args[i]);
+
+                if (args[i] == "--record")
+                {
+                    inputRecordFilename = args[++i];
+                    inputManager->startRecording();
+                }
+                else
+                    inputManager->startReplay(fileSystem.readFile(args[++i], false));
+            }
+        }
+
         // default assets
         switch (graphicsDriver)
         {
@@ -703,18 +814,68 @@ namespace ouzel
 
     void Engine::update()
     {
+        ProfileZone updateZone(profiler, "Update");
+        const std::chrono::steady_clock::time_point updateStartTime = std::chrono::steady_clock::now();
+
         eventDispatcher.dispatchEvents();
 
-        std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
-        auto diff = currentTime - previousUpdateTime;
+        // assets are reloaded between frames, so that the scene never sees a partially reloaded asset
+        cache.update();
 
-        if (diff > std::chrono::milliseconds(1)) // at least one millisecond has passed
+        float delta = 0.0F;
+
+        if (inputManager->isReplaying())
+        {
+            // the recorded time steps are used instead of the clock, so that the replay is deterministic
+            if (!inputManager->replayFrame(delta)) delta = 0.0F;
+            previousUpdateTime = std::chrono::steady_clock::now();
+        }
+        else
         {
-            if (diff > std::chrono::seconds(1000 / 20)) diff = std::chrono::milliseconds(1000 / 20); // limit the update rate to a minimum 20 FPS
+            std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+            auto diff = currentTime - previousUpdateTime;
+
+            if (diff > std::chrono::milliseconds(1)) // at least one millisecond has passed
+            {
+                if (diff > std::chrono::milliseconds(1000 / 20)) diff = std::chrono::milliseconds(1000 / 20); // limit the update rate to a minimum 20 FPS
+
+                previousUpdateTime = currentTime;
+                delta = std::chrono::duration_cast<std::chrono::microseconds>(diff).count() / 1000000.0F;
+            }
+
+            if (inputManager->isRecording()) inputManager->recordFrame(delta);
+        }
 
-            previousUpdateTime = currentTime;
-            float delta = std::chrono::duration_cast<std::chrono::microseconds>(diff).count() / 1000000.0F;
+        frameFixedUpdateCount = 0;
 
+        if (fixedUpdateStep > 0.0F)
+        {
+            fixedUpdateTime += delta;
+
+            while (fixedUpdateTime >= fixedUpdateStep)
+            {
+                if (frameFixedUpdateCount >= maxFixedUpdates)
+                {
+                    // the simulation is slower than real time, skip the steps that it can't catch up with
+                    uint64_t droppedCount = static_cast<uint64_t>(fixedUpdateTime / fixedUpdateStep);
+                    droppedFixedUpdateCount += droppedCount;
+                    fixedUpdateTime -= droppedCount * fixedUpdateStep;
+                    break;
+                }
+
+                fixedUpdateTime -= fixedUpdateStep;
+                ++fixedUpdateCount;
+                ++frameFixedUpdateCount;
+
+                std::unique_ptr<UpdateEvent> fixedUpdateEvent(new UpdateEvent());
+                fixedUpdateEvent->type = Event::Type::FIXED_UPDATE;
+                fixedUpdateEvent->delta = fixedUpdateStep;
+                eventDispatcher.dispatchEvent(std::move(fixedUpdateEvent));
+            }
+        }
+
+        if (delta > 0.0F)
+        {
             std::unique_ptr<UpdateEvent> updateEvent(new UpdateEvent());
             updateEvent->type = Event::Type::UPDATE;
             updateEvent->delta = delta;
@@ -725,10 +886,25 @@ namespace ouzel
         window->update();
         audio->update();
 
-        if (renderer->getRefillQueue())
+        // nothing consumes the draw commands without a display, but the world transforms are still pushed down to the children
+        if (headless)
+            sceneManager.updateWorld();
+        else if (renderer->getRefillQueue())
+        {
+            ProfileZone drawZone(profiler, "Draw");
+
+            if (fixedUpdateStep > 0.0F) interpolationAlpha = std::min(fixedUpdateTime / fixedUpdateStep, 1.0F);
             sceneManager.draw();
+            interpolationAlpha = 1.0F;
 
-        if (oneUpdatePerFrame) renderer->waitForNextFrame();
+            // the gameplay code must not see the interpolated transforms that were drawn
+            if (fixedUpdateStep > 0.0F) sceneManager.updateWorld();
+        }
+
+        updateTimeHistogram->observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - updateStartTime).count());
+        metrics.update();
+
+        if (oneUpdatePerFrame && !headless) renderer->waitForNextFrame();
     }
 
     void Engine::executeOnMainThread(const std::function<void()>& func)
@@ -745,10 +921,25 @@ namespace ouzel
             std::unique_ptr<Application> application = ouzel::main(args);
 
 #if !defined(__EMSCRIPTEN__)
+            std::chrono::steady_clock::time_point nextUpdateTime = std::chrono::steady_clock::now();
+
             while (active)
             {
                 if (!paused)
+                {
                     update();
+
+                    if (updateRate)
+                    {
+                        nextUpdateTime += std::chrono::microseconds(1000000 / updateRate);
+
+                        std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+                        if (nextUpdateTime > currentTime)
+                            std::this_thread::sleep_until(nextUpdateTime);
+                        else
+                            nextUpdateTime = currentTime; // don't try to catch up after a slow update
+                    }
+                }
                 else
                 {
                     std::unique_lock<std::mutex> lock(updateMutex);
@@ -762,7 +953,7 @@ namespace ouzel
         }
         catch (const std::exception& e)
         {
-            log(Log::Level::ERR) << e.what();
+            OUZEL_LOG(*this, Log::Level::ERR) << e.what();
             exit();
         }
     }
@@ -25,6 +25,8 @@
 #include "network/Network.hpp"
 #include "utils/Ini.hpp"
 #include "utils/Log.hpp"
+#include "utils/Metrics.hpp"
+#include "utils/Profiler.hpp"
 
 namespace ouzel
 {
@@ -59,6 +61,8 @@ namespace ouzel
 
         inline Log log(Log::Level level = Log::Level::INFO) const { return logger.log(level); }
         inline Logger& getLogger() { return logger; }
+        inline Profiler& getProfiler() { return profiler; }
+        inline Metrics& getMetrics() { return metrics; }
 
         inline storage::FileSystem& getFileSystem() { return fileSystem; }
         inline EventDispatcher& getEventDispatcher() { return eventDispatcher; }
@@ -91,9 +95,31 @@ namespace ouzel
         virtual void setScreenSaverEnabled(bool newScreenSaverEnabled);
         inline bool isScreenSaverEnabled() const { return screenSaverEnabled; }
 
+        // started with --headless, runs without a display, audio output and input devices
+        inline bool isHeadless() const { return headless; }
+
+        // updates per second, zero runs the updates as fast as possible
+        inline uint32_t getUpdateRate() const { return updateRate; }
+        inline void setUpdateRate(uint32_t rate) { updateRate = rate; }
+
         inline bool isOneUpdatePerFrame() const { return oneUpdatePerFrame; }
         inline void setOneUpdatePerFrame(bool value) { oneUpdatePerFrame = value; }
 
+        // FIXED_UPDATE events are sent every step (zero disables them) before the UPDATE event of the frame
+        inline float getFixedUpdateStep() const { return fixedUpdateStep; }
+        inline void setFixedUpdateStep(float step) { fixedUpdateStep = step; fixedUpdateTime = 0.0F; }
+
+        // the frame time that needs more fixed updates than this is dropped, so that a slow simulation can't fall behind forever
+        inline uint32_t getMaxFixedUpdates() const { return maxFixedUpdates; }
+        inline void setMaxFixedUpdates(uint32_t count) { maxFixedUpdates = count; }
+
+        inline uint64_t getFixedUpdateCount() const { return fixedUpdateCount; }
+        inline uint64_t getDroppedFixedUpdateCount() const { return droppedFixedUpdateCount; }
+        inline uint32_t getFrameFixedUpdateCount() const { return frameFixedUpdateCount; }
+
+        // part of the fixed step passed since the last fixed update while the scenes are drawn, one otherwise
+        inline float getInterpolationAlpha() const { return interpolationAlpha; }
+
     protected:
         class Command final
         {
@@ -114,7 +140,9 @@ namespace ouzel
         virtual void runOnMainThread(const std::function<void()>& func) = 0;
 
         Logger logger;
+        Profiler profiler;
         storage::FileSystem fileSystem;
+        Metrics metrics;
         EventDispatcher eventDispatcher;
         std::unique_ptr<Window> window;
         std::unique_ptr<graphics::Renderer> renderer;
@@ -123,6 +151,7 @@ namespace ouzel
         Localization localization;
         assets::Cache cache;
         assets::Bundle assetBundle;
+        EventHandler lowMemoryHandler;
         scene::SceneManager sceneManager;
         network::Network network;
 
@@ -136,6 +165,20 @@ namespace ouzel
 #endif
         std::chrono::steady_clock::time_point previousUpdateTime;
 
+        bool headless = false;
+        uint32_t updateRate = 0;
+        std::string inputRecordFilename; // the input log is written here when the engine stops, set with --record
+
+        float fixedUpdateStep = 0.0F;
+        float fixedUpdateTime = 0.0F;
+        uint32_t maxFixedUpdates = 5;
+        uint64_t fixedUpdateCount = 0;
+        uint64_t droppedFixedUpdateCount = 0;
+        uint32_t frameFixedUpdateCount = 0;
+        float interpolationAlpha = 1.0F;
+
+        Metrics::Histogram* updateTimeHistogram = nullptr;
+
         std::atomic_bool active{false};
         std::atomic_bool paused{false};
         std::atomic_bool oneUpdatePerFrame{false};
@@ -59,7 +59,15 @@ namespace ouzel
 #elif defined(__ANDROID__)
         nativeWindow(new NativeWindowAndroid(std::bind(&Window::eventCallback, this, std::placeholders::_1), newTitle)),
 #elif defined(__linux__)
-        nativeWindow(new NativeWindowLinux(std::bind(&Window::eventCallback, this, std::placeholders::_1),
+        nativeWindow(initEngine.isHeadless() ?
+                     new NativeWindow(std::bind(&Window::eventCallback, this, std::placeholders::_1),
+                                      newSize,
+                                      newResizable,
+                                      newFullscreen,
+                                      newExclusiveFullscreen,
+                                      newTitle,
+                                      newHighDpi) :
+                     new NativeWindowLinux(std::bind(&Window::eventCallback, this, std::placeholders::_1),
                                            newSize,
                                            newResizable,
                                            newFullscreen,
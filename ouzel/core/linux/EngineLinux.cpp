@@ -1,5 +1,6 @@
 // Copyright 2015-2019 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include <stdexcept>
 #include <cstdlib>
 #include <unistd.h>
@@ -249,6 +250,13 @@ namespace ouzel
         for (int i = 0; i < initArgc; ++i)
             args.push_back(initArgv[i]);
 
+        // the display is not needed in the headless mode, so it is not opened
+        if (std::find(args.begin(), args.end(), "--headless") != args.end())
+        {
+            headless = true;
+            return;
+        }
+
 #if OUZEL_SUPPORTS_X11
         if (!XInitThreads())
             throw std::runtime_error("Failed to initialize thread support");
@@ -276,7 +284,7 @@ namespace ouzel
         if (display != DISPMANX_NO_HANDLE)
             vc_dispmanx_display_close(display);
 
-        bcm_host_deinit();
+        if (!headless) bcm_host_deinit();
 #endif
     }
 
@@ -285,6 +293,23 @@ namespace ouzel
         init();
         start();
 
+        if (headless)
+        {
+            while (active)
+            {
+                std::unique_lock<std::mutex> lock(executeMutex);
+                // wake up periodically to notice that the engine was stopped
+                executeCondition.wait_for(lock, std::chrono::milliseconds(100),
+                                          [this]() { return !executeQueue.empty(); });
+                lock.unlock();
+
+                executeAll();
+            }
+
+            exit();
+            return;
+        }
+
         input::InputSystemLinux* inputLinux = static_cast<input::InputSystemLinux*>(inputManager->getInputSystem());
 
 #if OUZEL_SUPPORTS_X11
@@ -316,10 +341,10 @@ namespace ouzel
                 XISelectEvents(display, windowLinux->getNativeWindow(), &eventMask, 1);
             }
             else
-                log(Log::Level::WARN) << "XInput2 not supported";
+                OUZEL_LOG(*this, Log::Level::WARN) << "XInput2 not supported";
         }
         else
-            log(Log::Level::WARN) << "XInput not supported";
+            OUZEL_LOG(*this, Log::Level::WARN) << "XInput not supported";
 
         executeAtom = XInternAtom(display, "OUZEL_EXECUTE", False);
 
@@ -461,6 +486,15 @@ namespace ouzel
 
     void EngineLinux::runOnMainThread(const std::function<void()>& func)
     {
+        if (headless)
+        {
+            std::unique_lock<std::mutex> lock(executeMutex);
+            executeQueue.push(func);
+            lock.unlock();
+            executeCondition.notify_all();
+            return;
+        }
+
 #if OUZEL_SUPPORTS_X11
         NativeWindowLinux* windowLinux = static_cast<NativeWindowLinux*>(window->getNativeWindow());
 
@@ -501,9 +535,12 @@ namespace ouzel
         Engine::setScreenSaverEnabled(newScreenSaverEnabled);
 
 #if OUZEL_SUPPORTS_X11
-        executeOnMainThread([this, newScreenSaverEnabled]() {
-            XScreenSaverSuspend(display, !newScreenSaverEnabled);
-        });
+        if (display)
+        {
+            executeOnMainThread([this, newScreenSaverEnabled]() {
+                XScreenSaverSuspend(display, !newScreenSaverEnabled);
+            });
+        }
 #endif
     }
 
@@ -3,6 +3,7 @@
 #ifndef OUZEL_CORE_ENGINELINUX_HPP
 #define OUZEL_CORE_ENGINELINUX_HPP
 
+#include <condition_variable>
 #include "core/Setup.h"
 #if OUZEL_SUPPORTS_X11
 #  include <X11/Xlib.h>
@@ -37,6 +38,7 @@ namespace ouzel
 
         std::queue<std::function<void()>> executeQueue;
         std::mutex executeMutex;
+        std::condition_variable executeCondition; // used only in the headless mode
 
 #if OUZEL_SUPPORTS_X11
         Display* display = nullptr;
@@ -74,7 +74,7 @@ namespace ouzel
 
 #ifdef DEBUG
         if (!AllocConsole())
-            log(Log::Level::INFO) << "Attached to console";
+            OUZEL_LOG(*this, Log::Level::INFO) << "Attached to console";
 #endif
     }
 
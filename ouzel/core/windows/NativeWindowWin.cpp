@@ -461,7 +461,7 @@ namespace ouzel
         resolution = size;
 
         if (!RegisterTouchWindow(window, 0))
-            engine->log(Log::Level::WARN) << "Failed to enable touch for window";
+            OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to enable touch for window";
 
         ShowWindow(window, SW_SHOW);
 
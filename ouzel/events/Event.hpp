@@ -64,6 +64,7 @@ namespace ouzel
             ORIENTATION_CHANGE,
             LOW_MEMORY,
             OPEN_FILE,
+            ASSET_RELOAD, // asset was reloaded after its file changed (the filename is the name of the asset)
 
             // UI events
             ACTOR_ENTER, // mouse or touch entered the scene actor
@@ -85,6 +86,7 @@ namespace ouzel
             SOUND_FINISH,
 
             UPDATE,
+            FIXED_UPDATE, // sent every fixed time step, delta is the step
 
             USER // user defined event
         };
@@ -7,7 +7,11 @@
 
 namespace ouzel
 {
-    EventDispatcher::EventDispatcher()
+    // the queue holds the events posted during a frame, the rest goes to the overflow queue
+    static constexpr size_t EVENT_QUEUE_CAPACITY = 4096;
+
+    EventDispatcher::EventDispatcher():
+        eventQueue(EVENT_QUEUE_CAPACITY)
     {
     }
 
@@ -18,7 +22,7 @@ namespace ouzel
 
         for (EventHandler* eventHandler : eventHandlers)
         {
-            auto i = std::find(eventHandlerDeleteSet.begin(), eventHandlerDeleteSet.end(), eventHandler);
+            auto i = eventHandlerDeleteSet.find(eventHandler);
             if (i == eventHandlerDeleteSet.end()) eventHandler->eventDispatcher = nullptr;
         }
     }
@@ -52,124 +56,151 @@ namespace ouzel
 
         eventHandlerAddSet.clear();
 
-        std::pair<std::promise<bool>, std::unique_ptr<Event>> event;
+        // handler functions can be assigned after the handler was added, so the categories are rebuilt every frame
+        for (std::vector<EventHandler*>& handlers : categoryHandlers)
+            handlers.clear();
 
-        for (;;)
+        for (EventHandler* eventHandler : eventHandlers)
         {
-            std::unique_lock<std::mutex> lock(eventQueueMutex);
-            if (eventQueue.empty()) break;
+            if (eventHandler->keyboardHandler) categoryHandlers[KEYBOARD].push_back(eventHandler);
+            if (eventHandler->mouseHandler) categoryHandlers[MOUSE].push_back(eventHandler);
+            if (eventHandler->touchHandler) categoryHandlers[TOUCH].push_back(eventHandler);
+            if (eventHandler->gamepadHandler) categoryHandlers[GAMEPAD].push_back(eventHandler);
+            if (eventHandler->windowHandler) categoryHandlers[WINDOW].push_back(eventHandler);
+            if (eventHandler->systemHandler) categoryHandlers[SYSTEM].push_back(eventHandler);
+            if (eventHandler->uiHandler) categoryHandlers[UI].push_back(eventHandler);
+            if (eventHandler->animationHandler) categoryHandlers[ANIMATION].push_back(eventHandler);
+            if (eventHandler->soundHandler) categoryHandlers[SOUND].push_back(eventHandler);
+            if (eventHandler->updateHandler) categoryHandlers[UPDATE].push_back(eventHandler);
+            if (eventHandler->fixedUpdateHandler) categoryHandlers[FIXED_UPDATE].push_back(eventHandler);
+            if (eventHandler->userHandler) categoryHandlers[USER].push_back(eventHandler);
+        }
 
-            event = std::move(eventQueue.front());
-            eventQueue.pop();
+        QueuedEvent queuedEvent;
+        dispatchedEventCount = 0;
+
+        // events in the overflow queue were posted after the ones in the queue
+        while (eventQueue.pop(queuedEvent))
+        {
+            ++dispatchedEventCount;
+            dispatchQueuedEvent(queuedEvent);
+        }
+
+        while (overflowQueueSize.load(std::memory_order_acquire))
+        {
+            std::unique_lock<std::mutex> lock(overflowQueueMutex);
+            queuedEvent = std::move(overflowQueue.front());
+            overflowQueue.pop();
+            overflowQueueSize.fetch_sub(1, std::memory_order_release);
             lock.unlock();
 
-            event.first.set_value(dispatchEvent(std::move(event.second)));
+            ++dispatchedEventCount;
+            dispatchQueuedEvent(queuedEvent);
         }
     }
 
-    bool EventDispatcher::dispatchEvent(std::unique_ptr<Event>&& event)
+    void EventDispatcher::dispatchQueuedEvent(QueuedEvent& queuedEvent)
     {
-        if (!event) return false;
+        const bool handled = dispatchEvent(std::move(queuedEvent.event));
 
-        bool handled = false;
+        if (queuedEvent.promise)
+        {
+            queuedEvent.promise->set_value(handled);
+            queuedEvent.promise.reset();
+        }
+    }
 
-        for (const EventHandler* eventHandler : eventHandlers)
+    template<class T>
+    bool EventDispatcher::dispatchToHandlers(Category category,
+                                             std::function<bool(const T&)> EventHandler::*handler,
+                                             const Event& event)
+    {
+        for (EventHandler* eventHandler : categoryHandlers[category])
         {
-            auto i = std::find(eventHandlerDeleteSet.begin(), eventHandlerDeleteSet.end(), eventHandler);
+            // skip the handlers that were removed during this frame
+            if (!eventHandlerDeleteSet.empty() &&
+                eventHandlerDeleteSet.find(eventHandler) != eventHandlerDeleteSet.end())
+                continue;
 
-            if (i == eventHandlerDeleteSet.end())
-            {
-                switch (event->type)
-                {
-                    case Event::Type::KEYBOARD_CONNECT:
-                    case Event::Type::KEYBOARD_DISCONNECT:
-                    case Event::Type::KEY_PRESS:
-                    case Event::Type::KEY_RELEASE:
-                        if (eventHandler->keyboardHandler)
-                            handled = eventHandler->keyboardHandler(*static_cast<KeyboardEvent*>(event.get()));
-                        break;
-                    case Event::Type::MOUSE_CONNECT:
-                    case Event::Type::MOUSE_DISCONNECT:
-                    case Event::Type::MOUSE_PRESS:
-                    case Event::Type::MOUSE_RELEASE:
-                    case Event::Type::MOUSE_SCROLL:
-                    case Event::Type::MOUSE_MOVE:
-                    case Event::Type::MOUSE_CURSOR_LOCK_CHANGE:
-                        if (eventHandler->mouseHandler)
-                            handled = eventHandler->mouseHandler(*static_cast<MouseEvent*>(event.get()));
-                        break;
-                    case Event::Type::TOUCHPAD_CONNECT:
-                    case Event::Type::TOUCHPAD_DISCONNECT:
-                    case Event::Type::TOUCH_BEGIN:
-                    case Event::Type::TOUCH_MOVE:
-                    case Event::Type::TOUCH_END:
-                    case Event::Type::TOUCH_CANCEL:
-                        if (eventHandler->touchHandler)
-                            handled = eventHandler->touchHandler(*static_cast<TouchEvent*>(event.get()));
-                        break;
-                    case Event::Type::GAMEPAD_CONNECT:
-                    case Event::Type::GAMEPAD_DISCONNECT:
-                    case Event::Type::GAMEPAD_BUTTON_CHANGE:
-                        if (eventHandler->gamepadHandler)
-                            handled = eventHandler->gamepadHandler(*static_cast<GamepadEvent*>(event.get()));
-                        break;
-                    case Event::Type::WINDOW_SIZE_CHANGE:
-                    case Event::Type::WINDOW_TITLE_CHANGE:
-                    case Event::Type::FULLSCREEN_CHANGE:
-                    case Event::Type::SCREEN_CHANGE:
-                    case Event::Type::RESOLUTION_CHANGE:
-                        if (eventHandler->windowHandler)
-                            handled = eventHandler->windowHandler(*static_cast<WindowEvent*>(event.get()));
-                        break;
-                    case Event::Type::ENGINE_START:
-                    case Event::Type::ENGINE_STOP:
-                    case Event::Type::ENGINE_RESUME:
-                    case Event::Type::ENGINE_PAUSE:
-                    case Event::Type::ORIENTATION_CHANGE:
-                    case Event::Type::LOW_MEMORY:
-                    case Event::Type::OPEN_FILE:
-                        if (eventHandler->systemHandler)
-                            handled = eventHandler->systemHandler(*static_cast<SystemEvent*>(event.get()));
-                        break;
-                    case Event::Type::ACTOR_ENTER:
-                    case Event::Type::ACTOR_LEAVE:
-                    case Event::Type::ACTOR_PRESS:
-                    case Event::Type::ACTOR_RELEASE:
-                    case Event::Type::ACTOR_CLICK:
-                    case Event::Type::ACTOR_DRAG:
-                    case Event::Type::WIDGET_CHANGE:
-                        if (eventHandler->uiHandler)
-                            handled = eventHandler->uiHandler(*static_cast<UIEvent*>(event.get()));
-                        break;
-                    case Event::Type::ANIMATION_START:
-                    case Event::Type::ANIMATION_RESET:
-                    case Event::Type::ANIMATION_FINISH:
-                        if (eventHandler->animationHandler)
-                            handled = eventHandler->animationHandler(*static_cast<AnimationEvent*>(event.get()));
-                        break;
-                    case Event::Type::SOUND_START:
-                    case Event::Type::SOUND_RESET:
-                    case Event::Type::SOUND_FINISH:
-                        if (eventHandler->soundHandler)
-                            handled = eventHandler->soundHandler(*static_cast<SoundEvent*>(event.get()));
-                        break;
-                    case Event::Type::UPDATE:
-                        if (eventHandler->updateHandler)
-                            handled = eventHandler->updateHandler(*static_cast<UpdateEvent*>(event.get()));
-                        break;
-                    case Event::Type::USER:
-                        if (eventHandler->userHandler)
-                            handled = eventHandler->userHandler(*static_cast<UserEvent*>(event.get()));
-                        break;
-                    default:
-                        return false; // custom event should not be sent
-                }
-            }
+            const std::function<bool(const T&)>& function = eventHandler->*handler;
 
-            if (handled) break;
+            if (function && function(static_cast<const T&>(event)))
+                return true;
         }
 
-        return handled;
+        return false;
+    }
+
+    bool EventDispatcher::dispatchEvent(std::unique_ptr<Event>&& event)
+    {
+        if (!event) return false;
+
+        switch (event->type)
+        {
+            case Event::Type::KEYBOARD_CONNECT:
+            case Event::Type::KEYBOARD_DISCONNECT:
+            case Event::Type::KEY_PRESS:
+            case Event::Type::KEY_RELEASE:
+                return dispatchToHandlers(KEYBOARD, &EventHandler::keyboardHandler, *event);
+            case Event::Type::MOUSE_CONNECT:
+            case Event::Type::MOUSE_DISCONNECT:
+            case Event::Type::MOUSE_PRESS:
+            case Event::Type::MOUSE_RELEASE:
+            case Event::Type::MOUSE_SCROLL:
+            case Event::Type::MOUSE_MOVE:
+            case Event::Type::MOUSE_CURSOR_LOCK_CHANGE:
+                return dispatchToHandlers(MOUSE, &EventHandler::mouseHandler, *event);
+            case Event::Type::TOUCHPAD_CONNECT:
+            case Event::Type::TOUCHPAD_DISCONNECT:
+            case Event::Type::TOUCH_BEGIN:
+            case Event::Type::TOUCH_MOVE:
+            case Event::Type::TOUCH_END:
+            case Event::Type::TOUCH_CANCEL:
+                return dispatchToHandlers(TOUCH, &EventHandler::touchHandler, *event);
+            case Event::Type::GAMEPAD_CONNECT:
+            case Event::Type::GAMEPAD_DISCONNECT:
+            case Event::Type::GAMEPAD_BUTTON_CHANGE:
+                return dispatchToHandlers(GAMEPAD, &EventHandler::gamepadHandler, *event);
+            case Event::Type::WINDOW_SIZE_CHANGE:
+            case Event::Type::WINDOW_TITLE_CHANGE:
+            case Event::Type::FULLSCREEN_CHANGE:
+            case Event::Type::SCREEN_CHANGE:
+            case Event::Type::RESOLUTION_CHANGE:
+                return dispatchToHandlers(WINDOW, &EventHandler::windowHandler, *event);
+            case Event::Type::ENGINE_START:
+            case Event::Type::ENGINE_STOP:
+            case Event::Type::ENGINE_RESUME:
+            case Event::Type::ENGINE_PAUSE:
+            case Event::Type::ORIENTATION_CHANGE:
+            case Event::Type::LOW_MEMORY:
+            case Event::Type::OPEN_FILE:
+            case Event::Type::ASSET_RELOAD:
+                return dispatchToHandlers(SYSTEM, &EventHandler::systemHandler, *event);
+            case Event::Type::ACTOR_ENTER:
+            case Event::Type::ACTOR_LEAVE:
+            case Event::Type::ACTOR_PRESS:
+            case Event::Type::ACTOR_RELEASE:
+            case Event::Type::ACTOR_CLICK:
+            case Event::Type::ACTOR_DRAG:
+            case Event::Type::WIDGET_CHANGE:
+                return dispatchToHandlers(UI, &EventHandler::uiHandler, *event);
+            case Event::Type::ANIMATION_START:
+            case Event::Type::ANIMATION_RESET:
+            case Event::Type::ANIMATION_FINISH:
+                return dispatchToHandlers(ANIMATION, &EventHandler::animationHandler, *event);
+            case Event::Type::SOUND_START:
+            case Event::Type::SOUND_RESET:
+            case Event::Type::SOUND_FINISH:
+                return dispatchToHandlers(SOUND, &EventHandler::soundHandler, *event);
+            case Event::Type::UPDATE:
+                return dispatchToHandlers(UPDATE, &EventHandler::updateHandler, *event);
+            case Event::Type::FIXED_UPDATE:
+                return dispatchToHandlers(FIXED_UPDATE, &EventHandler::fixedUpdateHandler, *event);
+            case Event::Type::USER:
+                return dispatchToHandlers(USER, &EventHandler::userHandler, *event);
+            default:
+                return false; // custom event should not be sent
+        }
     }
 
     void EventDispatcher::addEventHandler(EventHandler* eventHandler)
@@ -200,18 +231,42 @@ namespace ouzel
             eventHandlerAddSet.erase(setIterator);
     }
 
-    std::future<bool> EventDispatcher::postEvent(std::unique_ptr<Event>&& event)
+    void EventDispatcher::postEvent(std::unique_ptr<Event>&& event)
     {
-        std::promise<bool> promise;
-        std::future<bool> future = promise.get_future();
+#if defined(__EMSCRIPTEN__)
+        dispatchEvent(std::move(event));
+#else
+        QueuedEvent queuedEvent;
+        queuedEvent.event = std::move(event);
+        queueEvent(std::move(queuedEvent));
+#endif
+    }
+
+    std::future<bool> EventDispatcher::postEventWithResult(std::unique_ptr<Event>&& event)
+    {
+        std::unique_ptr<std::promise<bool>> promise(new std::promise<bool>());
+        std::future<bool> future = promise->get_future();
 
 #if defined(__EMSCRIPTEN__)
-        promise.set_value(dispatchEvent(std::move(event)));
+        promise->set_value(dispatchEvent(std::move(event)));
 #else
-        std::unique_lock<std::mutex> lock(eventQueueMutex);
-        eventQueue.push(std::pair<std::promise<bool>, std::unique_ptr<Event>>(std::move(promise), std::move(event)));
+        QueuedEvent queuedEvent;
+        queuedEvent.event = std::move(event);
+        queuedEvent.promise = std::move(promise);
+        queueEvent(std::move(queuedEvent));
 #endif
 
         return future;
     }
+
+    void EventDispatcher::queueEvent(QueuedEvent&& queuedEvent)
+    {
+        if (!overflowQueueSize.load(std::memory_order_acquire) &&
+            eventQueue.push(std::move(queuedEvent)))
+            return;
+
+        std::unique_lock<std::mutex> lock(overflowQueueMutex);
+        overflowQueue.push(std::move(queuedEvent));
+        overflowQueueSize.fetch_add(1, std::memory_order_release);
+    }
 }
@@ -3,14 +3,17 @@
 #ifndef OUZEL_EVENTS_EVENTDISPATCHER_HPP
 #define OUZEL_EVENTS_EVENTDISPATCHER_HPP
 
+#include <atomic>
 #include <cstdint>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <set>
 #include <vector>
 #include "events/Event.hpp"
 #include "events/EventHandler.hpp"
+#include "utils/MpscQueue.hpp"
 
 namespace ouzel
 {
@@ -33,18 +36,64 @@ namespace ouzel
         bool dispatchEvent(std::unique_ptr<Event>&& event);
 
         // posts the event for dispatching on the game thread
-        std::future<bool> postEvent(std::unique_ptr<Event>&& event);
+        void postEvent(std::unique_ptr<Event>&& event);
+
+        // posts the event and returns a future that is set to true if a handler handled it
+        std::future<bool> postEventWithResult(std::unique_ptr<Event>&& event);
 
         // dispatches all queued events on the game thread
         void dispatchEvents();
 
+        // number of queued events that the last dispatchEvents call dispatched
+        inline size_t getDispatchedEventCount() const { return dispatchedEventCount; }
+
     private:
+        enum Category
+        {
+            KEYBOARD,
+            MOUSE,
+            TOUCH,
+            GAMEPAD,
+            WINDOW,
+            SYSTEM,
+            UI,
+            ANIMATION,
+            SOUND,
+            UPDATE,
+            FIXED_UPDATE,
+            USER,
+            CATEGORY_COUNT
+        };
+
+        struct QueuedEvent final
+        {
+            std::unique_ptr<Event> event;
+            std::unique_ptr<std::promise<bool>> promise; // only for postEventWithResult
+        };
+
+        void queueEvent(QueuedEvent&& queuedEvent);
+        void dispatchQueuedEvent(QueuedEvent& queuedEvent);
+
+        template<class T>
+        bool dispatchToHandlers(Category category,
+                                std::function<bool(const T&)> EventHandler::*handler,
+                                const Event& event);
+
         std::vector<EventHandler*> eventHandlers;
         std::set<EventHandler*> eventHandlerAddSet;
         std::set<EventHandler*> eventHandlerDeleteSet;
 
-        std::mutex eventQueueMutex;
-        std::queue<std::pair<std::promise<bool>, std::unique_ptr<Event>>> eventQueue;
+        // handlers that have a handler function for the category, sorted by priority
+        std::vector<EventHandler*> categoryHandlers[CATEGORY_COUNT];
+
+        MpscQueue<QueuedEvent> eventQueue;
+
+        // events posted while the queue is full, all events go here until it is drained to keep the order
+        std::mutex overflowQueueMutex;
+        std::queue<QueuedEvent> overflowQueue;
+        std::atomic<size_t> overflowQueueSize{0};
+
+        size_t dispatchedEventCount = 0;
     };
 }
 
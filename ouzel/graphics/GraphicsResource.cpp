@@ -15,7 +15,12 @@ namespace ouzel
 
         Resource::~Resource()
         {
-            if (id) renderer->deleteResourceId(id);
+            if (id) release();
+        }
+
+        void Resource::release()
+        {
+            renderer->deleteResourceId(id);
         }
     } // namespace graphics
 } // namespace ouzel
@@ -35,6 +35,8 @@ namespace ouzel
             {
                 if (&other != this)
                 {
+                    if (id) release();
+
                     renderer = other.renderer;
                     id = other.id;
                     other.renderer = nullptr;
@@ -55,6 +57,8 @@ namespace ouzel
             }
 
         private:
+            void release();
+
             Renderer* renderer = nullptr;
             uintptr_t id = 0;
         };
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include "RenderDevice.hpp"
+#include "core/Engine.hpp"
 
 namespace ouzel
 {
@@ -22,6 +23,9 @@ namespace ouzel
             projectionTransform(Matrix4F::identity()),
             renderTargetProjectionTransform(Matrix4F::identity())
         {
+            commandQueueDepthGauge = &engine->getMetrics().addGauge("ouzel_render_queue_depth", "Number of command buffers waiting for the render thread");
+            frameTimeHistogram = &engine->getMetrics().addHistogram("ouzel_frame_time_seconds", "Time between the rendered frames",
+                                                                    {0.004, 0.008, 0.011, 0.016, 0.022, 0.033, 0.05, 0.1, 0.25});
         }
 
         RenderDevice::~RenderDevice()
@@ -61,6 +65,7 @@ namespace ouzel
             previousFrameTime = currentTime;
 
             float delta = diff.count() / 1000000000.0F;
+            frameTimeHistogram->observe(delta);
 
             if (delta > 0.0F)
                 currentFPS = 1.0F / delta;
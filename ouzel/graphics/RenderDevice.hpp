@@ -15,6 +15,7 @@
 #include "graphics/Vertex.hpp"
 #include "math/Matrix.hpp"
 #include "math/Size.hpp"
+#include "utils/Metrics.hpp"
 
 namespace ouzel
 {
@@ -70,6 +71,7 @@ namespace ouzel
             {
                 std::unique_lock<std::mutex> lock(commandQueueMutex);
                 commandQueue.push(std::forward<CommandBuffer>(commandBuffer));
+                commandQueueDepthGauge->set(static_cast<double>(commandQueue.size()));
                 lock.unlock();
                 commandQueueCondition.notify_all();
             }
@@ -156,6 +158,7 @@ namespace ouzel
             std::queue<CommandBuffer> commandQueue;
             std::mutex commandQueueMutex;
             std::condition_variable commandQueueCondition;
+            Metrics::Gauge* commandQueueDepthGauge = nullptr;
 
             std::atomic<float> currentFPS{0.0F};
             std::chrono::steady_clock::time_point previousFrameTime;
@@ -163,6 +166,7 @@ namespace ouzel
             float accumulatedTime = 0.0F;
             float currentAccumulatedFPS = 0.0F;
             std::atomic<float> accumulatedFPS{0.0F};
+            Metrics::Histogram* frameTimeHistogram = nullptr;
 
             std::queue<std::function<void()>> executeQueue;
             std::mutex executeMutex;
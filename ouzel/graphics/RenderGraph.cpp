@@ -0,0 +1,421 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+#include "RenderGraph.hpp"
+#include "Renderer.hpp"
+
+static bool isDepthFormat(ouzel::graphics::PixelFormat pixelFormat)
+{
+    return pixelFormat == ouzel::graphics::PixelFormat::DEPTH ||
+        pixelFormat == ouzel::graphics::PixelFormat::DEPTH_STENCIL;
+}
+
+static bool isCompatible(const ouzel::graphics::RenderGraph::TextureDescriptor& a,
+                         const ouzel::graphics::RenderGraph::TextureDescriptor& b)
+{
+    return a.size == b.size &&
+        a.pixelFormat == b.pixelFormat &&
+        a.sampleCount == b.sampleCount;
+}
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        uint32_t RenderGraph::Builder::create(const std::string& name, const TextureDescriptor& descriptor)
+        {
+            Resource resource;
+            resource.name = name;
+            resource.descriptor = descriptor;
+            resource.creator = pass;
+
+            uint32_t texture = static_cast<uint32_t>(renderGraph.resources.size());
+            renderGraph.resources.push_back(resource);
+            renderGraph.passes[pass].writes.push_back(texture);
+
+            return texture;
+        }
+
+        uint32_t RenderGraph::Builder::read(uint32_t texture)
+        {
+            if (texture >= renderGraph.resources.size())
+                throw std::runtime_error("Invalid render graph texture");
+
+            renderGraph.passes[pass].reads.push_back(texture);
+
+            return texture;
+        }
+
+        uint32_t RenderGraph::Builder::write(uint32_t texture)
+        {
+            if (texture >= renderGraph.resources.size())
+                throw std::runtime_error("Invalid render graph texture");
+
+            renderGraph.passes[pass].writes.push_back(texture);
+
+            return texture;
+        }
+
+        void RenderGraph::Builder::writeBackBuffer()
+        {
+            renderGraph.passes[pass].writesBackBuffer = true;
+        }
+
+        const std::shared_ptr<Texture>& RenderGraph::Context::getTexture(uint32_t texture) const
+        {
+            if (texture >= renderGraph.resources.size())
+                throw std::runtime_error("Invalid render graph texture");
+
+            return renderGraph.resources[texture].texture;
+        }
+
+        RenderGraph::RenderGraph(Renderer& initRenderer):
+            renderer(initRenderer)
+        {
+        }
+
+        uint32_t RenderGraph::importTexture(const std::string& name, const std::shared_ptr<Texture>& texture)
+        {
+            if (!texture)
+                throw std::runtime_error("Invalid texture");
+
+            Resource resource;
+            resource.name = name;
+            resource.descriptor.size = texture->getSize();
+            resource.descriptor.pixelFormat = texture->getPixelFormat();
+            resource.descriptor.sampleCount = texture->getSampleCount();
+            resource.imported = true;
+            resource.texture = texture;
+
+            uint32_t result = static_cast<uint32_t>(resources.size());
+            resources.push_back(resource);
+            compiled = false;
+
+            return result;
+        }
+
+        void RenderGraph::addPass(const std::string& name,
+                                  const std::function<void(Builder&)>& setup,
+                                  const std::function<void(const Context&)>& execute)
+        {
+            Pass pass;
+            pass.name = name;
+            pass.execute = execute;
+
+            uint32_t index = static_cast<uint32_t>(passes.size());
+            passes.push_back(pass);
+
+            Builder builder(*this, index);
+            if (setup) setup(builder);
+
+            compiled = false;
+        }
+
+        std::vector<uint32_t> RenderGraph::sortPasses(const std::vector<std::vector<uint32_t>>& passReads,
+                                                      const std::vector<std::vector<uint32_t>>& passWrites,
+                                                      uint32_t textureCount)
+        {
+            const uint32_t passCount = static_cast<uint32_t>(passWrites.size());
+
+            // passes that only write, read and write and only read every texture, in the order they were added in
+            std::vector<std::vector<uint32_t>> producers(textureCount);
+            std::vector<std::vector<uint32_t>> modifiers(textureCount);
+            std::vector<std::vector<uint32_t>> consumers(textureCount);
+
+            for (uint32_t pass = 0; pass < passCount; ++pass)
+            {
+                const std::vector<uint32_t>& reads = passReads[pass];
+                const std::vector<uint32_t>& writes = passWrites[pass];
+
+                for (uint32_t texture : writes)
+                {
+                    if (std::find(reads.begin(), reads.end(), texture) != reads.end())
+                        modifiers[texture].push_back(pass);
+                    else
+                        producers[texture].push_back(pass);
+                }
+
+                for (uint32_t texture : reads)
+                    if (std::find(writes.begin(), writes.end(), texture) == writes.end())
+                        consumers[texture].push_back(pass);
+            }
+
+            std::vector<std::vector<uint32_t>> dependents(passCount);
+            std::vector<uint32_t> dependencyCounts(passCount, 0);
+
+            auto addDependency = [&dependents, &dependencyCounts](uint32_t pass, uint32_t dependent) {
+                if (pass == dependent) return;
+                dependents[pass].push_back(dependent);
+                ++dependencyCounts[dependent];
+            };
+
+            for (uint32_t texture = 0; texture < textureCount; ++texture)
+            {
+                std::vector<uint32_t> writers = producers[texture];
+                writers.insert(writers.end(), modifiers[texture].begin(), modifiers[texture].end());
+
+                if (writers.empty()) continue;
+
+                for (size_t i = 1; i < writers.size(); ++i)
+                    addDependency(writers[i - 1], writers[i]);
+
+                for (uint32_t reader : consumers[texture])
+                    addDependency(writers.back(), reader);
+            }
+
+            // the ready pass that was added first goes next, so unconstrained passes keep their order
+            std::set<uint32_t> ready;
+            for (uint32_t pass = 0; pass < passCount; ++pass)
+                if (dependencyCounts[pass] == 0) ready.insert(pass);
+
+            std::vector<uint32_t> result;
+            result.reserve(passCount);
+
+            while (!ready.empty())
+            {
+                uint32_t pass = *ready.begin();
+                ready.erase(ready.begin());
+                result.push_back(pass);
+
+                for (uint32_t dependent : dependents[pass])
+                    if (--dependencyCounts[dependent] == 0)
+                        ready.insert(dependent);
+            }
+
+            if (result.size() != passCount)
+                throw std::runtime_error("Render graph passes have a cyclic dependency");
+
+            return result;
+        }
+
+        void RenderGraph::compile()
+        {
+            std::vector<std::vector<uint32_t>> passReads;
+            std::vector<std::vector<uint32_t>> passWrites;
+
+            for (const Pass& pass : passes)
+            {
+                passReads.push_back(pass.reads);
+                passWrites.push_back(pass.writes);
+            }
+
+            order = sortPasses(passReads, passWrites, static_cast<uint32_t>(resources.size()));
+
+            // walk the passes backwards and keep only the ones that contribute to a side effect
+            std::vector<bool> needed(resources.size(), false);
+            culledPassCount = 0;
+
+            for (auto i = order.rbegin(); i != order.rend(); ++i)
+            {
+                uint32_t index = *i;
+                Pass& pass = passes[index];
+
+                pass.alive = pass.writesBackBuffer;
+
+                for (uint32_t texture : pass.writes)
+                    if (resources[texture].imported || needed[texture])
+                        pass.alive = true;
+
+                if (pass.alive)
+                {
+                    for (uint32_t texture : pass.reads)
+                        needed[texture] = true;
+
+                    // writing to a texture created by an earlier pass preserves its contents
+                    for (uint32_t texture : pass.writes)
+                        if (resources[texture].creator != index)
+                            needed[texture] = true;
+                }
+                else
+                    ++culledPassCount;
+            }
+
+            // calculate the lifetime of every transient texture
+            for (uint32_t position = 0; position < order.size(); ++position)
+            {
+                const Pass& pass = passes[order[position]];
+                if (!pass.alive) continue;
+
+                for (const std::vector<uint32_t>* textures : {&pass.reads, &pass.writes})
+                    for (uint32_t texture : *textures)
+                    {
+                        Resource& resource = resources[texture];
+                        if (resource.imported) continue;
+
+                        resource.firstPass = std::min(resource.firstPass, position);
+                        resource.lastPass = std::max(resource.lastPass, position);
+                    }
+            }
+
+            std::vector<std::vector<uint32_t>> allocations(passes.size());
+            std::vector<std::vector<uint32_t>> releases(passes.size());
+            transientTextureCount = 0;
+
+            for (uint32_t texture = 0; texture < resources.size(); ++texture)
+            {
+                const Resource& resource = resources[texture];
+
+                if (!resource.imported && resource.firstPass != UINT32_MAX)
+                {
+                    allocations[resource.firstPass].push_back(texture);
+                    releases[resource.lastPass].push_back(texture);
+                    ++transientTextureCount;
+                }
+            }
+
+            // assign pooled textures, a texture is returned to the pool after the last pass that uses it
+            std::vector<bool> busy(texturePool.size(), false);
+
+            for (uint32_t position = 0; position < order.size(); ++position)
+            {
+                for (uint32_t texture : allocations[position])
+                {
+                    Resource& resource = resources[texture];
+
+                    size_t poolIndex = 0;
+                    for (; poolIndex < texturePool.size(); ++poolIndex)
+                        if (!busy[poolIndex] && isCompatible(texturePool[poolIndex].descriptor, resource.descriptor))
+                            break;
+
+                    if (poolIndex == texturePool.size())
+                    {
+                        PooledTexture pooledTexture;
+                        pooledTexture.descriptor = resource.descriptor;
+                        pooledTexture.texture = std::make_shared<Texture>(renderer,
+                                                                          resource.descriptor.size,
+                                                                          Texture::BIND_RENDER_TARGET |
+                                                                          Texture::BIND_SHADER, 1,
+                                                                          resource.descriptor.sampleCount,
+                                                                          resource.descriptor.pixelFormat);
+                        texturePool.push_back(pooledTexture);
+                        busy.push_back(false);
+                    }
+
+                    busy[poolIndex] = true;
+                    texturePool[poolIndex].lastUsedFrame = currentFrame;
+                    resource.poolIndex = poolIndex;
+                    resource.texture = texturePool[poolIndex].texture;
+                }
+
+                for (uint32_t texture : releases[position])
+                    busy[resources[texture].poolIndex] = false;
+            }
+
+            compiled = true;
+        }
+
+        void RenderGraph::execute()
+        {
+            if (!compiled) compile();
+
+            Context context(*this);
+
+            for (uint32_t index : order)
+            {
+                const Pass& pass = passes[index];
+                if (!pass.alive) continue;
+
+                renderer.pushDebugMarker(pass.name);
+
+                std::vector<std::shared_ptr<Texture>> colorTextures;
+                std::shared_ptr<Texture> depthTexture;
+                const Resource* clearColorResource = nullptr;
+                const Resource* clearDepthResource = nullptr;
+
+                for (uint32_t texture : pass.writes)
+                {
+                    const Resource& resource = resources[texture];
+
+                    if (isDepthFormat(resource.descriptor.pixelFormat))
+                    {
+                        depthTexture = resource.texture;
+                        if (resource.creator == index) clearDepthResource = &resource;
+                    }
+                    else
+                    {
+                        colorTextures.push_back(resource.texture);
+                        if (resource.creator == index && !clearColorResource) clearColorResource = &resource;
+                    }
+                }
+
+                if (!colorTextures.empty() || depthTexture)
+                    renderer.setRenderTarget(getRenderTarget(colorTextures, depthTexture)->getResource());
+                else if (pass.writesBackBuffer)
+                    renderer.setRenderTarget(0);
+
+                if (clearColorResource || clearDepthResource)
+                    renderer.clearRenderTarget(clearColorResource != nullptr,
+                                               clearDepthResource != nullptr,
+                                               clearDepthResource && clearDepthResource->descriptor.pixelFormat == PixelFormat::DEPTH_STENCIL,
+                                               clearColorResource ? clearColorResource->descriptor.clearColor : Color(),
+                                               clearDepthResource ? clearDepthResource->descriptor.clearDepth : 1.0F,
+                                               clearDepthResource ? clearDepthResource->descriptor.clearStencil : 0);
+
+                if (pass.execute) pass.execute(context);
+
+                renderer.popDebugMarker();
+            }
+
+            // transient textures stay in the pool for the next frames
+            passes.clear();
+            resources.clear();
+            order.clear();
+            compiled = false;
+
+            releaseUnused();
+            ++currentFrame;
+        }
+
+        void RenderGraph::releaseUnused()
+        {
+            // keeping the textures for a few frames avoids recreating them when passes run only every other frame
+            std::vector<uintptr_t> releasedTextures;
+
+            for (auto i = texturePool.begin(); i != texturePool.end();)
+            {
+                if (currentFrame - i->lastUsedFrame >= RELEASE_FRAME_COUNT)
+                {
+                    releasedTextures.push_back(i->texture->getResource());
+                    i = texturePool.erase(i);
+                }
+                else
+                    ++i;
+            }
+
+            // the render targets hold references to their attachments, including the imported textures,
+            // so they are released with the pooled textures and when they were not used for a while
+            for (auto i = renderTargets.begin(); i != renderTargets.end();)
+            {
+                bool released = currentFrame - i->second.lastUsedFrame >= RELEASE_FRAME_COUNT;
+
+                for (uintptr_t texture : i->first)
+                    if (std::find(releasedTextures.begin(), releasedTextures.end(), texture) != releasedTextures.end())
+                        released = true;
+
+                if (released)
+                    i = renderTargets.erase(i);
+                else
+                    ++i;
+            }
+        }
+
+        std::shared_ptr<RenderTarget> RenderGraph::getRenderTarget(const std::vector<std::shared_ptr<Texture>>& colorTextures,
+                                                                   const std::shared_ptr<Texture>& depthTexture)
+        {
+            std::vector<uintptr_t> key;
+            for (const std::shared_ptr<Texture>& colorTexture : colorTextures)
+                key.push_back(colorTexture->getResource());
+            key.push_back(depthTexture ? depthTexture->getResource() : 0);
+
+            CachedRenderTarget& cachedRenderTarget = renderTargets[key];
+            cachedRenderTarget.lastUsedFrame = currentFrame;
+
+            if (!cachedRenderTarget.renderTarget)
+                cachedRenderTarget.renderTarget = std::make_shared<RenderTarget>(renderer, colorTextures, depthTexture);
+
+            return cachedRenderTarget.renderTarget;
+        }
+    } // namespace graphics
+} // namespace ouzel
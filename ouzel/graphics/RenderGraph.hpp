@@ -0,0 +1,171 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_RENDERGRAPH_HPP
+#define OUZEL_GRAPHICS_RENDERGRAPH_HPP
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "graphics/PixelFormat.hpp"
+#include "graphics/RenderTarget.hpp"
+#include "graphics/Texture.hpp"
+#include "math/Color.hpp"
+#include "math/Size.hpp"
+#include "utils/Inline.h"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        class Renderer;
+
+        // Frame graph of render passes. Passes declare the textures they read and write, they are ordered by these
+        // declarations, unused passes are culled and transient textures are taken from a pool so that passes with
+        // non-overlapping lifetimes share them.
+        // The scene renderer does not record its camera passes through the graph yet, it is meant for offscreen passes
+        // and post-processing chains that are built and executed by the application every frame (see RTSample).
+        class RenderGraph final
+        {
+        public:
+            struct TextureDescriptor final
+            {
+                Size2U size;
+                PixelFormat pixelFormat = PixelFormat::RGBA8_UNORM;
+                uint32_t sampleCount = 1;
+                Color clearColor;
+                float clearDepth = 1.0F;
+                uint32_t clearStencil = 0;
+            };
+
+            class Builder final
+            {
+                friend RenderGraph;
+            public:
+                // creates a transient texture that the pass writes to, it is cleared before the pass
+                uint32_t create(const std::string& name, const TextureDescriptor& descriptor);
+                uint32_t read(uint32_t texture);
+                uint32_t write(uint32_t texture);
+                // the pass renders to the back buffer and is never culled
+                void writeBackBuffer();
+
+            private:
+                Builder(RenderGraph& initRenderGraph, uint32_t initPass):
+                    renderGraph(initRenderGraph), pass(initPass)
+                {
+                }
+
+                RenderGraph& renderGraph;
+                uint32_t pass;
+            };
+
+            class Context final
+            {
+                friend RenderGraph;
+            public:
+                const std::shared_ptr<Texture>& getTexture(uint32_t texture) const;
+
+            private:
+                explicit Context(const RenderGraph& initRenderGraph):
+                    renderGraph(initRenderGraph)
+                {
+                }
+
+                const RenderGraph& renderGraph;
+            };
+
+            explicit RenderGraph(Renderer& initRenderer);
+
+            RenderGraph(const RenderGraph&) = delete;
+            RenderGraph& operator=(const RenderGraph&) = delete;
+
+            RenderGraph(RenderGraph&&) = delete;
+            RenderGraph& operator=(RenderGraph&&) = delete;
+
+            // imported textures outlive the frame, writing to them is a side effect that keeps the pass alive
+            uint32_t importTexture(const std::string& name, const std::shared_ptr<Texture>& texture);
+
+            void addPass(const std::string& name,
+                         const std::function<void(Builder&)>& setup,
+                         const std::function<void(const Context&)>& execute);
+
+            // orders and culls the passes and assigns pooled textures to the transient resources
+            void compile();
+            // records the passes to the renderer and clears them for the next frame
+            void execute();
+
+            ALWAYSINLINE uint32_t getPassCount() const { return static_cast<uint32_t>(passes.size()); }
+            ALWAYSINLINE uint32_t getCulledPassCount() const { return culledPassCount; }
+            ALWAYSINLINE uint32_t getTransientTextureCount() const { return transientTextureCount; }
+            ALWAYSINLINE uint32_t getPooledTextureCount() const { return static_cast<uint32_t>(texturePool.size()); }
+
+            // Orders the passes by the textures they read and write: the passes that only write a texture come first,
+            // then the ones that read and write it and then the ones that only read it. Passes that don't depend on
+            // each other keep the order they were added in. Throws if the declarations form a cycle.
+            static std::vector<uint32_t> sortPasses(const std::vector<std::vector<uint32_t>>& passReads,
+                                                    const std::vector<std::vector<uint32_t>>& passWrites,
+                                                    uint32_t textureCount);
+
+        private:
+            struct Resource final
+            {
+                std::string name;
+                TextureDescriptor descriptor;
+                bool imported = false;
+                std::shared_ptr<Texture> texture;
+                uint32_t creator = UINT32_MAX;
+                uint32_t firstPass = UINT32_MAX; // position in the execution order
+                uint32_t lastPass = 0;
+                size_t poolIndex = SIZE_MAX;
+            };
+
+            struct Pass final
+            {
+                std::string name;
+                std::function<void(const Context&)> execute;
+                std::vector<uint32_t> reads;
+                std::vector<uint32_t> writes;
+                bool writesBackBuffer = false;
+                bool alive = false;
+            };
+
+            struct PooledTexture final
+            {
+                TextureDescriptor descriptor;
+                std::shared_ptr<Texture> texture;
+                uint64_t lastUsedFrame = 0;
+            };
+
+            struct CachedRenderTarget final
+            {
+                std::shared_ptr<RenderTarget> renderTarget;
+                uint64_t lastUsedFrame = 0;
+            };
+
+            // pooled textures and render targets that were not used for this many frames are released
+            static constexpr uint64_t RELEASE_FRAME_COUNT = 3;
+
+            void releaseUnused();
+
+            std::shared_ptr<RenderTarget> getRenderTarget(const std::vector<std::shared_ptr<Texture>>& colorTextures,
+                                                          const std::shared_ptr<Texture>& depthTexture);
+
+            Renderer& renderer;
+            std::vector<Resource> resources;
+            std::vector<Pass> passes;
+            std::vector<uint32_t> order; // indices of the passes in the execution order
+            bool compiled = false;
+
+            uint64_t currentFrame = 0;
+            std::vector<PooledTexture> texturePool;
+            std::map<std::vector<uintptr_t>, CachedRenderTarget> renderTargets;
+
+            uint32_t culledPassCount = 0;
+            uint32_t transientTextureCount = 0;
+        };
+    } // namespace graphics
+} // namespace ouzel
+
+#endif // OUZEL_GRAPHICS_RENDERGRAPH_HPP
@@ -117,7 +117,7 @@ namespace ouzel
             {
 #if OUZEL_COMPILE_OPENGL
                 case Driver::OPENGL:
-                    engine->log(Log::Level::INFO) << "Using OpenGL render driver";
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "Using OpenGL render driver";
 #  if TARGET_OS_IOS
                     device.reset(new OGLRenderDeviceIOS(std::bind(&Renderer::handleEvent, this, std::placeholders::_1)));
 #  elif TARGET_OS_TV
@@ -139,13 +139,13 @@ namespace ouzel
 #endif
 #if OUZEL_COMPILE_DIRECT3D11
                 case Driver::DIRECT3D11:
-                    engine->log(Log::Level::INFO) << "Using Direct3D 11 render driver";
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "Using Direct3D 11 render driver";
                     device.reset(new D3D11RenderDevice(std::bind(&Renderer::handleEvent, this, std::placeholders::_1)));
                     break;
 #endif
 #if OUZEL_COMPILE_METAL
                 case Driver::METAL:
-                    engine->log(Log::Level::INFO) << "Using Metal render driver";
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "Using Metal render driver";
 #  if TARGET_OS_IOS
                     device.reset(new MetalRenderDeviceIOS(std::bind(&Renderer::handleEvent, this, std::placeholders::_1)));
 #  elif TARGET_OS_TV
@@ -156,7 +156,7 @@ namespace ouzel
                     break;
 #endif
                 default:
-                    engine->log(Log::Level::INFO) << "Not using render driver";
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "Not using render driver";
                     device.reset(new EmptyRenderDevice(std::bind(&Renderer::handleEvent, this, std::placeholders::_1)));
                     break;
             }
@@ -470,6 +470,14 @@ namespace ouzel
             return levels;
         }
 
+        std::vector<Texture::Level> Texture::calculateLevels(const Size2U& size,
+                                                             const std::vector<uint8_t>& data,
+                                                             uint32_t mipmaps,
+                                                             PixelFormat pixelFormat)
+        {
+            return calculateSizes(size, data, mipmaps, pixelFormat);
+        }
+
         Texture::Texture(Renderer& initRenderer):
             resource(initRenderer)
         {
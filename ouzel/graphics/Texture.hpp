@@ -91,6 +91,12 @@ namespace ouzel
                     uint32_t newFlags = 0,
                     PixelFormat newPixelFormat = PixelFormat::RGBA8_UNORM);
 
+            // returns the level and its mip chain, mipmaps 0 generates the full chain
+            static std::vector<Level> calculateLevels(const Size2U& size,
+                                                      const std::vector<uint8_t>& data,
+                                                      uint32_t mipmaps,
+                                                      PixelFormat pixelFormat);
+
             ALWAYSINLINE uintptr_t getResource() const { return resource.getId(); }
 
             ALWAYSINLINE const Size2U& getSize() const { return size; }
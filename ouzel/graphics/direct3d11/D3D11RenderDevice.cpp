@@ -178,7 +178,7 @@ namespace ouzel
                 {
                     std::vector<char> buffer(bufferSize);
                     if (WideCharToMultiByte(CP_UTF8, 0, adapterDesc.Description, -1, buffer.data(), bufferSize, nullptr, nullptr) != 0)
-                        engine->log(Log::Level::INFO) << "Using " << buffer.data() << " for rendering";
+                        OUZEL_LOG(*engine, Log::Level::INFO) << "Using " << buffer.data() << " for rendering";
                 }
             }
 
@@ -200,7 +200,7 @@ namespace ouzel
             if (supportedSampleCount != sampleCount)
             {
                 sampleCount = supportedSampleCount;
-                engine->log(Log::Level::WARN) << "Chosen sample count not supported, using: " << sampleCount;
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Chosen sample count not supported, using: " << sampleCount;
             }
 
             DXGI_SWAP_CHAIN_DESC swapChainDesc;
@@ -327,6 +327,8 @@ namespace ouzel
 
         void D3D11RenderDevice::process()
         {
+            ProfileZone renderZone(engine->getProfiler(), "Render");
+
             RenderDevice::process();
             executeAll();
 
@@ -350,6 +352,7 @@ namespace ouzel
                 while (commandQueue.empty()) commandQueueCondition.wait(lock);
                 commandBuffer = std::move(commandQueue.front());
                 commandQueue.pop();
+                commandQueueDepthGauge->set(static_cast<double>(commandQueue.size()));
                 lock.unlock();
 
                 while (!commandBuffer.isEmpty())
@@ -1146,7 +1149,7 @@ namespace ouzel
                 }
                 catch (const std::exception& e)
                 {
-                    engine->log(Log::Level::ERR) << e.what();
+                    OUZEL_LOG(*engine, Log::Level::ERR) << e.what();
                 }
             }
         }
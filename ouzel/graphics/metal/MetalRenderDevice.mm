@@ -163,7 +163,7 @@ namespace ouzel
                 throw std::runtime_error("Failed to create Metal device");
 
             if (device.name)
-                engine->log(Log::Level::INFO) << "Using " << [device.name cStringUsingEncoding:NSUTF8StringEncoding] << " for rendering";
+                OUZEL_LOG(*engine, Log::Level::INFO) << "Using " << [device.name cStringUsingEncoding:NSUTF8StringEncoding] << " for rendering";
 
             metalCommandQueue = [device newCommandQueue];
 
@@ -205,6 +205,8 @@ namespace ouzel
 
         void MetalRenderDevice::process()
         {
+            ProfileZone renderZone(engine->getProfiler(), "Render");
+
             RenderDevice::process();
             executeAll();
 
@@ -313,6 +315,7 @@ namespace ouzel
                 while (commandQueue.empty()) commandQueueCondition.wait(lock);
                 commandBuffer = std::move(commandQueue.front());
                 commandQueue.pop();
+                commandQueueDepthGauge->set(static_cast<double>(commandQueue.size()));
                 lock.unlock();
 
                 while (!commandBuffer.isEmpty())
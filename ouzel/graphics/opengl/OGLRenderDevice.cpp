@@ -8,6 +8,7 @@
 #  include <dlfcn.h>
 #endif
 
+#include <algorithm>
 #include <cassert>
 
 #include "graphics/opengl/OGL.h"
@@ -84,6 +85,12 @@ namespace ouzel
             return std::error_code(static_cast<int>(e), openGLErrorCategory);
         }
 
+#if OUZEL_OPENGLES
+        static constexpr GLenum TIMESTAMP_QUERY = GL_TIMESTAMP_EXT;
+#else
+        static constexpr GLenum TIMESTAMP_QUERY = GL_TIMESTAMP;
+#endif
+
         static GLenum getIndexType(uint32_t indexSize)
         {
             switch (indexSize)
@@ -311,6 +318,18 @@ namespace ouzel
         {
             if (vertexArrayId) glDeleteVertexArraysProc(1, &vertexArrayId);
 
+            for (const TimerQuery& timerQuery : pendingTimerQueries)
+            {
+                freeQueries.push_back(timerQuery.startQuery);
+                freeQueries.push_back(timerQuery.endQuery);
+            }
+
+            for (const TimerQuery& timerQuery : timerQueryStack)
+                if (timerQuery.startQuery) freeQueries.push_back(timerQuery.startQuery);
+
+            if (!freeQueries.empty())
+                glDeleteQueriesProc(static_cast<GLsizei>(freeQueries.size()), freeQueries.data());
+
             resources.clear();
         }
 
@@ -374,9 +393,19 @@ namespace ouzel
             GLenum error;
 
             if ((error = glGetErrorProc()) != GL_NO_ERROR || !deviceName)
-                engine->log(Log::Level::WARN) << "Failed to get OpenGL renderer, error: " + std::to_string(error);
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to get OpenGL renderer, error: " + std::to_string(error);
             else
-                engine->log(Log::Level::INFO) << "Using " << reinterpret_cast<const char*>(deviceName) << " for rendering";
+            {
+                OUZEL_LOG(*engine, Log::Level::INFO) << "Using " << reinterpret_cast<const char*>(deviceName) << " for rendering";
+                driverId = reinterpret_cast<const char*>(deviceName);
+            }
+
+            const GLubyte* driverVersion = glGetStringProc(GL_VERSION);
+
+            if ((error = glGetErrorProc()) != GL_NO_ERROR || !driverVersion)
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to get OpenGL version, error: " + std::to_string(error);
+            else
+                driverId += std::string(" ") + reinterpret_cast<const char*>(driverVersion);
 
             glEnableProc = getCoreProcAddress<PFNGLENABLEPROC>("glEnable");
             glDisableProc = getCoreProcAddress<PFNGLDISABLEPROC>("glDisable");
@@ -487,7 +516,7 @@ namespace ouzel
                 glGetIntegervProc(GL_NUM_EXTENSIONS, &extensionCount);
 
                 if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                    engine->log(Log::Level::WARN) << "Failed to get OpenGL extension count, error: " + std::to_string(error);
+                    OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to get OpenGL extension count, error: " + std::to_string(error);
                 else
                 {
                     for (GLuint i = 0; i < static_cast<GLuint>(extensionCount); ++i)
@@ -503,12 +532,12 @@ namespace ouzel
                 const GLubyte* extensionsPtr = glGetStringProc(GL_EXTENSIONS);
 
                 if ((error = glGetErrorProc()) != GL_NO_ERROR || !extensionsPtr)
-                    engine->log(Log::Level::WARN) << "Failed to get OpenGL extensions";
+                    OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to get OpenGL extensions";
                 else
                     extensions = explodeString(reinterpret_cast<const char*>(extensionsPtr), ' ');
             }
 
-            engine->log(Log::Level::ALL) << "Supported OpenGL extensions: " << extensions;
+            OUZEL_LOG(*engine, Log::Level::ALL) << "Supported OpenGL extensions: " << extensions;
 
             anisotropicFilteringSupported = false;
             npotTexturesSupported = false;
@@ -540,6 +569,17 @@ namespace ouzel
                 if ((apiMajorVersion == 3 && apiMinorVersion >= 1) || // at least OpenGL ES 3.1
                     apiMajorVersion > 3)
                     glTexStorage2DMultisampleProc = getExtProcAddress<PFNGLTEXSTORAGE2DMULTISAMPLEPROC>("glTexStorage2DMultisample");
+#else
+                if ((apiMajorVersion == 3 && apiMinorVersion >= 3) || // at least OpenGL 3.3
+                    apiMajorVersion > 3)
+                {
+                    glGenQueriesProc = getExtProcAddress<PFNGLGENQUERIESPROC>("glGenQueries");
+                    glDeleteQueriesProc = getExtProcAddress<PFNGLDELETEQUERIESPROC>("glDeleteQueries");
+                    glQueryCounterProc = getExtProcAddress<PFNGLQUERYCOUNTERPROC>("glQueryCounter");
+                    glGetQueryObjectivProc = getExtProcAddress<PFNGLGETQUERYOBJECTIVPROC>("glGetQueryObjectiv");
+                    glGetQueryObjectui64vProc = getExtProcAddress<PFNGLGETQUERYOBJECTUI64VPROC>("glGetQueryObjectui64v");
+                    glGetInteger64vProc = getExtProcAddress<PFNGLGETINTEGER64VPROC>("glGetInteger64v");
+                }
 #endif
                 npotTexturesSupported = true;
                 renderTargetsSupported = true;
@@ -647,6 +687,15 @@ namespace ouzel
                 }
                 else if (extension == "OES_element_index_uint")
                     uintElementIndexSupported = true;
+                else if (extension == "GL_EXT_disjoint_timer_query")
+                {
+                    glGenQueriesProc = getExtProcAddress<PFNGLGENQUERIESEXTPROC>("glGenQueriesEXT");
+                    glDeleteQueriesProc = getExtProcAddress<PFNGLDELETEQUERIESEXTPROC>("glDeleteQueriesEXT");
+                    glQueryCounterProc = getExtProcAddress<PFNGLQUERYCOUNTEREXTPROC>("glQueryCounterEXT");
+                    glGetQueryObjectivProc = getExtProcAddress<PFNGLGETQUERYOBJECTIVEXTPROC>("glGetQueryObjectivEXT");
+                    glGetQueryObjectui64vProc = getExtProcAddress<PFNGLGETQUERYOBJECTUI64VEXTPROC>("glGetQueryObjectui64vEXT");
+                    glGetInteger64vProc = getExtProcAddress<PFNGLGETINTEGER64VPROC>("glGetInteger64vEXT");
+                }
 #  if !OUZEL_OPENGL_INTERFACE_EAGL
                 else if (extension == "GL_EXT_copy_image")
                     glCopyImageSubDataProc = getExtProcAddress<PFNGLCOPYIMAGESUBDATAEXTPROC>("glCopyImageSubDataEXT");
@@ -665,6 +714,15 @@ namespace ouzel
 #else // OpenGL
                 else if (extension == "GL_ARB_copy_image")
                     glCopyImageSubDataProc = getExtProcAddress<PFNGLCOPYIMAGESUBDATAPROC>("glCopyImageSubData");
+                else if (extension == "GL_ARB_timer_query")
+                {
+                    glGenQueriesProc = getExtProcAddress<PFNGLGENQUERIESPROC>("glGenQueries");
+                    glDeleteQueriesProc = getExtProcAddress<PFNGLDELETEQUERIESPROC>("glDeleteQueries");
+                    glQueryCounterProc = getExtProcAddress<PFNGLQUERYCOUNTERPROC>("glQueryCounter");
+                    glGetQueryObjectivProc = getExtProcAddress<PFNGLGETQUERYOBJECTIVPROC>("glGetQueryObjectiv");
+                    glGetQueryObjectui64vProc = getExtProcAddress<PFNGLGETQUERYOBJECTUI64VPROC>("glGetQueryObjectui64v");
+                    glGetInteger64vProc = getExtProcAddress<PFNGLGETINTEGER64VPROC>("glGetInteger64v");
+                }
                 else if (extension == "GL_ARB_vertex_array_object")
                 {
                     glGenVertexArraysProc = getExtProcAddress<PFNGLGENVERTEXARRAYSPROC>("glGenVertexArrays");
@@ -704,6 +762,50 @@ namespace ouzel
 
             if (!multisamplingSupported) sampleCount = 1;
 
+#if OUZEL_OPENGLES
+            if (apiMajorVersion >= 3)
+#else
+            if ((apiMajorVersion == 4 && apiMinorVersion >= 1) || // at least OpenGL 4.1
+                apiMajorVersion > 4 ||
+                std::find(extensions.begin(), extensions.end(), "GL_ARB_get_program_binary") != extensions.end())
+#endif
+            {
+                glProgramParameteriProc = getExtProcAddress<PFNGLPROGRAMPARAMETERIPROC>("glProgramParameteri");
+                glGetProgramBinaryProc = getExtProcAddress<PFNGLGETPROGRAMBINARYPROC>("glGetProgramBinary");
+                glProgramBinaryProc = getExtProcAddress<PFNGLPROGRAMBINARYPROC>("glProgramBinary");
+
+                // some drivers expose the functions but do not support any binary formats
+                GLint binaryFormatCount = 0;
+                glGetIntegervProc(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+
+                if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                    OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to get program binary format count, error: " + std::to_string(error);
+                else
+                    programBinarySupported = binaryFormatCount > 0 &&
+                        glProgramParameteriProc && glGetProgramBinaryProc && glProgramBinaryProc;
+            }
+
+            timerQueriesSupported = glGenQueriesProc && glDeleteQueriesProc && glQueryCounterProc &&
+                glGetQueryObjectivProc && glGetQueryObjectui64vProc && glGetInteger64vProc;
+
+            if (timerQueriesSupported)
+            {
+                // GPU timestamps are converted to the profiler time with the offset measured at startup
+                GLint64 gpuTime = 0;
+                glGetInteger64vProc(TIMESTAMP_QUERY, &gpuTime);
+
+                if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                {
+                    OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to get GPU timestamp, error: " + std::to_string(error);
+                    timerQueriesSupported = false;
+                }
+                else
+                {
+                    gpuTrack = engine->getProfiler().addTrack("GPU");
+                    gpuTimeOffset = engine->getProfiler().getTime() - gpuTime;
+                }
+            }
+
             glDisableProc(GL_DITHER);
 
             if ((error = glGetErrorProc()) != GL_NO_ERROR)
@@ -793,9 +895,13 @@ namespace ouzel
 
         void OGLRenderDevice::process()
         {
+            ProfileZone renderZone(engine->getProfiler(), "Render");
+
             RenderDevice::process();
             executeAll();
 
+            if (timerQueriesSupported) readTimerQueries();
+
             OGLRenderTarget* currentRenderTarget = nullptr;
             OGLShader* currentShader = nullptr;
 
@@ -808,6 +914,7 @@ namespace ouzel
                 while (commandQueue.empty()) commandQueueCondition.wait(lock);
                 commandBuffer = std::move(commandQueue.front());
                 commandQueue.pop();
+                commandQueueDepthGauge->set(static_cast<double>(commandQueue.size()));
                 lock.unlock();
 
                 while (!commandBuffer.isEmpty())
@@ -1097,7 +1204,7 @@ namespace ouzel
 
 #if OUZEL_OPENGLES
                             if (setPipelineStateCommand->fillMode != FillMode::SOLID)
-                                engine->log(Log::Level::WARN) << "Unsupported fill mode";
+                                OUZEL_LOG(*engine, Log::Level::WARN) << "Unsupported fill mode";
 #else
                             setPolygonFillMode(getFillMode(setPipelineStateCommand->fillMode));
 #endif
@@ -1162,12 +1269,14 @@ namespace ouzel
                         {
                             auto pushDebugMarkerCommand = static_cast<const PushDebugMarkerCommand*>(command.get());
                             if (glPushGroupMarkerEXTProc) glPushGroupMarkerEXTProc(0, pushDebugMarkerCommand->name.c_str());
+                            if (timerQueriesSupported) pushTimerQuery(pushDebugMarkerCommand->name);
                             break;
                         }
 
                         case Command::Type::POP_DEBUG_MARKER:
                         {
                             if (glPopGroupMarkerEXTProc) glPopGroupMarkerEXTProc();
+                            if (timerQueriesSupported) popTimerQuery();
                             break;
                         }
 
@@ -1347,6 +1456,101 @@ namespace ouzel
         {
         }
 
+        GLuint OGLRenderDevice::createQuery()
+        {
+            if (!freeQueries.empty())
+            {
+                GLuint query = freeQueries.back();
+                freeQueries.pop_back();
+                return query;
+            }
+
+            GLuint query = 0;
+            glGenQueriesProc(1, &query);
+
+            GLenum error;
+            if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                throw std::system_error(makeErrorCode(error), "Failed to create query");
+
+            return query;
+        }
+
+        void OGLRenderDevice::pushTimerQuery(const std::string& name)
+        {
+            // markers are tracked even when the profiler is disabled, so that the pops always match the pushes
+            TimerQuery timerQuery;
+            timerQuery.depth = static_cast<uint32_t>(timerQueryStack.size());
+
+            Profiler& profiler = engine->getProfiler();
+
+            if (profiler.isEnabled())
+            {
+                timerQuery.name = profiler.getName(name);
+                timerQuery.startQuery = createQuery();
+                glQueryCounterProc(timerQuery.startQuery, TIMESTAMP_QUERY);
+            }
+
+            timerQueryStack.push_back(timerQuery);
+        }
+
+        void OGLRenderDevice::popTimerQuery()
+        {
+            if (timerQueryStack.empty()) return;
+
+            TimerQuery timerQuery = timerQueryStack.back();
+            timerQueryStack.pop_back();
+
+            if (timerQuery.startQuery)
+            {
+                timerQuery.endQuery = createQuery();
+                glQueryCounterProc(timerQuery.endQuery, TIMESTAMP_QUERY);
+                pendingTimerQueries.push_back(timerQuery);
+            }
+        }
+
+        void OGLRenderDevice::readTimerQueries()
+        {
+            Profiler& profiler = engine->getProfiler();
+
+            GLint disjoint = GL_FALSE;
+#if OUZEL_OPENGLES
+            // the results are invalid if the GPU changed its frequency or got interrupted
+            glGetIntegervProc(GL_GPU_DISJOINT_EXT, &disjoint);
+#endif
+
+            size_t count = 0;
+
+            // queries finish in the order they were issued
+            for (const TimerQuery& timerQuery : pendingTimerQueries)
+            {
+                GLint available = GL_FALSE;
+                glGetQueryObjectivProc(timerQuery.endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+                if (!available) break;
+
+                if (!disjoint)
+                {
+                    GLuint64 startTime = 0;
+                    GLuint64 endTime = 0;
+                    glGetQueryObjectui64vProc(timerQuery.startQuery, GL_QUERY_RESULT, &startTime);
+                    glGetQueryObjectui64vProc(timerQuery.endQuery, GL_QUERY_RESULT, &endTime);
+
+                    profiler.addSample(timerQuery.name, gpuTrack, timerQuery.depth,
+                                       static_cast<int64_t>(startTime) + gpuTimeOffset,
+                                       static_cast<int64_t>(endTime - startTime));
+                }
+
+                freeQueries.push_back(timerQuery.startQuery);
+                freeQueries.push_back(timerQuery.endQuery);
+                ++count;
+            }
+
+            pendingTimerQueries.erase(pendingTimerQueries.begin(), pendingTimerQueries.begin() + static_cast<std::ptrdiff_t>(count));
+
+            GLenum error;
+            if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                throw std::system_error(makeErrorCode(error), "Failed to read timer queries");
+        }
+
         void OGLRenderDevice::generateScreenshot(const std::string& filename)
         {
             bindFrameBuffer(frameBufferId);
@@ -140,6 +140,11 @@ namespace ouzel
             PFNGLMAPBUFFERRANGEEXTPROC glMapBufferRangeProc = nullptr;
             PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEEXTPROC glFramebufferTexture2DMultisampleProc = nullptr;
             PFNGLCOPYIMAGESUBDATAEXTPROC glCopyImageSubDataProc = nullptr;
+            PFNGLGENQUERIESEXTPROC glGenQueriesProc = nullptr;
+            PFNGLDELETEQUERIESEXTPROC glDeleteQueriesProc = nullptr;
+            PFNGLQUERYCOUNTEREXTPROC glQueryCounterProc = nullptr;
+            PFNGLGETQUERYOBJECTIVEXTPROC glGetQueryObjectivProc = nullptr;
+            PFNGLGETQUERYOBJECTUI64VEXTPROC glGetQueryObjectui64vProc = nullptr;
 #  if OUZEL_OPENGL_INTERFACE_EAGL
             PFNGLDISCARDFRAMEBUFFEREXTPROC glDiscardFramebufferEXTProc = nullptr;
             PFNGLRENDERBUFFERSTORAGEMULTISAMPLEAPPLEPROC glRenderbufferStorageMultisampleAPPLEProc = nullptr;
@@ -152,7 +157,13 @@ namespace ouzel
             PFNGLUNMAPBUFFERPROC glUnmapBufferProc = nullptr;
             PFNGLMAPBUFFERRANGEPROC glMapBufferRangeProc = nullptr;
             PFNGLCOPYIMAGESUBDATAPROC glCopyImageSubDataProc = nullptr;
+            PFNGLGENQUERIESPROC glGenQueriesProc = nullptr;
+            PFNGLDELETEQUERIESPROC glDeleteQueriesProc = nullptr;
+            PFNGLQUERYCOUNTERPROC glQueryCounterProc = nullptr;
+            PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectivProc = nullptr;
+            PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64vProc = nullptr;
 #endif
+            PFNGLGETINTEGER64VPROC glGetInteger64vProc = nullptr;
 
             PFNGLCREATESHADERPROC glCreateShaderProc = nullptr;
             PFNGLDELETESHADERPROC glDeleteShaderProc = nullptr;
@@ -171,6 +182,9 @@ namespace ouzel
             PFNGLGETPROGRAMIVPROC glGetProgramivProc = nullptr;
             PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLogProc = nullptr;
             PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocationProc = nullptr;
+            PFNGLPROGRAMPARAMETERIPROC glProgramParameteriProc = nullptr;
+            PFNGLGETPROGRAMBINARYPROC glGetProgramBinaryProc = nullptr;
+            PFNGLPROGRAMBINARYPROC glProgramBinaryProc = nullptr;
 
             PFNGLBINDBUFFERPROC glBindBufferProc = nullptr;
             PFNGLDELETEBUFFERSPROC glDeleteBuffersProc = nullptr;
@@ -193,6 +207,9 @@ namespace ouzel
 
             inline bool isTextureBaseLevelSupported() const { return textureBaseLevelSupported; }
             inline bool isTextureMaxLevelSupported() const { return textureMaxLevelSupported; }
+            inline bool isProgramBinarySupported() const { return programBinarySupported; }
+            // identifies the driver that produced the program binaries
+            inline const std::string& getDriverId() const { return driverId; }
 
             inline void setFrontFace(GLenum mode)
             {
@@ -636,6 +653,10 @@ namespace ouzel
             virtual void present();
             void generateScreenshot(const std::string& filename) override;
             void setUniform(GLint location, DataType dataType, const void* data);
+            GLuint createQuery();
+            void pushTimerQuery(const std::string& name);
+            void popTimerQuery();
+            void readTimerQueries();
 
             GLuint frameBufferId = 0;
             GLsizei frameBufferWidth = 0;
@@ -645,6 +666,23 @@ namespace ouzel
             bool textureBaseLevelSupported = false;
             bool textureMaxLevelSupported = false;
             bool uintElementIndexSupported = false;
+            bool timerQueriesSupported = false;
+            bool programBinarySupported = false;
+            std::string driverId;
+
+            struct TimerQuery final
+            {
+                const char* name = nullptr;
+                uint32_t depth = 0;
+                GLuint startQuery = 0;
+                GLuint endQuery = 0;
+            };
+
+            std::vector<TimerQuery> timerQueryStack;
+            std::vector<TimerQuery> pendingTimerQueries;
+            std::vector<GLuint> freeQueries;
+            uint32_t gpuTrack = 0;
+            int64_t gpuTimeOffset = 0; // difference between the profiler time and the GPU timestamp
 
             struct StateCache
             {
@@ -6,6 +6,9 @@
 
 #include "OGLShader.hpp"
 #include "OGLRenderDevice.hpp"
+#include "core/Engine.hpp"
+#include "utils/Log.hpp"
+#include "utils/Utils.hpp"
 
 namespace ouzel
 {
@@ -80,6 +83,68 @@ namespace ouzel
         }
 
         void OGLShader::compileShader()
+        {
+            const std::string cacheFilename = renderDevice.isProgramBinarySupported() ? getCacheFilename() : std::string();
+
+            if (cacheFilename.empty() || !loadProgramBinary(cacheFilename))
+            {
+                linkProgram();
+                if (!cacheFilename.empty()) saveProgramBinary(cacheFilename);
+            }
+
+            GLenum error;
+
+            renderDevice.useProgram(programId);
+
+            GLint texture0Location = renderDevice.glGetUniformLocationProc(programId, "texture0");
+            if (texture0Location != -1) renderDevice.glUniform1iProc(texture0Location, 0);
+
+            GLint texture1Location = renderDevice.glGetUniformLocationProc(programId, "texture1");
+            if (texture1Location != -1) renderDevice.glUniform1iProc(texture1Location, 1);
+
+            if ((error = renderDevice.glGetErrorProc()) != GL_NO_ERROR)
+                throw std::system_error(makeErrorCode(error), "Failed to get uniform location");
+
+            if (!fragmentShaderConstantInfo.empty())
+            {
+                fragmentShaderConstantLocations.clear();
+                fragmentShaderConstantLocations.reserve(fragmentShaderConstantInfo.size());
+
+                for (const Shader::ConstantInfo& info : fragmentShaderConstantInfo)
+                {
+                    GLint location = renderDevice.glGetUniformLocationProc(programId, info.name.c_str());
+
+                    if ((error = renderDevice.glGetErrorProc()) != GL_NO_ERROR)
+                        throw std::system_error(makeErrorCode(error), "Failed to get OpenGL uniform location");
+
+                    if (location == -1)
+                        throw std::runtime_error("Failed to get OpenGL uniform location");
+
+                    fragmentShaderConstantLocations.push_back({location, info.dataType});
+                }
+            }
+
+            if (!vertexShaderConstantInfo.empty())
+            {
+                vertexShaderConstantLocations.clear();
+                vertexShaderConstantLocations.reserve(vertexShaderConstantInfo.size());
+
+                for (const Shader::ConstantInfo& info : vertexShaderConstantInfo)
+                {
+                    GLint location = renderDevice.glGetUniformLocationProc(programId, info.name.c_str());
+
+                    if ((error = renderDevice.glGetErrorProc()) != GL_NO_ERROR)
+                        throw std::system_error(makeErrorCode(error), "Failed to get OpenGL uniform location");
+
+                    if (location == -1)
+                        throw std::runtime_error("Failed to get OpenGL uniform location");
+
+                    vertexShaderConstantLocations.push_back({location, info.dataType});
+                }
+            }
+        }
+
+        void OGLShader::linkProgram()
         {
             fragmentShaderId = renderDevice.glCreateShaderProc(GL_FRAGMENT_SHADER);
 
@@ -168,6 +233,9 @@ namespace ouzel
                 }
             }
 
+            if (renderDevice.isProgramBinarySupported())
+                renderDevice.glProgramParameteriProc(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
             renderDevice.glLinkProgramProc(programId);
 
             renderDevice.glGetProgramivProc(programId, GL_LINK_STATUS, &status);
@@ -187,54 +255,97 @@ namespace ouzel
 
             if ((error = renderDevice.glGetErrorProc()) != GL_NO_ERROR)
                 throw std::system_error(makeErrorCode(error), "Failed to detach shader");
+        }
 
-            renderDevice.useProgram(programId);
+        std::string OGLShader::getCacheFilename() const
+        {
+            uint64_t hash = fnv1aHash(renderDevice.getDriverId().data(), renderDevice.getDriverId().size());
+            hash = fnv1aHash(fragmentShaderData.data(), fragmentShaderData.size(), hash);
+            hash = fnv1aHash(vertexShaderData.data(), vertexShaderData.size(), hash);
 
-            GLint texture0Location = renderDevice.glGetUniformLocationProc(programId, "texture0");
-            if (texture0Location != -1) renderDevice.glUniform1iProc(texture0Location, 0);
+            for (Vertex::Attribute::Usage usage : vertexAttributes)
+            {
+                const uint32_t value = static_cast<uint32_t>(usage);
+                hash = fnv1aHash(&value, sizeof(value), hash);
+            }
 
-            GLint texture1Location = renderDevice.glGetUniformLocationProc(programId, "texture1");
-            if (texture1Location != -1) renderDevice.glUniform1iProc(texture1Location, 1);
+            return engine->getFileSystem().getStorageDirectory() + storage::FileSystem::DIRECTORY_SEPARATOR +
+                "shader" + hexToString(hash, 16) + ".bin";
+        }
 
-            if ((error = renderDevice.glGetErrorProc()) != GL_NO_ERROR)
-                throw std::system_error(makeErrorCode(error), "Failed to get uniform location");
+        bool OGLShader::loadProgramBinary(const std::string& filename)
+        {
+            storage::FileSystem& fileSystem = engine->getFileSystem();
 
-            if (!fragmentShaderConstantInfo.empty())
+            if (!fileSystem.fileExists(filename)) return false;
+
+            storage::MappedFile data;
+
+            try
             {
-                fragmentShaderConstantLocations.clear();
-                fragmentShaderConstantLocations.reserve(fragmentShaderConstantInfo.size());
+                data = fileSystem.mapFile(filename, false);
+            }
+            catch (const std::exception& e)
+            {
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to read program binary: " << e.what();
+                return false;
+            }
 
-                for (const Shader::ConstantInfo& info : fragmentShaderConstantInfo)
-                {
-                    GLint location = renderDevice.glGetUniformLocationProc(programId, info.name.c_str());
+            // the first four bytes hold the binary format
+            if (data.size() <= sizeof(uint32_t)) return false;
 
-                    if ((error = renderDevice.glGetErrorProc()) != GL_NO_ERROR)
-                        throw std::system_error(makeErrorCode(error), "Failed to get OpenGL uniform location");
+            const GLenum binaryFormat = static_cast<GLenum>(decodeLittleEndian<uint32_t>(data.data()));
 
-                    if (location == -1)
-                        throw std::runtime_error("Failed to get OpenGL uniform location");
+            programId = renderDevice.glCreateProgramProc();
+            renderDevice.glProgramBinaryProc(programId, binaryFormat,
+                                             data.data() + sizeof(uint32_t),
+                                             static_cast<GLsizei>(data.size() - sizeof(uint32_t)));
 
-                    fragmentShaderConstantLocations.push_back({location, info.dataType});
-                }
-            }
+            GLint status;
+            renderDevice.glGetProgramivProc(programId, GL_LINK_STATUS, &status);
 
-            if (!vertexShaderConstantInfo.empty())
+            // the driver rejects binaries that were produced by a different driver version
+            if (renderDevice.glGetErrorProc() != GL_NO_ERROR || status == GL_FALSE)
             {
-                vertexShaderConstantLocations.clear();
-                vertexShaderConstantLocations.reserve(vertexShaderConstantInfo.size());
+                renderDevice.deleteProgram(programId);
+                programId = 0;
+                return false;
+            }
 
-                for (const Shader::ConstantInfo& info : vertexShaderConstantInfo)
-                {
-                    GLint location = renderDevice.glGetUniformLocationProc(programId, info.name.c_str());
+            return true;
+        }
 
-                    if ((error = renderDevice.glGetErrorProc()) != GL_NO_ERROR)
-                        throw std::system_error(makeErrorCode(error), "Failed to get OpenGL uniform location");
+        void OGLShader::saveProgramBinary(const std::string& filename)
+        {
+            GLint length = 0;
+            renderDevice.glGetProgramivProc(programId, GL_PROGRAM_BINARY_LENGTH, &length);
 
-                    if (location == -1)
-                        throw std::runtime_error("Failed to get OpenGL uniform location");
+            GLenum error;
 
-                    vertexShaderConstantLocations.push_back({location, info.dataType});
-                }
+            if ((error = renderDevice.glGetErrorProc()) != GL_NO_ERROR || length <= 0)
+                return;
+
+            std::vector<uint8_t> data(sizeof(uint32_t) + static_cast<size_t>(length));
+            GLsizei written = 0;
+            GLenum binaryFormat = 0;
+            renderDevice.glGetProgramBinaryProc(programId, length, &written, &binaryFormat, data.data() + sizeof(uint32_t));
+
+            if ((error = renderDevice.glGetErrorProc()) != GL_NO_ERROR)
+            {
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to get program binary, error: " + std::to_string(error);
+                return;
+            }
+
+            encodeLittleEndian<uint32_t>(data.data(), static_cast<uint32_t>(binaryFormat));
+            data.resize(sizeof(uint32_t) + static_cast<size_t>(written));
+
+            try
+            {
+                engine->getFileSystem().writeFile(filename, data);
+            }
+            catch (const std::exception& e)
+            {
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to save program binary: " << e.what();
             }
         }
     } // namespace graphics
@@ -60,6 +60,10 @@ namespace ouzel
 
         private:
             void compileShader();
+            void linkProgram();
+            std::string getCacheFilename() const;
+            bool loadProgramBinary(const std::string& filename);
+            void saveProgramBinary(const std::string& filename);
             std::string getShaderMessage(GLuint shaderId);
             std::string getProgramMessage();
 
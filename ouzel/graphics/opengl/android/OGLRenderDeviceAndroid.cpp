@@ -148,7 +148,7 @@ namespace ouzel
                 {
                     apiMajorVersion = version;
                     apiMinorVersion = 0;
-                    engine->log(Log::Level::INFO) << "EGL OpenGL ES " << version << " context created";
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "EGL OpenGL ES " << version << " context created";
                     break;
                 }
             }
@@ -255,7 +255,7 @@ namespace ouzel
                 {
                     apiMajorVersion = version;
                     apiMinorVersion = 0;
-                    engine->log(Log::Level::INFO) << "EGL OpenGL ES " << version << " context created";
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "EGL OpenGL ES " << version << " context created";
                     break;
                 }
             }
@@ -316,10 +316,10 @@ namespace ouzel
             if (context)
             {
                 if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT))
-                    engine->log(Log::Level::ERR) << "Failed to unset EGL context";
+                    OUZEL_LOG(*engine, Log::Level::ERR) << "Failed to unset EGL context";
 
                 if (!eglDestroyContext(display, context))
-                    engine->log(Log::Level::ERR) << "Failed to destroy EGL context";
+                    OUZEL_LOG(*engine, Log::Level::ERR) << "Failed to destroy EGL context";
 
                 context = nullptr;
             }
@@ -327,7 +327,7 @@ namespace ouzel
             if (surface)
             {
                 if (!eglDestroySurface(display, surface))
-                    engine->log(Log::Level::ERR) << "Failed to destroy EGL surface";
+                    OUZEL_LOG(*engine, Log::Level::ERR) << "Failed to destroy EGL surface";
 
                 surface = nullptr;
             }
@@ -357,7 +357,7 @@ namespace ouzel
                 }
                 catch (const std::exception& e)
                 {
-                    engine->log(Log::Level::ERR) << e.what();
+                    OUZEL_LOG(*engine, Log::Level::ERR) << e.what();
                 }
             }
         }
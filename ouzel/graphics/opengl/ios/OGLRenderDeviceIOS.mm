@@ -81,7 +81,7 @@ namespace ouzel
             {
                 apiMajorVersion = 3;
                 apiMinorVersion = 0;
-                engine->log(Log::Level::INFO) << "EAGL OpenGL ES 3 context created";
+                OUZEL_LOG(*engine, Log::Level::INFO) << "EAGL OpenGL ES 3 context created";
             }
             else
             {
@@ -92,7 +92,7 @@ namespace ouzel
 
                 apiMajorVersion = 2;
                 apiMinorVersion = 0;
-                engine->log(Log::Level::INFO) << "EAGL OpenGL ES 2 context created";
+                OUZEL_LOG(*engine, Log::Level::INFO) << "EAGL OpenGL ES 2 context created";
             }
 
             if (![EAGLContext setCurrentContext:context])
@@ -116,7 +116,7 @@ namespace ouzel
             if (!glXQueryVersion(engineLinux->getDisplay(), &glxMajor, &glxMinor))
                 throw std::runtime_error("Failed to get GLX version");
 
-            engine->log(Log::Level::ALL) << "GLX version: " << glxMajor << "." << glxMinor;
+            OUZEL_LOG(*engine, Log::Level::ALL) << "GLX version: " << glxMajor << "." << glxMinor;
 
             Screen* screen = XDefaultScreenOfDisplay(engineLinux->getDisplay());
             int screenIndex = XScreenNumberOfScreen(screen);
@@ -132,7 +132,7 @@ namespace ouzel
             if (const char* extensionsPtr = glXQueryExtensionsString(engineLinux->getDisplay(), screenIndex))
                 extensions = explodeString(reinterpret_cast<const char*>(extensionsPtr), ' ');
 
-            engine->log(Log::Level::ALL) << "Supported GLX extensions: " << extensions;
+            OUZEL_LOG(*engine, Log::Level::ALL) << "Supported GLX extensions: " << extensions;
 
             glXMakeCurrent(engineLinux->getDisplay(), None, nullptr);
             glXDestroyContext(engineLinux->getDisplay(), tempContext);
@@ -194,7 +194,7 @@ namespace ouzel
                     {
                         apiMajorVersion = 3;
                         apiMinorVersion = 2;
-                        engine->log(Log::Level::INFO) << "GLX OpenGL 3.2 context created";
+                        OUZEL_LOG(*engine, Log::Level::INFO) << "GLX OpenGL 3.2 context created";
                     }
                 }
             }
@@ -207,7 +207,7 @@ namespace ouzel
                 {
                     apiMajorVersion = 2;
                     apiMinorVersion = 0;
-                    engine->log(Log::Level::INFO) << "GLX OpenGL 2 context created";
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "GLX OpenGL 2 context created";
                 }
                 else
                     throw std::runtime_error("Failed to create GLX context");
@@ -274,7 +274,7 @@ namespace ouzel
                 {
                     apiMajorVersion = version;
                     apiMinorVersion = 0;
-                    engine->log(Log::Level::INFO) << "EGL OpenGL ES " << version << " context created";
+                    OUZEL_LOG(*engine, Log::Level::INFO) << "EGL OpenGL ES " << version << " context created";
                     break;
                 }
             }
@@ -368,7 +368,7 @@ namespace ouzel
                 }
                 catch (const std::exception& e)
                 {
-                    engine->log(Log::Level::ERR) << e.what();
+                    OUZEL_LOG(*engine, Log::Level::ERR) << e.what();
                 }
             }
 
@@ -115,17 +115,17 @@ namespace ouzel
                         case NSOpenGLProfileVersionLegacy:
                             apiMajorVersion = 2;
                             apiMinorVersion = 0;
-                            engine->log(Log::Level::INFO) << "OpenGL 2 pixel format created";
+                            OUZEL_LOG(*engine, Log::Level::INFO) << "OpenGL 2 pixel format created";
                             break;
                         case NSOpenGLProfileVersion3_2Core:
                             apiMajorVersion = 3;
                             apiMinorVersion = 2;
-                            engine->log(Log::Level::INFO) << "OpenGL 3.2 pixel format created";
+                            OUZEL_LOG(*engine, Log::Level::INFO) << "OpenGL 3.2 pixel format created";
                             break;
                         case NSOpenGLProfileVersion4_1Core:
                             apiMajorVersion = 4;
                             apiMinorVersion = 1;
-                            engine->log(Log::Level::INFO) << "OpenGL 4.1 pixel format created";
+                            OUZEL_LOG(*engine, Log::Level::INFO) << "OpenGL 4.1 pixel format created";
                             break;
                     }
                     break;
@@ -175,7 +175,7 @@ namespace ouzel
                 if (const char* extensionsPtr = wglGetExtensionsStringProc(deviceContext))
                     extensions = explodeString(reinterpret_cast<const char*>(extensionsPtr), ' ');
 
-                engine->log(Log::Level::ALL) << "Supported WGL extensions: " << extensions;
+                OUZEL_LOG(*engine, Log::Level::ALL) << "Supported WGL extensions: " << extensions;
             }
 
             PFNWGLCHOOSEPIXELFORMATARBPROC wglChoosePixelFormatProc = nullptr;
@@ -272,7 +272,7 @@ namespace ouzel
 
                     if (renderContext)
                     {
-                        engine->log(Log::Level::INFO) << "OpenGL " << openGLVersion << " context created";
+                        OUZEL_LOG(*engine, Log::Level::INFO) << "OpenGL " << openGLVersion << " context created";
                         break;
                     }
                 }
@@ -324,7 +324,7 @@ namespace ouzel
                 }
                 catch (const std::exception& e)
                 {
-                    engine->log(Log::Level::ERR) << e.what();
+                    OUZEL_LOG(*engine, Log::Level::ERR) << e.what();
                 }
             }
         }
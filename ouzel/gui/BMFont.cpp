@@ -353,6 +353,9 @@ namespace ouzel
                         skipLine(data, iterator);
                 }
             }
+
+            size = chars.size() * (sizeof(uint32_t) + sizeof(CharDescriptor)) +
+                kern.size() * (sizeof(std::pair<uint32_t, uint32_t>) + sizeof(int16_t));
         }
 
         void BMFont::getVertices(const std::string& text,
@@ -3,6 +3,7 @@
 #ifndef OUZEL_GUI_FONT_HPP
 #define OUZEL_GUI_FONT_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <map>
@@ -36,6 +37,12 @@ namespace ouzel
                                      std::vector<uint16_t>& indices,
                                      std::vector<graphics::Vertex>& vertices,
                                      std::shared_ptr<graphics::Texture>& texture) = 0;
+
+            // approximate memory used by the font data in bytes, not counting the textures from the cache
+            inline size_t getSize() const { return size; }
+
+        protected:
+            size_t size = 0;
         };
     } // namespace gui
 } // namespace ouzel
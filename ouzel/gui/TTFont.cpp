@@ -28,6 +28,7 @@ namespace ouzel
                 throw std::runtime_error("Failed to load font");
 
             loaded = true;
+            size = data.size();
         }
 
         void TTFont::getVertices(const std::string& text,
@@ -51,7 +51,7 @@ namespace ouzel
         void Cursor::init(const std::string& filename, const Vector2F& hotSpot)
         {
             // TODO: load with asset loader
-            std::vector<uint8_t> data = engine->getFileSystem().readFile(filename);
+            storage::MappedFile data = engine->getFileSystem().mapFile(filename);
 
             int width;
             int height;
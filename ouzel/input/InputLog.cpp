@@ -0,0 +1,240 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <cstring>
+#include <stdexcept>
+#include "InputLog.hpp"
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace input
+    {
+        InputLog::Writer::Writer()
+        {
+            write<uint32_t>(MAGIC);
+            write<uint32_t>(VERSION);
+        }
+
+        void InputLog::Writer::writeFrame(uint64_t time, float delta)
+        {
+            write<uint8_t>(static_cast<uint8_t>(Record::FRAME));
+            write<uint64_t>(time);
+            writeFloat(delta);
+        }
+
+        // only the fields that InputManager::handleEvent uses are stored
+        void InputLog::Writer::writeEvent(uint64_t time, const InputSystem::Event& event)
+        {
+            using Event = InputSystem::Event;
+
+            write<uint8_t>(static_cast<uint8_t>(Record::EVENT));
+            write<uint64_t>(time);
+            write<uint8_t>(static_cast<uint8_t>(event.type));
+            write<uint32_t>(event.deviceId);
+
+            switch (event.type)
+            {
+                case Event::Type::DEVICE_CONNECT:
+                    write<uint8_t>(static_cast<uint8_t>(event.deviceType));
+                    write<uint8_t>(event.screen ? 1 : 0);
+                    break;
+                case Event::Type::DEVICE_DISCONNECT:
+                case Event::Type::DEVICE_DISCOVERY_COMPLETE:
+                    break;
+                case Event::Type::GAMEPAD_BUTTON_CHANGE:
+                    write<uint32_t>(static_cast<uint32_t>(event.gamepadButton));
+                    write<uint8_t>(event.pressed ? 1 : 0);
+                    writeFloat(event.value);
+                    break;
+                case Event::Type::KEY_PRESS:
+                case Event::Type::KEY_RELEASE:
+                    write<uint32_t>(static_cast<uint32_t>(event.keyboardKey));
+                    break;
+                case Event::Type::MOUSE_PRESS:
+                case Event::Type::MOUSE_RELEASE:
+                    write<uint32_t>(static_cast<uint32_t>(event.mouseButton));
+                    writeVector(event.position);
+                    break;
+                case Event::Type::MOUSE_SCROLL:
+                    writeVector(event.scroll);
+                    writeVector(event.position);
+                    break;
+                case Event::Type::MOUSE_MOVE:
+                case Event::Type::MOUSE_RELATIVE_MOVE:
+                    writeVector(event.position);
+                    break;
+                case Event::Type::MOUSE_LOCK_CHANGED:
+                    write<uint8_t>(event.locked ? 1 : 0);
+                    break;
+                case Event::Type::TOUCH_BEGIN:
+                case Event::Type::TOUCH_MOVE:
+                case Event::Type::TOUCH_END:
+                case Event::Type::TOUCH_CANCEL:
+                    write<uint64_t>(event.touchId);
+                    writeVector(event.position);
+                    writeFloat(event.force);
+                    break;
+            }
+        }
+
+        template<class T>
+        void InputLog::Writer::write(T value)
+        {
+            const size_t offset = data.size();
+            data.resize(offset + sizeof(T));
+            encodeLittleEndian<T>(data.data() + offset, value);
+        }
+
+        void InputLog::Writer::writeFloat(float value)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            write<uint32_t>(bits);
+        }
+
+        void InputLog::Writer::writeVector(const Vector2F& value)
+        {
+            writeFloat(value.v[0]);
+            writeFloat(value.v[1]);
+        }
+
+        InputLog::Reader::Reader(const std::vector<uint8_t>& initData):
+            data(initData)
+        {
+            if (read<uint32_t>() != MAGIC)
+                throw std::runtime_error("Invalid input log");
+
+            if (read<uint32_t>() != VERSION)
+                throw std::runtime_error("Unsupported input log version");
+
+            const size_t start = offset;
+
+            while (!isEnd())
+            {
+                switch (getRecord())
+                {
+                    case Record::FRAME: readFrame(); break;
+                    case Record::EVENT: readEvent(); break;
+                    default: throw std::runtime_error("Invalid input log record");
+                }
+            }
+
+            offset = start;
+        }
+
+        float InputLog::Reader::readFrame()
+        {
+            if (isEnd() || getRecord() != Record::FRAME)
+                throw std::runtime_error("Expected a frame record");
+
+            read<uint8_t>();
+            read<uint64_t>(); // time
+            return readFloat();
+        }
+
+        InputSystem::Event InputLog::Reader::readEvent()
+        {
+            if (isEnd() || getRecord() != Record::EVENT)
+                throw std::runtime_error("Expected an event record");
+
+            read<uint8_t>();
+            read<uint64_t>(); // time
+            return readEventData();
+        }
+
+        const uint8_t* InputLog::Reader::readBytes(size_t size)
+        {
+            if (data.size() - offset < size)
+                throw std::runtime_error("Input log is truncated");
+
+            const uint8_t* result = data.data() + offset;
+            offset += size;
+            return result;
+        }
+
+        template<class T>
+        T InputLog::Reader::read()
+        {
+            return decodeLittleEndian<T>(readBytes(sizeof(T)));
+        }
+
+        float InputLog::Reader::readFloat()
+        {
+            uint32_t bits = read<uint32_t>();
+            float result;
+            std::memcpy(&result, &bits, sizeof(result));
+            return result;
+        }
+
+        Vector2F InputLog::Reader::readVector()
+        {
+            float x = readFloat();
+            float y = readFloat();
+            return Vector2F(x, y);
+        }
+
+        InputSystem::Event InputLog::Reader::readEventData()
+        {
+            using Event = InputSystem::Event;
+
+            uint8_t type = read<uint8_t>();
+            if (type > static_cast<uint8_t>(Event::Type::TOUCH_CANCEL))
+                throw std::runtime_error("Invalid input log event type");
+
+            Event event(static_cast<Event::Type>(type));
+            event.deviceId = read<uint32_t>();
+
+            switch (event.type)
+            {
+                case Event::Type::DEVICE_CONNECT:
+                {
+                    uint8_t deviceType = read<uint8_t>();
+                    if (deviceType > static_cast<uint8_t>(Controller::Type::GAMEPAD))
+                        throw std::runtime_error("Invalid input log device type");
+
+                    event.deviceType = static_cast<Controller::Type>(deviceType);
+                    event.screen = read<uint8_t>() != 0;
+                    break;
+                }
+                case Event::Type::DEVICE_DISCONNECT:
+                case Event::Type::DEVICE_DISCOVERY_COMPLETE:
+                    break;
+                case Event::Type::GAMEPAD_BUTTON_CHANGE:
+                    event.gamepadButton = static_cast<Gamepad::Button>(read<uint32_t>());
+                    event.pressed = read<uint8_t>() != 0;
+                    event.value = readFloat();
+                    break;
+                case Event::Type::KEY_PRESS:
+                case Event::Type::KEY_RELEASE:
+                    event.keyboardKey = static_cast<Keyboard::Key>(read<uint32_t>());
+                    break;
+                case Event::Type::MOUSE_PRESS:
+                case Event::Type::MOUSE_RELEASE:
+                    event.mouseButton = static_cast<Mouse::Button>(read<uint32_t>());
+                    event.position = readVector();
+                    break;
+                case Event::Type::MOUSE_SCROLL:
+                    event.scroll = readVector();
+                    event.position = readVector();
+                    break;
+                case Event::Type::MOUSE_MOVE:
+                case Event::Type::MOUSE_RELATIVE_MOVE:
+                    event.position = readVector();
+                    break;
+                case Event::Type::MOUSE_LOCK_CHANGED:
+                    event.locked = read<uint8_t>() != 0;
+                    break;
+                case Event::Type::TOUCH_BEGIN:
+                case Event::Type::TOUCH_MOVE:
+                case Event::Type::TOUCH_END:
+                case Event::Type::TOUCH_CANCEL:
+                    event.touchId = read<uint64_t>();
+                    event.position = readVector();
+                    event.force = readFloat();
+                    break;
+            }
+
+            return event;
+        }
+    } // namespace input
+} // namespace ouzel
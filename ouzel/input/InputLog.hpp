@@ -0,0 +1,77 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_INPUT_INPUTLOG_HPP
+#define OUZEL_INPUT_INPUTLOG_HPP
+
+#include <cstdint>
+#include <vector>
+#include "input/InputSystem.hpp"
+#include "math/Vector.hpp"
+
+namespace ouzel
+{
+    namespace input
+    {
+        // Binary log of the dispatched input events and the time step of every frame
+        //
+        // Layout (all values are little endian):
+        // header: magic, version (2 x uint32)
+        // records: record type (uint8), time since the start of the recording in microseconds (uint64), then
+        //          the time step (float) of a frame record or the fields that InputManager::handleEvent uses of an event record
+        class InputLog final
+        {
+        public:
+            static constexpr uint32_t MAGIC = 0x504E494F; // "OINP"
+            static constexpr uint32_t VERSION = 1;
+
+            enum class Record: uint8_t
+            {
+                FRAME = 0,
+                EVENT = 1
+            };
+
+            class Writer final
+            {
+            public:
+                Writer();
+
+                void writeFrame(uint64_t time, float delta);
+                void writeEvent(uint64_t time, const InputSystem::Event& event);
+
+                inline const std::vector<uint8_t>& getData() const { return data; }
+
+            private:
+                template<class T> void write(T value);
+                void writeFloat(float value);
+                void writeVector(const Vector2F& value);
+
+                std::vector<uint8_t> data;
+            };
+
+            class Reader final
+            {
+            public:
+                // the whole log is validated, so that reading can't fail halfway
+                explicit Reader(const std::vector<uint8_t>& initData);
+
+                inline bool isEnd() const { return offset >= data.size(); }
+                inline Record getRecord() const { return static_cast<Record>(data[offset]); }
+
+                float readFrame();
+                InputSystem::Event readEvent();
+
+            private:
+                const uint8_t* readBytes(size_t size);
+                template<class T> T read();
+                float readFloat();
+                Vector2F readVector();
+                InputSystem::Event readEventData();
+
+                std::vector<uint8_t> data;
+                size_t offset = 0;
+            };
+        };
+    } // namespace input
+} // namespace ouzel
+
+#endif // OUZEL_INPUT_INPUTLOG_HPP
@@ -4,6 +4,7 @@
 #  include <TargetConditionals.h>
 #endif
 #include <algorithm>
+#include <stdexcept>
 #include "InputManager.hpp"
 #include "Gamepad.hpp"
 #include "Keyboard.hpp"
@@ -43,7 +44,9 @@ namespace ouzel
 #elif defined(__ANDROID__)
             inputSystem(new InputSystemAndroid(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
 #elif defined(__linux__)
-            inputSystem(new InputSystemLinux(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
+            inputSystem(engine->isHeadless() ?
+                        new InputSystem(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)) :
+                        new InputSystemLinux(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
 #elif defined(_WIN32)
             inputSystem(new InputSystemWin(std::bind(&InputManager::eventCallback, this, std::placeholders::_1)))
 #elif defined(__EMSCRIPTEN__)
@@ -58,29 +61,244 @@ namespace ouzel
         {
             std::pair<std::promise<bool>, InputSystem::Event> p;
 
+            std::unique_lock<std::mutex> lock(eventQueueMutex);
+            moveHistory.clear();
+            std::swap(moveHistory, pendingMoveHistory);
+            lock.unlock();
+
             for (;;)
             {
-                std::unique_lock<std::mutex> lock(eventQueueMutex);
+                lock.lock();
                 if (eventQueue.empty()) break;
 
                 p = std::move(eventQueue.front());
-                eventQueue.pop();
+                eventQueue.pop_front();
+                ++firstEventIndex;
+
+                // the rest of the moves will start new events
+                if (eventQueue.empty()) lastMoveEvents.clear();
                 lock.unlock();
 
+                // during the replay only the device list is kept up to date
+                if (replayLog &&
+                    p.second.type != InputSystem::Event::Type::DEVICE_CONNECT &&
+                    p.second.type != InputSystem::Event::Type::DEVICE_DISCONNECT &&
+                    p.second.type != InputSystem::Event::Type::DEVICE_DISCOVERY_COMPLETE)
+                {
+                    p.first.set_value(false);
+                    continue;
+                }
+
+                if (recordedLog) recordEvent(p.second);
                 p.first.set_value(handleEvent(p.second));
             }
+
+            if (replayLog) replayEvents();
         }
 
-        std::future<bool> InputManager::eventCallback(const InputSystem::Event& event)
+        void InputManager::startRecording()
         {
-            std::pair<std::promise<bool>, InputSystem::Event> p(std::promise<bool>(), event);
-            std::future<bool> f = p.first.get_future();
+            recordingStartTime = std::chrono::steady_clock::now();
+            recordedLog.reset(new InputLog::Writer());
+
+            // the devices that are already connected are recorded as connected at the start
+            for (Controller* controller : controllers)
+            {
+                InputSystem::Event event(InputSystem::Event::Type::DEVICE_CONNECT);
+                event.deviceType = controller->getType();
+                event.deviceId = controller->getDeviceId();
+                if (controller->getType() == Controller::Type::TOUCHPAD)
+                    event.screen = static_cast<Touchpad*>(controller)->isScreen();
+
+                recordEvent(event);
+            }
+        }
+
+        std::vector<uint8_t> InputManager::stopRecording()
+        {
+            if (!recordedLog) return std::vector<uint8_t>();
+
+            std::vector<uint8_t> result = recordedLog->getData();
+            recordedLog.reset();
+            return result;
+        }
+
+        void InputManager::recordFrame(float delta)
+        {
+            if (!recordedLog) return;
+
+            auto time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - recordingStartTime);
+            recordedLog->writeFrame(static_cast<uint64_t>(time.count()), delta);
+        }
+
+        void InputManager::recordEvent(const InputSystem::Event& event)
+        {
+            auto time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - recordingStartTime);
+            recordedLog->writeEvent(static_cast<uint64_t>(time.count()), event);
+        }
+
+        void InputManager::startReplay(const std::vector<uint8_t>& log)
+        {
+            std::unique_ptr<InputLog::Reader> reader(new InputLog::Reader(log));
+
+            if (replayLog) stopReplay();
+
+            replayLog = std::move(reader);
+        }
+
+        void InputManager::stopReplay()
+        {
+            if (!replayLog) return;
+
+            replayLog.reset();
+
+            // disconnect the devices that were created by the replay
+            for (const auto& i : replayDeviceIds)
+            {
+                InputSystem::Event event(InputSystem::Event::Type::DEVICE_DISCONNECT);
+                event.deviceId = i.second;
+                handleEvent(event);
+            }
+
+            replayDeviceIds.clear();
+        }
+
+        bool InputManager::replayFrame(float& delta)
+        {
+            if (!replayLog) return false;
+
+            replayEvents(); // events recorded before the first frame
+
+            if (replayLog->isEnd())
+            {
+                stopReplay();
+                return false;
+            }
+
+            delta = replayLog->readFrame();
+
+            return true;
+        }
+
+        void InputManager::replayEvents()
+        {
+            while (!replayLog->isEnd() &&
+                   replayLog->getRecord() == InputLog::Record::EVENT)
+            {
+                InputSystem::Event event = replayLog->readEvent();
 
+                auto i = replayDeviceIds.find(event.deviceId);
+                if (i != replayDeviceIds.end())
+                {
+                    event.deviceId = i->second;
+                    if (event.type == InputSystem::Event::Type::DEVICE_DISCONNECT)
+                        replayDeviceIds.erase(i);
+                }
+                else if (event.type == InputSystem::Event::Type::DEVICE_CONNECT)
+                {
+                    uint32_t deviceId = ++lastReplayDeviceId;
+                    replayDeviceIds[event.deviceId] = deviceId;
+                    event.deviceId = deviceId;
+                }
+                else if (event.type != InputSystem::Event::Type::DEVICE_DISCOVERY_COMPLETE)
+                    continue; // the device is not known
+
+                handleEvent(event);
+            }
+        }
+
+        bool InputManager::isReplayDevice(uint32_t deviceId) const
+        {
+            for (const auto& i : replayDeviceIds)
+                if (i.second == deviceId) return true;
+
+            return false;
+        }
+
+        Controller* InputManager::findPrimaryController(Controller::Type type) const
+        {
+            Controller* result = nullptr;
+
+            for (Controller* controller : controllers)
+            {
+                if (controller->getType() != type) continue;
+
+                // a live controller doesn't replace a replayed one during the replay
+                if (replayLog && result &&
+                    isReplayDevice(result->getDeviceId()) &&
+                    !isReplayDevice(controller->getDeviceId()))
+                    continue;
+
+                result = controller;
+            }
+
+            return result;
+        }
+
+        void InputManager::setCoalescingEnabled(bool enabled)
+        {
+            std::unique_lock<std::mutex> lock(eventQueueMutex);
+            coalescing = enabled;
+            lastMoveEvents.clear();
+        }
+
+        std::future<bool> InputManager::eventCallback(const InputSystem::Event& event)
+        {
             std::unique_lock<std::mutex> lock(eventQueueMutex);
-            eventQueue.push(std::move(p));
 
-            return f;
-        };
+            if (coalescing)
+            {
+                const uint64_t pointer = (event.type == InputSystem::Event::Type::TOUCH_BEGIN ||
+                                          event.type == InputSystem::Event::Type::TOUCH_MOVE ||
+                                          event.type == InputSystem::Event::Type::TOUCH_END ||
+                                          event.type == InputSystem::Event::Type::TOUCH_CANCEL) ? event.touchId : 0;
+                const std::pair<uint32_t, uint64_t> key(event.deviceId, pointer);
+
+                switch (event.type)
+                {
+                    case InputSystem::Event::Type::MOUSE_MOVE:
+                    case InputSystem::Event::Type::MOUSE_RELATIVE_MOVE:
+                    case InputSystem::Event::Type::TOUCH_MOVE:
+                    {
+                        pendingMoveHistory.push_back(event);
+
+                        auto i = lastMoveEvents.find(key);
+                        if (i != lastMoveEvents.end() && i->second >= firstEventIndex)
+                        {
+                            std::pair<std::promise<bool>, InputSystem::Event>& queued = eventQueue[static_cast<size_t>(i->second - firstEventIndex)];
+
+                            if (queued.second.type == event.type)
+                            {
+                                // the earlier sample is never dispatched on its own
+                                queued.first.set_value(false);
+                                queued.first = std::promise<bool>();
+
+                                if (event.type == InputSystem::Event::Type::MOUSE_RELATIVE_MOVE)
+                                    queued.second.position += event.position; // relative moves carry the difference
+                                else
+                                    queued.second.position = event.position;
+
+                                queued.second.force = event.force;
+
+                                return queued.first.get_future();
+                            }
+                        }
+
+                        lastMoveEvents[key] = firstEventIndex + eventQueue.size();
+                        break;
+                    }
+                    default:
+                        // a merged move is dispatched at the position of its first sample, so merging across any other
+                        // event would reorder them, e.g. a key press would be handled after the motion that followed it
+                        lastMoveEvents.clear();
+                        break;
+                }
+            }
+
+            eventQueue.push_back(std::make_pair(std::promise<bool>(), event));
+
+            return eventQueue.back().first.get_future();
+        }
 
         bool InputManager::handleEvent(const InputSystem::Event& event)
         {
@@ -105,7 +323,7 @@ namespace ouzel
                             std::unique_ptr<KeyboardEvent> connectEvent(new KeyboardEvent());
                             connectEvent->type = Event::Type::KEYBOARD_CONNECT;
                             std::unique_ptr<Keyboard> keyboardController(new Keyboard(*this, event.deviceId));
-                            if (!keyboard) keyboard = keyboardController.get();
+                            if (!keyboard || (replayLog && isReplayDevice(event.deviceId))) keyboard = keyboardController.get();
                             connectEvent->keyboard = keyboardController.get();
                             controllers.push_back(keyboardController.get());
                             controllerMap.insert(std::make_pair(event.deviceId, std::move(keyboardController)));
@@ -117,7 +335,7 @@ namespace ouzel
                             connectEvent->type = Event::Type::MOUSE_CONNECT;
                             std::unique_ptr<Mouse> mouseController(new Mouse(*this, event.deviceId));
                             connectEvent->mouse = mouseController.get();
-                            if (!mouse) mouse = mouseController.get();
+                            if (!mouse || (replayLog && isReplayDevice(event.deviceId))) mouse = mouseController.get();
                             controllers.push_back(mouseController.get());
                             controllerMap.insert(std::make_pair(event.deviceId, std::move(mouseController)));
                             return engine->getEventDispatcher().dispatchEvent(std::move(connectEvent));
@@ -128,7 +346,7 @@ namespace ouzel
                             connectEvent->type = Event::Type::TOUCHPAD_CONNECT;
                             std::unique_ptr<Touchpad> touchpadController(new Touchpad(*this, event.deviceId, event.screen));
                             connectEvent->touchpad = touchpadController.get();
-                            if (!touchpad) touchpad = touchpadController.get();
+                            if (!touchpad || (replayLog && isReplayDevice(event.deviceId))) touchpad = touchpadController.get();
                             controllers.push_back(touchpadController.get());
                             controllerMap.insert(std::make_pair(event.deviceId, std::move(touchpadController)));
                             return engine->getEventDispatcher().dispatchEvent(std::move(connectEvent));
@@ -162,10 +380,7 @@ namespace ouzel
                                 std::unique_ptr<KeyboardEvent> disconnectEvent(new KeyboardEvent());
                                 disconnectEvent->type = Event::Type::KEYBOARD_DISCONNECT;
                                 disconnectEvent->keyboard = static_cast<Keyboard*>(i->second.get());
-                                keyboard = nullptr;
-                                for (Controller* controller : controllers)
-                                    if (controller->getType() == Controller::Type::KEYBOARD)
-                                        keyboard = static_cast<Keyboard*>(controller);
+                                keyboard = static_cast<Keyboard*>(findPrimaryController(Controller::Type::KEYBOARD));
                                 handled = engine->getEventDispatcher().dispatchEvent(std::move(disconnectEvent));
                                 break;
                             }
@@ -174,10 +389,7 @@ namespace ouzel
                                 std::unique_ptr<MouseEvent> disconnectEvent(new MouseEvent());
                                 disconnectEvent->type = Event::Type::MOUSE_DISCONNECT;
                                 disconnectEvent->mouse = static_cast<Mouse*>(i->second.get());
-                                mouse = nullptr;
-                                for (Controller* controller : controllers)
-                                    if (controller->getType() == Controller::Type::MOUSE)
-                                        mouse = static_cast<Mouse*>(controller);
+                                mouse = static_cast<Mouse*>(findPrimaryController(Controller::Type::MOUSE));
                                 handled = engine->getEventDispatcher().dispatchEvent(std::move(disconnectEvent));
                                 break;
                             }
@@ -186,10 +398,7 @@ namespace ouzel
                                 std::unique_ptr<TouchEvent> disconnectEvent(new TouchEvent());
                                 disconnectEvent->type = Event::Type::TOUCHPAD_DISCONNECT;
                                 disconnectEvent->touchpad = static_cast<Touchpad*>(i->second.get());
-                                touchpad = nullptr;
-                                for (Controller* controller : controllers)
-                                    if (controller->getType() == Controller::Type::TOUCHPAD)
-                                        touchpad = static_cast<Touchpad*>(controller);
+                                touchpad = static_cast<Touchpad*>(findPrimaryController(Controller::Type::TOUCHPAD));
                                 handled = engine->getEventDispatcher().dispatchEvent(std::move(disconnectEvent));
                                 break;
                             }
@@ -3,11 +3,14 @@
 #ifndef OUZEL_INPUT_INPUTMANAGER_HPP
 #define OUZEL_INPUT_INPUTMANAGER_HPP
 
+#include <chrono>
+#include <deque>
+#include <map>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <vector>
 #include <unordered_map>
+#include "input/InputLog.hpp"
 #include "input/InputSystem.hpp"
 #include "math/Vector.hpp"
 
@@ -45,12 +48,53 @@ namespace ouzel
             void showVirtualKeyboard();
             void hideVirtualKeyboard();
 
+            // merges consecutive move events of every mouse and touch until the next update,
+            // so that only the last position (with the accumulated difference) is dispatched,
+            // any other event ends the merging, so the moves stay in order with it
+            void setCoalescingEnabled(bool enabled);
+            inline bool isCoalescingEnabled() const { return coalescing; }
+
+            // all move events that were received before the last update, including the merged ones
+            // (recorded only while coalescing is enabled)
+            inline const std::vector<InputSystem::Event>& getMoveHistory() const { return moveHistory; }
+
+            // records the dispatched input events and the time step of every frame into a binary log
+            void startRecording();
+            std::vector<uint8_t> stopRecording();
+            inline bool isRecording() const { return recordedLog != nullptr; }
+            void recordFrame(float delta); // delta is zero for frames without an update event
+
+            // feeds a recorded log back instead of the device input, one recorded frame per update
+            void startReplay(const std::vector<uint8_t>& log);
+            void stopReplay();
+            inline bool isReplaying() const { return replayLog != nullptr; }
+            bool replayFrame(float& delta); // returns false after the end of the log
+
         private:
             std::future<bool> eventCallback(const InputSystem::Event& event);
             bool handleEvent(const InputSystem::Event& event);
+            void recordEvent(const InputSystem::Event& event);
+            void replayEvents();
+
+            bool isReplayDevice(uint32_t deviceId) const;
+            // the last connected controller of the type, replayed controllers take precedence during the replay
+            Controller* findPrimaryController(Controller::Type type) const;
 
             std::mutex eventQueueMutex;
-            std::queue<std::pair<std::promise<bool>, InputSystem::Event>> eventQueue;
+            std::deque<std::pair<std::promise<bool>, InputSystem::Event>> eventQueue;
+
+            bool coalescing = false;
+            uint64_t firstEventIndex = 0; // number of events popped from the queue
+            std::map<std::pair<uint32_t, uint64_t>, uint64_t> lastMoveEvents; // device and pointer to the index of its last move event
+            std::vector<InputSystem::Event> pendingMoveHistory;
+            std::vector<InputSystem::Event> moveHistory;
+
+            std::chrono::steady_clock::time_point recordingStartTime;
+            std::unique_ptr<InputLog::Writer> recordedLog;
+
+            std::unique_ptr<InputLog::Reader> replayLog;
+            uint32_t lastReplayDeviceId = 0x80000000; // replayed devices don't collide with the connected ones
+            std::unordered_map<uint32_t, uint32_t> replayDeviceIds; // recorded device ID to the ID of the replayed device
 
             std::unique_ptr<InputSystem> inputSystem;
             Keyboard* keyboard = nullptr;
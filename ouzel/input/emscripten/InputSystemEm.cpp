@@ -324,7 +324,7 @@ namespace ouzel
             int result = emscripten_get_num_gamepads();
 
             if (result == EMSCRIPTEN_RESULT_NOT_SUPPORTED)
-                engine->log(Log::Level::INFO) << "Gamepads not supported";
+                OUZEL_LOG(*engine, Log::Level::INFO) << "Gamepads not supported";
             else
             {
                 for (long index = 0; index < result; ++index)
@@ -1,11 +1,13 @@
 // Copyright 2015-2019 Elviss Strazdins. All rights reserved.
 
+#include <cerrno>
 #include <system_error>
 #include <unordered_map>
 #include <fcntl.h>
 #include <unistd.h>
 #include <linux/input.h>
 #include "EventDevice.hpp"
+#include "EventReader.hpp"
 #include "InputSystemLinux.hpp"
 #include "input/GamepadConfig.hpp"
 #include "input/KeyboardDevice.hpp"
@@ -19,11 +21,6 @@ static constexpr float THUMB_DEADZONE = 0.2F;
 
 static constexpr uint32_t BITS_PER_LONG = 8 * sizeof(long);
 
-static constexpr size_t bitsToLongs(size_t n)
-{
-    return (n + BITS_PER_LONG - 1) / BITS_PER_LONG; // rounded up
-}
-
 static inline bool isBitSet(const unsigned long* array, int bit)
 {
     return (array[bit / BITS_PER_LONG] & (1LL << (bit % BITS_PER_LONG))) != 0;
@@ -223,28 +220,23 @@ namespace ouzel
         EventDevice::EventDevice(InputSystemLinux& inputSystem, const std::string& initFilename):
             filename(initFilename)
         {
-            fd = open(filename.c_str(), O_RDONLY);
+            fd = open(filename.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
 
             if (fd == -1)
                 throw std::system_error(errno, std::system_category(), "Failed to open device file");
 
             if (ioctl(fd, EVIOCGRAB, 1) == -1)
-                engine->log(Log::Level::WARN) << "Failed to grab device";
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to grab device";
 
             char deviceName[256];
             if (ioctl(fd, EVIOCGNAME(sizeof(deviceName) - 1), deviceName) == -1)
-                engine->log(Log::Level::WARN) << "Failed to get device name";
+                OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to get device name";
             else
             {
                 name = deviceName;
-                engine->log(Log::Level::INFO) << "Got device: " << name;
+                OUZEL_LOG(*engine, Log::Level::INFO) << "Got device: " << name;
             }
 
-            unsigned long eventBits[bitsToLongs(EV_CNT)];
-            unsigned long absBits[bitsToLongs(ABS_CNT)];
-            unsigned long relBits[bitsToLongs(REL_CNT)];
-            unsigned long keyBits[bitsToLongs(KEY_CNT)];
-
             if (ioctl(fd, EVIOCGBIT(0, sizeof(eventBits)), eventBits) == -1 ||
                 ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits) == -1 ||
                 ioctl(fd, EVIOCGBIT(EV_REL, sizeof(relBits)), relBits) == -1 ||
@@ -294,7 +286,8 @@ namespace ouzel
                     touchMaxY = info.maximum;
                     touchRangeY = touchMaxY - touchMinY;
 
-                    if (ioctl(fd, EVIOCGABS(ABS_MT_PRESSURE), &info) != -1)
+                    if (isBitSet(absBits, ABS_MT_PRESSURE) &&
+                        ioctl(fd, EVIOCGABS(ABS_MT_PRESSURE), &info) != -1)
                     {
                         touchMinPressure = info.minimum;
                         touchMaxPressure = info.maximum;
@@ -400,7 +393,7 @@ namespace ouzel
             if (fd != -1)
             {
                 if (ioctl(fd, EVIOCGRAB, 0) == -1)
-                    engine->log(Log::Level::WARN) << "Failed to release device";
+                    OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to release device";
 
                 close(fd);
             }
@@ -408,323 +401,316 @@ namespace ouzel
 
         void EventDevice::update()
         {
-            input_event events[32];
-            ssize_t bytesRead = read(fd, events, sizeof(events));
-
-            if (bytesRead == -1)
-                throw std::system_error(errno, std::system_category(), "Failed to read from " + filename);
-
-            int count = bytesRead / sizeof(input_event);
+            readEvents(fd, [this](const input_event& event) { handleEvent(event); });
+        }
 
-            for (int i = 0; i < count; ++i)
+        void EventDevice::handleEvent(const input_event& event)
+        {
+            if (keyboardDevice)
             {
-                input_event& event = events[i];
-
-                if (keyboardDevice)
+                switch (event.type)
                 {
-                    switch (event.type)
-                    {
-                        case EV_KEY:
-                            if (event.value == 1 || event.value == 2) // press or repeat
-                                keyboardDevice->handleKeyPress(convertKeyCode(event.code));
-                            else if (event.value == 0) // release
-                                keyboardDevice->handleKeyRelease(convertKeyCode(event.code));
-                            break;
-                    }
+                    case EV_KEY:
+                        if (event.value == 1 || event.value == 2) // press or repeat
+                            keyboardDevice->handleKeyPress(convertKeyCode(event.code));
+                        else if (event.value == 0) // release
+                            keyboardDevice->handleKeyRelease(convertKeyCode(event.code));
+                        break;
                 }
-                if (mouseDevice)
+            }
+            if (mouseDevice)
+            {
+                switch (event.type)
                 {
-                    switch (event.type)
+                    case EV_ABS:
                     {
-                        case EV_ABS:
+                        switch (event.code)
                         {
-                            switch (event.code)
-                            {
-                                case ABS_X:
-                                    cursorPosition.x = event.value;
-                                    break;
-                                case ABS_Y:
-                                    cursorPosition.y = event.value;
-                                    break;
-                            }
-
-                            Vector2F normalizedPosition = engine->getWindow()->convertWindowToNormalizedLocation(Vector2F(static_cast<float>(cursorPosition.x),
-                                                                                                                        static_cast<float>(cursorPosition.y)));
-                            mouseDevice->handleMove(normalizedPosition);
-                            break;
+                            case ABS_X:
+                                cursorPosition.x = event.value;
+                                break;
+                            case ABS_Y:
+                                cursorPosition.y = event.value;
+                                break;
                         }
-                        case EV_REL:
+
+                        Vector2F normalizedPosition = engine->getWindow()->convertWindowToNormalizedLocation(Vector2F(static_cast<float>(cursorPosition.x),
+                                                                                                                    static_cast<float>(cursorPosition.y)));
+                        mouseDevice->handleMove(normalizedPosition);
+                        break;
+                    }
+                    case EV_REL:
+                    {
+                        switch (event.code)
                         {
-                            switch (event.code)
+                            case REL_X:
                             {
-                                case REL_X:
-                                {
-                                    Vector2F normalizedPosition = engine->getWindow()->convertWindowToNormalizedLocation(Vector2F(static_cast<float>(event.value), 0.0F));
-                                    mouseDevice->handleRelativeMove(normalizedPosition);
-                                    break;
-                                }
-                                case REL_Y:
-                                {
-                                    Vector2F normalizedPosition = engine->getWindow()->convertWindowToNormalizedLocation(Vector2F(0.0F, static_cast<float>(event.value)));
-                                    mouseDevice->handleRelativeMove(normalizedPosition);
-                                    break;
-                                }
-                                case REL_WHEEL:
-                                {
-                                    Vector2F normalizedPosition = engine->getWindow()->convertWindowToNormalizedLocation(Vector2F(static_cast<float>(cursorPosition.x),
-                                                                                                                                static_cast<float>(cursorPosition.y)));
-                                    mouseDevice->handleScroll(Vector2F(0.0F, static_cast<float>(event.value)), normalizedPosition);
-                                    break;
-                                }
-                                case REL_HWHEEL:
-                                {
-                                    Vector2F normalizedPosition = engine->getWindow()->convertWindowToNormalizedLocation(Vector2F(static_cast<float>(cursorPosition.x),
-                                                                                                                                static_cast<float>(cursorPosition.y)));
-                                    mouseDevice->handleScroll(Vector2F(static_cast<float>(event.value), 0.0F), normalizedPosition);
-                                    break;
-                                }
+                                Vector2F normalizedPosition = engine->getWindow()->convertWindowToNormalizedLocation(Vector2F(static_cast<float>(event.value), 0.0F));
+                                mouseDevice->handleRelativeMove(normalizedPosition);
+                                break;
+                            }
+                            case REL_Y:
+                            {
+                                Vector2F normalizedPosition = engine->getWindow()->convertWindowToNormalizedLocation(Vector2F(0.0F, static_cast<float>(event.value)));
+                                mouseDevice->handleRelativeMove(normalizedPosition);
+                                break;
+                            }
+                            case REL_WHEEL:
+                            {
+                                Vector2F normalizedPosition = engine->getWindow()->convertWindowToNormalizedLocation(Vector2F(static_cast<float>(cursorPosition.x),
+                                                                                                                            static_cast<float>(cursorPosition.y)));
+                                mouseDevice->handleScroll(Vector2F(0.0F, static_cast<float>(event.value)), normalizedPosition);
+                                break;
+                            }
+                            case REL_HWHEEL:
+                            {
+                                Vector2F normalizedPosition = engine->getWindow()->convertWindowToNormalizedLocation(Vector2F(static_cast<float>(cursorPosition.x),
+                                                                                                                            static_cast<float>(cursorPosition.y)));
+                                mouseDevice->handleScroll(Vector2F(static_cast<float>(event.value), 0.0F), normalizedPosition);
+                                break;
                             }
-                            break;
-                        }
-                        case EV_KEY:
-                        {
-                            Vector2F normalizedPosition = engine->getWindow()->convertWindowToNormalizedLocation(Vector2F(static_cast<float>(cursorPosition.x),
-                                                                                                                        static_cast<float>(cursorPosition.y)));
-
-                            if (event.value == 1)
-                                mouseDevice->handleButtonPress(convertButtonCode(event.code), normalizedPosition);
-                            else if (event.value == 0)
-                                mouseDevice->handleButtonRelease(convertButtonCode(event.code), normalizedPosition);
-                            break;
                         }
+                        break;
+                    }
+                    case EV_KEY:
+                    {
+                        Vector2F normalizedPosition = engine->getWindow()->convertWindowToNormalizedLocation(Vector2F(static_cast<float>(cursorPosition.x),
+                                                                                                                    static_cast<float>(cursorPosition.y)));
+
+                        if (event.value == 1)
+                            mouseDevice->handleButtonPress(convertButtonCode(event.code), normalizedPosition);
+                        else if (event.value == 0)
+                            mouseDevice->handleButtonRelease(convertButtonCode(event.code), normalizedPosition);
+                        break;
                     }
                 }
-                if (touchpadDevice)
+            }
+            if (touchpadDevice)
+            {
+                switch (event.type)
                 {
-                    switch (event.type)
+                    case EV_ABS:
                     {
-                        case EV_ABS:
+                        switch (event.code)
                         {
-                            switch (event.code)
+                            case ABS_MT_SLOT:
                             {
-                                case ABS_MT_SLOT:
-                                {
-                                    currentTouchSlot = event.value;
-                                    break;
-                                }
-                                case ABS_MT_TRACKING_ID:
-                                {
-                                    if (event.value >= 0)
-                                    {
-                                        touchSlots[currentTouchSlot].trackingId = event.value;
-                                        touchSlots[currentTouchSlot].action = Slot::Action::BEGIN;
-                                    }
-                                    else
-                                        touchSlots[currentTouchSlot].action = Slot::Action::END;
-                                    break;
-                                }
-                                case ABS_MT_POSITION_X:
-                                {
-                                    touchSlots[currentTouchSlot].positionX = event.value;
-                                    touchSlots[currentTouchSlot].action = Slot::Action::MOVE;
-                                    break;
-                                }
-                                case ABS_MT_POSITION_Y:
-                                {
-                                    touchSlots[currentTouchSlot].positionY = event.value;
-                                    touchSlots[currentTouchSlot].action = Slot::Action::MOVE;
-                                    break;
-                                }
-                                case ABS_MT_PRESSURE:
+                                currentTouchSlot = event.value;
+                                break;
+                            }
+                            case ABS_MT_TRACKING_ID:
+                            {
+                                if (event.value >= 0)
                                 {
-                                    touchSlots[currentTouchSlot].pressure = event.value;
-                                    break;
+                                    touchSlots[currentTouchSlot].trackingId = event.value;
+                                    touchSlots[currentTouchSlot].action = Slot::Action::BEGIN;
                                 }
+                                else
+                                    touchSlots[currentTouchSlot].action = Slot::Action::END;
+                                break;
+                            }
+                            case ABS_MT_POSITION_X:
+                            {
+                                touchSlots[currentTouchSlot].positionX = event.value;
+                                touchSlots[currentTouchSlot].action = Slot::Action::MOVE;
+                                break;
+                            }
+                            case ABS_MT_POSITION_Y:
+                            {
+                                touchSlots[currentTouchSlot].positionY = event.value;
+                                touchSlots[currentTouchSlot].action = Slot::Action::MOVE;
+                                break;
+                            }
+                            case ABS_MT_PRESSURE:
+                            {
+                                touchSlots[currentTouchSlot].pressure = event.value;
+                                break;
                             }
-                            break;
                         }
-                        case EV_SYN:
+                        break;
+                    }
+                    case EV_SYN:
+                    {
+                        switch (event.code)
                         {
-                            switch (event.code)
+                            case SYN_REPORT:
                             {
-                                case SYN_REPORT:
+                                for (Slot& slot : touchSlots)
                                 {
-                                    for (Slot& slot : touchSlots)
+                                    if (slot.action != Slot::Action::NONE)
                                     {
-                                        if (slot.action != Slot::Action::NONE)
+                                        Vector2F position(static_cast<float>(slot.positionX - touchMinX) / touchRangeX,
+                                                         static_cast<float>(slot.positionY - touchMinY) / touchRangeY);
+                                        float pressure = static_cast<float>(slot.pressure - touchMinPressure) / touchMaxPressure;
+
+                                        switch (slot.action)
                                         {
-                                            Vector2F position(static_cast<float>(slot.positionX - touchMinX) / touchRangeX,
-                                                             static_cast<float>(slot.positionY - touchMinY) / touchRangeY);
-                                            float pressure = static_cast<float>(slot.pressure - touchMinPressure) / touchMaxPressure;
-
-                                            switch (slot.action)
-                                            {
-                                                case Slot::Action::NONE:
-                                                    break;
-                                                case Slot::Action::BEGIN:
-                                                    touchpadDevice->handleTouchBegin(static_cast<uint64_t>(slot.trackingId), position, pressure);
-                                                    break;
-                                                case Slot::Action::END:
-                                                    touchpadDevice->handleTouchEnd(static_cast<uint64_t>(slot.trackingId), position, pressure);
-                                                    break;
-                                                case Slot::Action::MOVE:
-                                                    touchpadDevice->handleTouchMove(static_cast<uint64_t>(slot.trackingId), position, pressure);
-                                                    break;
-                                            }
-
-                                            slot.action = Slot::Action::NONE;
+                                            case Slot::Action::NONE:
+                                                break;
+                                            case Slot::Action::BEGIN:
+                                                touchpadDevice->handleTouchBegin(static_cast<uint64_t>(slot.trackingId), position, pressure);
+                                                break;
+                                            case Slot::Action::END:
+                                                touchpadDevice->handleTouchEnd(static_cast<uint64_t>(slot.trackingId), position, pressure);
+                                                break;
+                                            case Slot::Action::MOVE:
+                                                touchpadDevice->handleTouchMove(static_cast<uint64_t>(slot.trackingId), position, pressure);
+                                                break;
                                         }
+
+                                        slot.action = Slot::Action::NONE;
                                     }
-                                    break;
                                 }
-                                case SYN_DROPPED:
+                                break;
+                            }
+                            case SYN_DROPPED:
+                            {
+                                struct input_mt_request_layout
                                 {
-                                    struct input_mt_request_layout
-                                    {
-                                        __u32 code;
-                                        __s32 values[1];
-                                    };
+                                    __u32 code;
+                                    __s32 values[1];
+                                };
 
-                                    size_t size = sizeof(__u32) + sizeof(__s32) * touchSlots.size();
-                                    std::vector<uint8_t> data(size);
+                                size_t size = sizeof(__u32) + sizeof(__s32) * touchSlots.size();
+                                std::vector<uint8_t> data(size);
 
-                                    input_mt_request_layout* request = reinterpret_cast<input_mt_request_layout*>(data.data());
+                                input_mt_request_layout* request = reinterpret_cast<input_mt_request_layout*>(data.data());
 
-                                    request->code = ABS_MT_TRACKING_ID;
-                                    if (ioctl(fd, EVIOCGMTSLOTS(size), request) == -1)
-                                        throw std::system_error(errno, std::system_category(), "Failed to get device info");
+                                request->code = ABS_MT_TRACKING_ID;
+                                if (ioctl(fd, EVIOCGMTSLOTS(size), request) == -1)
+                                    throw std::system_error(errno, std::system_category(), "Failed to get device info");
 
-                                    for (size_t i = 0; i < touchSlots.size(); ++i)
+                                for (size_t i = 0; i < touchSlots.size(); ++i)
+                                {
+                                    if (touchSlots[i].trackingId < 0 &&
+                                        request->values[i] >= 0)
                                     {
-                                        if (touchSlots[i].trackingId < 0 &&
-                                            request->values[i] >= 0)
-                                        {
-                                            touchSlots[i].trackingId = request->values[i];
-                                            touchSlots[i].action = Slot::Action::BEGIN;
-                                        }
-                                        else if (touchSlots[i].trackingId >= 0 &&
-                                                 request->values[i] < 0)
-                                        {
-                                            touchSlots[i].trackingId = request->values[i];
-                                            touchSlots[i].action = Slot::Action::END;
-                                        }
+                                        touchSlots[i].trackingId = request->values[i];
+                                        touchSlots[i].action = Slot::Action::BEGIN;
+                                    }
+                                    else if (touchSlots[i].trackingId >= 0 &&
+                                             request->values[i] < 0)
+                                    {
+                                        touchSlots[i].trackingId = request->values[i];
+                                        touchSlots[i].action = Slot::Action::END;
                                     }
+                                }
 
-                                    request->code = ABS_MT_POSITION_X;
-                                    if (ioctl(fd, EVIOCGMTSLOTS(size), request) == -1)
-                                        throw std::system_error(errno, std::system_category(), "Failed to get device info");
+                                request->code = ABS_MT_POSITION_X;
+                                if (ioctl(fd, EVIOCGMTSLOTS(size), request) == -1)
+                                    throw std::system_error(errno, std::system_category(), "Failed to get device info");
 
-                                    for (size_t i = 0; i < touchSlots.size(); ++i)
+                                for (size_t i = 0; i < touchSlots.size(); ++i)
+                                {
+                                    if (touchSlots[i].trackingId >= 0 &&
+                                        touchSlots[i].positionX != request->values[i])
                                     {
-                                        if (touchSlots[i].trackingId >= 0 &&
-                                            touchSlots[i].positionX != request->values[i])
-                                        {
-                                            touchSlots[i].positionX = request->values[i];
-                                            if (touchSlots[i].action == Slot::Action::NONE)
-                                                touchSlots[i].action = Slot::Action::MOVE;
-                                        }
+                                        touchSlots[i].positionX = request->values[i];
+                                        if (touchSlots[i].action == Slot::Action::NONE)
+                                            touchSlots[i].action = Slot::Action::MOVE;
                                     }
+                                }
 
-                                    request->code = ABS_MT_POSITION_Y;
-                                    if (ioctl(fd, EVIOCGMTSLOTS(size), request) == -1)
-                                        throw std::system_error(errno, std::system_category(), "Failed to get device info");
+                                request->code = ABS_MT_POSITION_Y;
+                                if (ioctl(fd, EVIOCGMTSLOTS(size), request) == -1)
+                                    throw std::system_error(errno, std::system_category(), "Failed to get device info");
 
+                                for (size_t i = 0; i < touchSlots.size(); ++i)
+                                {
+                                    if (touchSlots[i].trackingId >= 0 &&
+                                        touchSlots[i].positionY != request->values[i])
+                                    {
+                                        touchSlots[i].positionY = request->values[i];
+                                        if (touchSlots[i].action == Slot::Action::NONE)
+                                            touchSlots[i].action = Slot::Action::MOVE;
+                                    }
+                                }
+
+                                request->code = ABS_MT_PRESSURE;
+                                if (isBitSet(absBits, ABS_MT_PRESSURE) &&
+                                    ioctl(fd, EVIOCGMTSLOTS(size), request) != -1)
+                                {
                                     for (size_t i = 0; i < touchSlots.size(); ++i)
                                     {
                                         if (touchSlots[i].trackingId >= 0 &&
-                                            touchSlots[i].positionY != request->values[i])
+                                            touchSlots[i].pressure != request->values[i])
                                         {
-                                            touchSlots[i].positionY = request->values[i];
+                                            touchSlots[i].pressure = request->values[i];
                                             if (touchSlots[i].action == Slot::Action::NONE)
                                                 touchSlots[i].action = Slot::Action::MOVE;
                                         }
                                     }
+                                }
 
-                                    request->code = ABS_MT_PRESSURE;
-                                    if (ioctl(fd, EVIOCGABS(size), request) != -1)
-                                    {
-                                        for (size_t i = 0; i < touchSlots.size(); ++i)
-                                        {
-                                            if (touchSlots[i].trackingId >= 0 &&
-                                                touchSlots[i].pressure != request->values[i])
-                                            {
-                                                touchSlots[i].pressure = request->values[i];
-                                                if (touchSlots[i].action == Slot::Action::NONE)
-                                                    touchSlots[i].action = Slot::Action::MOVE;
-                                            }
-                                        }
-                                    }
-
-                                    input_absinfo info;
-                                    if (ioctl(fd, EVIOCGABS(ABS_MT_SLOT), &info) == -1)
-                                        throw std::system_error(errno, std::system_category(), "Failed to get device info");
-                                    currentTouchSlot = info.value;
+                                input_absinfo info;
+                                if (ioctl(fd, EVIOCGABS(ABS_MT_SLOT), &info) == -1)
+                                    throw std::system_error(errno, std::system_category(), "Failed to get device info");
+                                currentTouchSlot = info.value;
 
-                                    break;
-                                }
+                                break;
                             }
-                            break;
                         }
+                        break;
                     }
                 }
-                if (gamepadDevice)
+            }
+            if (gamepadDevice)
+            {
+                switch(event.type)
                 {
-                    switch(event.type)
+                    case EV_ABS:
                     {
-                        case EV_ABS:
+                        if (event.code == ABS_HAT0X)
                         {
-                            if (event.code == ABS_HAT0X)
-                            {
-                                if (event.value != 0)
-                                    gamepadDevice->handleButtonValueChange((event.value > 0) ? Gamepad::Button::DPAD_RIGHT : Gamepad::Button::DPAD_LEFT, true, 1.0F);
-                                else if (hat0XValue != 0)
-                                    gamepadDevice->handleButtonValueChange((hat0XValue > 0) ? Gamepad::Button::DPAD_RIGHT : Gamepad::Button::DPAD_LEFT, false, 0.0F);
+                            if (event.value != 0)
+                                gamepadDevice->handleButtonValueChange((event.value > 0) ? Gamepad::Button::DPAD_RIGHT : Gamepad::Button::DPAD_LEFT, true, 1.0F);
+                            else if (hat0XValue != 0)
+                                gamepadDevice->handleButtonValueChange((hat0XValue > 0) ? Gamepad::Button::DPAD_RIGHT : Gamepad::Button::DPAD_LEFT, false, 0.0F);
 
-                                hat0XValue = event.value;
-                            }
-                            else if (event.code == ABS_HAT0Y)
-                            {
-                                if (event.value != 0)
-                                    gamepadDevice->handleButtonValueChange((event.value > 0) ? Gamepad::Button::DPAD_DOWN : Gamepad::Button::DPAD_UP, true, 1.0F);
-                                else if (hat0YValue != 0)
-                                    gamepadDevice->handleButtonValueChange((hat0YValue > 0) ? Gamepad::Button::DPAD_DOWN : Gamepad::Button::DPAD_UP, false, 0.0F);
+                            hat0XValue = event.value;
+                        }
+                        else if (event.code == ABS_HAT0Y)
+                        {
+                            if (event.value != 0)
+                                gamepadDevice->handleButtonValueChange((event.value > 0) ? Gamepad::Button::DPAD_DOWN : Gamepad::Button::DPAD_UP, true, 1.0F);
+                            else if (hat0YValue != 0)
+                                gamepadDevice->handleButtonValueChange((hat0YValue > 0) ? Gamepad::Button::DPAD_DOWN : Gamepad::Button::DPAD_UP, false, 0.0F);
 
-                                hat0YValue = event.value;
-                            }
+                            hat0YValue = event.value;
+                        }
 
-                            auto axisIterator = axes.find(event.code);
+                        auto axisIterator = axes.find(event.code);
 
-                            if (axisIterator != axes.end())
-                            {
-                                Axis& axis = axisIterator->second;
+                        if (axisIterator != axes.end())
+                        {
+                            Axis& axis = axisIterator->second;
 
-                                handleAxisChange(axis.value,
-                                                 event.value,
-                                                 axis.min, axis.range,
-                                                 axis.negativeButton, axis.positiveButton);
+                            handleAxisChange(axis.value,
+                                             event.value,
+                                             axis.min, axis.range,
+                                             axis.negativeButton, axis.positiveButton);
 
-                                axis.value = event.value;
-                            }
-                            break;
+                            axis.value = event.value;
                         }
-                        case EV_KEY:
+                        break;
+                    }
+                    case EV_KEY:
+                    {
+                        auto buttonIterator = buttons.find(event.code);
+
+                        if (buttonIterator != buttons.end())
                         {
-                            auto buttonIterator = buttons.find(event.code);
+                            Button& button = buttonIterator->second;
 
-                            if (buttonIterator != buttons.end())
+                            if ((button.button != Gamepad::Button::LEFT_TRIGGER || !hasLeftTrigger) &&
+                                (button.button != Gamepad::Button::RIGHT_TRIGGER || !hasRightTrigger))
                             {
-                                Button& button = buttonIterator->second;
-
-                                if ((button.button != Gamepad::Button::LEFT_TRIGGER || !hasLeftTrigger) &&
-                                    (button.button != Gamepad::Button::RIGHT_TRIGGER || !hasRightTrigger))
-                                {
-                                    gamepadDevice->handleButtonValueChange(button.button, event.value > 0, (event.value > 0) ? 1.0F : 0.0F);
-                                }
-
-                                button.value = event.value;
+                                gamepadDevice->handleButtonValueChange(button.button, event.value > 0, (event.value > 0) ? 1.0F : 0.0F);
                             }
-                            break;
+
+                            button.value = event.value;
                         }
+                        break;
                     }
                 }
             }
@@ -9,6 +9,7 @@
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include <linux/input.h>
 #include "input/Gamepad.hpp"
 
 namespace ouzel
@@ -35,8 +36,10 @@ namespace ouzel
             void update();
 
             inline int getFd() const { return fd; }
+            inline const std::string& getFilename() const { return filename; }
 
         private:
+            void handleEvent(const input_event& event);
             void handleAxisChange(int32_t oldValue, int32_t newValue,
                                   int32_t min, int32_t range,
                                   Gamepad::Button negativeButton, Gamepad::Button positiveButton);
@@ -45,6 +48,12 @@ namespace ouzel
             std::string filename;
             std::string name;
 
+            // capabilities, queried once with EVIOCGBIT
+            unsigned long eventBits[(EV_CNT + 8 * sizeof(long) - 1) / (8 * sizeof(long))];
+            unsigned long absBits[(ABS_CNT + 8 * sizeof(long) - 1) / (8 * sizeof(long))];
+            unsigned long relBits[(REL_CNT + 8 * sizeof(long) - 1) / (8 * sizeof(long))];
+            unsigned long keyBits[(KEY_CNT + 8 * sizeof(long) - 1) / (8 * sizeof(long))];
+
             std::unique_ptr<KeyboardDevice> keyboardDevice;
             std::unique_ptr<GamepadDevice> gamepadDevice;
             std::unique_ptr<MouseDevice> mouseDevice;
@@ -0,0 +1,47 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_INPUT_EVENTREADER_HPP
+#define OUZEL_INPUT_EVENTREADER_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <system_error>
+#include <unistd.h>
+#include <linux/input.h>
+
+namespace ouzel
+{
+    namespace input
+    {
+        static constexpr size_t EVENT_BATCH_SIZE = 64;
+
+        // Reads the events queued on a non-blocking file descriptor in batches until it is drained
+        template<class F>
+        void readEvents(int fd, F handler)
+        {
+            input_event events[EVENT_BATCH_SIZE];
+
+            for (;;)
+            {
+                ssize_t bytesRead = read(fd, events, sizeof(events));
+
+                if (bytesRead == -1)
+                {
+                    if (errno == EAGAIN) break;
+                    if (errno == EINTR) continue;
+                    throw std::system_error(errno, std::system_category(), "Failed to read events");
+                }
+
+                size_t count = static_cast<size_t>(bytesRead) / sizeof(input_event);
+
+                for (size_t i = 0; i < count; ++i)
+                    handler(events[i]);
+
+                // a short read (or end of file after a hang-up) means that the queue is empty
+                if (static_cast<size_t>(bytesRead) < sizeof(events)) break;
+            }
+        }
+    }
+}
+
+#endif // OUZEL_INPUT_EVENTREADER_HPP
@@ -1,6 +1,7 @@
 // Copyright 2015-2019 Elviss Strazdins. All rights reserved.
 
 #include "core/Setup.h"
+#include <cerrno>
 #include <cstdio>
 #include <cstring>
 #include <system_error>
@@ -8,6 +9,8 @@
 #include <dirent.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
 #include <linux/joystick.h>
 #if OUZEL_SUPPORTS_X11
 #  include <X11/cursorfont.h>
@@ -47,31 +50,44 @@ namespace ouzel
                 XFreePixmap(display, pixmap);
             }
 #endif
-            DIR* dir = opendir("/dev/input");
+            epollFd = epoll_create1(EPOLL_CLOEXEC);
 
-            if (!dir)
-                throw std::system_error(errno, std::system_category(), "Failed to open directory");
+            if (epollFd == -1)
+                throw std::system_error(errno, std::system_category(), "Failed to create epoll instance");
 
-            dirent ent;
-            dirent* p;
+            // devices are rescanned during discovery if inotify is not available
+            notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
 
-            while (readdir_r(dir, &ent, &p) == 0 && p)
+            if (notifyFd != -1)
             {
-                if (strncmp("event", ent.d_name, 5) == 0)
+                epoll_event event;
+                event.events = EPOLLIN;
+                event.data.fd = notifyFd;
+
+                // udev sets the permissions of the device file after creating it, so wait for IN_ATTRIB too
+                if (inotify_add_watch(notifyFd, "/dev/input", IN_CREATE | IN_ATTRIB | IN_DELETE) == -1 ||
+                    epoll_ctl(epollFd, EPOLL_CTL_ADD, notifyFd, &event) == -1)
                 {
-                    try
-                    {
-                        std::string filename = std::string("/dev/input/") + ent.d_name;
-                        std::unique_ptr<EventDevice> eventDevice(new EventDevice(*this, filename));
-                        eventDevices.insert(std::make_pair(eventDevice->getFd(), std::move(eventDevice)));
-                    }
-                    catch (const std::exception&)
-                    {
-                    }
+                    close(notifyFd);
+                    notifyFd = -1;
                 }
             }
 
-            closedir(dir);
+            try
+            {
+                scanEventDevices();
+            }
+            catch (...)
+            {
+                eventDevices.clear();
+
+                if (notifyFd != -1) close(notifyFd);
+                close(epollFd);
+#if OUZEL_SUPPORTS_X11
+                if (emptyCursor != None) XFreeCursor(display, emptyCursor);
+#endif
+                throw;
+            }
         }
 
         InputSystemLinux::~InputSystemLinux()
@@ -80,6 +96,10 @@ namespace ouzel
             EngineLinux* engineLinux = static_cast<EngineLinux*>(engine);
             if (emptyCursor != None) XFreeCursor(engineLinux->getDisplay(), emptyCursor);
 #endif
+            eventDevices.clear();
+
+            if (notifyFd != -1) close(notifyFd);
+            if (epollFd != -1) close(epollFd);
         }
 
         void InputSystemLinux::executeCommand(const Command& command)
@@ -88,6 +108,7 @@ namespace ouzel
             {
                 case Command::Type::START_DEVICE_DISCOVERY:
                     discovering = true;
+                    scanEventDevices(); // pick up the devices that were connected before the discovery
                     break;
                 case Command::Type::STOP_DEVICE_DISCOVERY:
                     discovering = false;
@@ -184,73 +205,121 @@ namespace ouzel
 
         void InputSystemLinux::update()
         {
-            fd_set rfds;
-            struct timeval tv;
-            tv.tv_sec = 0;
-            tv.tv_usec = 0;
+            epoll_event events[32];
+            int count = epoll_wait(epollFd, events, 32, 0);
 
-            FD_ZERO(&rfds);
+            if (count == -1)
+            {
+                if (errno != EINTR)
+                    throw std::system_error(errno, std::system_category(), "Failed to wait for input events");
 
-            int maxFd = 0;
+                count = 0;
+            }
 
-            for (const auto& i : eventDevices)
+            for (int i = 0; i < count; ++i)
             {
-                FD_SET(i.first, &rfds);
-                if (i.first > maxFd) maxFd = i.first;
-            }
+                if (events[i].data.fd == notifyFd)
+                {
+                    handleNotifyEvents();
+                    continue;
+                }
 
-            int retval;
-            if ((retval = select(maxFd + 1, &rfds, nullptr, nullptr, &tv)) == -1)
-                throw std::system_error(errno, std::system_category(), "Select failed");
+                auto eventDeviceIterator = eventDevices.find(events[i].data.fd);
+                if (eventDeviceIterator == eventDevices.end()) continue;
 
-            if (retval > 0)
-            {
-                for (auto i = eventDevices.begin(); i != eventDevices.end();)
+                try
                 {
-                    if (FD_ISSET(i->first, &rfds))
-                    {
-                        try
-                        {
-                            i->second->update();
-                            ++i;
-                        }
-                        catch (const std::exception&)
-                        {
-                            i = eventDevices.erase(i);
-                        }
-                    }
-                    else
-                        ++i;
+                    if (events[i].events & EPOLLIN)
+                        eventDeviceIterator->second->update();
+
+                    // the device was unplugged
+                    if (events[i].events & (EPOLLERR | EPOLLHUP))
+                        eventDevices.erase(eventDeviceIterator);
+                }
+                catch (const std::exception&)
+                {
+                    eventDevices.erase(eventDeviceIterator);
                 }
             }
 
-            if (discovering)
+            if (discovering && notifyFd == -1)
+                scanEventDevices();
+        }
+
+        void InputSystemLinux::scanEventDevices()
+        {
+            DIR* dir = opendir("/dev/input");
+
+            if (!dir)
+                throw std::system_error(errno, std::system_category(), "Failed to open directory");
+
+            dirent ent;
+            dirent* p;
+
+            while (readdir_r(dir, &ent, &p) == 0 && p)
             {
-                DIR* dir = opendir("/dev/input");
+                if (strncmp("event", ent.d_name, 5) == 0)
+                    addEventDevice(std::string("/dev/input/") + ent.d_name);
+            }
 
-                if (!dir)
-                    throw std::system_error(errno, std::system_category(), "Failed to open directory");
+            closedir(dir);
+        }
 
-                dirent ent;
-                dirent* p;
+        void InputSystemLinux::addEventDevice(const std::string& filename)
+        {
+            for (const auto& i : eventDevices)
+                if (i.second->getFilename() == filename) return;
 
-                while (readdir_r(dir, &ent, &p) == 0 && p)
+            try
+            {
+                std::unique_ptr<EventDevice> eventDevice(new EventDevice(*this, filename));
+
+                epoll_event event;
+                event.events = EPOLLIN;
+                event.data.fd = eventDevice->getFd();
+
+                if (epoll_ctl(epollFd, EPOLL_CTL_ADD, eventDevice->getFd(), &event) == -1)
+                    throw std::system_error(errno, std::system_category(), "Failed to add device to epoll");
+
+                eventDevices.insert(std::make_pair(eventDevice->getFd(), std::move(eventDevice)));
+            }
+            catch (const std::exception&)
+            {
+            }
+        }
+
+        void InputSystemLinux::handleNotifyEvents()
+        {
+            alignas(struct inotify_event) char buffer[4096];
+
+            for (;;)
+            {
+                ssize_t length = read(notifyFd, buffer, sizeof(buffer));
+                if (length <= 0) break; // EAGAIN, no more events
+
+                for (char* pointer = buffer; pointer < buffer + length;)
                 {
-                    if (strncmp("event", ent.d_name, 5) == 0)
+                    const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(pointer);
+                    pointer += sizeof(struct inotify_event) + event->len;
+
+                    if (event->len == 0 || strncmp("event", event->name, 5) != 0) continue;
+
+                    std::string filename = std::string("/dev/input/") + event->name;
+
+                    if (event->mask & IN_DELETE)
                     {
-                        try
-                        {
-                            std::string filename = std::string("/dev/input/") + ent.d_name;
-                            std::unique_ptr<EventDevice> eventDevice(new EventDevice(*this, filename));
-                            eventDevices.insert(std::make_pair(eventDevice->getFd(), std::move(eventDevice)));
-                        }
-                        catch (const std::exception&)
+                        for (auto i = eventDevices.begin(); i != eventDevices.end(); ++i)
                         {
+                            if (i->second->getFilename() == filename)
+                            {
+                                eventDevices.erase(i);
+                                break;
+                            }
                         }
                     }
+                    else if (discovering)
+                        addEventDevice(filename);
                 }
-
-                closedir(dir);
             }
         }
 
@@ -41,9 +41,15 @@ namespace ouzel
 #if OUZEL_SUPPORTS_X11
             void updateCursor() const;
 #endif
+            void scanEventDevices();
+            void addEventDevice(const std::string& filename);
+            void handleNotifyEvents();
 
             bool discovering = false;
 
+            int epollFd = -1;
+            int notifyFd = -1; // inotify on /dev/input for hot-plugging
+
             uint32_t lastDeviceId = 0;
             std::unique_ptr<KeyboardDeviceLinux> keyboardDevice;
             std::unique_ptr<MouseDeviceLinux> mouseDevice;
@@ -3,6 +3,9 @@
 #ifndef OUZEL_HPP
 #define OUZEL_HPP
 
+#include "assets/AssetId.hpp"
+#include "assets/AssetMap.hpp"
+#include "assets/BakeCache.hpp"
 #include "assets/Bundle.hpp"
 #include "assets/Cache.hpp"
 #include "assets/Loader.hpp"
@@ -52,6 +55,7 @@
 #include "graphics/PixelFormat.hpp"
 #include "graphics/RasterizerState.hpp"
 #include "graphics/RenderDevice.hpp"
+#include "graphics/RenderGraph.hpp"
 #include "graphics/Renderer.hpp"
 #include "graphics/RenderTarget.hpp"
 #include "graphics/Shader.hpp"
@@ -64,6 +68,7 @@
 #include "input/Controller.hpp"
 #include "input/Cursor.hpp"
 #include "input/Gamepad.hpp"
+#include "input/InputLog.hpp"
 #include "input/InputManager.hpp"
 #include "input/InputSystem.hpp"
 #include "input/Keyboard.hpp"
@@ -92,6 +97,7 @@
 #include "scene/Layer.hpp"
 #include "scene/Light.hpp"
 #include "scene/ParticleSystem.hpp"
+#include "scene/ParticleWorld.hpp"
 #include "scene/Scene.hpp"
 #include "scene/SceneManager.hpp"
 #include "scene/ShapeRenderer.hpp"
@@ -100,15 +106,25 @@
 #include "scene/StaticMeshRenderer.hpp"
 #include "scene/TextRenderer.hpp"
 #include "storage/Archive.hpp"
+#include "storage/Compression.hpp"
 #include "storage/File.hpp"
+#include "storage/FileMonitor.hpp"
 #include "storage/FileSystem.hpp"
+#include "storage/MappedFile.hpp"
+#include "storage/Pack.hpp"
 #include "utils/Base64.hpp"
 #include "utils/Ini.hpp"
-#include "utils/Json.hpp"
+#include "utils/JsonParser.hpp"
 #include "utils/Log.hpp"
+#include "utils/Metrics.hpp"
+#include "utils/MpscQueue.hpp"
 #include "utils/Obf.hpp"
+#include "utils/ObfSerializer.hpp"
+#include "utils/Profiler.hpp"
+#include "utils/StringView.hpp"
 #include "utils/Utf8.hpp"
 #include "utils/Utils.hpp"
 #include "utils/Xml.hpp"
+#include "utils/XmlParser.hpp"
 
 #endif // OUZEL_HPP
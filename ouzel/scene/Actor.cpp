@@ -2,12 +2,14 @@
 
 #include <cassert>
 #include <algorithm>
+#include <limits>
 #include "Actor.hpp"
 #include "SceneManager.hpp"
 #include "Layer.hpp"
 #include "Camera.hpp"
 #include "math/MathUtils.hpp"
 #include "Component.hpp"
+#include "core/Engine.hpp"
 
 namespace ouzel
 {
@@ -245,6 +247,9 @@ namespace ouzel
             worldOrder = parentOrder + order;
             worldHidden = parentHidden || hidden;
 
+            // the interpolated transform changes every frame until the next fixed update
+            if (isInterpolating()) updateLocalTransform();
+
             if (parentTransformDirty) updateTransform(newParentTransform);
             if (transformDirty) calculateTransform();
 
@@ -269,6 +274,26 @@ namespace ouzel
             updateChildrenTransform = false;
         }
 
+        void Actor::updateWorld(const Matrix4F& newParentTransform,
+                                bool parentTransformDirty,
+                                int32_t parentOrder,
+                                bool parentHidden)
+        {
+            worldOrder = parentOrder + order;
+            worldHidden = parentHidden || hidden;
+
+            // replace the pose that was interpolated for drawing with the simulated one
+            if (interpolatedTransform) updateLocalTransform();
+
+            if (parentTransformDirty) updateTransform(newParentTransform);
+            if (transformDirty) calculateTransform();
+
+            for (Actor* actor : children)
+                actor->updateWorld(transform, updateChildrenTransform, worldOrder, worldHidden);
+
+            updateChildrenTransform = false;
+        }
+
         void Actor::draw(Camera* camera, bool wireframe)
         {
             if (transformDirty)
@@ -295,6 +320,8 @@ namespace ouzel
 
         void Actor::setPosition(const Vector2F& newPosition)
         {
+            storePreviousState();
+
             position.v[0] = newPosition.v[0];
             position.v[1] = newPosition.v[1];
 
@@ -303,6 +330,8 @@ namespace ouzel
 
         void Actor::setPosition(const Vector3F& newPosition)
         {
+            storePreviousState();
+
             position = newPosition;
 
             updateLocalTransform();
@@ -310,6 +339,8 @@ namespace ouzel
 
         void Actor::setRotation(const QuaternionF& newRotation)
         {
+            storePreviousState();
+
             rotation = newRotation;
 
             updateLocalTransform();
@@ -320,6 +351,7 @@ namespace ouzel
             QuaternionF roationQuaternion;
             roationQuaternion.setEulerAngles(newRotation);
 
+            storePreviousState();
             rotation = roationQuaternion;
 
             updateLocalTransform();
@@ -330,6 +362,7 @@ namespace ouzel
             QuaternionF roationQuaternion;
             roationQuaternion.rotate(newRotation, Vector3F(0.0F, 0.0F, 1.0F));
 
+            storePreviousState();
             rotation = roationQuaternion;
 
             updateLocalTransform();
@@ -337,6 +370,8 @@ namespace ouzel
 
         void Actor::setScale(const Vector2F& newScale)
         {
+            storePreviousState();
+
             scale.v[0] = newScale.v[0];
             scale.v[1] = newScale.v[1];
 
@@ -345,6 +380,8 @@ namespace ouzel
 
         void Actor::setScale(const Vector3F& newScale)
         {
+            storePreviousState();
+
             scale = newScale;
 
             updateLocalTransform();
@@ -428,10 +465,11 @@ namespace ouzel
 
         Vector3F Actor::getWorldPosition() const
         {
-            Vector3F result = position;
+            // the origin of the actor, the transform already contains the position
+            Vector3F result;
             getTransform().transformPoint(result);
 
-            return position;
+            return result;
         }
 
         Vector3F Actor::convertWorldToLocal(const Vector3F& worldPosition) const
@@ -454,18 +492,64 @@ namespace ouzel
             return worldPosition;
         }
 
+        void Actor::setInterpolated(bool newInterpolated)
+        {
+            interpolated = newInterpolated;
+            previousStateFixedUpdate = std::numeric_limits<uint64_t>::max();
+            updateLocalTransform();
+        }
+
+        bool Actor::isInterpolating() const
+        {
+            return interpolated &&
+                previousStateFixedUpdate == engine->getFixedUpdateCount() &&
+                engine->getInterpolationAlpha() < 1.0F;
+        }
+
+        void Actor::storePreviousState()
+        {
+            // the state before the first change in a fixed update is the one to interpolate from
+            if (interpolated && previousStateFixedUpdate != engine->getFixedUpdateCount())
+            {
+                previousPosition = position;
+                previousRotation = rotation;
+                previousScale = scale;
+                previousStateFixedUpdate = engine->getFixedUpdateCount();
+            }
+        }
+
         void Actor::calculateLocalTransform() const
         {
-            localTransform.setTranslation(position);
+            Vector3F finalPosition = position;
+            QuaternionF finalRotation = rotation;
+            Vector3F finalScale = scale;
+
+            interpolatedTransform = isInterpolating();
+
+            if (interpolatedTransform)
+            {
+                const float alpha = engine->getInterpolationAlpha();
+
+                finalPosition = previousPosition + (position - previousPosition) * alpha;
+
+                // take the shorter path
+                const float dot = previousRotation.v[0] * rotation.v[0] + previousRotation.v[1] * rotation.v[1] +
+                    previousRotation.v[2] * rotation.v[2] + previousRotation.v[3] * rotation.v[3];
+                finalRotation.lerp(previousRotation, (dot < 0.0F) ? -rotation : rotation, alpha);
+                finalRotation.normalize();
+
+                finalScale = previousScale + (scale - previousScale) * alpha;
+            }
+
+            localTransform.setTranslation(finalPosition);
 
             Matrix4F rotationMatrix;
-            rotationMatrix.setRotation(rotation);
+            rotationMatrix.setRotation(finalRotation);
 
             localTransform *= rotationMatrix;
 
-            Vector3F finalScale = Vector3F(scale.v[0] * (flipX ? -1.0F : 1.0F),
-                                           scale.v[1] * (flipY ? -1.0F : 1.0F),
-                                           scale.v[2]);
+            finalScale.v[0] *= (flipX ? -1.0F : 1.0F);
+            finalScale.v[1] *= (flipY ? -1.0F : 1.0F);
 
             Matrix4F scaleMatrix;
             scaleMatrix.setScale(finalScale);
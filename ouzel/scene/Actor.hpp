@@ -3,6 +3,7 @@
 #ifndef OUZEL_SCENE_ACTOR_HPP
 #define OUZEL_SCENE_ACTOR_HPP
 
+#include <limits>
 #include <memory>
 #include <vector>
 #include "math/Box.hpp"
@@ -77,6 +78,12 @@ namespace ouzel
                                bool parentHidden);
             virtual void draw(Camera* camera, bool wireframe);
 
+            // calculates the world transform, order and visibility like visit, but without culling
+            virtual void updateWorld(const Matrix4F& newParentTransform,
+                                     bool parentTransformDirty,
+                                     int32_t parentOrder,
+                                     bool parentHidden);
+
             virtual const Vector3F& getPosition() const { return position; }
             virtual void setPosition(const Vector2F& newPosition);
             virtual void setPosition(const Vector3F& newPosition);
@@ -108,6 +115,11 @@ namespace ouzel
             virtual bool isCullDisabled() const { return cullDisabled; }
             virtual void setCullDisabled(bool newCullDisabled) { cullDisabled = newCullDisabled; }
 
+            // draws the actor between its states before and after the last fixed update (see Engine::setFixedUpdateStep),
+            // the interpolated transform is used only while drawing, outside of it the transforms follow the simulation
+            inline bool isInterpolated() const { return interpolated; }
+            void setInterpolated(bool newInterpolated);
+
             virtual bool isHidden() const { return hidden; }
             virtual void setHidden(bool newHidden);
             inline bool isWorldHidden() const { return worldHidden; }
@@ -163,6 +175,9 @@ namespace ouzel
             void updateLocalTransform();
             void updateTransform(const Matrix4F& newParentTransform);
 
+            bool isInterpolating() const;
+            void storePreviousState();
+
             virtual void calculateLocalTransform() const;
             virtual void calculateTransform() const;
 
@@ -177,6 +192,7 @@ namespace ouzel
             mutable bool inverseTransformDirty = true;
             mutable bool localTransformDirty = true;
             mutable bool updateChildrenTransform = true;
+            mutable bool interpolatedTransform = false; // the local transform holds an interpolated pose
 
             bool flipX = false;
             bool flipY = false;
@@ -190,6 +206,12 @@ namespace ouzel
             QuaternionF rotation = QuaternionF::identity();
             Vector3F scale = Vector3F(1.0F, 1.0F, 1.0F);
             float opacity = 1.0F;
+
+            bool interpolated = false;
+            uint64_t previousStateFixedUpdate = std::numeric_limits<uint64_t>::max();
+            Vector3F previousPosition;
+            QuaternionF previousRotation = QuaternionF::identity();
+            Vector3F previousScale = Vector3F(1.0F, 1.0F, 1.0F);
             int32_t order = 0;
             int32_t worldOrder = 0;
 
@@ -44,6 +44,12 @@ namespace ouzel
             }
         }
 
+        void Layer::updateWorld()
+        {
+            for (Actor* actor : children)
+                actor->updateWorld(Matrix4F::identity(), false, 0, false);
+        }
+
         void Layer::addChild(Actor* actor)
         {
             ActorContainer::addChild(actor);
@@ -26,6 +26,7 @@ namespace ouzel
             virtual ~Layer();
 
             virtual void draw();
+            void updateWorld();
 
             void addChild(Actor* actor) override;
 
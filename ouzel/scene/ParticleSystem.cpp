@@ -1,8 +1,15 @@
 // Copyright 2015-2019 Elviss Strazdins. All rights reserved.
 
 #include <algorithm>
+#include <cmath>
 #include <cstdlib>
+#include <limits>
 #include <stdexcept>
+#if defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#elif defined(__SSE__)
+#  include <xmmintrin.h>
+#endif
 #include "ParticleSystem.hpp"
 #include "core/Engine.hpp"
 #include "SceneManager.hpp"
@@ -16,18 +23,197 @@
 
 static constexpr float UPDATE_STEP = 1.0F / 60.0F;
 
+// values[i] += deltas[i] * step
+static void integrate(float* values, const float* deltas, float step, uint32_t count)
+{
+    uint32_t i = 0;
+
+    if (ouzel::isSimdAvailable)
+    {
+#if defined(__ARM_NEON__)
+        const float32x4_t s = vdupq_n_f32(step);
+        for (; i + 4 <= count; i += 4)
+            vst1q_f32(values + i, vaddq_f32(vld1q_f32(values + i), vmulq_f32(vld1q_f32(deltas + i), s)));
+#elif defined(__SSE__)
+        const __m128 s = _mm_set1_ps(step);
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), _mm_mul_ps(_mm_loadu_ps(deltas + i), s)));
+#endif
+    }
+
+    for (; i < count; ++i)
+        values[i] += deltas[i] * step;
+}
+
+// values[i] = max(values[i] + deltas[i] * step, minimum)
+static void integrateClamped(float* values, const float* deltas, float step, float minimum, uint32_t count)
+{
+    uint32_t i = 0;
+
+    if (ouzel::isSimdAvailable)
+    {
+#if defined(__ARM_NEON__)
+        const float32x4_t s = vdupq_n_f32(step);
+        const float32x4_t m = vdupq_n_f32(minimum);
+        for (; i + 4 <= count; i += 4)
+            vst1q_f32(values + i, vmaxq_f32(vaddq_f32(vld1q_f32(values + i), vmulq_f32(vld1q_f32(deltas + i), s)), m));
+#elif defined(__SSE__)
+        const __m128 s = _mm_set1_ps(step);
+        const __m128 m = _mm_set1_ps(minimum);
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(values + i, _mm_max_ps(_mm_add_ps(_mm_loadu_ps(values + i), _mm_mul_ps(_mm_loadu_ps(deltas + i), s)), m));
+#endif
+    }
+
+    for (; i < count; ++i)
+        values[i] = std::max(values[i] + deltas[i] * step, minimum);
+}
+
+// values[i] -= step
+static void decrement(float* values, float step, uint32_t count)
+{
+    uint32_t i = 0;
+
+    if (ouzel::isSimdAvailable)
+    {
+#if defined(__ARM_NEON__)
+        const float32x4_t s = vdupq_n_f32(step);
+        for (; i + 4 <= count; i += 4)
+            vst1q_f32(values + i, vsubq_f32(vld1q_f32(values + i), s));
+#elif defined(__SSE__)
+        const __m128 s = _mm_set1_ps(step);
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps(values + i, _mm_sub_ps(_mm_loadu_ps(values + i), s));
+#endif
+    }
+
+    for (; i < count; ++i)
+        values[i] -= step;
+}
+
+static void updateGravity(float* positionX, float* positionY,
+                          float* directionX, float* directionY,
+                          const float* radialAcceleration, const float* tangentialAcceleration,
+                          float gravityX, float gravityY, float step, float yFlip,
+                          uint32_t count)
+{
+    uint32_t i = 0;
+
+    if (ouzel::isSimdAvailable)
+    {
+#if defined(__ARM_NEON__)
+#  if defined(__arm64__) || defined(__aarch64__) // NEON64
+        const float32x4_t zero = vdupq_n_f32(0.0F);
+        const float32x4_t minLength = vdupq_n_f32(std::numeric_limits<float>::min());
+        const float32x4_t gx = vdupq_n_f32(gravityX);
+        const float32x4_t gy = vdupq_n_f32(gravityY);
+        const float32x4_t s = vdupq_n_f32(step);
+        const float32x4_t f = vdupq_n_f32(yFlip);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            float32x4_t px = vld1q_f32(positionX + i);
+            float32x4_t py = vld1q_f32(positionY + i);
+
+            // radial direction is the normalized position (only for particles on an axis)
+            const uint32x4_t onAxis = vorrq_u32(vceqq_f32(px, zero), vceqq_f32(py, zero));
+            const float32x4_t length = vsqrtq_f32(vaddq_f32(vmulq_f32(px, px), vmulq_f32(py, py)));
+            const uint32x4_t mask = vandq_u32(onAxis, vcgtq_f32(length, minLength));
+            const float32x4_t rx = vreinterpretq_f32_u32(vandq_u32(mask, vreinterpretq_u32_f32(vdivq_f32(px, length))));
+            const float32x4_t ry = vreinterpretq_f32_u32(vandq_u32(mask, vreinterpretq_u32_f32(vdivq_f32(py, length))));
+
+            const float32x4_t ra = vld1q_f32(radialAcceleration + i);
+            const float32x4_t ta = vld1q_f32(tangentialAcceleration + i);
+
+            // (radial + tangential + gravity) * step
+            const float32x4_t ax = vmulq_f32(vaddq_f32(vaddq_f32(vmulq_f32(rx, ra), vmulq_f32(ry, vnegq_f32(ta))), gx), s);
+            const float32x4_t ay = vmulq_f32(vaddq_f32(vaddq_f32(vmulq_f32(ry, ra), vmulq_f32(rx, ta)), gy), s);
+
+            const float32x4_t dx = vaddq_f32(vld1q_f32(directionX + i), ax);
+            const float32x4_t dy = vaddq_f32(vld1q_f32(directionY + i), ay);
+            vst1q_f32(directionX + i, dx);
+            vst1q_f32(directionY + i, dy);
+
+            vst1q_f32(positionX + i, vaddq_f32(px, vmulq_f32(vmulq_f32(dx, s), f)));
+            vst1q_f32(positionY + i, vaddq_f32(py, vmulq_f32(vmulq_f32(dy, s), f)));
+        }
+#  endif
+#elif defined(__SSE__)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 minLength = _mm_set1_ps(std::numeric_limits<float>::min());
+        const __m128 gx = _mm_set1_ps(gravityX);
+        const __m128 gy = _mm_set1_ps(gravityY);
+        const __m128 s = _mm_set1_ps(step);
+        const __m128 f = _mm_set1_ps(yFlip);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 px = _mm_loadu_ps(positionX + i);
+            __m128 py = _mm_loadu_ps(positionY + i);
+
+            // radial direction is the normalized position (only for particles on an axis)
+            const __m128 onAxis = _mm_or_ps(_mm_cmpeq_ps(px, zero), _mm_cmpeq_ps(py, zero));
+            const __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(px, px), _mm_mul_ps(py, py)));
+            const __m128 mask = _mm_and_ps(onAxis, _mm_cmpgt_ps(length, minLength));
+            const __m128 rx = _mm_and_ps(mask, _mm_div_ps(px, length));
+            const __m128 ry = _mm_and_ps(mask, _mm_div_ps(py, length));
+
+            const __m128 ra = _mm_loadu_ps(radialAcceleration + i);
+            const __m128 ta = _mm_loadu_ps(tangentialAcceleration + i);
+
+            // (radial + tangential + gravity) * step
+            const __m128 ax = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, ra), _mm_mul_ps(ry, _mm_sub_ps(zero, ta))), gx), s);
+            const __m128 ay = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ry, ra), _mm_mul_ps(rx, ta)), gy), s);
+
+            const __m128 dx = _mm_add_ps(_mm_loadu_ps(directionX + i), ax);
+            const __m128 dy = _mm_add_ps(_mm_loadu_ps(directionY + i), ay);
+            _mm_storeu_ps(directionX + i, dx);
+            _mm_storeu_ps(directionY + i, dy);
+
+            _mm_storeu_ps(positionX + i, _mm_add_ps(px, _mm_mul_ps(_mm_mul_ps(dx, s), f)));
+            _mm_storeu_ps(positionY + i, _mm_add_ps(py, _mm_mul_ps(_mm_mul_ps(dy, s), f)));
+        }
+#endif
+    }
+
+    for (; i < count; ++i)
+    {
+        float rx = 0.0F;
+        float ry = 0.0F;
+
+        // radial direction is the normalized position (only for particles on an axis)
+        if (positionX[i] == 0.0F || positionY[i] == 0.0F)
+        {
+            const float length = std::sqrt(positionX[i] * positionX[i] + positionY[i] * positionY[i]);
+            if (length > std::numeric_limits<float>::min())
+            {
+                rx = positionX[i] / length;
+                ry = positionY[i] / length;
+            }
+        }
+
+        // (radial + tangential + gravity) * step
+        directionX[i] += (rx * radialAcceleration[i] + ry * -tangentialAcceleration[i] + gravityX) * step;
+        directionY[i] += (ry * radialAcceleration[i] + rx * tangentialAcceleration[i] + gravityY) * step;
+
+        positionX[i] += directionX[i] * step * yFlip;
+        positionY[i] += directionY[i] * step * yFlip;
+    }
+}
+
 namespace ouzel
 {
     namespace scene
     {
         ParticleSystem::ParticleSystem():
-            Component(CLASS)
+            Component(CLASS),
+            randomEngine(ouzel::randomEngine())
         {
             shader = engine->getCache().getShader(SHADER_TEXTURE);
             blendState = engine->getCache().getBlendState(BLEND_ALPHA);
             whitePixelTexture = engine->getCache().getTexture(TEXTURE_WHITE_PIXEL);
 
-            updateHandler.updateHandler = std::bind(&ParticleSystem::handleUpdate, this, std::placeholders::_1);
+            reloadHandler.systemHandler = std::bind(&ParticleSystem::handleSystem, this, std::placeholders::_1);
         }
 
         ParticleSystem::ParticleSystem(const ParticleSystemData& initParticleSystemData):
@@ -42,6 +228,12 @@ namespace ouzel
             init(filename);
         }
 
+        ParticleSystem::~ParticleSystem()
+        {
+            if (active)
+                engine->getSceneManager().getParticleWorld().removeParticleSystem(this);
+        }
+
         void ParticleSystem::draw(const Matrix4F& transformMatrix,
                                   float opacity,
                                   const Matrix4F& renderViewProjection,
@@ -92,6 +284,22 @@ namespace ouzel
             }
         }
 
+        void ParticleSystem::prepareUpdate()
+        {
+            // actor transforms are calculated lazily, so read them before the update runs on a worker thread
+            if (actor)
+            {
+                if (particleSystemData.positionType == ParticleSystemData::PositionType::FREE)
+                    emitterPosition = Vector2F(actor->convertLocalToWorld(Vector3F()));
+                else if (particleSystemData.positionType == ParticleSystemData::PositionType::PARENT)
+                    emitterPosition = Vector2F(actor->convertLocalToWorld(Vector3F()) - actor->getPosition());
+                else
+                    emitterPosition = Vector2F();
+
+                inverseTransform = actor->getInverseTransform();
+            }
+        }
+
         void ParticleSystem::update(float delta)
         {
             timeSinceUpdate += delta;
@@ -128,87 +336,13 @@ namespace ouzel
                 }
                 else if (active && !particleCount)
                 {
-                    active = false;
-                    updateHandler.remove();
-
-                    std::unique_ptr<AnimationEvent> finishEvent(new AnimationEvent());
-                    finishEvent->type = Event::Type::ANIMATION_FINISH;
-                    finishEvent->component = this;
-                    engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
-
+                    finishPending = true;
                     return;
                 }
 
                 if (active)
                 {
-                    for (uint32_t counter = particleCount; counter > 0; --counter)
-                    {
-                        size_t i = counter - 1;
-
-                        particles[i].life -= UPDATE_STEP;
-
-                        if (particles[i].life >= 0.0F)
-                        {
-                            if (particleSystemData.emitterType == ParticleSystemData::EmitterType::GRAVITY)
-                            {
-                                Vector2F tmp;
-                                Vector2F radial;
-                                Vector2F tangential;
-
-                                // radial acceleration
-                                if (particles[i].position.v[0] == 0.0F || particles[i].position.v[1] == 0.0F)
-                                {
-                                    radial = particles[i].position;
-                                    radial.normalize();
-                                }
-                                tangential = radial;
-                                radial *= particles[i].radialAcceleration;
-
-                                // tangential acceleration
-                                std::swap(tangential.v[0], tangential.v[1]);
-                                tangential.v[0] *= - particles[i].tangentialAcceleration;
-                                tangential.v[1] *= particles[i].tangentialAcceleration;
-
-                                // (gravity + radial + tangential) * UPDATE_STEP
-                                tmp.v[0] = radial.v[0] + tangential.v[0] + particleSystemData.gravity.v[0];
-                                tmp.v[1] = radial.v[1] + tangential.v[1] + particleSystemData.gravity.v[1];
-                                tmp.v[0] *= UPDATE_STEP;
-                                tmp.v[1] *= UPDATE_STEP;
-
-                                particles[i].direction.v[0] += tmp.v[0];
-                                particles[i].direction.v[1] += tmp.v[1];
-                                tmp.v[0] = particles[i].direction.v[0] * UPDATE_STEP * particleSystemData.yCoordFlipped;
-                                tmp.v[1] = particles[i].direction.v[1] * UPDATE_STEP * particleSystemData.yCoordFlipped;
-                                particles[i].position.v[0] += tmp.v[0];
-                                particles[i].position.v[1] += tmp.v[1];
-                            }
-                            else
-                            {
-                                particles[i].angle += particles[i].degreesPerSecond * UPDATE_STEP;
-                                particles[i].radius += particles[i].deltaRadius * UPDATE_STEP;
-                                particles[i].position.v[0] = -cos(particles[i].angle) * particles[i].radius;
-                                particles[i].position.v[1] = -sin(particles[i].angle) * particles[i].radius * particleSystemData.yCoordFlipped;
-                            }
-
-                            // color r,g,b,a
-                            particles[i].colorRed += particles[i].deltaColorRed * UPDATE_STEP;
-                            particles[i].colorGreen += particles[i].deltaColorGreen * UPDATE_STEP;
-                            particles[i].colorBlue += particles[i].deltaColorBlue * UPDATE_STEP;
-                            particles[i].colorAlpha += particles[i].deltaColorAlpha * UPDATE_STEP;
-
-                            // size
-                            particles[i].size += (particles[i].deltaSize * UPDATE_STEP);
-                            particles[i].size = std::max(0.0F, particles[i].size);
-
-                            // angle
-                            particles[i].rotation += particles[i].deltaRotation * UPDATE_STEP;
-                        }
-                        else
-                        {
-                            particles[i] = particles[particleCount - 1];
-                            --particleCount;
-                        }
-                    }
+                    updateParticles(UPDATE_STEP);
 
                     needsMeshUpdate = true;
                     needsBoundingBoxUpdate = true;
@@ -225,11 +359,13 @@ namespace ouzel
                 {
                     if (actor)
                     {
-                        const Matrix4F& inverseTransform = actor->getInverseTransform();
+                        // the inverse transform was taken in prepareUpdate, the actor can't be read from a worker thread
+                        const float* positionX = getAttribute(POSITION_X);
+                        const float* positionY = getAttribute(POSITION_Y);
 
                         for (uint32_t i = 0; i < particleCount; ++i)
                         {
-                            Vector3F position = Vector3F(particles[i].position);
+                            Vector3F position(positionX[i], positionY[i], 0.0F);
                             inverseTransform.transformPoint(position);
                             boundingBox.insertPoint(position);
                         }
@@ -237,20 +373,95 @@ namespace ouzel
                 }
                 else if (particleSystemData.positionType == ParticleSystemData::PositionType::GROUPED)
                 {
+                    const float* positionX = getAttribute(POSITION_X);
+                    const float* positionY = getAttribute(POSITION_Y);
+
                     for (uint32_t i = 0; i < particleCount; ++i)
-                        boundingBox.insertPoint(Vector3F(particles[i].position));
+                        boundingBox.insertPoint(Vector3F(positionX[i], positionY[i], 0.0F));
                 }
             }
         }
 
-        bool ParticleSystem::handleUpdate(const UpdateEvent& event)
+        void ParticleSystem::updateParticles(float step)
         {
-            update(event.delta);
-            return false;
+            decrement(getAttribute(LIFE), step, particleCount);
+
+            if (particleSystemData.emitterType == ParticleSystemData::EmitterType::GRAVITY)
+            {
+                updateGravity(getAttribute(POSITION_X), getAttribute(POSITION_Y),
+                              getAttribute(DIRECTION_X), getAttribute(DIRECTION_Y),
+                              getAttribute(RADIAL_ACCELERATION), getAttribute(TANGENTIAL_ACCELERATION),
+                              particleSystemData.gravity.v[0], particleSystemData.gravity.v[1],
+                              step, particleSystemData.yCoordFlipped ? 1.0F : 0.0F,
+                              particleCount);
+            }
+            else
+            {
+                float* angle = getAttribute(ANGLE);
+                float* radius = getAttribute(RADIUS);
+                float* positionX = getAttribute(POSITION_X);
+                float* positionY = getAttribute(POSITION_Y);
+                const float yFlip = particleSystemData.yCoordFlipped ? 1.0F : 0.0F;
+
+                integrate(angle, getAttribute(DEGREES_PER_SECOND), step, particleCount);
+                integrate(radius, getAttribute(DELTA_RADIUS), step, particleCount);
+
+                for (uint32_t i = 0; i < particleCount; ++i)
+                {
+                    positionX[i] = -std::cos(angle[i]) * radius[i];
+                    positionY[i] = -std::sin(angle[i]) * radius[i] * yFlip;
+                }
+            }
+
+            integrate(getAttribute(COLOR_RED), getAttribute(DELTA_COLOR_RED), step, particleCount);
+            integrate(getAttribute(COLOR_GREEN), getAttribute(DELTA_COLOR_GREEN), step, particleCount);
+            integrate(getAttribute(COLOR_BLUE), getAttribute(DELTA_COLOR_BLUE), step, particleCount);
+            integrate(getAttribute(COLOR_ALPHA), getAttribute(DELTA_COLOR_ALPHA), step, particleCount);
+            integrateClamped(getAttribute(SIZE), getAttribute(DELTA_SIZE), step, 0.0F, particleCount);
+            integrate(getAttribute(ROTATION), getAttribute(DELTA_ROTATION), step, particleCount);
+
+            // remove dead particles by moving the last particle in their place
+            const float* life = getAttribute(LIFE);
+            for (uint32_t counter = particleCount; counter > 0; --counter)
+            {
+                uint32_t i = counter - 1;
+
+                if (life[i] < 0.0F)
+                    removeParticle(i);
+            }
+        }
+
+        void ParticleSystem::removeParticle(uint32_t index)
+        {
+            --particleCount;
+
+            if (index != particleCount)
+                for (uint32_t attribute = 0; attribute < ATTRIBUTE_COUNT; ++attribute)
+                {
+                    float* values = getAttribute(static_cast<Attribute>(attribute));
+                    values[index] = values[particleCount];
+                }
+        }
+
+        void ParticleSystem::finishUpdate()
+        {
+            if (finishPending)
+            {
+                finishPending = false;
+                active = false;
+
+                std::unique_ptr<AnimationEvent> finishEvent(new AnimationEvent());
+                finishEvent->type = Event::Type::ANIMATION_FINISH;
+                finishEvent->component = this;
+                engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+            }
         }
 
         void ParticleSystem::init(const ParticleSystemData& newParticleSystemData)
         {
+            filename.clear();
+            reloadHandler.remove();
+
             particleSystemData = newParticleSystemData;
 
             texture = particleSystemData.texture;
@@ -262,19 +473,49 @@ namespace ouzel
             resume();
         }
 
-        void ParticleSystem::init(const std::string& filename)
+        void ParticleSystem::init(const std::string& newFilename)
         {
-            particleSystemData = *engine->getCache().getParticleSystemData(filename);
+            particleSystemData = *engine->getCache().getParticleSystemData(newFilename);
 
             texture = particleSystemData.texture;
 
             if (!texture)
                 throw std::runtime_error("Paricle system data has no texture");
 
+            filename = newFilename;
+            if (engine->getCache().isHotReloadEnabled())
+                engine->getEventDispatcher().addEventHandler(&reloadHandler);
+            else
+                reloadHandler.remove();
+
             createParticleMesh();
             resume();
         }
 
+        bool ParticleSystem::handleSystem(const SystemEvent& event)
+        {
+            if (event.type != Event::Type::ASSET_RELOAD || event.filename != filename)
+                return false;
+
+            const ParticleSystemData* newParticleSystemData = engine->getCache().getParticleSystemData(filename);
+            if (!newParticleSystemData || !newParticleSystemData->texture) return false;
+
+            const uint32_t previousMaxParticles = particleSystemData.maxParticles;
+
+            // the emitter keeps running, the particles that are alive finish with their current attributes
+            particleSystemData = *newParticleSystemData;
+            texture = particleSystemData.texture;
+
+            if (particleSystemData.maxParticles != previousMaxParticles)
+            {
+                // the attribute streams are laid out by the capacity, so the old particles can't be kept
+                particleCount = 0;
+                createParticleMesh();
+            }
+
+            return false;
+        }
+
         void ParticleSystem::resume()
         {
             if (!running)
@@ -285,7 +526,7 @@ namespace ouzel
                 if (!active)
                 {
                     active = true;
-                    engine->getEventDispatcher().addEventHandler(&updateHandler);
+                    engine->getSceneManager().getParticleWorld().addParticleSystem(this);
                 }
 
                 if (particleCount == 0)
@@ -314,6 +555,9 @@ namespace ouzel
 
         void ParticleSystem::createParticleMesh()
         {
+            indices.clear();
+            vertices.clear();
+
             indices.reserve(particleSystemData.maxParticles * 6);
             vertices.reserve(particleSystemData.maxParticles * 4);
 
@@ -347,13 +591,23 @@ namespace ouzel
                                                               vertices.data(),
                                                               static_cast<uint32_t>(getVectorSize(vertices)));
 
-            particles.resize(particleSystemData.maxParticles);
+            particleCapacity = particleSystemData.maxParticles;
+            particles.resize(ATTRIBUTE_COUNT * particleCapacity);
         }
 
         void ParticleSystem::updateParticleMesh()
         {
             if (actor)
             {
+                const float* positionX = getAttribute(POSITION_X);
+                const float* positionY = getAttribute(POSITION_Y);
+                const float* size = getAttribute(SIZE);
+                const float* rotation = getAttribute(ROTATION);
+                const float* colorRed = getAttribute(COLOR_RED);
+                const float* colorGreen = getAttribute(COLOR_GREEN);
+                const float* colorBlue = getAttribute(COLOR_BLUE);
+                const float* colorAlpha = getAttribute(COLOR_ALPHA);
+
                 for (uint32_t counter = particleCount; counter > 0; --counter)
                 {
                     size_t i = counter - 1;
@@ -361,15 +615,15 @@ namespace ouzel
                     Vector2F position;
 
                     if (particleSystemData.positionType == ParticleSystemData::PositionType::FREE)
-                        position = particles[i].position;
+                        position = Vector2F(positionX[i], positionY[i]);
                     else if (particleSystemData.positionType == ParticleSystemData::PositionType::PARENT)
-                        position = Vector2F(actor->getPosition()) + particles[i].position;
+                        position = Vector2F(actor->getPosition()) + Vector2F(positionX[i], positionY[i]);
 
-                    float size_2 = particles[i].size / 2.0F;
+                    float size_2 = size[i] / 2.0F;
                     Vector2F v1(-size_2, -size_2);
                     Vector2F v2(size_2, size_2);
 
-                    float r = -degToRad(particles[i].rotation);
+                    float r = -degToRad(rotation[i]);
                     float cr = cos(r);
                     float sr = sin(r);
 
@@ -378,10 +632,10 @@ namespace ouzel
                     Vector2F c(v2.v[0] * cr - v2.v[1] * sr, v2.v[0] * sr + v2.v[1] * cr);
                     Vector2F d(v1.v[0] * cr - v2.v[1] * sr, v1.v[0] * sr + v2.v[1] * cr);
 
-                    Color color(static_cast<uint8_t>(particles[i].colorRed * 255),
-                                static_cast<uint8_t>(particles[i].colorGreen * 255),
-                                static_cast<uint8_t>(particles[i].colorBlue * 255),
-                                static_cast<uint8_t>(particles[i].colorAlpha * 255));
+                    Color color(static_cast<uint8_t>(colorRed[i] * 255),
+                                static_cast<uint8_t>(colorGreen[i] * 255),
+                                static_cast<uint8_t>(colorBlue[i] * 255),
+                                static_cast<uint8_t>(colorAlpha[i] * 255));
 
                     vertices[i * 4 + 0].position = Vector3F(a + position);
                     vertices[i * 4 + 0].color = color;
@@ -407,49 +661,68 @@ namespace ouzel
 
             if (count && actor)
             {
-                Vector2F position;
-
-                if (particleSystemData.positionType == ParticleSystemData::PositionType::FREE)
-                    position = Vector2F(actor->convertLocalToWorld(Vector3F()));
-                else if (particleSystemData.positionType == ParticleSystemData::PositionType::PARENT)
-                    position = Vector2F(actor->convertLocalToWorld(Vector3F()) - actor->getPosition());
+                float* life = getAttribute(LIFE);
+                float* positionX = getAttribute(POSITION_X);
+                float* positionY = getAttribute(POSITION_Y);
+                float* colorRed = getAttribute(COLOR_RED);
+                float* colorGreen = getAttribute(COLOR_GREEN);
+                float* colorBlue = getAttribute(COLOR_BLUE);
+                float* colorAlpha = getAttribute(COLOR_ALPHA);
+                float* deltaColorRed = getAttribute(DELTA_COLOR_RED);
+                float* deltaColorGreen = getAttribute(DELTA_COLOR_GREEN);
+                float* deltaColorBlue = getAttribute(DELTA_COLOR_BLUE);
+                float* deltaColorAlpha = getAttribute(DELTA_COLOR_ALPHA);
+                float* angle = getAttribute(ANGLE);
+                float* size = getAttribute(SIZE);
+                float* deltaSize = getAttribute(DELTA_SIZE);
+                float* rotation = getAttribute(ROTATION);
+                float* deltaRotation = getAttribute(DELTA_ROTATION);
+                float* radialAcceleration = getAttribute(RADIAL_ACCELERATION);
+                float* tangentialAcceleration = getAttribute(TANGENTIAL_ACCELERATION);
+                float* directionX = getAttribute(DIRECTION_X);
+                float* directionY = getAttribute(DIRECTION_Y);
+                float* radius = getAttribute(RADIUS);
+                float* degreesPerSecond = getAttribute(DEGREES_PER_SECOND);
+                float* deltaRadius = getAttribute(DELTA_RADIUS);
 
                 for (uint32_t i = particleCount; i < particleCount + count; ++i)
                 {
                     if (particleSystemData.emitterType == ParticleSystemData::EmitterType::GRAVITY)
                     {
-                        particles[i].life = std::max(particleSystemData.particleLifespan + particleSystemData.particleLifespanVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
+                        life[i] = std::max(particleSystemData.particleLifespan + particleSystemData.particleLifespanVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
 
-                        particles[i].position = particleSystemData.sourcePosition + position + Vector2F(particleSystemData.sourcePositionVariance.v[0] * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine),
-                                                                                                       particleSystemData.sourcePositionVariance.v[1] * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
+                        Vector2F particlePosition = particleSystemData.sourcePosition + emitterPosition + Vector2F(particleSystemData.sourcePositionVariance.v[0] * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine),
+                                                                                                                  particleSystemData.sourcePositionVariance.v[1] * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
+                        positionX[i] = particlePosition.v[0];
+                        positionY[i] = particlePosition.v[1];
 
-                        particles[i].size = std::max(particleSystemData.startParticleSize + particleSystemData.startParticleSizeVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
+                        size[i] = std::max(particleSystemData.startParticleSize + particleSystemData.startParticleSizeVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
 
                         float finishSize = std::max(particleSystemData.finishParticleSize + particleSystemData.finishParticleSizeVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
-                        particles[i].deltaSize = (finishSize - particles[i].size) / particles[i].life;
+                        deltaSize[i] = (finishSize - size[i]) / life[i];
 
-                        particles[i].colorRed = clamp(particleSystemData.startColorRed + particleSystemData.startColorRedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        particles[i].colorGreen = clamp(particleSystemData.startColorGreen + particleSystemData.startColorGreenVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        particles[i].colorBlue = clamp(particleSystemData.startColorBlue + particleSystemData.startColorBlueVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        particles[i].colorAlpha = clamp(particleSystemData.startColorAlpha + particleSystemData.startColorAlphaVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
+                        colorRed[i] = clamp(particleSystemData.startColorRed + particleSystemData.startColorRedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
+                        colorGreen[i] = clamp(particleSystemData.startColorGreen + particleSystemData.startColorGreenVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
+                        colorBlue[i] = clamp(particleSystemData.startColorBlue + particleSystemData.startColorBlueVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
+                        colorAlpha[i] = clamp(particleSystemData.startColorAlpha + particleSystemData.startColorAlphaVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
 
                         float finishColorRed = clamp(particleSystemData.finishColorRed + particleSystemData.finishColorRedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
                         float finishColorGreen = clamp(particleSystemData.finishColorGreen + particleSystemData.finishColorGreenVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
                         float finishColorBlue = clamp(particleSystemData.finishColorBlue + particleSystemData.finishColorBlueVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
                         float finishColorAlpha = clamp(particleSystemData.finishColorAlpha + particleSystemData.finishColorAlphaVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
 
-                        particles[i].deltaColorRed = (finishColorRed - particles[i].colorRed) / particles[i].life;
-                        particles[i].deltaColorGreen = (finishColorGreen - particles[i].colorGreen) / particles[i].life;
-                        particles[i].deltaColorBlue = (finishColorBlue - particles[i].colorBlue) / particles[i].life;
-                        particles[i].deltaColorAlpha = (finishColorAlpha - particles[i].colorAlpha) / particles[i].life;
+                        deltaColorRed[i] = (finishColorRed - colorRed[i]) / life[i];
+                        deltaColorGreen[i] = (finishColorGreen - colorGreen[i]) / life[i];
+                        deltaColorBlue[i] = (finishColorBlue - colorBlue[i]) / life[i];
+                        deltaColorAlpha[i] = (finishColorAlpha - colorAlpha[i]) / life[i];
 
-                        particles[i].rotation = particleSystemData.startRotation + particleSystemData.startRotationVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
+                        rotation[i] = particleSystemData.startRotation + particleSystemData.startRotationVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
 
                         float finishRotation = particleSystemData.finishRotation + particleSystemData.finishRotationVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                        particles[i].deltaRotation = (finishRotation - particles[i].rotation) / particles[i].life;
+                        deltaRotation[i] = (finishRotation - rotation[i]) / life[i];
 
-                        particles[i].radialAcceleration = particleSystemData.radialAcceleration + particleSystemData.radialAcceleration * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                        particles[i].tangentialAcceleration = particleSystemData.tangentialAcceleration + particleSystemData.tangentialAcceleration * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
+                        radialAcceleration[i] = particleSystemData.radialAcceleration + particleSystemData.radialAcceleration * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
+                        tangentialAcceleration[i] = particleSystemData.tangentialAcceleration + particleSystemData.tangentialAcceleration * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
 
                         if (particleSystemData.rotationIsDir)
                         {
@@ -457,8 +730,9 @@ namespace ouzel
                             Vector2F v(cos(a), sin(a));
                             float s = particleSystemData.speed + particleSystemData.speedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
                             Vector2F dir = v * s;
-                            particles[i].direction = dir;
-                            particles[i].rotation = -radToDeg(dir.getAngle());
+                            directionX[i] = dir.v[0];
+                            directionY[i] = dir.v[1];
+                            rotation[i] = -radToDeg(dir.getAngle());
                         }
                         else
                         {
@@ -466,17 +740,18 @@ namespace ouzel
                             Vector2F v(cos(a), sin(a));
                             float s = particleSystemData.speed + particleSystemData.speedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
                             Vector2F dir = v * s;
-                            particles[i].direction = dir;
+                            directionX[i] = dir.v[0];
+                            directionY[i] = dir.v[1];
                         }
                     }
                     else
                     {
-                        particles[i].radius = particleSystemData.maxRadius + particleSystemData.maxRadiusVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                        particles[i].angle = degToRad(particleSystemData.angle + particleSystemData.angleVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
-                        particles[i].degreesPerSecond = degToRad(particleSystemData.rotatePerSecond + particleSystemData.rotatePerSecondVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
+                        radius[i] = particleSystemData.maxRadius + particleSystemData.maxRadiusVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
+                        angle[i] = degToRad(particleSystemData.angle + particleSystemData.angleVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
+                        degreesPerSecond[i] = degToRad(particleSystemData.rotatePerSecond + particleSystemData.rotatePerSecondVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
 
                         float endRadius = particleSystemData.minRadius + particleSystemData.minRadiusVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                        particles[i].deltaRadius = (endRadius - particles[i].radius) / particles[i].life;
+                        deltaRadius[i] = (endRadius - radius[i]) / life[i];
                     }
                 }
 
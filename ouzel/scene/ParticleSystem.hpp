@@ -3,13 +3,15 @@
 #ifndef OUZEL_SCENE_PARTICLESYSTEM_HPP
 #define OUZEL_SCENE_PARTICLESYSTEM_HPP
 
+#include <random>
 #include <string>
 #include <vector>
 #include <functional>
 #include "scene/Component.hpp"
+#include "events/EventHandler.hpp"
 #include "math/Color.hpp"
+#include "math/Matrix.hpp"
 #include "math/Vector.hpp"
-#include "events/EventHandler.hpp"
 #include "graphics/Vertex.hpp"
 #include "graphics/BlendState.hpp"
 #include "graphics/Buffer.hpp"
@@ -115,14 +117,18 @@ namespace ouzel
             std::shared_ptr<graphics::Texture> texture;
         };
 
+        class ParticleWorld;
+
         class ParticleSystem: public Component
         {
+            friend ParticleWorld;
         public:
             static constexpr uint32_t CLASS = Component::PARTICLE_SYSTEM;
 
             ParticleSystem();
             explicit ParticleSystem(const ParticleSystemData& initParticleSystemData);
             explicit ParticleSystem(const std::string& filename);
+            ~ParticleSystem() override;
 
             void draw(const Matrix4F& transformMatrix,
                       float opacity,
@@ -142,9 +148,18 @@ namespace ouzel
             inline ParticleSystemData::PositionType getPositionType() const { return particleSystemData.positionType; }
             inline void setPositionType(ParticleSystemData::PositionType newPositionType) { particleSystemData.positionType = newPositionType; }
 
+            // seeds the emitter's own random engine, the simulation is deterministic for the same seed
+            inline void setRandomSeed(uint32_t seed) { randomEngine.seed(seed); }
+
         private:
+            // called by the particle world on the update thread before the simulation
+            void prepareUpdate();
+            // called by the particle world, possibly on a worker thread
             void update(float delta);
-            bool handleUpdate(const UpdateEvent& event);
+            // called by the particle world on the update thread after the simulation
+            void finishUpdate();
+
+            bool handleSystem(const SystemEvent& event);
 
             void createParticleMesh();
             void updateParticleMesh();
@@ -158,41 +173,43 @@ namespace ouzel
             std::shared_ptr<graphics::Texture> texture;
             std::shared_ptr<graphics::Texture> whitePixelTexture;
 
-            struct Particle final
+            // particle attributes are stored as a structure of arrays, one stream of particleCapacity floats per attribute
+            enum Attribute
             {
-                float life = 0.0F;
-
-                Vector2F position;
-
-                float colorRed = 0.0F;
-                float colorGreen = 0.0F;
-                float colorBlue = 0.0F;
-                float colorAlpha = 0.0F;
-
-                float deltaColorRed = 0.0F;
-                float deltaColorGreen = 0.0F;
-                float deltaColorBlue = 0.0F;
-                float deltaColorAlpha = 0.0F;
-
-                float angle = 0.0F;
-                float speed = 0.0F;
-
-                float size = 0.0F;
-                float deltaSize = 0.0F;
+                LIFE,
+                POSITION_X,
+                POSITION_Y,
+                COLOR_RED,
+                COLOR_GREEN,
+                COLOR_BLUE,
+                COLOR_ALPHA,
+                DELTA_COLOR_RED,
+                DELTA_COLOR_GREEN,
+                DELTA_COLOR_BLUE,
+                DELTA_COLOR_ALPHA,
+                ANGLE,
+                SIZE,
+                DELTA_SIZE,
+                ROTATION,
+                DELTA_ROTATION,
+                RADIAL_ACCELERATION,
+                TANGENTIAL_ACCELERATION,
+                DIRECTION_X,
+                DIRECTION_Y,
+                RADIUS,
+                DEGREES_PER_SECOND,
+                DELTA_RADIUS,
+                ATTRIBUTE_COUNT
+            };
 
-                float rotation = 0.0F;
-                float deltaRotation = 0.0F;
+            inline float* getAttribute(Attribute attribute) { return particles.data() + attribute * particleCapacity; }
+            inline const float* getAttribute(Attribute attribute) const { return particles.data() + attribute * particleCapacity; }
 
-                float radialAcceleration = 0.0F;
-                float tangentialAcceleration = 0.0F;
+            void updateParticles(float step);
+            void removeParticle(uint32_t index);
 
-                Vector2F direction;
-                float radius = 0.0F;
-                float degreesPerSecond = 0.0F;
-                float deltaRadius = 0.0F;
-            };
-
-            std::vector<Particle> particles;
+            std::vector<float> particles;
+            uint32_t particleCapacity = 0;
 
             std::shared_ptr<graphics::Buffer> indexBuffer;
             std::shared_ptr<graphics::Buffer> vertexBuffer;
@@ -210,8 +227,15 @@ namespace ouzel
             bool finished = false;
 
             bool needsMeshUpdate = false;
+            bool finishPending = false;
+
+            Vector2F emitterPosition;
+            Matrix4F inverseTransform;
+
+            std::mt19937 randomEngine;
 
-            EventHandler updateHandler;
+            std::string filename; // the data is taken again when the asset with this name is reloaded
+            EventHandler reloadHandler;
         };
     } // namespace scene
 } // namespace ouzel
@@ -0,0 +1,165 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "ParticleWorld.hpp"
+#include "ParticleSystem.hpp"
+#include "core/Engine.hpp"
+#include "utils/Utils.hpp"
+
+// number of particle systems a thread takes at once
+static constexpr size_t CHUNK_SIZE = 4;
+
+namespace ouzel
+{
+    namespace scene
+    {
+        ParticleWorld::ParticleWorld()
+        {
+            updateHandler.updateHandler = std::bind(&ParticleWorld::handleUpdate, this, std::placeholders::_1);
+        }
+
+        ParticleWorld::~ParticleWorld()
+        {
+            std::unique_lock<std::mutex> lock(workerMutex);
+            running = false;
+            lock.unlock();
+            workerCondition.notify_all();
+
+            for (std::thread& worker : workers)
+                if (worker.joinable()) worker.join();
+        }
+
+        void ParticleWorld::addParticleSystem(ParticleSystem* particleSystem)
+        {
+            auto i = std::find(particleSystems.begin(), particleSystems.end(), particleSystem);
+
+            if (i == particleSystems.end())
+            {
+                if (particleSystems.empty())
+                    engine->getEventDispatcher().addEventHandler(&updateHandler);
+
+                particleSystems.push_back(particleSystem);
+            }
+        }
+
+        void ParticleWorld::removeParticleSystem(ParticleSystem* particleSystem)
+        {
+            // the entry is erased on the next update, so that it is safe to remove particle systems from event handlers
+            auto i = std::find(particleSystems.begin(), particleSystems.end(), particleSystem);
+
+            if (i != particleSystems.end())
+                *i = nullptr;
+        }
+
+        bool ParticleWorld::handleUpdate(const UpdateEvent& event)
+        {
+            update(event.delta);
+            return false;
+        }
+
+        void ParticleWorld::update(float delta)
+        {
+            particleSystems.erase(std::remove(particleSystems.begin(), particleSystems.end(), nullptr),
+                                  particleSystems.end());
+
+            if (particleSystems.empty())
+            {
+                updateHandler.remove();
+                return;
+            }
+
+            for (ParticleSystem* particleSystem : particleSystems)
+                particleSystem->prepareUpdate();
+
+#if !defined(__EMSCRIPTEN__)
+            if (particleSystems.size() > CHUNK_SIZE && std::thread::hardware_concurrency() > 1)
+            {
+                if (workers.empty()) startWorkers();
+
+                updateDelta = delta;
+                nextChunk = 0;
+
+                std::unique_lock<std::mutex> lock(workerMutex);
+                ++frame;
+                busyWorkers = static_cast<uint32_t>(workers.size());
+                lock.unlock();
+                workerCondition.notify_all();
+
+                simulate();
+
+                lock.lock();
+                while (busyWorkers)
+                    finishCondition.wait(lock);
+            }
+            else
+#endif
+            {
+                for (ParticleSystem* particleSystem : particleSystems)
+                    particleSystem->update(delta);
+            }
+
+            // particle systems added by the event handlers will be updated in the next frame
+            const size_t count = particleSystems.size();
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                ParticleSystem* particleSystem = particleSystems[i];
+
+                if (particleSystem && particleSystem->finishPending)
+                {
+                    // finished particle systems leave the world until they are resumed
+                    particleSystems[i] = nullptr;
+                    particleSystem->finishUpdate();
+                }
+            }
+        }
+
+        void ParticleWorld::simulate()
+        {
+            const size_t count = particleSystems.size();
+
+            for (;;)
+            {
+                const size_t first = nextChunk.fetch_add(CHUNK_SIZE);
+                if (first >= count) break;
+
+                const size_t last = std::min(first + CHUNK_SIZE, count);
+
+                for (size_t i = first; i < last; ++i)
+                    particleSystems[i]->update(updateDelta);
+            }
+        }
+
+        void ParticleWorld::startWorkers()
+        {
+            const uint32_t workerCount = std::thread::hardware_concurrency() - 1;
+
+            for (uint32_t i = 0; i < workerCount; ++i)
+                workers.push_back(std::thread(&ParticleWorld::workerMain, this, frame));
+        }
+
+        void ParticleWorld::workerMain(uint64_t currentFrame)
+        {
+            setCurrentThreadName("Particles");
+
+            std::unique_lock<std::mutex> lock(workerMutex);
+
+            for (;;)
+            {
+                while (running && frame == currentFrame)
+                    workerCondition.wait(lock);
+
+                if (!running) break;
+
+                currentFrame = frame;
+                lock.unlock();
+
+                simulate();
+
+                lock.lock();
+                if (--busyWorkers == 0)
+                    finishCondition.notify_all();
+            }
+        }
+    } // namespace scene
+} // namespace ouzel
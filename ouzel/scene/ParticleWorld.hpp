@@ -0,0 +1,60 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_PARTICLEWORLD_HPP
+#define OUZEL_SCENE_PARTICLEWORLD_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "events/EventHandler.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class ParticleSystem;
+
+        // Updates all active particle systems once per frame, simulating them in parallel on worker threads
+        class ParticleWorld final
+        {
+        public:
+            ParticleWorld();
+            ~ParticleWorld();
+
+            ParticleWorld(const ParticleWorld&) = delete;
+            ParticleWorld& operator=(const ParticleWorld&) = delete;
+
+            ParticleWorld(ParticleWorld&&) = delete;
+            ParticleWorld& operator=(ParticleWorld&&) = delete;
+
+            void addParticleSystem(ParticleSystem* particleSystem);
+            void removeParticleSystem(ParticleSystem* particleSystem);
+
+        private:
+            bool handleUpdate(const UpdateEvent& event);
+            void update(float delta);
+            void simulate();
+            void startWorkers();
+            void workerMain(uint64_t currentFrame);
+
+            std::vector<ParticleSystem*> particleSystems;
+            EventHandler updateHandler;
+
+            std::vector<std::thread> workers;
+            std::mutex workerMutex;
+            std::condition_variable workerCondition;
+            std::condition_variable finishCondition;
+            uint64_t frame = 0;
+            uint32_t busyWorkers = 0;
+            bool running = true;
+
+            float updateDelta = 0.0F;
+            std::atomic<size_t> nextChunk{0};
+        };
+    } // namespace scene
+} // namespace ouzel
+
+#endif // OUZEL_SCENE_PARTICLEWORLD_HPP
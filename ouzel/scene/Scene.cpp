@@ -64,6 +64,12 @@ namespace ouzel
             engine->getRenderer()->present();
         }
 
+        void Scene::updateWorld()
+        {
+            for (Layer* layer : layers)
+                layer->updateWorld();
+        }
+
         void Scene::addLayer(Layer* layer)
         {
             assert(layer);
@@ -30,6 +30,7 @@ namespace ouzel
             Scene& operator=(Scene&&) = delete;
 
             virtual void draw();
+            void updateWorld();
 
             void addLayer(Layer* layer);
 
@@ -71,5 +71,18 @@ namespace ouzel
                 scene->draw();
             }
         }
+
+        void SceneManager::updateWorld()
+        {
+            while (scenes.size() > 1)
+                removeScene(scenes.front());
+
+            if (!scenes.empty())
+            {
+                Scene* scene = scenes.back();
+                if (!scene->entered) scene->enter();
+                scene->updateWorld();
+            }
+        }
     } // namespace scene
 } // namespace ouzel
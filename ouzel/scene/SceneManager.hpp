@@ -9,6 +9,7 @@
 #include <queue>
 #include <set>
 #include <vector>
+#include "scene/ParticleWorld.hpp"
 
 namespace ouzel
 {
@@ -29,6 +30,8 @@ namespace ouzel
             SceneManager& operator=(SceneManager&&) = delete;
 
             void draw();
+            // keeps the actor transforms up to date when nothing is drawn (e.g. in headless mode)
+            void updateWorld();
 
             void setScene(Scene* scene);
 
@@ -52,7 +55,10 @@ namespace ouzel
 
             inline Scene* getScene() const { return scenes.empty() ? nullptr : scenes.back(); }
 
+            inline ParticleWorld& getParticleWorld() { return particleWorld; }
+
         private:
+            ParticleWorld particleWorld; // must be destroyed after the scenes
             std::vector<Scene*> scenes;
             std::vector<std::unique_ptr<Scene>> ownedScenes;
         };
@@ -136,6 +136,7 @@ namespace ouzel
             Component(CLASS)
         {
             updateHandler.updateHandler = std::bind(&Sprite::handleUpdate, this, std::placeholders::_1);
+            reloadHandler.systemHandler = std::bind(&Sprite::handleSystem, this, std::placeholders::_1);
 
             currentAnimation = animationQueue.end();
         }
@@ -162,6 +163,9 @@ namespace ouzel
 
         void Sprite::init(const SpriteData& spriteData)
         {
+            filename.clear();
+            reloadHandler.remove();
+
             material = std::make_shared<graphics::Material>();
             material->cullMode = graphics::CullMode::NONE;
             material->blendState = spriteData.blendState ? spriteData.blendState : engine->getCache().getBlendState(BLEND_ALPHA);
@@ -177,8 +181,14 @@ namespace ouzel
             updateBoundingBox();
         }
 
-        void Sprite::init(const std::string& filename)
+        void Sprite::init(const std::string& newFilename)
         {
+            filename = newFilename;
+            if (engine->getCache().isHotReloadEnabled())
+                engine->getEventDispatcher().addEventHandler(&reloadHandler);
+            else
+                reloadHandler.remove();
+
             material = std::make_shared<graphics::Material>();
             material->cullMode = graphics::CullMode::NONE;
             material->shader = engine->getCache().getShader(SHADER_TEXTURE);
@@ -218,6 +228,9 @@ namespace ouzel
                           uint32_t spritesX, uint32_t spritesY,
                           const Vector2F& pivot)
         {
+            filename.clear();
+            reloadHandler.remove();
+
             material = std::make_shared<graphics::Material>();
             material->cullMode = graphics::CullMode::NONE;
             material->shader = engine->getCache().getShader(SHADER_TEXTURE);
@@ -327,6 +340,33 @@ namespace ouzel
             return false;
         }
 
+        bool Sprite::handleSystem(const SystemEvent& event)
+        {
+            if (event.type != Event::Type::ASSET_RELOAD || event.filename != filename)
+                return false;
+
+            const SpriteData* spriteData = engine->getCache().getSpriteData(filename);
+            if (!spriteData) return false; // sprites made of a texture see the reloaded texture in place
+
+            // the material may have been replaced by the user, so only its texture is updated
+            material->textures[0] = spriteData->texture;
+
+            // the queued animations point into the old animations, only the current one is kept (if it still exists)
+            const std::string animationName = currentAnimation != animationQueue.end() ? currentAnimation->animation->name : "";
+            const bool repeat = currentAnimation != animationQueue.end() && currentAnimation->repeat;
+
+            animationQueue.clear();
+            animations = spriteData->animations;
+
+            auto i = animations.find(animationName);
+            animationQueue.push_back({i != animations.end() ? &i->second : &animations[""], repeat});
+            currentAnimation = animationQueue.begin();
+
+            updateBoundingBox();
+
+            return false;
+        }
+
         void Sprite::draw(const Matrix4F& transformMatrix,
                           float opacity,
                           const Matrix4F& renderViewProjection,
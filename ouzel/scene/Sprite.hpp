@@ -125,6 +125,7 @@ namespace ouzel
 
         private:
             bool handleUpdate(const UpdateEvent& event);
+            bool handleSystem(const SystemEvent& event);
             void updateBoundingBox();
 
             std::shared_ptr<graphics::Material> material;
@@ -147,6 +148,9 @@ namespace ouzel
             float currentTime = 0.0F;
 
             EventHandler updateHandler;
+
+            std::string filename; // the animations are taken again when the asset with this name is reloaded
+            EventHandler reloadHandler;
         };
     } // namespace scene
 } // namespace ouzel
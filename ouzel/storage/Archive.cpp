@@ -5,6 +5,10 @@
 #include "FileSystem.hpp"
 #include "utils/Utils.hpp"
 
+static constexpr uint16_t METHOD_STORED = 0;
+static constexpr uint16_t METHOD_DEFLATED = 8;
+static constexpr uint16_t METHOD_LZ4 = 0x4C34; // not assigned by the ZIP specification, written by ouzel --archive
+
 namespace ouzel
 {
     namespace storage
@@ -39,9 +43,6 @@ namespace ouzel
                 uint16_t compression;
                 file.read(&compression, sizeof(compression), true);
 
-                if (compression != 0x00)
-                    throw std::runtime_error("Unsupported compression");
-
                 file.seek(4, File::CURRENT); // skip modification time
                 file.seek(4, File::CURRENT); // skip CRC-32
 
@@ -65,12 +66,28 @@ namespace ouzel
 
                 Entry& entry = entries[name.data()];
                 entry.size = decodeLittleEndian<uint32_t>(&uncompressedSize);
+                entry.compressedSize = decodeLittleEndian<uint32_t>(&compressedSize);
+
+                switch (decodeLittleEndian<uint16_t>(&compression))
+                {
+                    case METHOD_STORED: entry.compression = Compression::NONE; break;
+                    case METHOD_DEFLATED: entry.compression = Compression::DEFLATE; break;
+                    case METHOD_LZ4: entry.compression = Compression::LZ4; break;
+                    default: throw std::runtime_error("Unsupported compression");
+                }
+
+                if (decodeLittleEndian<uint16_t>(&flags) & 0x0001)
+                    throw std::runtime_error("Encrypted files are not supported");
+
+                // sizes are stored after the data if the 3rd bit is set, so the entries can not be skipped
+                if (decodeLittleEndian<uint16_t>(&flags) & 0x0008)
+                    throw std::runtime_error("Data descriptors are not supported");
 
                 file.seek(decodeLittleEndian<uint16_t>(&extraFieldLength), File::CURRENT); // skip extra field
 
                 entry.offset = file.getOffset();
 
-                file.seek(static_cast<int32_t>(decodeLittleEndian<uint32_t>(&uncompressedSize)), File::CURRENT); // skip uncompressed size
+                file.seek(static_cast<int32_t>(entry.compressedSize), File::CURRENT); // skip file data
             }
         }
 
@@ -88,11 +105,29 @@ namespace ouzel
             if (i == entries.end())
                 throw std::runtime_error("File " + filename + " does not exist");
 
-            file.seek(static_cast<int32_t>(i->second.offset), File::BEGIN);
+            const Entry& entry = i->second;
+
+            data.resize(entry.size);
 
-            data.resize(i->second.size);
+            if (entry.size == 0) return data;
 
-            file.read(data.data(), i->second.size, true);
+            // positional reads don't share the file pointer, so entries can be read from multiple threads
+            if (entry.compression == Compression::NONE)
+            {
+                if (file.readAt(data.data(), entry.size, entry.offset, true) != entry.size)
+                    throw std::runtime_error("Failed to read file " + filename);
+            }
+            else
+            {
+                std::vector<uint8_t> compressedData(entry.compressedSize);
+
+                if (file.readAt(compressedData.data(), entry.compressedSize, entry.offset, true) != entry.compressedSize)
+                    throw std::runtime_error("Failed to read file " + filename);
+
+                decompress(entry.compression,
+                           compressedData.data(), compressedData.size(),
+                           data.data(), data.size());
+            }
 
             return data;
         }
@@ -7,6 +7,7 @@
 #include <map>
 #include <string>
 #include <vector>
+#include "storage/Compression.hpp"
 #include "storage/File.hpp"
 
 namespace ouzel
@@ -40,6 +41,8 @@ namespace ouzel
             {
                 uint32_t offset;
                 uint32_t size;
+                uint32_t compressedSize;
+                Compression compression;
             };
 
             std::map<std::string, Entry> entries;
@@ -0,0 +1,223 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include "Compression.hpp"
+#include "stb_image.h"
+
+static void inflate(const uint8_t* source, size_t sourceSize,
+                    uint8_t* destination, size_t destinationSize)
+{
+    if (sourceSize > static_cast<size_t>(std::numeric_limits<int>::max()) ||
+        destinationSize > static_cast<size_t>(std::numeric_limits<int>::max()))
+        throw std::runtime_error("Deflate stream too large");
+
+    // stb_image's zlib decoder writes into the fixed buffer and fails if the output does not fit
+    int size = stbi_zlib_decode_noheader_buffer(reinterpret_cast<char*>(destination),
+                                                static_cast<int>(destinationSize),
+                                                reinterpret_cast<const char*>(source),
+                                                static_cast<int>(sourceSize));
+
+    if (size < 0 || static_cast<size_t>(size) != destinationSize)
+        throw std::runtime_error("Invalid deflate stream");
+}
+
+static size_t readLz4Length(const uint8_t*& source, const uint8_t* sourceEnd, size_t length)
+{
+    if (length == 15)
+    {
+        uint8_t byte;
+
+        do
+        {
+            if (source == sourceEnd)
+                throw std::runtime_error("Invalid LZ4 block");
+
+            byte = *source++;
+            length += byte;
+        }
+        while (byte == 255);
+    }
+
+    return length;
+}
+
+static void decompressLz4(const uint8_t* source, size_t sourceSize,
+                          uint8_t* destination, size_t destinationSize)
+{
+    const uint8_t* sourceEnd = source + sourceSize;
+    uint8_t* const destinationBegin = destination;
+    uint8_t* const destinationEnd = destination + destinationSize;
+
+    while (source < sourceEnd)
+    {
+        const uint8_t token = *source++;
+
+        const size_t literalLength = readLz4Length(source, sourceEnd, token >> 4);
+
+        if (literalLength > static_cast<size_t>(sourceEnd - source) ||
+            literalLength > static_cast<size_t>(destinationEnd - destination))
+            throw std::runtime_error("Invalid LZ4 block");
+
+        std::memcpy(destination, source, literalLength);
+        source += literalLength;
+        destination += literalLength;
+
+        // the last sequence contains only literals
+        if (source == sourceEnd) break;
+
+        if (sourceEnd - source < 2)
+            throw std::runtime_error("Invalid LZ4 block");
+
+        const size_t offset = static_cast<size_t>(source[0]) | (static_cast<size_t>(source[1]) << 8);
+        source += 2;
+
+        if (offset == 0 || offset > static_cast<size_t>(destination - destinationBegin))
+            throw std::runtime_error("Invalid LZ4 block");
+
+        const size_t matchLength = readLz4Length(source, sourceEnd, token & 0x0F) + 4;
+
+        if (matchLength > static_cast<size_t>(destinationEnd - destination))
+            throw std::runtime_error("Invalid LZ4 block");
+
+        const uint8_t* match = destination - offset;
+
+        if (offset >= matchLength)
+        {
+            std::memcpy(destination, match, matchLength);
+            destination += matchLength;
+        }
+        else // overlapping match repeats the last offset bytes
+            for (size_t i = 0; i < matchLength; ++i)
+                *destination++ = *match++;
+    }
+
+    if (destination != destinationEnd)
+        throw std::runtime_error("Invalid LZ4 block");
+}
+
+static void writeLz4Length(std::vector<uint8_t>& result, size_t length)
+{
+    for (; length >= 255; length -= 255)
+        result.push_back(255);
+
+    result.push_back(static_cast<uint8_t>(length));
+}
+
+static void writeLz4Sequence(std::vector<uint8_t>& result,
+                             const uint8_t* literals, size_t literalLength,
+                             size_t offset, size_t matchLength)
+{
+    const size_t matchCode = matchLength ? matchLength - 4 : 0;
+
+    result.push_back(static_cast<uint8_t>(((literalLength < 15 ? literalLength : 15) << 4) |
+                                          (matchCode < 15 ? matchCode : 15)));
+
+    if (literalLength >= 15) writeLz4Length(result, literalLength - 15);
+    result.insert(result.end(), literals, literals + literalLength);
+
+    // the last sequence contains only literals
+    if (!matchLength) return;
+
+    result.push_back(static_cast<uint8_t>(offset));
+    result.push_back(static_cast<uint8_t>(offset >> 8));
+
+    if (matchCode >= 15) writeLz4Length(result, matchCode - 15);
+}
+
+// greedy compressor that finds matches through a hash table of the last position of every 4-byte sequence
+static std::vector<uint8_t> compressLz4(const uint8_t* source, size_t sourceSize)
+{
+    static constexpr size_t MIN_MATCH = 4;
+    static constexpr size_t LAST_LITERALS = 5; // the block must end with literals
+    static constexpr size_t MATCH_LIMIT = 12; // the last match must start this far from the end
+    static constexpr size_t MAX_OFFSET = 65535;
+    static constexpr uint32_t HASH_BITS = 16;
+
+    std::vector<uint8_t> result;
+    result.reserve(sourceSize + sourceSize / 255 + 16);
+
+    size_t anchor = 0;
+
+    if (sourceSize > MATCH_LIMIT)
+    {
+        // positions are stored plus one, so that zero means none
+        std::vector<size_t> table(size_t(1) << HASH_BITS, 0);
+        const size_t matchStartEnd = sourceSize - MATCH_LIMIT;
+        const size_t matchEnd = sourceSize - LAST_LITERALS;
+
+        for (size_t position = 0; position <= matchStartEnd;)
+        {
+            uint32_t sequence;
+            std::memcpy(&sequence, source + position, sizeof(sequence));
+
+            size_t& entry = table[(sequence * 2654435761U) >> (32 - HASH_BITS)];
+            const size_t candidate = entry;
+            entry = position + 1;
+
+            if (!candidate ||
+                position - (candidate - 1) > MAX_OFFSET ||
+                std::memcmp(source + candidate - 1, source + position, MIN_MATCH) != 0)
+            {
+                ++position;
+                continue;
+            }
+
+            const size_t match = candidate - 1;
+            size_t matchLength = MIN_MATCH;
+            while (position + matchLength < matchEnd && source[match + matchLength] == source[position + matchLength])
+                ++matchLength;
+
+            writeLz4Sequence(result, source + anchor, position - anchor, position - match, matchLength);
+
+            position += matchLength;
+            anchor = position;
+        }
+    }
+
+    writeLz4Sequence(result, source + anchor, sourceSize - anchor, 0, 0);
+
+    return result;
+}
+
+namespace ouzel
+{
+    namespace storage
+    {
+        void decompress(Compression compression,
+                        const uint8_t* source, size_t sourceSize,
+                        uint8_t* destination, size_t destinationSize)
+        {
+            switch (compression)
+            {
+                case Compression::NONE:
+                    if (sourceSize != destinationSize)
+                        throw std::runtime_error("Invalid uncompressed size");
+                    if (sourceSize) std::memcpy(destination, source, sourceSize);
+                    break;
+                case Compression::DEFLATE:
+                    inflate(source, sourceSize, destination, destinationSize);
+                    break;
+                case Compression::LZ4:
+                    decompressLz4(source, sourceSize, destination, destinationSize);
+                    break;
+                default:
+                    throw std::runtime_error("Unsupported compression");
+            }
+        }
+
+        std::vector<uint8_t> compress(Compression compression, const uint8_t* source, size_t sourceSize)
+        {
+            switch (compression)
+            {
+                case Compression::NONE:
+                    return std::vector<uint8_t>(source, source + sourceSize);
+                case Compression::LZ4:
+                    return compressLz4(source, sourceSize);
+                default:
+                    throw std::runtime_error("Unsupported compression");
+            }
+        }
+    } // namespace storage
+} // namespace ouzel
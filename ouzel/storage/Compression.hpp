@@ -0,0 +1,32 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_STORAGE_COMPRESSION_HPP
+#define OUZEL_STORAGE_COMPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ouzel
+{
+    namespace storage
+    {
+        enum class Compression
+        {
+            NONE,
+            DEFLATE, // raw deflate stream (RFC 1951) as used by ZIP
+            LZ4 // LZ4 block format
+        };
+
+        // decompresses the source directly into the destination buffer, which must be exactly the size of the uncompressed data
+        // the functions don't keep any state, so independent buffers can be decompressed in parallel
+        void decompress(Compression compression,
+                        const uint8_t* source, size_t sourceSize,
+                        uint8_t* destination, size_t destinationSize);
+
+        // only NONE and LZ4 can be compressed, deflate streams are written by external tools
+        std::vector<uint8_t> compress(Compression compression, const uint8_t* source, size_t sourceSize);
+    } // namespace storage
+} // namespace ouzel
+
+#endif // OUZEL_STORAGE_COMPRESSION_HPP
@@ -148,6 +148,55 @@ namespace ouzel
             }
         }
 
+        uint32_t File::readAt(void* buffer, uint32_t size, uint32_t offset, bool all) const
+        {
+            if (all)
+            {
+                uint8_t* dest = static_cast<uint8_t*>(buffer);
+                uint32_t remaining = size;
+
+                while (remaining > 0)
+                {
+                    uint32_t bytesRead = readAt(dest, remaining, offset);
+
+                    if (bytesRead == 0)
+                        return 0; // End of file reached
+
+                    remaining -= bytesRead;
+                    dest += bytesRead;
+                    offset += bytesRead;
+                }
+
+                return size;
+            }
+            else
+            {
+#if defined(_WIN32)
+                // the offset comes from the OVERLAPPED structure, but on a synchronous handle ReadFile still
+                // moves the file pointer, restoring it would not be safe when other threads read at the same time
+                OVERLAPPED overlapped = {};
+                overlapped.Offset = offset;
+
+                DWORD n;
+                if (!ReadFile(file, buffer, size, &n, &overlapped))
+                {
+                    DWORD error = GetLastError();
+                    if (error == ERROR_HANDLE_EOF) return 0;
+                    throw std::system_error(error, std::system_category(), "Failed to read from file");
+                }
+
+                return static_cast<uint32_t>(n);
+#else
+                ssize_t ret = pread(file, buffer, size, static_cast<off_t>(offset));
+
+                if (ret == -1)
+                    throw std::system_error(errno, std::system_category(), "Failed to read from file");
+
+                return static_cast<uint32_t>(ret);
+#endif
+            }
+        }
+
         uint32_t File::write(const void* buffer, uint32_t size, bool all) const
         {
             if (all)
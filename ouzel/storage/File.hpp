@@ -62,6 +62,11 @@ namespace ouzel
             void close();
 
             uint32_t read(void* buffer, uint32_t size, bool all = false) const;
+            // reads at the given offset, concurrent calls from multiple threads are safe on all platforms
+            // on Linux, macOS, iOS, tvOS, Android and Emscripten it uses pread and leaves the file pointer unchanged,
+            // on Windows ReadFile moves the file pointer to the end of the read, so there it must not be mixed with
+            // read, seek and getOffset
+            uint32_t readAt(void* buffer, uint32_t size, uint32_t offset, bool all = false) const;
             uint32_t write(const void* buffer, uint32_t size, bool all = false) const;
             void seek(int32_t offset, int method) const;
             uint32_t getOffset() const;
@@ -0,0 +1,171 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <set>
+#include <system_error>
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  define NOMINMAX
+#  include <Windows.h>
+#  undef WIN32_LEAN_AND_MEAN
+#  undef NOMINMAX
+#else
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+#if defined(__linux__)
+#  include <sys/inotify.h>
+#endif
+#include "FileMonitor.hpp"
+#include "FileSystem.hpp"
+#include "core/Engine.hpp"
+
+namespace ouzel
+{
+    namespace storage
+    {
+        FileMonitor::FileMonitor():
+            previousPollTime(std::chrono::steady_clock::now())
+        {
+#if defined(__linux__)
+            // polling is used if inotify is not available
+            notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+        }
+
+        FileMonitor::~FileMonitor()
+        {
+#if defined(__linux__)
+            if (notifyFd != -1) close(notifyFd);
+#endif
+        }
+
+        void FileMonitor::addFile(const std::string& filename)
+        {
+            if (files.find(filename) != files.end()) return;
+
+            files[filename] = getFileState(filename);
+
+#if defined(__linux__)
+            if (notifyFd != -1)
+            {
+                // watch the directory, because editors often replace the file instead of writing to it
+                std::string directory = FileSystem::getDirectoryPart(filename);
+                if (directory.empty()) directory = ".";
+
+                if (directories.find(directory) == directories.end())
+                {
+                    int watch = inotify_add_watch(notifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+                    if (watch == -1)
+                    {
+                        // e.g. the watch limit is reached, the asset is still usable but won't be reloaded
+                        OUZEL_LOG(*engine, Log::Level::WARN) << "Failed to watch directory " << directory << ", error: " << errno;
+                        files.erase(filename);
+                        return;
+                    }
+
+                    directories[directory] = watch;
+                    watches[watch] = directory;
+                }
+            }
+#endif
+        }
+
+        void FileMonitor::removeFile(const std::string& filename)
+        {
+            files.erase(filename);
+        }
+
+        std::vector<std::string> FileMonitor::getModifiedFiles()
+        {
+            std::vector<std::string> result;
+
+#if defined(__linux__)
+            if (notifyFd != -1)
+            {
+                std::set<std::string> modifiedFiles;
+                alignas(struct inotify_event) char buffer[4096];
+
+                for (;;)
+                {
+                    ssize_t length = read(notifyFd, buffer, sizeof(buffer));
+                    if (length <= 0) break; // EAGAIN, no more events
+
+                    for (char* pointer = buffer; pointer < buffer + length;)
+                    {
+                        const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(pointer);
+                        pointer += sizeof(struct inotify_event) + event->len;
+
+                        if (event->len == 0) continue;
+
+                        auto watch = watches.find(event->wd);
+                        if (watch == watches.end()) continue;
+
+                        std::string filename = (watch->second == ".") ?
+                            std::string(event->name) :
+                            watch->second + FileSystem::DIRECTORY_SEPARATOR + event->name;
+
+                        if (files.find(filename) != files.end())
+                            modifiedFiles.insert(filename);
+                    }
+                }
+
+                result.assign(modifiedFiles.begin(), modifiedFiles.end());
+
+                return result;
+            }
+#endif
+
+            // stat every file at most once a second
+            auto currentTime = std::chrono::steady_clock::now();
+            if (currentTime - previousPollTime < std::chrono::seconds(1)) return result;
+            previousPollTime = currentTime;
+
+            for (auto& file : files)
+            {
+                FileState state = getFileState(file.first);
+
+                if (state.modificationTime != file.second.modificationTime ||
+                    state.size != file.second.size)
+                {
+                    file.second = state;
+                    result.push_back(file.first);
+                }
+            }
+
+            return result;
+        }
+
+        FileMonitor::FileState FileMonitor::getFileState(const std::string& filename)
+        {
+            FileState result;
+
+#if defined(_WIN32)
+            int bufferSize = MultiByteToWideChar(CP_UTF8, 0, filename.c_str(), -1, nullptr, 0);
+            if (bufferSize == 0)
+                throw std::system_error(GetLastError(), std::system_category(), "Failed to convert UTF-8 to wide char");
+
+            std::vector<WCHAR> buffer(bufferSize);
+            if (MultiByteToWideChar(CP_UTF8, 0, filename.c_str(), -1, buffer.data(), bufferSize) == 0)
+                throw std::system_error(GetLastError(), std::system_category(), "Failed to convert UTF-8 to wide char");
+
+            WIN32_FILE_ATTRIBUTE_DATA attributes;
+            if (GetFileAttributesExW(buffer.data(), GetFileExInfoStandard, &attributes))
+            {
+                result.modificationTime = static_cast<int64_t>((static_cast<uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32) |
+                                                               attributes.ftLastWriteTime.dwLowDateTime);
+                result.size = (static_cast<uint64_t>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow;
+            }
+#else
+            // a missing file (e.g. while it is being replaced) has a zero state
+            struct stat buf;
+            if (stat(filename.c_str(), &buf) == 0)
+            {
+                result.modificationTime = static_cast<int64_t>(buf.st_mtime);
+                result.size = static_cast<uint64_t>(buf.st_size);
+            }
+#endif
+
+            return result;
+        }
+    } // namespace storage
+} // namespace ouzel
@@ -0,0 +1,56 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_STORAGE_FILEMONITOR_HPP
+#define OUZEL_STORAGE_FILEMONITOR_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ouzel
+{
+    namespace storage
+    {
+        // Reports modified files, uses inotify on Linux and falls back to polling the modification time elsewhere
+        class FileMonitor final
+        {
+        public:
+            FileMonitor();
+            ~FileMonitor();
+
+            FileMonitor(const FileMonitor&) = delete;
+            FileMonitor& operator=(const FileMonitor&) = delete;
+
+            FileMonitor(FileMonitor&&) = delete;
+            FileMonitor& operator=(FileMonitor&&) = delete;
+
+            void addFile(const std::string& filename);
+            void removeFile(const std::string& filename);
+
+            // doesn't block, every modified file is returned once
+            std::vector<std::string> getModifiedFiles();
+
+        private:
+            struct FileState final
+            {
+                int64_t modificationTime = 0;
+                uint64_t size = 0;
+            };
+
+            static FileState getFileState(const std::string& filename);
+
+            std::map<std::string, FileState> files;
+            std::chrono::steady_clock::time_point previousPollTime;
+
+#if defined(__linux__)
+            int notifyFd = -1;
+            std::map<int, std::string> watches;
+            std::map<std::string, int> directories;
+#endif
+        };
+    } // namespace storage
+} // namespace ouzel
+
+#endif // OUZEL_STORAGE_FILEMONITOR_HPP
@@ -76,7 +76,7 @@ namespace ouzel
                 throw std::system_error(GetLastError(), std::system_category(), "Failed to convert wide char to UTF-8");
 
             appPath = getDirectoryPart(appFilename.data());
-            engine.log(Log::Level::INFO) << "Application directory: " << appPath;
+            OUZEL_LOG(engine, Log::Level::INFO) << "Application directory: " << appPath;
 
 #elif defined(__APPLE__)
             CFBundleRef bundle = CFBundleGetMainBundle();
@@ -101,7 +101,7 @@ namespace ouzel
                 throw std::runtime_error("Failed to get current directory");
 
             appPath = resourceDirectory.data();
-            engine.log(Log::Level::INFO) << "Application directory: " << appPath;
+            OUZEL_LOG(engine, Log::Level::INFO) << "Application directory: " << appPath;
 
 #elif defined(__ANDROID__)
             // not available for Android
@@ -115,7 +115,7 @@ namespace ouzel
 
             executableDirectory[length] = '\0';
             appPath = getDirectoryPart(executableDirectory);
-            engine.log(Log::Level::INFO) << "Application directory: " << appPath;
+            OUZEL_LOG(engine, Log::Level::INFO) << "Application directory: " << appPath;
 #endif
         }
 
@@ -331,26 +331,28 @@ namespace ouzel
                 }
             }
 
-            std::vector<uint8_t> data;
-            char buffer[1024];
-
 #if defined(__ANDROID__)
             if (pathIsRelative(filename))
             {
                 EngineAndroid& engineAndroid = static_cast<EngineAndroid&>(engine);
 
-                AAsset* asset = AAssetManager_open(engineAndroid.getAssetManager(), filename.c_str(), AASSET_MODE_STREAMING);
+                AAsset* asset = AAssetManager_open(engineAndroid.getAssetManager(), filename.c_str(), AASSET_MODE_BUFFER);
 
                 if (!asset)
                     throw std::runtime_error("Failed to open file " + filename);
 
+                std::vector<uint8_t> data(static_cast<size_t>(AAsset_getLength(asset)));
+                size_t offset = 0;
                 int bytesRead = 0;
 
-                while ((bytesRead = AAsset_read(asset, buffer, sizeof(buffer))) > 0)
-                    data.insert(data.end(), reinterpret_cast<uint8_t*>(buffer), reinterpret_cast<uint8_t*>(buffer + bytesRead));
+                while (offset < data.size() &&
+                       (bytesRead = AAsset_read(asset, data.data() + offset, data.size() - offset)) > 0)
+                    offset += static_cast<size_t>(bytesRead);
 
                 AAsset_close(asset);
 
+                data.resize(offset);
+
                 return data;
             }
 #endif
@@ -363,15 +365,53 @@ namespace ouzel
 
             File file(path, File::Mode::READ);
 
-            while (uint32_t size = file.read(buffer, sizeof(buffer)))
-                data.insert(data.end(), buffer, buffer + size);
+            // read the whole file at once instead of growing the buffer
+            file.seek(0, File::Seek::END);
+            std::vector<uint8_t> data(file.getOffset());
+            file.seek(0, File::Seek::BEGIN);
+
+            uint32_t offset = 0;
+
+            while (offset < data.size())
+            {
+                uint32_t size = file.read(data.data() + offset, static_cast<uint32_t>(data.size()) - offset);
+                if (size == 0) break;
+                offset += size;
+            }
+
+            data.resize(offset);
 
             return data;
         }
 
-        void FileSystem::writeFile(const std::string& filename, const std::vector<uint8_t>& data) const
+        MappedFile FileSystem::mapFile(const std::string& filename, bool searchResources) const
+        {
+            if (searchResources)
+            {
+                for (const auto& archive : archives)
+                {
+                    if (archive->fileExists(filename))
+                        return MappedFile(archive->readFile(filename));
+                }
+            }
+
+#if defined(__ANDROID__)
+            if (pathIsRelative(filename))
+                return MappedFile(readFile(filename, searchResources));
+#endif
+
+            std::string path = getPath(filename, searchResources);
+
+            // file does not exist
+            if (path.empty())
+                throw std::runtime_error("Failed to find file " + filename);
+
+            return MappedFile(path);
+        }
+
+        void FileSystem::writeFile(const std::string& filename, const std::vector<uint8_t>& data, bool append) const
         {
-            File file(filename, File::Mode::WRITE | File::Mode::CREATE | File::Mode::TRUNCATE);
+            File file(filename, File::Mode::WRITE | File::Mode::CREATE | (append ? File::Mode::APPEND : File::Mode::TRUNCATE));
 
             uint32_t offset = 0;
 
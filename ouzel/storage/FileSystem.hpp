@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include "storage/MappedFile.hpp"
 
 namespace ouzel
 {
@@ -31,7 +32,9 @@ namespace ouzel
             std::string getTempDirectory() const;
 
             std::vector<uint8_t> readFile(const std::string& filename, bool searchResources = true) const;
-            void writeFile(const std::string& filename, const std::vector<uint8_t>& data) const;
+            void writeFile(const std::string& filename, const std::vector<uint8_t>& data, bool append = false) const;
+            // maps the file into memory instead of copying it, archive entries and Android assets are read into a buffer
+            MappedFile mapFile(const std::string& filename, bool searchResources = true) const;
 
             bool resourceFileExists(const std::string& filename) const;
             std::string getPath(const std::string& filename, bool searchResources = true) const;
@@ -0,0 +1,166 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <system_error>
+#if !defined(_WIN32)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+#include "MappedFile.hpp"
+
+namespace ouzel
+{
+    namespace storage
+    {
+        MappedFile::MappedFile(const std::string& filename)
+        {
+#if defined(_WIN32)
+            int bufferSize = MultiByteToWideChar(CP_UTF8, 0, filename.c_str(), -1, nullptr, 0);
+            if (bufferSize == 0)
+                throw std::system_error(GetLastError(), std::system_category(), "Failed to convert UTF-8 to wide char");
+
+            std::vector<WCHAR> filenameBuffer(bufferSize);
+            if (MultiByteToWideChar(CP_UTF8, 0, filename.c_str(), -1, filenameBuffer.data(), bufferSize) == 0)
+                throw std::system_error(GetLastError(), std::system_category(), "Failed to convert the filename to wide char");
+
+            // relative paths longer than MAX_PATH are not supported
+            if (filenameBuffer.size() > MAX_PATH)
+                filenameBuffer.insert(filenameBuffer.begin(), {L'\\', L'\\', L'?', L'\\'});
+
+            HANDLE file = CreateFileW(filenameBuffer.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                throw std::system_error(GetLastError(), std::system_category(), "Failed to open file");
+
+            LARGE_INTEGER fileSize;
+            if (!GetFileSizeEx(file, &fileSize))
+            {
+                DWORD error = GetLastError();
+                CloseHandle(file);
+                throw std::system_error(error, std::system_category(), "Failed to get file size");
+            }
+
+            // empty files can not be mapped
+            if (fileSize.QuadPart > 0)
+            {
+                HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (!mapping)
+                {
+                    DWORD error = GetLastError();
+                    CloseHandle(file);
+                    throw std::system_error(error, std::system_category(), "Failed to create file mapping");
+                }
+
+                void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                DWORD error = GetLastError();
+
+                // the view keeps the mapping alive
+                CloseHandle(mapping);
+                CloseHandle(file);
+
+                if (!view)
+                    throw std::system_error(error, std::system_category(), "Failed to map view of file");
+
+                address = static_cast<const uint8_t*>(view);
+                length = static_cast<size_t>(fileSize.QuadPart);
+                mapped = true;
+            }
+            else
+                CloseHandle(file);
+#else
+            int file = open(filename.c_str(), O_RDONLY);
+            if (file == -1)
+                throw std::system_error(errno, std::system_category(), "Failed to open file");
+
+            struct stat fileStat;
+            if (fstat(file, &fileStat) == -1)
+            {
+                int error = errno;
+                ::close(file);
+                throw std::system_error(error, std::system_category(), "Failed to get file size");
+            }
+
+            // empty files can not be mapped
+            if (fileStat.st_size > 0)
+            {
+                void* view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+                int error = errno;
+
+                // the mapping stays valid after the file is closed
+                ::close(file);
+
+                if (view == MAP_FAILED)
+                    throw std::system_error(error, std::system_category(), "Failed to map file");
+
+                address = static_cast<const uint8_t*>(view);
+                length = static_cast<size_t>(fileStat.st_size);
+                mapped = true;
+            }
+            else
+                ::close(file);
+#endif
+        }
+
+        MappedFile::MappedFile(std::vector<uint8_t>&& initBuffer):
+            buffer(std::move(initBuffer))
+        {
+            address = buffer.data();
+            length = buffer.size();
+        }
+
+        MappedFile::~MappedFile()
+        {
+            unmap();
+        }
+
+        MappedFile::MappedFile(MappedFile&& other):
+            address(other.address),
+            length(other.length),
+            mapped(other.mapped),
+            buffer(std::move(other.buffer))
+        {
+            if (!mapped) address = buffer.data();
+
+            other.address = nullptr;
+            other.length = 0;
+            other.mapped = false;
+        }
+
+        MappedFile& MappedFile::operator=(MappedFile&& other)
+        {
+            if (&other != this)
+            {
+                unmap();
+
+                address = other.address;
+                length = other.length;
+                mapped = other.mapped;
+                buffer = std::move(other.buffer);
+
+                if (!mapped) address = buffer.data();
+
+                other.address = nullptr;
+                other.length = 0;
+                other.mapped = false;
+            }
+
+            return *this;
+        }
+
+        void MappedFile::unmap()
+        {
+            if (mapped)
+            {
+#if defined(_WIN32)
+                UnmapViewOfFile(address);
+#else
+                munmap(const_cast<uint8_t*>(address), length);
+#endif
+                mapped = false;
+            }
+
+            address = nullptr;
+            length = 0;
+        }
+    } // namespace storage
+} // namespace ouzel
@@ -0,0 +1,59 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_STORAGE_MAPPEDFILE_HPP
+#define OUZEL_STORAGE_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  define NOMINMAX
+#  include <Windows.h>
+#  undef WIN32_LEAN_AND_MEAN
+#  undef NOMINMAX
+#endif
+
+namespace ouzel
+{
+    namespace storage
+    {
+        // Read-only view of a file mapped into memory. Files that can not be mapped (e.g. archive entries)
+        // are held in an owned buffer, so the view is always valid until the object is destroyed.
+        class MappedFile final
+        {
+        public:
+            MappedFile() {}
+            explicit MappedFile(const std::string& filename);
+            explicit MappedFile(std::vector<uint8_t>&& initBuffer);
+            ~MappedFile();
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            MappedFile(MappedFile&& other);
+            MappedFile& operator=(MappedFile&& other);
+
+            inline const uint8_t* data() const { return address; }
+            inline size_t size() const { return length; }
+            inline bool empty() const { return length == 0; }
+
+            inline const uint8_t* begin() const { return address; }
+            inline const uint8_t* end() const { return address + length; }
+
+            inline uint8_t operator[](size_t index) const { return address[index]; }
+
+        private:
+            void unmap();
+
+            const uint8_t* address = nullptr;
+            size_t length = 0;
+            bool mapped = false;
+            std::vector<uint8_t> buffer;
+        };
+    } // namespace storage
+} // namespace ouzel
+
+#endif // OUZEL_STORAGE_MAPPEDFILE_HPP
@@ -0,0 +1,113 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <cstring>
+#include <stdexcept>
+#include "Pack.hpp"
+#include "utils/Utils.hpp"
+
+static bool isInside(uint64_t offset, uint64_t size, uint64_t totalSize)
+{
+    return offset <= totalSize && size <= totalSize - offset;
+}
+
+namespace ouzel
+{
+    namespace storage
+    {
+        bool Pack::isPack(const uint8_t* data, size_t size)
+        {
+            return size >= HEADER_SIZE && decodeLittleEndian<uint32_t>(data) == MAGIC;
+        }
+
+        Pack::Pack(MappedFile&& initFile):
+            file(std::move(initFile))
+        {
+            const uint8_t* data = file.data();
+            const size_t size = file.size();
+
+            if (!isPack(data, size))
+                throw std::runtime_error("Invalid pack");
+
+            if (decodeLittleEndian<uint32_t>(data + 4) != VERSION)
+                throw std::runtime_error("Unsupported pack version");
+
+            const uint32_t entryCount = decodeLittleEndian<uint32_t>(data + 8);
+            slotCount = decodeLittleEndian<uint32_t>(data + 12);
+            const uint32_t entryOffset = decodeLittleEndian<uint32_t>(data + 16);
+            const uint32_t slotOffset = decodeLittleEndian<uint32_t>(data + 20);
+            const uint32_t nameOffset = decodeLittleEndian<uint32_t>(data + 24);
+            const uint32_t nameSize = decodeLittleEndian<uint32_t>(data + 28);
+
+            // the slot count must be a power of two with at least one empty slot
+            if (slotCount == 0 || (slotCount & (slotCount - 1)) != 0 || slotCount <= entryCount)
+                throw std::runtime_error("Invalid pack slot count");
+
+            if (!isInside(entryOffset, static_cast<uint64_t>(entryCount) * ENTRY_SIZE, size) ||
+                !isInside(slotOffset, static_cast<uint64_t>(slotCount) * sizeof(uint32_t), size) ||
+                !isInside(nameOffset, nameSize, size))
+                throw std::runtime_error("Invalid pack");
+
+            slots = data + slotOffset;
+            entries.reserve(entryCount);
+
+            for (uint32_t i = 0; i < entryCount; ++i)
+            {
+                const uint8_t* entryData = data + entryOffset + i * ENTRY_SIZE;
+
+                Entry entry;
+                entry.hash = decodeLittleEndian<uint64_t>(entryData);
+                const uint32_t entryNameOffset = decodeLittleEndian<uint32_t>(entryData + 8);
+                entry.nameLength = decodeLittleEndian<uint32_t>(entryData + 12);
+                const uint32_t dataOffset = decodeLittleEndian<uint32_t>(entryData + 16);
+                entry.size = decodeLittleEndian<uint32_t>(entryData + 20);
+                entry.type = decodeLittleEndian<uint32_t>(entryData + 24);
+                entry.flags = decodeLittleEndian<uint32_t>(entryData + 28);
+
+                if (!isInside(entryNameOffset, entry.nameLength, nameSize) ||
+                    !isInside(dataOffset, entry.size, size))
+                    throw std::runtime_error("Invalid pack entry");
+
+                entry.name = reinterpret_cast<const char*>(data + nameOffset + entryNameOffset);
+                entry.data = data + dataOffset;
+
+                entries.push_back(entry);
+            }
+
+            // every entry occupies one slot, so lookups always reach an empty slot
+            uint32_t usedSlotCount = 0;
+
+            for (uint32_t i = 0; i < slotCount; ++i)
+            {
+                const uint32_t index = decodeLittleEndian<uint32_t>(slots + i * sizeof(uint32_t));
+
+                if (index > entryCount)
+                    throw std::runtime_error("Invalid pack slot");
+
+                if (index != 0) ++usedSlotCount;
+            }
+
+            if (usedSlotCount != entryCount)
+                throw std::runtime_error("Invalid pack slots");
+        }
+
+        const Pack::Entry* Pack::find(const std::string& name) const
+        {
+            const uint64_t nameHash = hash(name);
+
+            for (uint32_t slot = static_cast<uint32_t>(nameHash) & (slotCount - 1);;
+                 slot = (slot + 1) & (slotCount - 1))
+            {
+                const uint32_t index = decodeLittleEndian<uint32_t>(slots + slot * sizeof(uint32_t));
+
+                if (index == 0) return nullptr; // reached an empty slot
+
+                const Entry& entry = entries[index - 1];
+
+                if (entry.hash == nameHash &&
+                    entry.nameLength == name.size() &&
+                    std::memcmp(entry.name, name.data(), name.size()) == 0)
+                    return &entry;
+            }
+        }
+    } // namespace storage
+} // namespace ouzel
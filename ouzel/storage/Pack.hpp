@@ -0,0 +1,84 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_STORAGE_PACK_HPP
+#define OUZEL_STORAGE_PACK_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "storage/MappedFile.hpp"
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace storage
+    {
+        // Packed bundle of files that is read with a single mapping
+        //
+        // Layout (all values are little endian):
+        // header: magic, version, entry count, slot count, entry offset, slot offset, name offset, name size (8 x uint32)
+        // entries sorted by hash: hash (uint64), name offset, name length, data offset, data size, type, flags (6 x uint32)
+        // slots: open addressing hash table of entry index + 1 (0 for empty slots), probed linearly from hash & (slot count - 1)
+        // names: entry names without terminators
+        // data: entry data, every entry starts at a multiple of ALIGNMENT
+        class Pack final
+        {
+        public:
+            static constexpr uint32_t MAGIC = 0x4B505A4F; // "OZPK"
+            static constexpr uint32_t VERSION = 1;
+            static constexpr uint32_t ALIGNMENT = 16;
+            static constexpr uint32_t HEADER_SIZE = 8 * sizeof(uint32_t);
+            static constexpr uint32_t ENTRY_SIZE = sizeof(uint64_t) + 6 * sizeof(uint32_t);
+
+            enum Flags
+            {
+                MIPMAPS = 0x01
+            };
+
+            struct Entry final
+            {
+                uint64_t hash;
+                const char* name;
+                uint32_t nameLength;
+                const uint8_t* data;
+                uint32_t size;
+                uint32_t type;
+                uint32_t flags;
+            };
+
+            // 64-bit FNV-1a
+            static inline uint64_t hash(const char* name, size_t length)
+            {
+                return fnv1aHash(name, length);
+            }
+
+            static inline uint64_t hash(const std::string& name)
+            {
+                return hash(name.data(), name.size());
+            }
+
+            static bool isPack(const uint8_t* data, size_t size);
+
+            explicit Pack(MappedFile&& initFile);
+
+            Pack(const Pack&) = delete;
+            Pack& operator=(const Pack&) = delete;
+
+            Pack(Pack&&) = delete;
+            Pack& operator=(Pack&&) = delete;
+
+            inline const std::vector<Entry>& getEntries() const { return entries; }
+
+            // returns nullptr if the pack does not contain the entry
+            const Entry* find(const std::string& name) const;
+
+        private:
+            MappedFile file;
+            std::vector<Entry> entries;
+            const uint8_t* slots = nullptr;
+            uint32_t slotCount = 0;
+        };
+    } // namespace storage
+} // namespace ouzel
+
+#endif // OUZEL_STORAGE_PACK_HPP
@@ -0,0 +1,743 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_UTILS_JSONPARSER_HPP
+#define OUZEL_UTILS_JSONPARSER_HPP
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "utils/StringView.hpp"
+
+namespace ouzel
+{
+    namespace json
+    {
+        // Single pass UTF-8 parser that reports the values to a handler instead of building a tree.
+        // The handler must provide:
+        // void startObject(), void key(const StringView&), void endObject(),
+        // void startArray(), void endArray(),
+        // void string(const StringView&), void integer(int64_t), void number(double),
+        // void boolean(bool), void null()
+        // Strings without escape sequences point into the input, others into a buffer of the parser, so
+        // a handler that keeps a string past the callback must check whether it is inside the input.
+        class Parser final
+        {
+        public:
+            template <class Handler>
+            void parse(const uint8_t* begin, const uint8_t* end, Handler& handler)
+            {
+                const char* iterator = reinterpret_cast<const char*>(begin);
+                const char* last = reinterpret_cast<const char*>(end);
+
+                // BOM
+                if (last - iterator >= 3 &&
+                    static_cast<uint8_t>(iterator[0]) == 0xEF &&
+                    static_cast<uint8_t>(iterator[1]) == 0xBB &&
+                    static_cast<uint8_t>(iterator[2]) == 0xBF)
+                    iterator += 3;
+
+                // true for objects and false for arrays
+                stack.clear();
+
+                for (;;)
+                {
+                    // parse a value
+                    skipWhitespaces(iterator, last);
+
+                    if (iterator == last)
+                        throw std::runtime_error("Unexpected end of data");
+
+                    bool valueEnded = true;
+
+                    switch (*iterator)
+                    {
+                        case '{':
+                            ++iterator;
+                            handler.startObject();
+                            skipWhitespaces(iterator, last);
+
+                            if (iterator != last && *iterator == '}')
+                            {
+                                ++iterator;
+                                handler.endObject();
+                            }
+                            else
+                            {
+                                stack.push_back(true);
+                                handler.key(parseKey(iterator, last));
+                                valueEnded = false;
+                            }
+                            break;
+                        case '[':
+                            ++iterator;
+                            handler.startArray();
+                            skipWhitespaces(iterator, last);
+
+                            if (iterator != last && *iterator == ']')
+                            {
+                                ++iterator;
+                                handler.endArray();
+                            }
+                            else
+                            {
+                                stack.push_back(false);
+                                valueEnded = false;
+                            }
+                            break;
+                        case '"':
+                            handler.string(parseString(iterator, last));
+                            break;
+                        case 't':
+                            parseKeyword(iterator, last, "true");
+                            handler.boolean(true);
+                            break;
+                        case 'f':
+                            parseKeyword(iterator, last, "false");
+                            handler.boolean(false);
+                            break;
+                        case 'n':
+                            parseKeyword(iterator, last, "null");
+                            handler.null();
+                            break;
+                        default:
+                            if (*iterator == '-' || (*iterator >= '0' && *iterator <= '9'))
+                                parseNumber(iterator, last, handler);
+                            else
+                                throw std::runtime_error("Expected a value");
+                    }
+
+                    if (!valueEnded) continue;
+
+                    // close the containers that end after the value
+                    for (;;)
+                    {
+                        skipWhitespaces(iterator, last);
+
+                        if (stack.empty())
+                        {
+                            if (iterator != last)
+                                throw std::runtime_error("Unexpected data after the value");
+
+                            return;
+                        }
+
+                        if (iterator == last)
+                            throw std::runtime_error("Unexpected end of data");
+
+                        if (*iterator == ',')
+                        {
+                            ++iterator;
+                            if (stack.back()) handler.key(parseKey(iterator, last));
+                            break;
+                        }
+                        else if (stack.back() && *iterator == '}')
+                        {
+                            ++iterator;
+                            stack.pop_back();
+                            handler.endObject();
+                        }
+                        else if (!stack.back() && *iterator == ']')
+                        {
+                            ++iterator;
+                            stack.pop_back();
+                            handler.endArray();
+                        }
+                        else
+                            throw std::runtime_error("Expected a comma");
+                    }
+                }
+            }
+
+        private:
+            static inline void skipWhitespaces(const char*& iterator, const char* end)
+            {
+                while (iterator != end &&
+                       (*iterator == ' ' || *iterator == '\t' || *iterator == '\r' || *iterator == '\n'))
+                    ++iterator;
+            }
+
+            static void parseKeyword(const char*& iterator, const char* end, const char* keyword)
+            {
+                const size_t length = std::strlen(keyword);
+
+                if (static_cast<size_t>(end - iterator) < length ||
+                    std::memcmp(iterator, keyword, length) != 0)
+                    throw std::runtime_error("Unknown keyword");
+
+                iterator += length;
+            }
+
+            static inline bool isDigit(char c)
+            {
+                return c >= '0' && c <= '9';
+            }
+
+            template <class Handler>
+            void parseNumber(const char*& iterator, const char* end, Handler& handler)
+            {
+                const char* start = iterator;
+                bool isFloat = false;
+
+                if (*iterator == '-')
+                {
+                    if (++iterator == end || !isDigit(*iterator))
+                        throw std::runtime_error("Invalid number");
+                }
+
+                while (iterator != end && isDigit(*iterator)) ++iterator;
+
+                if (iterator != end && *iterator == '.')
+                {
+                    isFloat = true;
+
+                    if (++iterator == end || !isDigit(*iterator))
+                        throw std::runtime_error("Invalid number");
+
+                    while (iterator != end && isDigit(*iterator)) ++iterator;
+                }
+
+                // parse exponent
+                if (iterator != end && (*iterator == 'e' || *iterator == 'E'))
+                {
+                    isFloat = true;
+
+                    if (++iterator == end)
+                        throw std::runtime_error("Invalid exponent");
+
+                    if (*iterator == '+' || *iterator == '-') ++iterator;
+
+                    if (iterator == end || !isDigit(*iterator))
+                        throw std::runtime_error("Invalid exponent");
+
+                    while (iterator != end && isDigit(*iterator)) ++iterator;
+                }
+
+                if (isFloat)
+                {
+                    // strtod needs a terminated string, numbers are short enough to copy to the stack
+                    char number[64];
+                    const size_t length = static_cast<size_t>(iterator - start);
+
+                    if (length < sizeof(number))
+                    {
+                        std::memcpy(number, start, length);
+                        number[length] = '\0';
+                        handler.number(std::strtod(number, nullptr));
+                    }
+                    else
+                        handler.number(std::strtod(std::string(start, length).c_str(), nullptr));
+                }
+                else
+                {
+                    const bool negative = (*start == '-');
+                    uint64_t value = 0;
+
+                    for (const char* digit = negative ? start + 1 : start; digit != iterator; ++digit)
+                    {
+                        const uint64_t next = value * 10 + static_cast<uint64_t>(*digit - '0');
+
+                        if (next / 10 != value || next > static_cast<uint64_t>(INT64_MAX) + (negative ? 1 : 0))
+                            throw std::runtime_error("Integer out of range");
+
+                        value = next;
+                    }
+
+                    handler.integer(negative ? static_cast<int64_t>(0 - value) : static_cast<int64_t>(value));
+                }
+            }
+
+            StringView parseKey(const char*& iterator, const char* end)
+            {
+                skipWhitespaces(iterator, end);
+
+                if (iterator == end || *iterator != '"')
+                    throw std::runtime_error("Expected a string literal");
+
+                StringView key = parseString(iterator, end);
+
+                skipWhitespaces(iterator, end);
+
+                if (iterator == end || *iterator != ':')
+                    throw std::runtime_error("Expected a colon");
+
+                ++iterator;
+
+                return key;
+            }
+
+            static void encodeUtf8(std::string& str, uint32_t c)
+            {
+                if (c <= 0x7F)
+                    str.push_back(static_cast<char>(c));
+                else if (c <= 0x7FF)
+                {
+                    str.push_back(static_cast<char>(0xC0 | ((c >> 6) & 0x1F)));
+                    str.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+                }
+                else if (c <= 0xFFFF)
+                {
+                    str.push_back(static_cast<char>(0xE0 | ((c >> 12) & 0x0F)));
+                    str.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+                    str.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+                }
+                else
+                {
+                    str.push_back(static_cast<char>(0xF0 | ((c >> 18) & 0x07)));
+                    str.push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+                    str.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+                    str.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+                }
+            }
+
+            static uint32_t parseHex(const char*& iterator, const char* end)
+            {
+                if (end - iterator < 4)
+                    throw std::runtime_error("Unexpected end of data");
+
+                uint32_t c = 0;
+
+                for (uint32_t i = 0; i < 4; ++i, ++iterator)
+                {
+                    uint32_t code = 0;
+
+                    if (*iterator >= '0' && *iterator <= '9') code = static_cast<uint32_t>(*iterator - '0');
+                    else if (*iterator >= 'a' && *iterator <='f') code = static_cast<uint32_t>(*iterator - 'a' + 10);
+                    else if (*iterator >= 'A' && *iterator <='F') code = static_cast<uint32_t>(*iterator - 'A' + 10);
+                    else
+                        throw std::runtime_error("Invalid character code");
+
+                    c = (c << 4) | code;
+                }
+
+                return c;
+            }
+
+            StringView parseString(const char*& iterator, const char* end)
+            {
+                const char* start = ++iterator; // skip the quotation mark
+
+                // strings without escape sequences are returned without copying
+                for (;;)
+                {
+                    if (iterator == end)
+                        throw std::runtime_error("Unterminated string literal");
+
+                    if (*iterator == '"')
+                        return StringView(start, static_cast<size_t>(iterator++ - start));
+                    else if (*iterator == '\\')
+                        break;
+                    else if (static_cast<uint8_t>(*iterator) <= 0x1F) // control char
+                        throw std::runtime_error("Unterminated string literal");
+
+                    ++iterator;
+                }
+
+                buffer.assign(start, iterator);
+
+                for (;;)
+                {
+                    if (iterator == end)
+                        throw std::runtime_error("Unterminated string literal");
+
+                    if (*iterator == '"')
+                    {
+                        ++iterator;
+                        return StringView(buffer.data(), buffer.size());
+                    }
+                    else if (*iterator == '\\')
+                    {
+                        if (++iterator == end)
+                            throw std::runtime_error("Unterminated string literal");
+
+                        const char escape = *iterator++;
+
+                        if (escape == '"') buffer.push_back('"');
+                        else if (escape == '\\') buffer.push_back('\\');
+                        else if (escape == '/') buffer.push_back('/');
+                        else if (escape == 'b') buffer.push_back('\b');
+                        else if (escape == 'f') buffer.push_back('\f');
+                        else if (escape == 'n') buffer.push_back('\n');
+                        else if (escape == 'r') buffer.push_back('\r');
+                        else if (escape == 't') buffer.push_back('\t');
+                        else if (escape == 'u')
+                        {
+                            uint32_t c = parseHex(iterator, end);
+
+                            // characters outside of the basic multilingual plane are encoded as surrogate pairs
+                            if (c >= 0xD800 && c <= 0xDBFF &&
+                                end - iterator >= 6 && iterator[0] == '\\' && iterator[1] == 'u')
+                            {
+                                const char* next = iterator + 2;
+                                const uint32_t low = parseHex(next, end);
+
+                                if (low >= 0xDC00 && low <= 0xDFFF)
+                                {
+                                    c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+                                    iterator = next;
+                                }
+                            }
+
+                            encodeUtf8(buffer, c);
+                        }
+                        else
+                            throw std::runtime_error("Unrecognized escape character");
+                    }
+                    else if (static_cast<uint8_t>(*iterator) <= 0x1F) // control char
+                        throw std::runtime_error("Unterminated string literal");
+                    else
+                        buffer.push_back(*iterator++);
+                }
+            }
+
+            std::vector<bool> stack;
+            std::string buffer;
+        };
+
+        class Document;
+
+        // Read-only handle to a value of a document, valid for the lifetime of the document
+        class Node final
+        {
+            friend Document;
+        public:
+            enum class Type
+            {
+                NONE,
+                INTEGER,
+                FLOAT,
+                STRING,
+                OBJECT,
+                ARRAY,
+                BOOLEAN
+            };
+
+            class Iterator final
+            {
+            public:
+                Iterator(const Document* initDocument, const uint32_t* initChild):
+                    document(initDocument), child(initChild)
+                {
+                }
+
+                inline Node operator*() const { return Node(document, *child); }
+                inline Iterator& operator++() { ++child; return *this; }
+                inline bool operator==(const Iterator& other) const { return child == other.child; }
+                inline bool operator!=(const Iterator& other) const { return child != other.child; }
+
+            private:
+                const Document* document;
+                const uint32_t* child;
+            };
+
+            Node() = default;
+
+            inline Type getType() const;
+            inline bool isNull() const;
+
+            // key of an object member
+            inline StringView getKey() const;
+
+            // throws if the node has a different type or doesn't exist
+            template<typename T, typename std::enable_if<std::is_same<T, std::string>::value>::type* = nullptr>
+            inline std::string as() const
+            {
+                return as<StringView>().str();
+            }
+
+            template<typename T, typename std::enable_if<std::is_same<T, StringView>::value>::type* = nullptr>
+            inline StringView as() const;
+
+            template<typename T, typename std::enable_if<std::is_same<T, bool>::value>::type* = nullptr>
+            inline T as() const;
+
+            template<typename T, typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>::type* = nullptr>
+            inline T as() const;
+
+            inline bool hasMember(const std::string& member) const;
+
+            // returns a node of type NONE if the member or element does not exist
+            inline Node operator[](const std::string& member) const;
+            inline Node operator[](size_t index) const;
+
+            // number of elements of an array or members of an object
+            inline size_t getSize() const;
+
+            inline Iterator begin() const;
+            inline Iterator end() const;
+
+        private:
+            Node(const Document* initDocument, uint32_t initIndex):
+                document(initDocument), index(initIndex)
+            {
+            }
+
+            const Document* document = nullptr;
+            uint32_t index = 0;
+        };
+
+        // Tree of values stored in contiguous arrays, strings point into the parsed data where possible,
+        // so the data must outlive the document
+        class Document final
+        {
+            friend Node;
+        public:
+            Document(const uint8_t* begin, const uint8_t* end):
+                source(reinterpret_cast<const char*>(begin)),
+                sourceEnd(reinterpret_cast<const char*>(end))
+            {
+                Builder builder(*this);
+                Parser parser;
+                parser.parse(begin, end, builder);
+            }
+
+            explicit Document(const std::vector<uint8_t>& data):
+                Document(data.data(), data.data() + data.size())
+            {
+            }
+
+            Document(const Document&) = delete;
+            Document& operator=(const Document&) = delete;
+
+            Document(Document&&) = delete;
+            Document& operator=(Document&&) = delete;
+
+            inline Node getRoot() const { return Node(this, 0); }
+
+            inline bool hasMember(const std::string& member) const { return getRoot().hasMember(member); }
+            inline Node operator[](const std::string& member) const { return getRoot()[member]; }
+
+        private:
+            struct Entry final
+            {
+                Node::Type type = Node::Type::NONE;
+                bool null = false;
+                union
+                {
+                    bool boolValue;
+                    int64_t intValue = 0;
+                    double doubleValue;
+                };
+                StringView string; // value of strings
+                StringView key; // key of object members
+                uint32_t firstChild = 0; // index in children
+                uint32_t childCount = 0;
+            };
+
+            class Builder final
+            {
+            public:
+                explicit Builder(Document& initDocument): document(initDocument) {}
+
+                void startObject() { start(Node::Type::OBJECT); }
+                void endObject() { end(); }
+                void startArray() { start(Node::Type::ARRAY); }
+                void endArray() { end(); }
+
+                void key(const StringView& value)
+                {
+                    pendingKey = document.store(value);
+                }
+
+                void string(const StringView& value)
+                {
+                    Entry& entry = add(Node::Type::STRING);
+                    entry.string = document.store(value);
+                }
+
+                void integer(int64_t value)
+                {
+                    add(Node::Type::INTEGER).intValue = value;
+                }
+
+                void number(double value)
+                {
+                    add(Node::Type::FLOAT).doubleValue = value;
+                }
+
+                void boolean(bool value)
+                {
+                    add(Node::Type::BOOLEAN).boolValue = value;
+                }
+
+                void null()
+                {
+                    add(Node::Type::OBJECT).null = true;
+                }
+
+            private:
+                Entry& add(Node::Type type)
+                {
+                    const uint32_t index = static_cast<uint32_t>(document.entries.size());
+                    document.entries.push_back(Entry());
+
+                    Entry& entry = document.entries.back();
+                    entry.type = type;
+                    entry.key = pendingKey;
+                    pendingKey = StringView();
+
+                    if (!containers.empty()) children.push_back(index);
+
+                    return entry;
+                }
+
+                void start(Node::Type type)
+                {
+                    const uint32_t container = static_cast<uint32_t>(document.entries.size());
+                    add(type);
+                    containers.push_back(container);
+                    childStarts.push_back(children.size());
+                }
+
+                void end()
+                {
+                    // the children of every container are moved next to each other when it closes
+                    const uint32_t container = containers.back();
+                    const size_t childStart = childStarts.back();
+
+                    Entry& entry = document.entries[container];
+                    entry.firstChild = static_cast<uint32_t>(document.children.size());
+                    entry.childCount = static_cast<uint32_t>(children.size() - childStart);
+
+                    document.children.insert(document.children.end(), children.begin() + static_cast<std::ptrdiff_t>(childStart), children.end());
+                    children.resize(childStart);
+
+                    containers.pop_back();
+                    childStarts.pop_back();
+                }
+
+                Document& document;
+                StringView pendingKey;
+                std::vector<uint32_t> containers;
+                std::vector<size_t> childStarts;
+                std::vector<uint32_t> children;
+            };
+
+            // strings outside of the source were unescaped into the buffer of the parser and have to be copied
+            StringView store(const StringView& value)
+            {
+                if (value.getData() >= source && value.getData() <= sourceEnd)
+                    return value;
+
+                strings.push_back(value.str());
+                return StringView(strings.back().data(), strings.back().size());
+            }
+
+            // nodes without a document (missing members and elements) refer to an entry of type NONE
+            static const Entry& getEntry(const Document* document, uint32_t index)
+            {
+                static const Entry none;
+                return (document && index < document->entries.size()) ? document->entries[index] : none;
+            }
+
+            const char* source;
+            const char* sourceEnd;
+            std::vector<Entry> entries;
+            std::vector<uint32_t> children;
+            std::deque<std::string> strings;
+        };
+
+        inline Node::Type Node::getType() const
+        {
+            return Document::getEntry(document, index).type;
+        }
+
+        inline bool Node::isNull() const
+        {
+            assert(getType() == Type::OBJECT);
+            return Document::getEntry(document, index).null;
+        }
+
+        inline StringView Node::getKey() const
+        {
+            return Document::getEntry(document, index).key;
+        }
+
+        template<typename T, typename std::enable_if<std::is_same<T, StringView>::value>::type*>
+        inline StringView Node::as() const
+        {
+            const Document::Entry& entry = Document::getEntry(document, index);
+            if (entry.type != Type::STRING)
+                throw std::runtime_error("Expected a string");
+
+            return entry.string;
+        }
+
+        template<typename T, typename std::enable_if<std::is_same<T, bool>::value>::type*>
+        inline T Node::as() const
+        {
+            const Document::Entry& entry = Document::getEntry(document, index);
+            if (entry.type == Type::BOOLEAN) return entry.boolValue;
+            else if (entry.type == Type::INTEGER) return entry.intValue != 0;
+            else if (entry.type == Type::FLOAT) return entry.doubleValue != 0.0;
+            else throw std::runtime_error("Expected a boolean");
+        }
+
+        template<typename T, typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>::type*>
+        inline T Node::as() const
+        {
+            const Document::Entry& entry = Document::getEntry(document, index);
+            if (entry.type == Type::BOOLEAN) return entry.boolValue;
+            else if (entry.type == Type::INTEGER) return static_cast<T>(entry.intValue);
+            else if (entry.type == Type::FLOAT) return static_cast<T>(entry.doubleValue);
+            else throw std::runtime_error("Expected a number");
+        }
+
+        inline bool Node::hasMember(const std::string& member) const
+        {
+            assert(getType() == Type::OBJECT);
+            return (*this)[member].getType() != Type::NONE;
+        }
+
+        inline Node Node::operator[](const std::string& member) const
+        {
+            if (getType() != Type::OBJECT) return Node();
+
+            // objects are small, so a linear search is faster than building a map
+            const Document::Entry& entry = Document::getEntry(document, index);
+            for (uint32_t i = 0; i < entry.childCount; ++i)
+            {
+                const uint32_t child = document->children[entry.firstChild + i];
+                if (document->entries[child].key == member)
+                    return Node(document, child);
+            }
+
+            return Node();
+        }
+
+        inline Node Node::operator[](size_t element) const
+        {
+            if (getType() != Type::ARRAY) return Node();
+
+            const Document::Entry& entry = Document::getEntry(document, index);
+            if (element >= entry.childCount) return Node();
+
+            return Node(document, document->children[entry.firstChild + element]);
+        }
+
+        inline size_t Node::getSize() const
+        {
+            assert(getType() == Type::ARRAY || getType() == Type::OBJECT);
+            return Document::getEntry(document, index).childCount;
+        }
+
+        inline Node::Iterator Node::begin() const
+        {
+            if (!document || document->children.empty()) return Iterator(document, nullptr);
+            return Iterator(document, document->children.data() + Document::getEntry(document, index).firstChild);
+        }
+
+        inline Node::Iterator Node::end() const
+        {
+            if (!document || document->children.empty()) return Iterator(document, nullptr);
+            const Document::Entry& entry = Document::getEntry(document, index);
+            return Iterator(document, document->children.data() + entry.firstChild + entry.childCount);
+        }
+    } // namespace json
+} // namespace ouzel
+
+#endif // OUZEL_UTILS_JSONPARSER_HPP
@@ -25,11 +25,192 @@
 
 namespace ouzel
 {
+    constexpr Log::Level Log::MAX_LEVEL;
+    constexpr size_t Log::Record::CAPACITY;
+#if !defined(__EMSCRIPTEN__)
+    constexpr size_t Logger::QUEUE_CAPACITY;
+    constexpr std::chrono::milliseconds Logger::BLOCKING_TIMEOUT;
+#endif
+
+    std::string Log::Record::format() const
+    {
+        std::string result = text;
+
+        for (uint32_t offset = 0; offset < size;)
+        {
+            const uint8_t argument = data[offset++];
+
+            switch (argument)
+            {
+                case SIGNED:
+                {
+                    int64_t value;
+                    memcpy(&value, data + offset, sizeof(value));
+                    offset += sizeof(value);
+                    result += std::to_string(value);
+                    break;
+                }
+                case UNSIGNED:
+                {
+                    uint64_t value;
+                    memcpy(&value, data + offset, sizeof(value));
+                    offset += sizeof(value);
+                    result += std::to_string(value);
+                    break;
+                }
+                case FLOATING_POINT:
+                {
+                    double value;
+                    memcpy(&value, data + offset, sizeof(value));
+                    offset += sizeof(value);
+                    result += std::to_string(value);
+                    break;
+                }
+                case BOOLEAN:
+                    result += data[offset++] ? "true" : "false";
+                    break;
+                case STRING:
+                {
+                    uint32_t length;
+                    memcpy(&length, data + offset, sizeof(length));
+                    offset += sizeof(length);
+                    result.append(reinterpret_cast<const char*>(data + offset), length);
+                    offset += length;
+                    break;
+                }
+                case POINTER:
+                {
+                    uintptr_t value;
+                    memcpy(&value, data + offset, sizeof(value));
+                    offset += sizeof(value);
+
+                    static constexpr const char* digits = "0123456789ABCDEF";
+
+                    std::string str(sizeof(value) * 2, '0');
+                    for (size_t i = 0; i < sizeof(value) * 2; ++i)
+                        str[i] = digits[(value >> (sizeof(value) * 2 - i - 1) * 4) & 0x0f];
+
+                    result += str;
+                    break;
+                }
+                default:
+                    return result;
+            }
+        }
+
+        return result;
+    }
+
     Log::~Log()
     {
-        if (!s.empty())
-            logger.log(s, level);
+        if (enabled && (record.size || !record.text.empty()))
+            logger.push(std::move(record));
+    }
+
+    void Log::spill()
+    {
+        record.text = record.format();
+        record.size = 0;
+    }
+
+    void Logger::push(Log::Record&& record) const
+    {
+        if (const uint32_t limit = rateLimit.load(std::memory_order_relaxed))
+        {
+            const uint64_t second = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+            uint64_t lastSecond = rateSecond.load(std::memory_order_relaxed);
+
+            if (lastSecond != second &&
+                rateSecond.compare_exchange_strong(lastSecond, second, std::memory_order_relaxed))
+                rateCount.store(0, std::memory_order_relaxed);
+
+            if (rateCount.fetch_add(1, std::memory_order_relaxed) >= limit)
+            {
+#if !defined(__EMSCRIPTEN__)
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+#endif
+                return;
+            }
+        }
+
+#if defined(__EMSCRIPTEN__)
+        logString(record.format(), record.level);
+#else
+        std::chrono::steady_clock::time_point deadline;
+
+        while (!logQueue.push(std::move(record)))
+        {
+            if (record.level > blockingLevel.load(std::memory_order_relaxed) ||
+                !running.load(std::memory_order_acquire))
+            {
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            // the log thread is awake while the queue is not empty, so a cell gets freed soon,
+            // unless it is stalled in the output, in which case the message is dropped after a while
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (deadline == std::chrono::steady_clock::time_point())
+                deadline = now + BLOCKING_TIMEOUT;
+            else if (now > deadline)
+            {
+                droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            std::this_thread::yield();
+        }
+
+        // pairs with the fence in logLoop, either the log thread sees the record or this sees it sleeping
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (sleeping.load(std::memory_order_relaxed))
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            lock.unlock();
+            logCondition.notify_all();
+        }
+#endif
+    }
+
+#if !defined(__EMSCRIPTEN__)
+    void Logger::logLoop()
+    {
+        Log::Record record;
+
+        for (;;)
+        {
+            while (logQueue.pop(record))
+                logString(record.format(), record.level);
+
+            if (const uint64_t dropped = droppedCount.exchange(0, std::memory_order_relaxed))
+                logString(std::to_string(dropped) + " log messages dropped", Log::Level::WARN);
+
+            std::unique_lock<std::mutex> lock(queueMutex);
+            if (!running) break;
+
+            sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (!logQueue.pop(record))
+                logCondition.wait(lock);
+            else
+            {
+                lock.unlock();
+                logString(record.format(), record.level);
+            }
+
+            sleeping.store(false, std::memory_order_relaxed);
+        }
+
+        // flush the messages that were logged before the logger was destroyed
+        while (logQueue.pop(record))
+            logString(record.format(), record.level);
+
+        if (const uint64_t dropped = droppedCount.exchange(0, std::memory_order_relaxed))
+            logString(std::to_string(dropped) + " log messages dropped", Log::Level::WARN);
     }
+#endif
 
     void Logger::logString(const std::string& str, Log::Level level)
     {
@@ -4,9 +4,10 @@
 #define OUZEL_UTILS_LOG_HPP
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstring>
 #include <mutex>
-#include <queue>
 #include <string>
 #include <thread>
 #include <type_traits>
@@ -15,6 +16,16 @@
 #include "math/Quaternion.hpp"
 #include "math/Size.hpp"
 #include "math/Vector.hpp"
+#include "utils/MpscQueue.hpp"
+
+// messages with a higher level are compiled out (4 is Log::Level::ALL)
+#ifndef OUZEL_MAX_LOG_LEVEL
+#  define OUZEL_MAX_LOG_LEVEL 4
+#endif
+
+// logs a message with the logger (or the engine), the arguments are not evaluated if the level is compiled out
+#define OUZEL_LOG(logger, level) \
+    ((level) > ouzel::Log::MAX_LEVEL) ? static_cast<void>(0) : ouzel::Log::Voidify() & (logger).log(level)
 
 namespace ouzel
 {
@@ -32,30 +43,59 @@ namespace ouzel
             ALL
         };
 
-        explicit Log(const Logger& initLogger, Level initLevel = Level::INFO):
-            logger(initLogger), level(initLevel)
+        static constexpr Level MAX_LEVEL = static_cast<Level>(OUZEL_MAX_LOG_LEVEL);
+
+        // turns the message of OUZEL_LOG into void, & binds weaker than << and stronger than ?:
+        struct Voidify final
         {
-        }
+            void operator&(const Log&) {}
+        };
+
+        // The arguments of a message are stored in binary and formatted on the log thread,
+        // messages that don't fit in the data are formatted into the text instead.
+        struct Record final
+        {
+            enum Argument: uint8_t
+            {
+                SIGNED,
+                UNSIGNED,
+                FLOATING_POINT,
+                BOOLEAN,
+                STRING,
+                POINTER
+            };
+
+            static constexpr size_t CAPACITY = 224;
+
+            std::string format() const;
+
+            Level level = Level::INFO;
+            uint32_t size = 0;
+            uint8_t data[CAPACITY];
+            std::string text;
+        };
+
+        explicit Log(const Logger& initLogger, Level initLevel = Level::INFO);
 
         Log(const Log& other):
             logger(other.logger),
-            level(other.level),
-            s(other.s)
+            enabled(other.enabled),
+            record(other.record)
         {
         }
 
         Log(Log&& other):
             logger(other.logger),
-            level(other.level),
-            s(std::move(other.s))
+            enabled(other.enabled),
+            record(std::move(other.record))
         {
-            other.level = Level::INFO;
+            other.enabled = false;
         }
 
         Log& operator=(const Log& other)
         {
-            level = other.level;
-            s = other.s;
+            enabled = other.enabled;
+            record = other.record;
 
             return *this;
         }
@@ -64,9 +104,9 @@ namespace ouzel
         {
             if (&other != this)
             {
-                level = other.level;
-                other.level = Level::INFO;
-                s = std::move(other.s);
+                enabled = other.enabled;
+                other.enabled = false;
+                record = std::move(other.record);
             }
 
             return *this;
@@ -74,60 +114,70 @@ namespace ouzel
 
         ~Log();
 
-        template<typename T, typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>::type* = nullptr>
+        template<typename T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value && !std::is_same<T, bool>::value>::type* = nullptr>
+        Log& operator<<(T val)
+        {
+            if (enabled) write(Record::SIGNED, static_cast<int64_t>(val));
+            return *this;
+        }
+
+        template<typename T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value && !std::is_same<T, bool>::value>::type* = nullptr>
+        Log& operator<<(T val)
+        {
+            if (enabled) write(Record::UNSIGNED, static_cast<uint64_t>(val));
+            return *this;
+        }
+
+        template<typename T, typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
         Log& operator<<(T val)
         {
-            s += std::to_string(val);
+            if (enabled) write(Record::FLOATING_POINT, static_cast<double>(val));
             return *this;
         }
 
         template<typename T, typename std::enable_if<std::is_same<T, bool>::value>::type* = nullptr>
         Log& operator<<(T val)
         {
-            s += val ? "true" : "false";
+            if (enabled) write(Record::BOOLEAN, static_cast<uint8_t>(val ? 1 : 0));
             return *this;
         }
 
         template<typename T, typename std::enable_if<std::is_same<T, std::string>::value>::type* = nullptr>
         Log& operator<<(const T& val)
         {
-            s += val;
+            if (enabled) writeString(val.data(), val.size());
             return *this;
         }
 
         template<typename T, typename std::enable_if<std::is_same<T, char>::value>::type* = nullptr>
         Log& operator<<(const T* val)
         {
-            s += val;
+            if (enabled) writeString(val, strlen(val));
             return *this;
         }
 
         template<typename T, typename std::enable_if<!std::is_same<T, char>::value>::type* = nullptr>
         Log& operator<<(const T* val)
         {
-            static constexpr const char* digits = "0123456789ABCDEF";
-
-            std::string str(sizeof(val) * 2, '0');
-            for (size_t i = 0; i < sizeof(val) * 2; ++i)
-                str[i] = digits[(reinterpret_cast<uintptr_t>(val) >> (sizeof(val) * 2 - i - 1) * 4) & 0x0f];
-
-            s += str;
+            if (enabled) write(Record::POINTER, reinterpret_cast<uintptr_t>(val));
             return *this;
         }
 
         template<typename T, typename std::enable_if<std::is_same<T, std::vector<uint8_t>>::value>::type* = nullptr>
         Log& operator<<(const T& val)
         {
+            if (!enabled) return *this;
+
             bool first = true;
 
             for (uint8_t b : val)
             {
-                if (!first) s += ", ";
+                if (!first) writeString(", ", 2);
                 first = false;
 
                 static constexpr const char* digits = "0123456789ABCDEF";
-                s += digits[(b >> 4) & 0x0f];
-                s += digits[b & 0x0f];
+                const char hex[2] = {digits[(b >> 4) & 0x0f], digits[b & 0x0f]};
+                writeString(hex, 2);
             }
 
             return *this;
@@ -136,13 +186,15 @@ namespace ouzel
         template<typename T, typename std::enable_if<std::is_same<T, std::vector<std::string>>::value>::type* = nullptr>
         Log& operator<<(const T& val)
         {
+            if (!enabled) return *this;
+
             bool first = true;
 
             for (const std::string& str : val)
             {
-                if (!first) s += ", ";
+                if (!first) writeString(", ", 2);
                 first = false;
-                s += str;
+                writeString(str.data(), str.size());
             }
 
             return *this;
@@ -151,13 +203,15 @@ namespace ouzel
         template<size_t N, size_t M, class T>
         Log& operator<<(const Matrix<N, M, T>& val)
         {
+            if (!enabled) return *this;
+
             bool first = true;
 
             for (T c : val.m)
             {
-                if (!first) s += ",";
+                if (!first) writeString(",", 1);
                 first = false;
-                s += std::to_string(c);
+                *this << c;
             }
 
             return *this;
@@ -166,21 +220,30 @@ namespace ouzel
         template<class T>
         Log& operator<<(const Quaternion<T>& val)
         {
-            s += std::to_string(val.v[0]) + "," + std::to_string(val.v[1]) + "," +
-                std::to_string(val.v[2]) + "," + std::to_string(val.v[3]);
+            if (!enabled) return *this;
+
+            *this << val.v[0];
+            writeString(",", 1);
+            *this << val.v[1];
+            writeString(",", 1);
+            *this << val.v[2];
+            writeString(",", 1);
+            *this << val.v[3];
             return *this;
         }
 
         template<size_t N, class T>
         Log& operator<<(const Size<N, T>& val)
         {
+            if (!enabled) return *this;
+
             bool first = true;
 
             for (T c : val.v)
             {
-                if (!first) s += ",";
+                if (!first) writeString(",", 1);
                 first = false;
-                s += std::to_string(c);
+                *this << c;
             }
             return *this;
         }
@@ -188,25 +251,62 @@ namespace ouzel
         template<size_t N, class T>
         Log& operator<<(const Vector<N, T>& val)
         {
+            if (!enabled) return *this;
+
             bool first = true;
 
             for (T c : val.v)
             {
-                if (!first) s += ",";
+                if (!first) writeString(",", 1);
                 first = false;
-                s += std::to_string(c);
+                *this << c;
             }
             return *this;
         }
 
     private:
+        template<class T>
+        void write(Record::Argument argument, T value)
+        {
+            if (record.size + 1 + sizeof(T) > Record::CAPACITY) spill();
+
+            record.data[record.size] = argument;
+            memcpy(record.data + record.size + 1, &value, sizeof(T));
+            record.size += static_cast<uint32_t>(1 + sizeof(T));
+        }
+
+        void writeString(const char* str, size_t length)
+        {
+            if (record.size + 1 + sizeof(uint32_t) + length > Record::CAPACITY)
+            {
+                spill();
+
+                // too long to be stored as an argument
+                if (1 + sizeof(uint32_t) + length > Record::CAPACITY)
+                {
+                    record.text.append(str, length);
+                    return;
+                }
+            }
+
+            const uint32_t size = static_cast<uint32_t>(length);
+            record.data[record.size] = Record::STRING;
+            memcpy(record.data + record.size + 1, &size, sizeof(size));
+            memcpy(record.data + record.size + 1 + sizeof(size), str, length);
+            record.size += static_cast<uint32_t>(1 + sizeof(size) + length);
+        }
+
+        // formats the stored arguments into the text to make room for more
+        void spill();
+
         const Logger& logger;
-        Level level = Level::INFO;
-        std::string s;
+        bool enabled = false;
+        Record record;
     };
 
     class Logger final
     {
+        friend Log;
     public:
         explicit Logger(Log::Level initThreshold = Log::Level::ALL):
             threshold(initThreshold)
@@ -234,51 +334,62 @@ namespace ouzel
 
         void log(const std::string& str, Log::Level level = Log::Level::INFO) const
         {
-            if (level <= threshold)
-            {
-#if defined(__EMSCRIPTEN__)
-                logString(str, level);
-#else
-                std::unique_lock<std::mutex> lock(queueMutex);
-                logQueue.push(std::make_pair(level, str));
-                lock.unlock();
-                logCondition.notify_all();
-#endif
-            }
+            Log(*this, level) << str;
         }
 
+        inline bool isEnabled(Log::Level level) const
+        {
+            return level <= Log::MAX_LEVEL && level <= threshold.load(std::memory_order_relaxed);
+        }
+
+        // the messages above the limit (per second) are dropped, zero disables the limit
+        inline uint32_t getRateLimit() const { return rateLimit; }
+        inline void setRateLimit(uint32_t newRateLimit) { rateLimit = newRateLimit; }
+
+        // when the queue is full, the messages of this level and more severe ones wait for the log thread
+        // instead of being dropped, OFF never blocks the caller
+        // the wait is bounded by BLOCKING_TIMEOUT and ends when the logger is being destroyed
+        inline Log::Level getBlockingLevel() const { return blockingLevel.load(std::memory_order_relaxed); }
+        inline void setBlockingLevel(Log::Level newBlockingLevel) { blockingLevel.store(newBlockingLevel, std::memory_order_relaxed); }
+
     private:
         static void logString(const std::string& str, Log::Level level = Log::Level::INFO);
 
+        void push(Log::Record&& record) const;
+
 #ifdef DEBUG
         std::atomic<Log::Level> threshold{Log::Level::ALL};
 #else
         std::atomic<Log::Level> threshold{Log::Level::INFO};
 #endif
 
+        std::atomic<Log::Level> blockingLevel{Log::Level::WARN};
+        std::atomic<uint32_t> rateLimit{0};
+        mutable std::atomic<uint64_t> rateSecond{0};
+        mutable std::atomic<uint32_t> rateCount{0};
+
 #if !defined(__EMSCRIPTEN__)
-        void logLoop()
-        {
-            for (;;)
-            {
-                std::unique_lock<std::mutex> lock(queueMutex);
-                while (running && logQueue.empty()) logCondition.wait(lock);
-                if (!running) break;
-                std::pair<Log::Level, std::string> str = std::move(logQueue.front());
-                logQueue.pop();
-                lock.unlock();
-
-                logString(str.second, str.first);
-            }
-        }
+        void logLoop();
+
+        static constexpr size_t QUEUE_CAPACITY = 1024;
+        static constexpr std::chrono::milliseconds BLOCKING_TIMEOUT{100};
+
+        mutable MpscQueue<Log::Record> logQueue{QUEUE_CAPACITY};
+        mutable std::atomic<uint64_t> droppedCount{0};
 
         mutable std::condition_variable logCondition;
         mutable std::mutex queueMutex;
-        mutable std::queue<std::pair<Log::Level, std::string>> logQueue;
+        mutable std::atomic_bool sleeping{false}; // producers lock the mutex only when the log thread waits
         std::thread logThread;
-        bool running = true;
+        std::atomic_bool running{true};
 #endif
     };
+
+    inline Log::Log(const Logger& initLogger, Level initLevel):
+        logger(initLogger), enabled(initLogger.isEnabled(initLevel))
+    {
+        record.level = initLevel;
+    }
 }
 
 #endif // OUZEL_UTILS_LOG_HPP
@@ -0,0 +1,294 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include "Metrics.hpp"
+#include "core/Engine.hpp"
+#include "storage/FileSystem.hpp"
+
+static bool isValidName(const std::string& name)
+{
+    if (name.empty()) return false;
+
+    for (size_t i = 0; i < name.size(); ++i)
+    {
+        const char c = name[i];
+        if ((c < 'a' || c > 'z') && (c < 'A' || c > 'Z') && c != '_' && c != ':' &&
+            (i == 0 || c < '0' || c > '9'))
+            return false;
+    }
+
+    return true;
+}
+
+static std::string formatNumber(double value, bool json)
+{
+    if (std::isnan(value)) return json ? "null" : "NaN";
+    if (std::isinf(value)) return json ? "null" : (value > 0.0 ? "+Inf" : "-Inf");
+
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.9g", value);
+    return buffer;
+}
+
+static std::string escapeHelp(const std::string& str)
+{
+    std::string result;
+
+    for (char c : str)
+    {
+        if (c == '\\') result += "\\\\";
+        else if (c == '\n') result += "\\n";
+        else result.push_back(c);
+    }
+
+    return result;
+}
+
+namespace ouzel
+{
+    Metrics::Histogram::Histogram(const std::vector<double>& initBounds):
+        bounds(initBounds),
+        bucketCounts(new std::atomic<uint64_t>[initBounds.size() + 1])
+    {
+        if (!std::is_sorted(bounds.begin(), bounds.end()))
+            throw std::runtime_error("Histogram bounds must be in ascending order");
+
+        for (size_t i = 0; i <= bounds.size(); ++i)
+            bucketCounts[i].store(0, std::memory_order_relaxed);
+    }
+
+    void Metrics::Histogram::observe(double value)
+    {
+        const size_t bucket = static_cast<size_t>(std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin());
+        bucketCounts[bucket].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+
+        double oldSum = sum.load(std::memory_order_relaxed);
+        while (!sum.compare_exchange_weak(oldSum, oldSum + value, std::memory_order_relaxed));
+    }
+
+    Metrics::Metrics(storage::FileSystem& initFileSystem):
+        fileSystem(initFileSystem)
+    {
+    }
+
+    Metrics::Entry& Metrics::addEntry(const std::string& name, const std::string& help, Type type)
+    {
+        if (!isValidName(name))
+            throw std::runtime_error("Invalid metric name " + name);
+
+        auto i = entries.find(name);
+
+        if (i != entries.end())
+        {
+            if (i->second.type != type)
+                throw std::runtime_error("Metric " + name + " is already registered with a different type");
+
+            return i->second;
+        }
+
+        Entry& entry = entries[name];
+        entry.type = type;
+        entry.help = help;
+        return entry;
+    }
+
+    Metrics::Counter& Metrics::addCounter(const std::string& name, const std::string& help)
+    {
+        std::unique_lock<std::mutex> lock(entryMutex);
+        Entry& entry = addEntry(name, help, Type::COUNTER);
+        if (!entry.counter) entry.counter.reset(new Counter());
+        return *entry.counter;
+    }
+
+    Metrics::Gauge& Metrics::addGauge(const std::string& name, const std::string& help)
+    {
+        std::unique_lock<std::mutex> lock(entryMutex);
+        Entry& entry = addEntry(name, help, Type::GAUGE);
+        if (!entry.gauge) entry.gauge.reset(new Gauge());
+        return *entry.gauge;
+    }
+
+    Metrics::Gauge& Metrics::addGauge(const std::string& name, const std::string& help, const std::function<double()>& sampler)
+    {
+        std::unique_lock<std::mutex> lock(entryMutex);
+        Entry& entry = addEntry(name, help, Type::GAUGE);
+        if (!entry.gauge) entry.gauge.reset(new Gauge(sampler));
+        return *entry.gauge;
+    }
+
+    Metrics::Histogram& Metrics::addHistogram(const std::string& name, const std::string& help, const std::vector<double>& bounds)
+    {
+        std::unique_lock<std::mutex> lock(entryMutex);
+        Entry& entry = addEntry(name, help, Type::HISTOGRAM);
+        if (!entry.histogram) entry.histogram.reset(new Histogram(bounds));
+        return *entry.histogram;
+    }
+
+    std::string Metrics::exportJson() const
+    {
+        const auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+        std::string result = "{\"timestamp\":" + std::to_string(timestamp);
+
+        std::unique_lock<std::mutex> lock(entryMutex);
+
+        for (const auto& i : entries)
+        {
+            result += ",\"" + i.first + "\":";
+
+            switch (i.second.type)
+            {
+                case Type::COUNTER:
+                    result += std::to_string(i.second.counter->getValue());
+                    break;
+                case Type::GAUGE:
+                    result += formatNumber(i.second.gauge->getValue(), true);
+                    break;
+                case Type::HISTOGRAM:
+                {
+                    const Histogram& histogram = *i.second.histogram;
+                    const std::vector<double>& bounds = histogram.getBounds();
+
+                    result += "{\"count\":" + std::to_string(histogram.getCount()) +
+                        ",\"sum\":" + formatNumber(histogram.getSum(), true) + ",\"buckets\":{";
+
+                    for (size_t bucket = 0; bucket <= bounds.size(); ++bucket)
+                    {
+                        if (bucket) result += ",";
+                        result += "\"" + (bucket < bounds.size() ? formatNumber(bounds[bucket], false) : std::string("+Inf")) + "\":" +
+                            std::to_string(histogram.getBucketCount(bucket));
+                    }
+
+                    result += "}}";
+                    break;
+                }
+            }
+        }
+
+        result += "}\n";
+
+        return result;
+    }
+
+    std::string Metrics::exportPrometheus() const
+    {
+        std::string result;
+
+        std::unique_lock<std::mutex> lock(entryMutex);
+
+        for (const auto& i : entries)
+        {
+            const std::string& name = i.first;
+
+            if (!i.second.help.empty())
+                result += "# HELP " + name + " " + escapeHelp(i.second.help) + "\n";
+
+            switch (i.second.type)
+            {
+                case Type::COUNTER:
+                    result += "# TYPE " + name + " counter\n";
+                    result += name + " " + std::to_string(i.second.counter->getValue()) + "\n";
+                    break;
+                case Type::GAUGE:
+                    result += "# TYPE " + name + " gauge\n";
+                    result += name + " " + formatNumber(i.second.gauge->getValue(), false) + "\n";
+                    break;
+                case Type::HISTOGRAM:
+                {
+                    const Histogram& histogram = *i.second.histogram;
+                    const std::vector<double>& bounds = histogram.getBounds();
+
+                    result += "# TYPE " + name + " histogram\n";
+
+                    // Prometheus buckets are cumulative
+                    uint64_t cumulativeCount = 0;
+                    for (size_t bucket = 0; bucket <= bounds.size(); ++bucket)
+                    {
+                        cumulativeCount += histogram.getBucketCount(bucket);
+                        result += name + "_bucket{le=\"" +
+                            (bucket < bounds.size() ? formatNumber(bounds[bucket], false) : std::string("+Inf")) + "\"} " +
+                            std::to_string(cumulativeCount) + "\n";
+                    }
+
+                    result += name + "_sum " + formatNumber(histogram.getSum(), false) + "\n";
+                    result += name + "_count " + std::to_string(cumulativeCount) + "\n";
+                    break;
+                }
+            }
+        }
+
+        return result;
+    }
+
+    void Metrics::startExport(const std::string& filename, Format format, std::chrono::steady_clock::duration interval)
+    {
+        exportFilename = filename;
+        exportFormat = format;
+        exportInterval = interval;
+        lastExportTime = std::chrono::steady_clock::now();
+        exporting = true;
+    }
+
+    void Metrics::stopExport()
+    {
+        if (exporting)
+        {
+            exporting = false;
+            writeExport(); // the values since the last export
+        }
+    }
+
+    void Metrics::update()
+    {
+        if (!exporting) return;
+
+        const std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+        if (currentTime - lastExportTime < exportInterval) return;
+
+        lastExportTime = currentTime;
+
+        try
+        {
+            writeExport();
+        }
+        catch (const std::exception& e)
+        {
+            // a failing export must not stop the game
+            exporting = false;
+            OUZEL_LOG(*engine, Log::Level::ERR) << "Failed to export metrics: " << e.what();
+        }
+    }
+
+    void Metrics::writeExport()
+    {
+        switch (exportFormat)
+        {
+            case Format::JSON:
+            {
+                const std::string str = exportJson();
+                fileSystem.writeFile(exportFilename, std::vector<uint8_t>(str.begin(), str.end()), true);
+                break;
+            }
+            case Format::PROMETHEUS:
+            {
+                // scrapers must never see a partially written file, so it is replaced with a rename
+                const std::string str = exportPrometheus();
+                const std::string temporaryFilename = exportFilename + ".tmp";
+                fileSystem.writeFile(temporaryFilename, std::vector<uint8_t>(str.begin(), str.end()));
+
+                if (std::rename(temporaryFilename.c_str(), exportFilename.c_str()) != 0)
+                {
+                    // rename doesn't replace existing files on Windows
+                    std::remove(exportFilename.c_str());
+                    if (std::rename(temporaryFilename.c_str(), exportFilename.c_str()) != 0)
+                        throw std::runtime_error("Failed to rename " + temporaryFilename);
+                }
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,144 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_UTILS_METRICS_HPP
+#define OUZEL_UTILS_METRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ouzel
+{
+    namespace storage
+    {
+        class FileSystem;
+    }
+
+    // Registry of named counters, gauges and histograms, the values are updated with relaxed atomics from any thread
+    class Metrics final
+    {
+    public:
+        enum class Format
+        {
+            JSON, // one JSON object per line, appended to the file
+            PROMETHEUS // Prometheus text exposition format, replaces the file
+        };
+
+        class Counter final
+        {
+        public:
+            inline void increment(uint64_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+            inline uint64_t getValue() const { return value.load(std::memory_order_relaxed); }
+
+        private:
+            std::atomic<uint64_t> value{0};
+        };
+
+        class Gauge final
+        {
+        public:
+            Gauge() = default;
+            explicit Gauge(const std::function<double()>& initSampler): sampler(initSampler) {}
+
+            inline void set(double newValue) { value.store(newValue, std::memory_order_relaxed); }
+            void add(double amount)
+            {
+                double oldValue = value.load(std::memory_order_relaxed);
+                while (!value.compare_exchange_weak(oldValue, oldValue + amount, std::memory_order_relaxed));
+            }
+
+            // sampled gauges call the sampler on the thread that exports the metrics
+            inline double getValue() const { return sampler ? sampler() : value.load(std::memory_order_relaxed); }
+
+        private:
+            std::function<double()> sampler;
+            std::atomic<double> value{0.0};
+        };
+
+        class Histogram final
+        {
+        public:
+            // upper bounds of the buckets in ascending order, larger values go to an additional bucket
+            explicit Histogram(const std::vector<double>& initBounds);
+
+            void observe(double value);
+
+            inline const std::vector<double>& getBounds() const { return bounds; }
+            // number of values in the bucket (not cumulative), the last bucket has no upper bound
+            inline uint64_t getBucketCount(size_t bucket) const { return bucketCounts[bucket].load(std::memory_order_relaxed); }
+            inline uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+            inline double getSum() const { return sum.load(std::memory_order_relaxed); }
+
+        private:
+            std::vector<double> bounds;
+            std::unique_ptr<std::atomic<uint64_t>[]> bucketCounts;
+            std::atomic<uint64_t> count{0};
+            std::atomic<double> sum{0.0};
+        };
+
+        explicit Metrics(storage::FileSystem& initFileSystem);
+
+        Metrics(const Metrics&) = delete;
+        Metrics& operator=(const Metrics&) = delete;
+
+        Metrics(Metrics&&) = delete;
+        Metrics& operator=(Metrics&&) = delete;
+
+        // the returned references stay valid for the lifetime of the registry,
+        // adding a metric with a name that is already registered returns the existing one
+        Counter& addCounter(const std::string& name, const std::string& help = "");
+        Gauge& addGauge(const std::string& name, const std::string& help = "");
+        Gauge& addGauge(const std::string& name, const std::string& help, const std::function<double()>& sampler);
+        Histogram& addHistogram(const std::string& name, const std::string& help, const std::vector<double>& bounds);
+
+        std::string exportJson() const;
+        std::string exportPrometheus() const;
+
+        // writes the metrics to the file every interval
+        void startExport(const std::string& filename, Format format, std::chrono::steady_clock::duration interval);
+        void stopExport();
+        inline bool isExporting() const { return exporting; }
+
+        // called on the update thread, exports the metrics when the interval has passed
+        void update();
+
+    private:
+        enum class Type
+        {
+            COUNTER,
+            GAUGE,
+            HISTOGRAM
+        };
+
+        struct Entry final
+        {
+            Type type;
+            std::string help;
+            std::unique_ptr<Counter> counter;
+            std::unique_ptr<Gauge> gauge;
+            std::unique_ptr<Histogram> histogram;
+        };
+
+        Entry& addEntry(const std::string& name, const std::string& help, Type type);
+        void writeExport();
+
+        storage::FileSystem& fileSystem;
+
+        mutable std::mutex entryMutex;
+        std::map<std::string, Entry> entries;
+
+        bool exporting = false;
+        std::string exportFilename;
+        Format exportFormat = Format::JSON;
+        std::chrono::steady_clock::duration exportInterval;
+        std::chrono::steady_clock::time_point lastExportTime;
+    };
+}
+
+#endif // OUZEL_UTILS_METRICS_HPP
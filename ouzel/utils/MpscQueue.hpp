@@ -0,0 +1,95 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_UTILS_MPSCQUEUE_HPP
+#define OUZEL_UTILS_MPSCQUEUE_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+
+namespace ouzel
+{
+    // Bounded lock-free queue for multiple producer threads and one consumer thread.
+    // The cells are allocated once, so pushing and popping never allocate.
+    template<class T>
+    class MpscQueue final
+    {
+    public:
+        // the capacity must be a power of two
+        explicit MpscQueue(size_t capacity):
+            cells(new Cell[capacity]), mask(capacity - 1)
+        {
+            assert(capacity >= 2 && (capacity & (capacity - 1)) == 0);
+
+            for (size_t i = 0; i < capacity; ++i)
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        MpscQueue(MpscQueue&&) = delete;
+        MpscQueue& operator=(MpscQueue&&) = delete;
+
+        // returns false if the queue is full, can be called from any thread
+        bool push(T&& value)
+        {
+            size_t position = pushPosition.load(std::memory_order_relaxed);
+            Cell* cell;
+
+            for (;;)
+            {
+                cell = &cells[position & mask];
+                const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const ptrdiff_t difference = static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(position);
+
+                if (difference == 0)
+                {
+                    // the cell is free, try to claim it
+                    if (pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (difference < 0)
+                    return false; // the consumer hasn't popped this cell yet
+                else
+                    position = pushPosition.load(std::memory_order_relaxed);
+            }
+
+            cell->value = std::move(value);
+            cell->sequence.store(position + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        // returns false if the queue is empty, must be called only from the consumer thread
+        bool pop(T& value)
+        {
+            Cell* cell = &cells[popPosition & mask];
+
+            if (cell->sequence.load(std::memory_order_acquire) != popPosition + 1)
+                return false;
+
+            value = std::move(cell->value);
+            cell->sequence.store(popPosition + mask + 1, std::memory_order_release);
+            ++popPosition;
+
+            return true;
+        }
+
+    private:
+        struct Cell final
+        {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        std::unique_ptr<Cell[]> cells;
+        size_t mask;
+
+        std::atomic<size_t> pushPosition{0};
+        size_t popPosition = 0;
+    };
+}
+
+#endif // OUZEL_UTILS_MPSCQUEUE_HPP
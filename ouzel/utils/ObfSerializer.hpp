@@ -0,0 +1,509 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_UTILS_OBFSERIALIZER_HPP
+#define OUZEL_UTILS_OBFSERIALIZER_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "utils/Obf.hpp"
+#include "utils/Utils.hpp"
+
+// Serializes structs that list their fields once in a member template:
+//
+// struct Player
+// {
+//     std::string name;
+//     uint32_t score = 0;
+//
+//     template<class Archive>
+//     void serialize(Archive& archive)
+//     {
+//         archive(1, name);
+//         archive(2, score);
+//     }
+// };
+//
+// Structs are written as objects of obf::Value, so the data can be read by either side. The keys must be
+// ascending and must never be reused, fields with keys missing in the data keep their values and unknown
+// keys are skipped, so fields can be added and removed between versions.
+
+namespace ouzel
+{
+    namespace obf
+    {
+        class Encoder final
+        {
+        public:
+            explicit Encoder(std::vector<uint8_t>& initBuffer):
+                buffer(initBuffer)
+            {
+            }
+
+            // writes a field of a struct
+            template<class T>
+            void operator()(uint32_t key, const T& value)
+            {
+                assert(fieldCount == 0 || key > lastKey);
+                lastKey = key;
+                ++fieldCount;
+
+                writeUInt32(key);
+                write(value);
+            }
+
+            template<class T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type* = nullptr>
+            void write(T value)
+            {
+                // obf::Value stores integers in 64 bits, so negative values are sign extended to be read back unchanged
+                writeInt(std::is_signed<T>::value ? static_cast<uint64_t>(static_cast<int64_t>(value)) : static_cast<uint64_t>(value));
+            }
+
+            void write(bool value)
+            {
+                writeInt(value ? 1 : 0);
+            }
+
+            template<class T, typename std::enable_if<std::is_enum<T>::value>::type* = nullptr>
+            void write(T value)
+            {
+                write(static_cast<typename std::underlying_type<T>::type>(value));
+            }
+
+            void write(float value)
+            {
+                writeMarker(Value::Marker::FLOAT);
+                uint8_t* data = grow(sizeof(value));
+                std::memcpy(data, &value, sizeof(value));
+            }
+
+            void write(double value)
+            {
+                writeMarker(Value::Marker::DOUBLE);
+                uint8_t* data = grow(sizeof(value));
+                std::memcpy(data, &value, sizeof(value));
+            }
+
+            void write(const std::string& value)
+            {
+                if (value.length() > std::numeric_limits<uint16_t>::max())
+                {
+                    writeMarker(Value::Marker::LONG_STRING);
+                    writeUInt32(static_cast<uint32_t>(value.length()));
+                }
+                else
+                {
+                    writeMarker(Value::Marker::STRING);
+                    encodeBigEndian<uint16_t>(grow(sizeof(uint16_t)), static_cast<uint16_t>(value.length()));
+                }
+
+                writeBytes(value.data(), value.length());
+            }
+
+            void write(const std::vector<uint8_t>& value)
+            {
+                writeMarker(Value::Marker::BYTE_ARRAY);
+                writeUInt32(static_cast<uint32_t>(value.size()));
+                writeBytes(value.data(), value.size());
+            }
+
+            template<class T>
+            void write(const std::vector<T>& value)
+            {
+                writeMarker(Value::Marker::ARRAY);
+                writeUInt32(static_cast<uint32_t>(value.size()));
+
+                for (const T& element : value)
+                    write(element);
+            }
+
+            template<class T>
+            void write(const std::map<std::string, T>& value)
+            {
+                writeMarker(Value::Marker::DICTIONARY);
+                writeUInt32(static_cast<uint32_t>(value.size()));
+
+                for (const auto& element : value)
+                {
+                    encodeBigEndian<uint16_t>(grow(sizeof(uint16_t)), static_cast<uint16_t>(element.first.length()));
+                    writeBytes(element.first.data(), element.first.length());
+                    write(element.second);
+                }
+            }
+
+            template<class T, typename std::enable_if<std::is_class<T>::value>::type* = nullptr>
+            void write(const T& value)
+            {
+                writeMarker(Value::Marker::OBJECT);
+
+                // the field count is known only after the fields are written
+                const size_t countOffset = buffer.size();
+                grow(sizeof(uint32_t));
+
+                const uint32_t parentFieldCount = fieldCount;
+                const uint32_t parentLastKey = lastKey;
+                fieldCount = 0;
+                lastKey = 0;
+
+                // serialize only reads the fields when called with an encoder
+                const_cast<T&>(value).serialize(*this);
+
+                encodeBigEndian<uint32_t>(buffer.data() + countOffset, fieldCount);
+
+                fieldCount = parentFieldCount;
+                lastKey = parentLastKey;
+            }
+
+        private:
+            inline uint8_t* grow(size_t size)
+            {
+                const size_t offset = buffer.size();
+                buffer.resize(offset + size);
+                return buffer.data() + offset;
+            }
+
+            inline void writeMarker(Value::Marker marker)
+            {
+                buffer.push_back(static_cast<uint8_t>(marker));
+            }
+
+            inline void writeUInt32(uint32_t value)
+            {
+                encodeBigEndian<uint32_t>(grow(sizeof(value)), value);
+            }
+
+            inline void writeBytes(const void* data, size_t size)
+            {
+                if (size) std::memcpy(grow(size), data, size);
+            }
+
+            // uses the smallest marker that fits the value, same as Value::encode
+            void writeInt(uint64_t value)
+            {
+                if (value > std::numeric_limits<uint32_t>::max())
+                {
+                    writeMarker(Value::Marker::INT64);
+                    encodeBigEndian<uint64_t>(grow(sizeof(uint64_t)), value);
+                }
+                else if (value > std::numeric_limits<uint16_t>::max())
+                {
+                    writeMarker(Value::Marker::INT32);
+                    encodeBigEndian<uint32_t>(grow(sizeof(uint32_t)), static_cast<uint32_t>(value));
+                }
+                else if (value > std::numeric_limits<uint8_t>::max())
+                {
+                    writeMarker(Value::Marker::INT16);
+                    encodeBigEndian<uint16_t>(grow(sizeof(uint16_t)), static_cast<uint16_t>(value));
+                }
+                else
+                {
+                    writeMarker(Value::Marker::INT8);
+                    buffer.push_back(static_cast<uint8_t>(value));
+                }
+            }
+
+            std::vector<uint8_t>& buffer;
+            uint32_t fieldCount = 0;
+            uint32_t lastKey = 0;
+        };
+
+        class Decoder final
+        {
+        public:
+            Decoder(const std::vector<uint8_t>& buffer, uint32_t offset = 0):
+                data(buffer.data()), size(buffer.size()), position(offset)
+            {
+                if (offset > size)
+                    throw std::runtime_error("Not enough data");
+            }
+
+            inline uint32_t getOffset() const { return static_cast<uint32_t>(position); }
+
+            // reads a field of a struct, the value is left unchanged if the data doesn't have the field
+            template<class T>
+            void operator()(uint32_t key, T& value)
+            {
+                // skip the fields that were removed from the struct
+                while (remainingFields && currentKey < key)
+                {
+                    skip();
+                    nextField();
+                }
+
+                if (remainingFields && currentKey == key)
+                {
+                    read(value);
+                    nextField();
+                }
+            }
+
+            template<class T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type* = nullptr>
+            void read(T& value)
+            {
+                value = static_cast<T>(readInt());
+            }
+
+            void read(bool& value)
+            {
+                value = readInt() != 0;
+            }
+
+            template<class T, typename std::enable_if<std::is_enum<T>::value>::type* = nullptr>
+            void read(T& value)
+            {
+                value = static_cast<T>(readInt());
+            }
+
+            void read(float& value)
+            {
+                double result;
+                read(result);
+                value = static_cast<float>(result);
+            }
+
+            void read(double& value)
+            {
+                const Value::Marker marker = readMarker();
+
+                if (marker == Value::Marker::FLOAT)
+                {
+                    float result;
+                    std::memcpy(&result, consume(sizeof(result)), sizeof(result));
+                    value = result;
+                }
+                else if (marker == Value::Marker::DOUBLE)
+                    std::memcpy(&value, consume(sizeof(value)), sizeof(value));
+                else
+                    throw std::runtime_error("Expected a floating point value");
+            }
+
+            void read(std::string& value)
+            {
+                const Value::Marker marker = readMarker();
+
+                uint32_t length;
+                if (marker == Value::Marker::STRING)
+                    length = decodeBigEndian<uint16_t>(consume(sizeof(uint16_t)));
+                else if (marker == Value::Marker::LONG_STRING)
+                    length = readUInt32();
+                else
+                    throw std::runtime_error("Expected a string");
+
+                value.assign(reinterpret_cast<const char*>(consume(length)), length);
+            }
+
+            void read(std::vector<uint8_t>& value)
+            {
+                if (readMarker() != Value::Marker::BYTE_ARRAY)
+                    throw std::runtime_error("Expected a byte array");
+
+                const uint32_t length = readUInt32();
+                const uint8_t* bytes = consume(length);
+                value.assign(bytes, bytes + length);
+            }
+
+            // std::vector<bool> doesn't store bool elements, so they can't be read through references
+            void read(std::vector<bool>& value)
+            {
+                if (readMarker() != Value::Marker::ARRAY)
+                    throw std::runtime_error("Expected an array");
+
+                const uint32_t count = readUInt32();
+
+                if (count > size - position)
+                    throw std::runtime_error("Not enough data");
+
+                value.resize(count);
+
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    bool element;
+                    read(element);
+                    value[i] = element;
+                }
+            }
+
+            template<class T>
+            void read(std::vector<T>& value)
+            {
+                if (readMarker() != Value::Marker::ARRAY)
+                    throw std::runtime_error("Expected an array");
+
+                const uint32_t count = readUInt32();
+
+                // every element takes at least one byte, so a corrupt count can't allocate too much
+                if (count > size - position)
+                    throw std::runtime_error("Not enough data");
+
+                value.resize(count);
+
+                for (T& element : value)
+                    read(element);
+            }
+
+            template<class T>
+            void read(std::map<std::string, T>& value)
+            {
+                if (readMarker() != Value::Marker::DICTIONARY)
+                    throw std::runtime_error("Expected a dictionary");
+
+                const uint32_t count = readUInt32();
+                value.clear();
+
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    const uint16_t length = decodeBigEndian<uint16_t>(consume(sizeof(uint16_t)));
+                    std::string key(reinterpret_cast<const char*>(consume(length)), length);
+                    read(value[key]);
+                }
+            }
+
+            template<class T, typename std::enable_if<std::is_class<T>::value>::type* = nullptr>
+            void read(T& value)
+            {
+                if (readMarker() != Value::Marker::OBJECT)
+                    throw std::runtime_error("Expected an object");
+
+                const uint32_t parentRemainingFields = remainingFields;
+                const uint32_t parentCurrentKey = currentKey;
+
+                remainingFields = readUInt32();
+                if (remainingFields) currentKey = readUInt32();
+
+                value.serialize(*this);
+
+                // skip the fields that were added in newer versions
+                while (remainingFields)
+                {
+                    skip();
+                    nextField();
+                }
+
+                remainingFields = parentRemainingFields;
+                currentKey = parentCurrentKey;
+            }
+
+            // skips a value without decoding it
+            void skip()
+            {
+                switch (readMarker())
+                {
+                    case Value::Marker::NONE: break;
+                    case Value::Marker::INT8: consume(sizeof(uint8_t)); break;
+                    case Value::Marker::INT16: consume(sizeof(uint16_t)); break;
+                    case Value::Marker::INT32: consume(sizeof(uint32_t)); break;
+                    case Value::Marker::INT64: consume(sizeof(uint64_t)); break;
+                    case Value::Marker::FLOAT: consume(sizeof(float)); break;
+                    case Value::Marker::DOUBLE: consume(sizeof(double)); break;
+                    case Value::Marker::STRING: consume(decodeBigEndian<uint16_t>(consume(sizeof(uint16_t)))); break;
+                    case Value::Marker::LONG_STRING:
+                    case Value::Marker::BYTE_ARRAY: consume(readUInt32()); break;
+                    case Value::Marker::OBJECT:
+                    {
+                        const uint32_t count = readUInt32();
+                        for (uint32_t i = 0; i < count; ++i)
+                        {
+                            consume(sizeof(uint32_t));
+                            skip();
+                        }
+                        break;
+                    }
+                    case Value::Marker::ARRAY:
+                    {
+                        const uint32_t count = readUInt32();
+                        for (uint32_t i = 0; i < count; ++i)
+                            skip();
+                        break;
+                    }
+                    case Value::Marker::DICTIONARY:
+                    {
+                        const uint32_t count = readUInt32();
+                        for (uint32_t i = 0; i < count; ++i)
+                        {
+                            consume(decodeBigEndian<uint16_t>(consume(sizeof(uint16_t))));
+                            skip();
+                        }
+                        break;
+                    }
+                    default:
+                        throw std::runtime_error("Unsupported marker");
+                }
+            }
+
+        private:
+            inline const uint8_t* consume(size_t count)
+            {
+                if (size - position < count)
+                    throw std::runtime_error("Not enough data");
+
+                const uint8_t* result = data + position;
+                position += count;
+                return result;
+            }
+
+            inline Value::Marker readMarker()
+            {
+                return static_cast<Value::Marker>(*consume(1));
+            }
+
+            inline uint32_t readUInt32()
+            {
+                return decodeBigEndian<uint32_t>(consume(sizeof(uint32_t)));
+            }
+
+            uint64_t readInt()
+            {
+                switch (readMarker())
+                {
+                    case Value::Marker::INT8: return *consume(sizeof(uint8_t));
+                    case Value::Marker::INT16: return decodeBigEndian<uint16_t>(consume(sizeof(uint16_t)));
+                    case Value::Marker::INT32: return decodeBigEndian<uint32_t>(consume(sizeof(uint32_t)));
+                    case Value::Marker::INT64: return decodeBigEndian<uint64_t>(consume(sizeof(uint64_t)));
+                    default:
+                        throw std::runtime_error("Expected an integer");
+                }
+            }
+
+            inline void nextField()
+            {
+                if (--remainingFields) currentKey = readUInt32();
+            }
+
+            const uint8_t* data;
+            size_t size;
+            size_t position;
+            uint32_t remainingFields = 0;
+            uint32_t currentKey = 0;
+        };
+
+        // appends the value to the buffer and returns the number of bytes written
+        template<class T>
+        uint32_t encode(const T& value, std::vector<uint8_t>& buffer)
+        {
+            const size_t originalSize = buffer.size();
+
+            Encoder encoder(buffer);
+            encoder.write(value);
+
+            return static_cast<uint32_t>(buffer.size() - originalSize);
+        }
+
+        // returns the number of bytes read
+        template<class T>
+        uint32_t decode(T& value, const std::vector<uint8_t>& buffer, uint32_t offset = 0)
+        {
+            Decoder decoder(buffer, offset);
+            decoder.read(value);
+
+            return decoder.getOffset() - offset;
+        }
+    } // namespace obf
+} // namespace ouzel
+
+#endif // OUZEL_UTILS_OBFSERIALIZER_HPP
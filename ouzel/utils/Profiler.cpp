@@ -0,0 +1,162 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include "Profiler.hpp"
+#include "Utils.hpp"
+
+static thread_local const ouzel::Profiler* trackProfiler = nullptr;
+static thread_local uint32_t currentTrack = 0;
+static thread_local uint32_t currentDepth = 0;
+
+static std::string escapeString(const std::string& str)
+{
+    std::string result;
+
+    for (char c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            result.push_back('\\');
+            result.push_back(c);
+        }
+        else if (static_cast<unsigned char>(c) >= 0x20)
+            result.push_back(c);
+    }
+
+    return result;
+}
+
+namespace ouzel
+{
+    Profiler::Profiler():
+        startTime(std::chrono::steady_clock::now()),
+        slots(new Slot[CAPACITY])
+    {
+    }
+
+    uint32_t Profiler::addTrack(const std::string& name)
+    {
+        std::unique_lock<std::mutex> lock(trackMutex);
+        uint32_t track = static_cast<uint32_t>(tracks.size());
+        tracks.push_back(name.empty() ? "Thread " + std::to_string(track) : name);
+        return track;
+    }
+
+    std::vector<std::string> Profiler::getTracks() const
+    {
+        std::unique_lock<std::mutex> lock(trackMutex);
+        return tracks;
+    }
+
+    const char* Profiler::getName(const std::string& name)
+    {
+        std::unique_lock<std::mutex> lock(nameMutex);
+        return names.insert(name).first->c_str();
+    }
+
+    uint32_t Profiler::getCurrentTrack()
+    {
+        if (trackProfiler != this)
+        {
+            currentTrack = addTrack(getCurrentThreadName());
+            trackProfiler = this;
+        }
+
+        return currentTrack;
+    }
+
+    int64_t Profiler::beginZone()
+    {
+        ++currentDepth;
+        return getTime();
+    }
+
+    void Profiler::endZone(const char* name, int64_t start)
+    {
+        const int64_t end = getTime();
+        --currentDepth;
+        addSample(name, getCurrentTrack(), currentDepth, start, end - start);
+    }
+
+    void Profiler::addSample(const char* name, uint32_t track, uint32_t depth, int64_t start, int64_t duration)
+    {
+        const uint64_t index = writeIndex.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = slots[index & (CAPACITY - 1)];
+
+        // the sequence number is zero while the slot is being written
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.track.store(track, std::memory_order_relaxed);
+        slot.depth.store(depth, std::memory_order_relaxed);
+        slot.start.store(start, std::memory_order_relaxed);
+        slot.duration.store(duration, std::memory_order_relaxed);
+
+        slot.sequence.store(index + 1, std::memory_order_release);
+    }
+
+    std::vector<Profiler::Sample> Profiler::getSamples() const
+    {
+        std::vector<Sample> result;
+
+        const uint64_t last = writeIndex.load(std::memory_order_acquire);
+        const uint64_t first = (last > CAPACITY) ? last - CAPACITY : 0;
+
+        result.reserve(static_cast<size_t>(last - first));
+
+        for (uint64_t index = first; index < last; ++index)
+        {
+            const Slot& slot = slots[index & (CAPACITY - 1)];
+
+            const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != index + 1) continue; // not written yet or already overwritten
+
+            Sample sample;
+            sample.name = slot.name.load(std::memory_order_relaxed);
+            sample.track = slot.track.load(std::memory_order_relaxed);
+            sample.depth = slot.depth.load(std::memory_order_relaxed);
+            sample.start = slot.start.load(std::memory_order_relaxed);
+            sample.duration = slot.duration.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence) continue;
+
+            result.push_back(sample);
+        }
+
+        return result;
+    }
+
+    std::string Profiler::exportChromeTrace() const
+    {
+        std::string result = "{\"traceEvents\":[";
+        bool first = true;
+
+        std::vector<std::string> trackNames = getTracks();
+
+        for (uint32_t track = 0; track < trackNames.size(); ++track)
+        {
+            if (!first) result += ",";
+            first = false;
+
+            result += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" + std::to_string(track) +
+                ",\"args\":{\"name\":\"" + escapeString(trackNames[track]) + "\"}}";
+        }
+
+        for (const Sample& sample : getSamples())
+        {
+            if (!first) result += ",";
+            first = false;
+
+            // trace event timestamps are in microseconds
+            result += "{\"name\":\"" + escapeString(sample.name ? sample.name : "") + "\",\"ph\":\"X\",\"pid\":0,\"tid\":" +
+                std::to_string(sample.track) +
+                ",\"ts\":" + std::to_string(static_cast<double>(sample.start) / 1000.0) +
+                ",\"dur\":" + std::to_string(static_cast<double>(sample.duration) / 1000.0) + "}";
+        }
+
+        result += "]}";
+
+        return result;
+    }
+}
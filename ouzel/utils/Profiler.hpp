@@ -0,0 +1,121 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_UTILS_PROFILER_HPP
+#define OUZEL_UTILS_PROFILER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ouzel
+{
+    // Collects timed zones from all threads into a lock-free ring buffer, older samples get overwritten
+    class Profiler final
+    {
+    public:
+        static constexpr size_t CAPACITY = 65536; // must be a power of two
+
+        struct Sample final
+        {
+            const char* name;
+            uint32_t track;
+            uint32_t depth;
+            int64_t start; // nanoseconds since the creation of the profiler
+            int64_t duration;
+        };
+
+        Profiler();
+
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+
+        Profiler(Profiler&&) = delete;
+        Profiler& operator=(Profiler&&) = delete;
+
+        inline bool isEnabled() const { return enabled; }
+        inline void setEnabled(bool newEnabled) { enabled = newEnabled; }
+
+        inline int64_t getTime() const
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+        }
+
+        // tracks are timelines that are not bound to a thread (e.g. GPU)
+        uint32_t addTrack(const std::string& name);
+        std::vector<std::string> getTracks() const;
+
+        // returns a pointer to a string that stays valid for the lifetime of the profiler
+        const char* getName(const std::string& name);
+
+        int64_t beginZone();
+        void endZone(const char* name, int64_t start);
+        void addSample(const char* name, uint32_t track, uint32_t depth, int64_t start, int64_t duration);
+
+        std::vector<Sample> getSamples() const;
+
+        // returns the samples in Chrome trace event format, readable by chrome://tracing and Perfetto
+        std::string exportChromeTrace() const;
+
+    private:
+        struct Slot final
+        {
+            std::atomic<uint64_t> sequence{0};
+            std::atomic<const char*> name{nullptr};
+            std::atomic<uint32_t> track{0};
+            std::atomic<uint32_t> depth{0};
+            std::atomic<int64_t> start{0};
+            std::atomic<int64_t> duration{0};
+        };
+
+        uint32_t getCurrentTrack();
+
+        std::atomic_bool enabled{false};
+        std::chrono::steady_clock::time_point startTime;
+
+        std::unique_ptr<Slot[]> slots;
+        std::atomic<uint64_t> writeIndex{0};
+
+        mutable std::mutex trackMutex;
+        std::vector<std::string> tracks;
+
+        std::mutex nameMutex;
+        std::set<std::string> names;
+    };
+
+    class ProfileZone final
+    {
+    public:
+        ProfileZone(Profiler& initProfiler, const char* initName):
+            profiler(initProfiler), name(initName), active(profiler.isEnabled())
+        {
+            if (active) start = profiler.beginZone();
+        }
+
+        ~ProfileZone()
+        {
+            if (active) profiler.endZone(name, start);
+        }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+        ProfileZone(ProfileZone&&) = delete;
+        ProfileZone& operator=(ProfileZone&&) = delete;
+
+        // the name is recorded when the zone ends, so it can be changed once the outcome is known
+        inline void setName(const char* newName) { name = newName; }
+
+    private:
+        Profiler& profiler;
+        const char* name;
+        bool active;
+        int64_t start = 0;
+    };
+}
+
+#endif // OUZEL_UTILS_PROFILER_HPP
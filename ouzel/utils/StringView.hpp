@@ -0,0 +1,66 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_UTILS_STRINGVIEW_HPP
+#define OUZEL_UTILS_STRINGVIEW_HPP
+
+#include <cstring>
+#include <string>
+
+namespace ouzel
+{
+    // Pointer and length of a string, does not own the characters
+    class StringView final
+    {
+    public:
+        StringView() = default;
+        StringView(const char* initData, size_t initLength):
+            data(initData), length(initLength)
+        {
+        }
+
+        inline const char* getData() const { return data; }
+        inline size_t getLength() const { return length; }
+        inline bool empty() const { return length == 0; }
+
+        inline const char* begin() const { return data; }
+        inline const char* end() const { return data + length; }
+
+        inline std::string str() const { return std::string(data, length); }
+
+        inline bool operator==(const StringView& other) const
+        {
+            return length == other.length && std::memcmp(data, other.data, length) == 0;
+        }
+
+        inline bool operator!=(const StringView& other) const
+        {
+            return !(*this == other);
+        }
+
+        inline bool operator==(const std::string& other) const
+        {
+            return length == other.length() && std::memcmp(data, other.data(), length) == 0;
+        }
+
+        inline bool operator==(const char* other) const
+        {
+            return length == std::strlen(other) && std::memcmp(data, other, length) == 0;
+        }
+
+        inline bool operator!=(const std::string& other) const
+        {
+            return !(*this == other);
+        }
+
+        inline bool operator!=(const char* other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        const char* data = nullptr;
+        size_t length = 0;
+    };
+} // namespace ouzel
+
+#endif // OUZEL_UTILS_STRINGVIEW_HPP
@@ -11,12 +11,12 @@ namespace ouzel
 {
     namespace utf8
     {
-        template<typename T>
-        inline std::vector<uint32_t> toUtf32(const T& text)
+        template<typename Iterator>
+        inline std::vector<uint32_t> toUtf32(Iterator begin, Iterator end)
         {
             std::vector<uint32_t> result;
 
-            for (auto i = text.begin(); i != text.end(); ++i)
+            for (auto i = begin; i != end; ++i)
             {
                 uint32_t cp = *i & 0xff;
 
@@ -26,23 +26,23 @@ namespace ouzel
                 }
                 else if ((cp >> 5) == 0x6) // length = 2
                 {
-                    if (++i == text.end()) return result;
+                    if (++i == end) return result;
                     cp = ((cp << 6) & 0x7ff) + (*i & 0x3f);
                 }
                 else if ((cp >> 4) == 0xe) // length = 3
                 {
-                    if (++i == text.end()) return result;
+                    if (++i == end) return result;
                     cp = ((cp << 12) & 0xffff) + (((*i & 0xff) << 6) & 0xfff);
-                    if (++i == text.end()) return result;
+                    if (++i == end) return result;
                     cp += *i & 0x3f;
                 }
                 else if ((cp >> 3) == 0x1e) // length = 4
                 {
-                    if (++i == text.end()) return result;
+                    if (++i == end) return result;
                     cp = ((cp << 18) & 0x1fffff) + (((*i & 0xff) << 12) & 0x3ffff);
-                    if (++i == text.end()) return result;
+                    if (++i == end) return result;
                     cp += ((*i & 0xff) << 6) & 0xfff;
-                    if (++i == text.end()) return result;
+                    if (++i == end) return result;
                     cp += (*i) & 0x3f;
                 }
 
@@ -52,6 +52,12 @@ namespace ouzel
             return result;
         }
 
+        template<typename T>
+        inline std::vector<uint32_t> toUtf32(const T& text)
+        {
+            return toUtf32(text.begin(), text.end());
+        }
+
         inline std::string fromUtf32(uint32_t c)
         {
             std::string result;
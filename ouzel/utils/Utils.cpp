@@ -29,8 +29,12 @@ namespace ouzel
 {
     std::mt19937 randomEngine(std::random_device{}());
 
+    static thread_local std::string currentThreadName;
+
     void setCurrentThreadName(const std::string& name)
     {
+        currentThreadName = name;
+
 #if defined(_MSC_VER)
         THREADNAME_INFO info;
         info.dwType = 0x1000;
@@ -56,6 +60,11 @@ namespace ouzel
 #endif
     }
 
+    const std::string& getCurrentThreadName()
+    {
+        return currentThreadName;
+    }
+
     void setThreadPriority(std::thread& t, float priority, bool realtime)
     {
 #if defined(_MSC_VER)
@@ -30,7 +30,7 @@ namespace ouzel
         T result = 0;
 
         for (uintptr_t i = 0; i < sizeof(T); ++i)
-            result |= static_cast<T>(bytes[sizeof(buffer) - i - 1] << (i * 8));
+            result |= static_cast<T>(static_cast<T>(bytes[sizeof(T) - i - 1]) << (i * 8));
 
         return result;
     }
@@ -42,7 +42,7 @@ namespace ouzel
         T result = 0;
 
         for (uintptr_t i = 0; i < sizeof(T); ++i)
-            result |= static_cast<T>(bytes[i] << (i * 8));
+            result |= static_cast<T>(static_cast<T>(bytes[i]) << (i * 8));
 
         return result;
     }
@@ -57,7 +57,7 @@ namespace ouzel
     }
 
     template<class T, typename std::enable_if<std::is_unsigned<T>::value>::type* = nullptr>
-    inline T encodeLittleEndian(void* buffer, T value)
+    inline void encodeLittleEndian(void* buffer, T value)
     {
         uint8_t* bytes = static_cast<uint8_t*>(buffer);
 
@@ -65,6 +65,23 @@ namespace ouzel
             bytes[i] = static_cast<uint8_t>(value >> (i * 8));
     }
 
+    // 64-bit Fowler / Noll / Vo (FNV-1a) hash, data can be hashed in parts by passing the previous result as the hash
+    constexpr uint64_t FNV1A_OFFSET_BASIS = 14695981039346656037ULL;
+    constexpr uint64_t FNV1A_PRIME = 1099511628211ULL;
+
+    inline uint64_t fnv1aHash(const void* data, size_t size, uint64_t hash = FNV1A_OFFSET_BASIS)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= FNV1A_PRIME;
+        }
+
+        return hash;
+    }
+
     template<typename T, typename std::enable_if<std::is_unsigned<T>::value>::type* = nullptr>
     std::string hexToString(T n, size_t len = 0)
     {
@@ -105,6 +122,7 @@ namespace ouzel
     }
 
     void setCurrentThreadName(const std::string& name);
+    const std::string& getCurrentThreadName();
     void setThreadPriority(std::thread& t, float priority, bool realtime);
 }
 
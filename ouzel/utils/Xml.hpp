@@ -630,6 +630,18 @@ namespace ouzel
             }
 
             Data(const std::vector<uint8_t>& data,
+                 bool preserveWhitespaces = false,
+                 bool preserveComments = false,
+                 bool preserveProcessingInstructions = false):
+                Data(data.data(), data.data() + data.size(),
+                     preserveWhitespaces,
+                     preserveComments,
+                     preserveProcessingInstructions)
+            {
+            }
+
+            // parses the data in place, e.g. from a storage::MappedFile
+            Data(const uint8_t* begin, const uint8_t* end,
                  bool preserveWhitespaces = false,
                  bool preserveComments = false,
                  bool preserveProcessingInstructions = false)
@@ -637,18 +649,18 @@ namespace ouzel
                 std::vector<uint32_t> str;
 
                 // BOM
-                if (data.size() >= 3 &&
-                    data[0] == UTF8_BOM[0] &&
-                    data[1] == UTF8_BOM[1] &&
-                    data[2] == UTF8_BOM[2])
+                if (end - begin >= 3 &&
+                    begin[0] == UTF8_BOM[0] &&
+                    begin[1] == UTF8_BOM[1] &&
+                    begin[2] == UTF8_BOM[2])
                 {
                     bom = true;
-                    str = utf8::toUtf32(std::vector<uint8_t>(data.begin() + 3, data.end()));
+                    str = utf8::toUtf32(begin + 3, end);
                 }
                 else
                 {
                     bom = false;
-                    str = utf8::toUtf32(data);
+                    str = utf8::toUtf32(begin, end);
                 }
 
                 bool rootTagFound = false;
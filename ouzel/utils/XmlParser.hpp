@@ -0,0 +1,786 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_UTILS_XMLPARSER_HPP
+#define OUZEL_UTILS_XMLPARSER_HPP
+
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "utils/StringView.hpp"
+#include "utils/Xml.hpp"
+
+namespace ouzel
+{
+    namespace xml
+    {
+        // Pull parser that reads UTF-8 data one event at a time without building a tree.
+        // Names, comments and CDATA sections point into the data, texts and attribute values point into it
+        // unless they contain entities, so the data must outlive the reader and the strings of an event are
+        // only valid until the next call to next().
+        class Reader final
+        {
+        public:
+            enum class Event
+            {
+                NONE,
+                START_TAG,
+                END_TAG,
+                TEXT,
+                CDATA,
+                COMMENT,
+                PROCESSING_INSTRUCTION,
+                END
+            };
+
+            struct Attribute final
+            {
+                StringView name;
+                StringView value;
+            };
+
+            Reader(const uint8_t* begin, const uint8_t* end,
+                   bool initPreserveWhitespaces = false):
+                first(reinterpret_cast<const char*>(begin)),
+                iterator(first),
+                last(reinterpret_cast<const char*>(end)),
+                preserveWhitespaces(initPreserveWhitespaces)
+            {
+                // BOM
+                if (end - begin >= 3 &&
+                    begin[0] == UTF8_BOM[0] &&
+                    begin[1] == UTF8_BOM[1] &&
+                    begin[2] == UTF8_BOM[2])
+                    iterator += 3;
+            }
+
+            explicit Reader(const std::vector<uint8_t>& data,
+                            bool initPreserveWhitespaces = false):
+                Reader(data.data(), data.data() + data.size(), initPreserveWhitespaces)
+            {
+            }
+
+            Event next()
+            {
+                attributes.clear();
+
+                // self-closing tags report an end tag right after the start tag
+                if (pendingEndTag)
+                {
+                    pendingEndTag = false;
+                    name = tags.back();
+                    tags.pop_back();
+                    return event = Event::END_TAG;
+                }
+
+                if (!preserveWhitespaces) skipWhitespaces();
+
+                if (iterator == last)
+                {
+                    if (!tags.empty())
+                        throw std::runtime_error("Unexpected end of data");
+
+                    if (!rootTagFound)
+                        throw std::runtime_error("No root tag found");
+
+                    return event = Event::END;
+                }
+
+                if (*iterator != '<')
+                {
+                    parseText();
+                    return event = Event::TEXT;
+                }
+
+                if (++iterator == last)
+                    throw std::runtime_error("Unexpected end of data");
+
+                if (*iterator == '!') // <!
+                {
+                    if (++iterator == last)
+                        throw std::runtime_error("Unexpected end of data");
+
+                    if (*iterator == '-') // <!-
+                    {
+                        if (++iterator == last)
+                            throw std::runtime_error("Unexpected end of data");
+
+                        if (*iterator != '-') // <!--
+                            throw std::runtime_error("Expected a comment");
+
+                        const char* start = ++iterator;
+
+                        for (;;)
+                        {
+                            if (last - iterator < 3)
+                                throw std::runtime_error("Unexpected end of data");
+
+                            if (iterator[0] == '-' && iterator[1] == '-')
+                            {
+                                if (iterator[2] != '>') // -->
+                                    throw std::runtime_error("Unexpected double-hyphen inside comment");
+
+                                value = StringView(start, static_cast<size_t>(iterator - start));
+                                iterator += 3;
+                                break;
+                            }
+
+                            ++iterator;
+                        }
+
+                        return event = Event::COMMENT;
+                    }
+                    else if (*iterator == '[') // <![
+                    {
+                        ++iterator;
+
+                        if (parseName() != "CDATA")
+                            throw std::runtime_error("Expected CDATA");
+
+                        if (iterator == last)
+                            throw std::runtime_error("Unexpected end of data");
+
+                        if (*iterator != '[')
+                            throw std::runtime_error("Expected a left bracket");
+
+                        const char* start = ++iterator;
+
+                        for (;;)
+                        {
+                            if (last - iterator < 3)
+                                throw std::runtime_error("Unexpected end of data");
+
+                            if (iterator[0] == ']' && iterator[1] == ']' && iterator[2] == '>')
+                            {
+                                value = StringView(start, static_cast<size_t>(iterator - start));
+                                iterator += 3;
+                                break;
+                            }
+
+                            ++iterator;
+                        }
+
+                        return event = Event::CDATA;
+                    }
+                    else
+                        throw std::runtime_error("Type declarations are not supported");
+                }
+                else if (*iterator == '?') // <?
+                {
+                    ++iterator;
+                    name = parseName();
+
+                    if (!parseAttributes('?'))
+                        throw std::runtime_error("Expected a question mark");
+
+                    return event = Event::PROCESSING_INSTRUCTION;
+                }
+                else if (*iterator == '/') // </
+                {
+                    ++iterator;
+                    name = parseName();
+
+                    if (tags.empty() || tags.back() != name)
+                        throw std::runtime_error("Tag not closed properly");
+
+                    skipWhitespaces();
+
+                    if (iterator == last)
+                        throw std::runtime_error("Unexpected end of data");
+
+                    if (*iterator != '>')
+                        throw std::runtime_error("Expected a right angle bracket");
+
+                    ++iterator;
+                    tags.pop_back();
+
+                    return event = Event::END_TAG;
+                }
+                else // <
+                {
+                    if (tags.empty())
+                    {
+                        if (rootTagFound)
+                            throw std::runtime_error("Multiple root tags found");
+                        else
+                            rootTagFound = true;
+                    }
+
+                    name = parseName();
+                    pendingEndTag = parseAttributes('/');
+                    tags.push_back(name);
+
+                    return event = Event::START_TAG;
+                }
+            }
+
+            // skips the children and the end tag of the current start tag
+            void skip()
+            {
+                if (event != Event::START_TAG) return;
+
+                const size_t depth = tags.size();
+
+                while (next() != Event::END_TAG || tags.size() != depth - 1);
+            }
+
+            inline Event getEvent() const { return event; }
+
+            // number of open tags
+            inline size_t getDepth() const { return tags.size(); }
+
+            // name of a tag or a processing instruction
+            inline const StringView& getName() const { return name; }
+
+            // contents of a text, CDATA section or comment
+            inline const StringView& getValue() const { return value; }
+
+            inline const std::vector<Attribute>& getAttributes() const { return attributes; }
+
+            bool hasAttribute(const std::string& attribute) const
+            {
+                for (const Attribute& i : attributes)
+                    if (i.name == attribute) return true;
+
+                return false;
+            }
+
+            StringView getAttribute(const std::string& attribute) const
+            {
+                for (const Attribute& i : attributes)
+                    if (i.name == attribute) return i.value;
+
+                return StringView();
+            }
+
+        private:
+            inline void skipWhitespaces()
+            {
+                while (iterator != last && isWhitespace(static_cast<uint8_t>(*iterator)))
+                    ++iterator;
+            }
+
+            // bytes of multibyte characters are accepted as name characters
+            static inline bool isNameStartByte(char c)
+            {
+                return static_cast<uint8_t>(c) >= 0x80 ||
+                    isNameStartChar(static_cast<uint8_t>(c));
+            }
+
+            static inline bool isNameByte(char c)
+            {
+                return static_cast<uint8_t>(c) >= 0x80 ||
+                    isNameChar(static_cast<uint8_t>(c));
+            }
+
+            StringView parseName()
+            {
+                if (iterator == last)
+                    throw std::runtime_error("Unexpected end of data");
+
+                if (!isNameStartByte(*iterator))
+                    throw std::runtime_error("Invalid name start");
+
+                const char* start = iterator;
+
+                for (;;)
+                {
+                    if (iterator == last)
+                        throw std::runtime_error("Unexpected end of data");
+
+                    if (!isNameByte(*iterator))
+                        break;
+
+                    ++iterator;
+                }
+
+                return StringView(start, static_cast<size_t>(iterator - start));
+            }
+
+            void parseEntity(std::string& result)
+            {
+                const char* start = ++iterator; // skip the ampersand
+
+                for (;;)
+                {
+                    if (iterator == last)
+                        throw std::runtime_error("Unexpected end of data");
+
+                    if (*iterator == ';') break;
+
+                    ++iterator;
+                }
+
+                const StringView entity(start, static_cast<size_t>(iterator++ - start));
+
+                if (entity.empty())
+                    throw std::runtime_error("Invalid entity");
+
+                if (entity == "quot")
+                    result.push_back('"');
+                else if (entity == "amp")
+                    result.push_back('&');
+                else if (entity == "apos")
+                    result.push_back('\'');
+                else if (entity == "lt")
+                    result.push_back('<');
+                else if (entity == "gt")
+                    result.push_back('>');
+                else if (entity.getData()[0] == '#')
+                {
+                    const bool hex = entity.getLength() > 1 && entity.getData()[1] == 'x';
+                    const char* digit = entity.getData() + (hex ? 2 : 1);
+
+                    if (digit == entity.end() || entity.end() - digit > 8)
+                        throw std::runtime_error("Invalid entity");
+
+                    uint32_t c = 0;
+
+                    for (; digit != entity.end(); ++digit)
+                    {
+                        uint32_t code = 0;
+
+                        if (*digit >= '0' && *digit <= '9') code = static_cast<uint32_t>(*digit - '0');
+                        else if (hex && *digit >= 'a' && *digit <='f') code = static_cast<uint32_t>(*digit - 'a' + 10);
+                        else if (hex && *digit >= 'A' && *digit <='F') code = static_cast<uint32_t>(*digit - 'A' + 10);
+                        else
+                            throw std::runtime_error("Invalid character code");
+
+                        c = hex ? (c << 4) | code : c * 10 + code;
+                    }
+
+                    result += utf8::fromUtf32(c);
+                }
+                else
+                    throw std::runtime_error("Invalid entity");
+            }
+
+            // strings without entities are returned without copying
+            StringView parseString(std::string& buffer)
+            {
+                if (iterator == last)
+                    throw std::runtime_error("Unexpected end of data");
+
+                if (*iterator != '"' && *iterator != '\'')
+                    throw std::runtime_error("Expected quotes");
+
+                const char quotes = *iterator;
+                const char* start = ++iterator;
+
+                for (;;)
+                {
+                    if (iterator == last)
+                        throw std::runtime_error("Unexpected end of data");
+
+                    if (*iterator == quotes)
+                        return StringView(start, static_cast<size_t>(iterator++ - start));
+                    else if (*iterator == '&')
+                        break;
+
+                    ++iterator;
+                }
+
+                buffer.assign(start, iterator);
+
+                for (;;)
+                {
+                    if (iterator == last)
+                        throw std::runtime_error("Unexpected end of data");
+
+                    if (*iterator == quotes)
+                    {
+                        ++iterator;
+                        return StringView(buffer.data(), buffer.size());
+                    }
+                    else if (*iterator == '&')
+                        parseEntity(buffer);
+                    else
+                        buffer.push_back(*iterator++);
+                }
+            }
+
+            void parseText()
+            {
+                const char* start = iterator;
+
+                while (iterator != last && *iterator != '<' && *iterator != '&')
+                    ++iterator;
+
+                if (iterator == last || *iterator == '<')
+                {
+                    value = StringView(start, static_cast<size_t>(iterator - start));
+                    return;
+                }
+
+                valueBuffer.assign(start, iterator);
+
+                while (iterator != last && *iterator != '<')
+                {
+                    if (*iterator == '&')
+                        parseEntity(valueBuffer);
+                    else
+                        valueBuffer.push_back(*iterator++);
+                }
+
+                value = StringView(valueBuffer.data(), valueBuffer.size());
+            }
+
+            // parses the attributes until the closing bracket, returns true if it was preceded by the terminator
+            bool parseAttributes(char terminator)
+            {
+                size_t decodedCount = 0;
+
+                for (;;)
+                {
+                    skipWhitespaces();
+
+                    if (iterator == last)
+                        throw std::runtime_error("Unexpected end of data");
+
+                    if (*iterator == '>')
+                    {
+                        ++iterator;
+                        break;
+                    }
+                    else if (*iterator == terminator)
+                    {
+                        if (++iterator == last)
+                            throw std::runtime_error("Unexpected end of data");
+
+                        if (*iterator != '>')
+                            throw std::runtime_error("Expected a right angle bracket");
+
+                        ++iterator;
+                        return true;
+                    }
+
+                    Attribute attribute;
+                    attribute.name = parseName();
+
+                    skipWhitespaces();
+
+                    if (iterator == last)
+                        throw std::runtime_error("Unexpected end of data");
+
+                    if (*iterator != '=')
+                        throw std::runtime_error("Expected an equal sign");
+
+                    ++iterator;
+
+                    skipWhitespaces();
+
+                    if (attributeBuffers.size() <= decodedCount) attributeBuffers.resize(decodedCount + 1);
+                    attribute.value = parseString(attributeBuffers[decodedCount]);
+
+                    if (attribute.value.getData() < first || attribute.value.getData() > last)
+                        ++decodedCount;
+
+                    attributes.push_back(attribute);
+                }
+
+                // resizing the buffers could have moved the decoded values, so point to them only at the end
+                size_t buffer = 0;
+                for (Attribute& attribute : attributes)
+                    if (attribute.value.getData() < first || attribute.value.getData() > last)
+                    {
+                        attribute.value = StringView(attributeBuffers[buffer].data(), attributeBuffers[buffer].size());
+                        ++buffer;
+                    }
+
+                return false;
+            }
+
+            const char* first;
+            const char* iterator;
+            const char* last;
+            bool preserveWhitespaces;
+
+            Event event = Event::NONE;
+            StringView name;
+            StringView value;
+            std::vector<Attribute> attributes;
+
+            std::vector<StringView> tags;
+            bool pendingEndTag = false;
+            bool rootTagFound = false;
+
+            std::string valueBuffer;
+            std::vector<std::string> attributeBuffers;
+        };
+
+        class Document;
+
+        // Read-only handle to a node of a document, valid for the lifetime of the document
+        class NodeView final
+        {
+            friend Document;
+        public:
+            class Iterator final
+            {
+            public:
+                Iterator(const Document* initDocument, const uint32_t* initChild):
+                    document(initDocument), child(initChild)
+                {
+                }
+
+                inline NodeView operator*() const { return NodeView(document, *child); }
+                inline Iterator& operator++() { ++child; return *this; }
+                inline bool operator==(const Iterator& other) const { return child == other.child; }
+                inline bool operator!=(const Iterator& other) const { return child != other.child; }
+
+            private:
+                const Document* document;
+                const uint32_t* child;
+            };
+
+            NodeView() = default;
+
+            inline Node::Type getType() const;
+
+            // name of a tag or a processing instruction, contents of other nodes
+            inline StringView getValue() const;
+
+            inline bool hasAttribute(const std::string& attribute) const;
+            inline StringView getAttribute(const std::string& attribute) const;
+
+            inline size_t getChildCount() const;
+
+            // returns a node of type NONE if the child does not exist
+            inline NodeView operator[](size_t index) const;
+
+            inline Iterator begin() const;
+            inline Iterator end() const;
+
+        private:
+            NodeView(const Document* initDocument, uint32_t initIndex):
+                document(initDocument), index(initIndex)
+            {
+            }
+
+            const Document* document = nullptr;
+            uint32_t index = 0;
+        };
+
+        // Tree of nodes stored in contiguous arrays, strings point into the parsed data where possible,
+        // so the data must outlive the document
+        class Document final
+        {
+            friend NodeView;
+        public:
+            Document(const uint8_t* begin, const uint8_t* end,
+                     bool preserveWhitespaces = false,
+                     bool preserveComments = false,
+                     bool preserveProcessingInstructions = false):
+                source(reinterpret_cast<const char*>(begin)),
+                sourceEnd(reinterpret_cast<const char*>(end))
+            {
+                Reader reader(begin, end, preserveWhitespaces);
+
+                std::vector<uint32_t> tags;
+                std::vector<size_t> childStarts;
+                std::vector<uint32_t> pendingChildren;
+
+                // the first entry holds the top level nodes
+                entries.push_back(Entry());
+                tags.push_back(0);
+                childStarts.push_back(0);
+
+                for (;;)
+                {
+                    const Reader::Event event = reader.next();
+
+                    if (event == Reader::Event::END_TAG || event == Reader::Event::END)
+                    {
+                        // the children of every tag are moved next to each other when it closes
+                        Entry& entry = entries[tags.back()];
+                        entry.firstChild = static_cast<uint32_t>(children.size());
+                        entry.childCount = static_cast<uint32_t>(pendingChildren.size() - childStarts.back());
+
+                        children.insert(children.end(), pendingChildren.begin() + static_cast<std::ptrdiff_t>(childStarts.back()), pendingChildren.end());
+                        pendingChildren.resize(childStarts.back());
+
+                        tags.pop_back();
+                        childStarts.pop_back();
+
+                        if (event == Reader::Event::END) break;
+                        continue;
+                    }
+
+                    Entry entry;
+
+                    switch (event)
+                    {
+                        case Reader::Event::START_TAG:
+                            entry.type = Node::Type::TAG;
+                            entry.value = store(reader.getName());
+                            break;
+                        case Reader::Event::PROCESSING_INSTRUCTION:
+                            if (!preserveProcessingInstructions) continue;
+                            entry.type = Node::Type::PROCESSING_INSTRUCTION;
+                            entry.value = store(reader.getName());
+                            break;
+                        case Reader::Event::COMMENT:
+                            if (!preserveComments) continue;
+                            entry.type = Node::Type::COMMENT;
+                            entry.value = store(reader.getValue());
+                            break;
+                        case Reader::Event::CDATA:
+                            entry.type = Node::Type::CDATA;
+                            entry.value = store(reader.getValue());
+                            break;
+                        case Reader::Event::TEXT:
+                            entry.type = Node::Type::TEXT;
+                            entry.value = store(reader.getValue());
+                            break;
+                        default:
+                            throw std::runtime_error("Unknown node type");
+                    }
+
+                    entry.firstAttribute = static_cast<uint32_t>(attributes.size());
+                    entry.attributeCount = static_cast<uint32_t>(reader.getAttributes().size());
+
+                    for (const Reader::Attribute& attribute : reader.getAttributes())
+                    {
+                        Reader::Attribute stored;
+                        stored.name = attribute.name;
+                        stored.value = store(attribute.value);
+                        attributes.push_back(stored);
+                    }
+
+                    const uint32_t index = static_cast<uint32_t>(entries.size());
+                    entries.push_back(entry);
+                    pendingChildren.push_back(index);
+
+                    if (event == Reader::Event::START_TAG)
+                    {
+                        tags.push_back(index);
+                        childStarts.push_back(pendingChildren.size());
+                    }
+                }
+            }
+
+            explicit Document(const std::vector<uint8_t>& data,
+                              bool preserveWhitespaces = false,
+                              bool preserveComments = false,
+                              bool preserveProcessingInstructions = false):
+                Document(data.data(), data.data() + data.size(),
+                         preserveWhitespaces,
+                         preserveComments,
+                         preserveProcessingInstructions)
+            {
+            }
+
+            Document(const Document&) = delete;
+            Document& operator=(const Document&) = delete;
+
+            Document(Document&&) = delete;
+            Document& operator=(Document&&) = delete;
+
+            // the top level tag
+            NodeView getRoot() const
+            {
+                for (NodeView node : *this)
+                    if (node.getType() == Node::Type::TAG)
+                        return node;
+
+                return NodeView();
+            }
+
+            inline NodeView::Iterator begin() const { return NodeView(this, 0).begin(); }
+            inline NodeView::Iterator end() const { return NodeView(this, 0).end(); }
+
+        private:
+            struct Entry final
+            {
+                Node::Type type = Node::Type::NONE;
+                StringView value;
+                uint32_t firstChild = 0; // index in children
+                uint32_t childCount = 0;
+                uint32_t firstAttribute = 0; // index in attributes
+                uint32_t attributeCount = 0;
+            };
+
+            // strings outside of the source were decoded into the buffers of the reader and have to be copied
+            StringView store(const StringView& value)
+            {
+                if (value.getData() >= source && value.getData() <= sourceEnd)
+                    return value;
+
+                strings.push_back(value.str());
+                return StringView(strings.back().data(), strings.back().size());
+            }
+
+            // nodes without a document (missing children) refer to an entry of type NONE
+            static const Entry& getEntry(const Document* document, uint32_t index)
+            {
+                static const Entry none;
+                return (document && index < document->entries.size()) ? document->entries[index] : none;
+            }
+
+            const char* source;
+            const char* sourceEnd;
+            std::vector<Entry> entries;
+            std::vector<uint32_t> children;
+            std::vector<Reader::Attribute> attributes;
+            std::deque<std::string> strings;
+        };
+
+        inline Node::Type NodeView::getType() const
+        {
+            return Document::getEntry(document, index).type;
+        }
+
+        inline StringView NodeView::getValue() const
+        {
+            return Document::getEntry(document, index).value;
+        }
+
+        inline bool NodeView::hasAttribute(const std::string& attribute) const
+        {
+            const Document::Entry& entry = Document::getEntry(document, index);
+            for (uint32_t i = 0; i < entry.attributeCount; ++i)
+                if (document->attributes[entry.firstAttribute + i].name == attribute)
+                    return true;
+
+            return false;
+        }
+
+        inline StringView NodeView::getAttribute(const std::string& attribute) const
+        {
+            const Document::Entry& entry = Document::getEntry(document, index);
+            for (uint32_t i = 0; i < entry.attributeCount; ++i)
+                if (document->attributes[entry.firstAttribute + i].name == attribute)
+                    return document->attributes[entry.firstAttribute + i].value;
+
+            return StringView();
+        }
+
+        inline size_t NodeView::getChildCount() const
+        {
+            return Document::getEntry(document, index).childCount;
+        }
+
+        inline NodeView NodeView::operator[](size_t child) const
+        {
+            const Document::Entry& entry = Document::getEntry(document, index);
+            if (child >= entry.childCount) return NodeView();
+
+            return NodeView(document, document->children[entry.firstChild + child]);
+        }
+
+        inline NodeView::Iterator NodeView::begin() const
+        {
+            if (!document || document->children.empty()) return Iterator(document, nullptr);
+            return Iterator(document, document->children.data() + Document::getEntry(document, index).firstChild);
+        }
+
+        inline NodeView::Iterator NodeView::end() const
+        {
+            if (!document || document->children.empty()) return Iterator(document, nullptr);
+            const Document::Entry& entry = Document::getEntry(document, index);
+            return Iterator(document, document->children.data() + entry.firstChild + entry.childCount);
+        }
+    } // namespace xml
+} // namespace ouzel
+
+#endif // OUZEL_UTILS_XMLPARSER_HPP
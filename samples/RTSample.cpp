@@ -7,6 +7,7 @@ using namespace ouzel;
 using namespace input;
 
 RTSample::RTSample():
+    renderGraph(*engine->getRenderer()),
     characterSprite("run.json"),
     backButton("button.png", "button_selected.png", "button_down.png", "", "Back", "Arial", 1.0F, Color::BLACK, Color::BLACK, Color::BLACK)
 {
@@ -17,24 +18,23 @@ RTSample::RTSample():
 
     addLayer(&rtLayer);
 
-    std::shared_ptr<graphics::Texture> renderTexture = std::make_shared<graphics::Texture>(*engine->getRenderer(),
-                                                                                           Size2U(256, 256),
-                                                                                           graphics::Texture::BIND_RENDER_TARGET |
-                                                                                           graphics::Texture::BIND_SHADER, 1, 1);
+    renderTexture = std::make_shared<graphics::Texture>(*engine->getRenderer(),
+                                                        Size2U(256, 256),
+                                                        graphics::Texture::BIND_RENDER_TARGET |
+                                                        graphics::Texture::BIND_SHADER, 1, 1);
 
-    std::shared_ptr<graphics::Texture> depthTexture = std::make_shared<graphics::Texture>(*engine->getRenderer(),
-                                                                                          Size2U(256, 256),
-                                                                                          graphics::Texture::BIND_RENDER_TARGET |
-                                                                                          graphics::Texture::BIND_SHADER, 1, 1,
-                                                                                          graphics::PixelFormat::DEPTH);
+    depthTexture = std::make_shared<graphics::Texture>(*engine->getRenderer(),
+                                                       Size2U(256, 256),
+                                                       graphics::Texture::BIND_RENDER_TARGET |
+                                                       graphics::Texture::BIND_SHADER, 1, 1,
+                                                       graphics::PixelFormat::DEPTH);
 
     std::shared_ptr<graphics::RenderTarget> renderTarget = std::make_shared<graphics::RenderTarget>(*engine->getRenderer(),
                                                                                                     std::vector<std::shared_ptr<graphics::Texture>>{renderTexture},
                                                                                                     depthTexture);
 
+    // the render target is cleared by the offscreen pass, the scene would clear it after the pass
     rtCamera.setRenderTarget(renderTarget);
-    rtCamera.setClearColorBuffer(true);
-    rtCamera.setClearColor(Color(0, 64, 0));
     rtCameraActor.addComponent(&rtCamera);
     rtLayer.addChild(&rtCameraActor);
 
@@ -74,6 +74,22 @@ RTSample::RTSample():
     menu.addWidget(&backButton);
 }
 
+void RTSample::draw()
+{
+    // the character is rendered offscreen before the layers that show it
+    renderGraph.addPass("Character", [this](graphics::RenderGraph::Builder& builder) {
+        builder.write(renderGraph.importTexture("Character", renderTexture));
+        builder.write(renderGraph.importTexture("Character depth", depthTexture));
+    }, [this](const graphics::RenderGraph::Context&) {
+        engine->getRenderer()->clearRenderTarget(true, false, false, Color(0, 64, 0), 1.0F, 0);
+        rtLayer.drawOffscreen();
+    });
+
+    renderGraph.execute();
+
+    Scene::draw();
+}
+
 bool RTSample::handleGamepad(const GamepadEvent& event)
 {
     if (event.type == Event::Type::GAMEPAD_BUTTON_CHANGE)
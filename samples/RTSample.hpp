@@ -5,11 +5,21 @@
 
 #include "ouzel.hpp"
 
+// drawn by the offscreen pass of the render graph instead of the scene
+class OffscreenLayer final: public ouzel::scene::Layer
+{
+public:
+    void draw() override {}
+    void drawOffscreen() { Layer::draw(); }
+};
+
 class RTSample: public ouzel::scene::Scene
 {
 public:
     RTSample();
 
+    void draw() override;
+
 private:
     bool handleGamepad(const ouzel::GamepadEvent& event);
     bool handleUI(const ouzel::UIEvent& event) const;
@@ -19,7 +29,11 @@ private:
     ouzel::scene::Camera camera;
     ouzel::scene::Actor cameraActor;
 
-    ouzel::scene::Layer rtLayer;
+    ouzel::graphics::RenderGraph renderGraph;
+    std::shared_ptr<ouzel::graphics::Texture> renderTexture;
+    std::shared_ptr<ouzel::graphics::Texture> depthTexture;
+
+    OffscreenLayer rtLayer;
 
     ouzel::scene::Camera rtCamera;
     ouzel::scene::Actor rtCameraActor;
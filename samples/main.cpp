@@ -38,6 +38,15 @@ public:
                 else
                     ouzel::engine->log(ouzel::Log::Level::WARN) << "No sample specified";
             }
+            else if (*arg == "--headless")
+            {
+                // handled by the engine
+            }
+            else if (*arg == "--record" || *arg == "--replay")
+            {
+                // handled by the engine
+                if (++arg == args.end()) break;
+            }
             else
                 ouzel::engine->log(ouzel::Log::Level::WARN) << "Invalid argument \"" << *arg << "\"";
         }
@@ -0,0 +1,84 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "storage/Compression.hpp"
+
+using namespace ouzel;
+using namespace storage;
+
+static bool check(bool condition, const char* message)
+{
+    if (!condition) std::cerr << "Failed: " << message << std::endl;
+    return condition;
+}
+
+static bool roundTrip(const std::vector<uint8_t>& data, size_t* compressedSize = nullptr)
+{
+    const std::vector<uint8_t> compressed = compress(Compression::LZ4, data.data(), data.size());
+    if (compressedSize) *compressedSize = compressed.size();
+
+    std::vector<uint8_t> result(data.size());
+    decompress(Compression::LZ4, compressed.data(), compressed.size(), result.data(), result.size());
+
+    return result == data;
+}
+
+int main()
+{
+    try
+    {
+        bool result = true;
+
+        result &= check(roundTrip({}), "empty data");
+        result &= check(roundTrip({1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12}), "data too short for a match");
+
+        std::vector<uint8_t> random(100000);
+        uint32_t state = 1;
+        for (uint8_t& b : random)
+        {
+            state = state * 1664525U + 1013904223U;
+            b = static_cast<uint8_t>(state >> 24);
+        }
+        result &= check(roundTrip(random), "incompressible data");
+
+        // a run longer than 270 bytes needs extra length bytes and overlaps its own offset
+        std::vector<uint8_t> run(1000, 'a');
+        size_t runSize;
+        result &= check(roundTrip(run, &runSize) && runSize < 20, "a long run of one byte");
+
+        std::string text;
+        for (int i = 0; i < 2000; ++i)
+            text += "texture" + std::to_string(i % 37) + ".png sprite" + std::to_string(i % 11) + ".json\n";
+
+        std::vector<uint8_t> textData(text.begin(), text.end());
+        size_t textSize;
+        result &= check(roundTrip(textData, &textSize) && textSize < textData.size() / 4, "repetitive text");
+
+        // matches are limited to 64 KiB back
+        std::vector<uint8_t> distant = random;
+        distant.insert(distant.end(), random.begin(), random.begin() + 1000);
+        result &= check(roundTrip(distant), "repeats beyond the match window");
+
+        const std::vector<uint8_t> compressed = compress(Compression::LZ4, textData.data(), textData.size());
+        std::vector<uint8_t> shorter(textData.size() - 1);
+
+        try
+        {
+            decompress(Compression::LZ4, compressed.data(), compressed.size(), shorter.data(), shorter.size());
+            result &= check(false, "a block larger than the destination is rejected");
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+
+        return result ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
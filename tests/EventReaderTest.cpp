@@ -0,0 +1,125 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <cstdlib>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include "input/linux/EventReader.hpp"
+
+using namespace ouzel;
+
+// a pipe stands in for the evdev node, the epoll dispatch mirrors InputSystemLinux::update
+class EventReaderTest final
+{
+public:
+    EventReaderTest()
+    {
+        if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) == -1)
+            throw std::system_error(errno, std::system_category(), "Failed to create pipe");
+
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd == -1)
+            throw std::system_error(errno, std::system_category(), "Failed to create epoll instance");
+
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = fds[0];
+
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fds[0], &event) == -1)
+            throw std::system_error(errno, std::system_category(), "Failed to add pipe to epoll");
+    }
+
+    ~EventReaderTest()
+    {
+        close(epollFd);
+        close(fds[0]);
+        if (fds[1] != -1) close(fds[1]);
+    }
+
+    // returns false if the device would be dropped
+    bool update()
+    {
+        epoll_event events[32];
+        int count = epoll_wait(epollFd, events, 32, 0);
+
+        bool connected = true;
+
+        for (int i = 0; i < count; ++i)
+        {
+            if (events[i].events & EPOLLIN)
+                input::readEvents(fds[0], [this](const input_event& event) {
+                    if (event.value != static_cast<int32_t>(handled)) ordered = false;
+                    ++handled;
+                });
+
+            if (events[i].events & (EPOLLERR | EPOLLHUP))
+                connected = false;
+        }
+
+        return connected;
+    }
+
+    void write(size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            input_event event = {};
+            event.type = EV_KEY;
+            event.value = static_cast<int32_t>(written++);
+
+            if (::write(fds[1], &event, sizeof(event)) != sizeof(event))
+                throw std::system_error(errno, std::system_category(), "Failed to write event");
+        }
+    }
+
+    void hangUp()
+    {
+        close(fds[1]);
+        fds[1] = -1;
+    }
+
+    size_t handled = 0;
+    size_t written = 0;
+    bool ordered = true;
+
+private:
+    int fds[2] = {-1, -1};
+    int epollFd = -1;
+};
+
+static bool check(bool condition, const char* message)
+{
+    if (!condition) std::cerr << "Failed: " << message << std::endl;
+    return condition;
+}
+
+int main()
+{
+    try
+    {
+        EventReaderTest test;
+        bool result = true;
+
+        result &= check(test.update() && test.handled == 0, "nothing is read from an empty queue");
+
+        test.write(input::EVENT_BATCH_SIZE * 3 + 17);
+        result &= check(test.update() && test.handled == test.written, "a burst of several batches is drained in one update");
+
+        test.write(input::EVENT_BATCH_SIZE);
+        result &= check(test.update() && test.handled == test.written, "exactly one batch is drained and the read stops on EAGAIN");
+
+        test.write(5);
+        test.hangUp();
+        result &= check(!test.update() && test.handled == test.written, "events queued before a hang-up are read before the device is dropped");
+
+        result &= check(test.ordered, "events are handled in order");
+
+        return result ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
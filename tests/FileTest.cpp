@@ -0,0 +1,114 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "storage/File.hpp"
+
+using namespace ouzel;
+
+static constexpr uint32_t FILE_SIZE = 1024 * 1024;
+static constexpr uint32_t THREAD_COUNT = 8;
+static constexpr uint32_t READ_COUNT = 2000;
+
+static uint8_t getByte(uint32_t offset)
+{
+    return static_cast<uint8_t>((offset * 7 + offset / 251) & 0xFF);
+}
+
+static bool check(bool condition, const char* message)
+{
+    if (!condition) std::cerr << "Failed: " << message << std::endl;
+    return condition;
+}
+
+int main()
+{
+    const char* filename = "FileTest.tmp";
+
+    try
+    {
+        bool result = true;
+
+        {
+            std::vector<uint8_t> data(FILE_SIZE);
+            for (uint32_t i = 0; i < FILE_SIZE; ++i)
+                data[i] = getByte(i);
+
+            storage::File file(filename, storage::File::WRITE | storage::File::CREATE | storage::File::TRUNCATE);
+            file.write(data.data(), FILE_SIZE, true);
+        }
+
+        storage::File file(filename, storage::File::READ);
+
+        // every thread reads chunks of different sizes at different offsets of the same file
+        std::atomic<uint32_t> mismatches{0};
+        std::atomic<uint32_t> failures{0};
+        std::vector<std::thread> threads;
+
+        for (uint32_t t = 0; t < THREAD_COUNT; ++t)
+            threads.emplace_back([&file, &mismatches, &failures, t]() {
+                uint32_t state = t * 2654435761U + 1;
+                std::vector<uint8_t> buffer;
+
+                for (uint32_t i = 0; i < READ_COUNT; ++i)
+                {
+                    state = state * 1664525U + 1013904223U;
+                    const uint32_t size = 1 + (state >> 8) % 4096;
+                    state = state * 1664525U + 1013904223U;
+                    const uint32_t offset = (state >> 4) % (FILE_SIZE - size);
+
+                    buffer.resize(size);
+
+                    try
+                    {
+                        if (file.readAt(buffer.data(), size, offset, true) != size)
+                        {
+                            ++failures;
+                            continue;
+                        }
+                    }
+                    catch (...)
+                    {
+                        ++failures;
+                        continue;
+                    }
+
+                    for (uint32_t b = 0; b < size; ++b)
+                        if (buffer[b] != getByte(offset + b))
+                        {
+                            ++mismatches;
+                            break;
+                        }
+                }
+            });
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        result &= check(failures == 0, "concurrent reads return the requested size");
+        result &= check(mismatches == 0, "concurrent reads return the data at their own offsets");
+
+        uint8_t last[2];
+        result &= check(file.readAt(last, 2, FILE_SIZE - 1) == 1 && last[0] == getByte(FILE_SIZE - 1), "a read past the end is short");
+        result &= check(file.readAt(last, 2, FILE_SIZE - 1, true) == 0, "a full read past the end returns zero");
+
+#if !defined(_WIN32)
+        result &= check(file.getOffset() == 0, "reads at an offset don't move the file pointer");
+#endif
+
+        file.close();
+        std::remove(filename);
+
+        return result ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        std::remove(filename);
+        return EXIT_FAILURE;
+    }
+}
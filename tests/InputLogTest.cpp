@@ -0,0 +1,163 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "input/InputLog.hpp"
+
+using namespace ouzel;
+using namespace input;
+
+using Event = InputSystem::Event;
+
+static bool check(bool condition, const char* message)
+{
+    if (!condition) std::cerr << "Failed: " << message << std::endl;
+    return condition;
+}
+
+// compares the fields that are stored in the log
+static bool isEqual(const Event& a, const Event& b)
+{
+    if (a.type != b.type || a.deviceId != b.deviceId) return false;
+
+    switch (a.type)
+    {
+        case Event::Type::DEVICE_CONNECT:
+            return a.deviceType == b.deviceType && a.screen == b.screen;
+        case Event::Type::GAMEPAD_BUTTON_CHANGE:
+            return a.gamepadButton == b.gamepadButton && a.pressed == b.pressed && a.value == b.value;
+        case Event::Type::KEY_PRESS:
+        case Event::Type::KEY_RELEASE:
+            return a.keyboardKey == b.keyboardKey;
+        case Event::Type::MOUSE_PRESS:
+        case Event::Type::MOUSE_RELEASE:
+            return a.mouseButton == b.mouseButton && a.position == b.position;
+        case Event::Type::MOUSE_SCROLL:
+            return a.scroll == b.scroll && a.position == b.position;
+        case Event::Type::MOUSE_MOVE:
+        case Event::Type::MOUSE_RELATIVE_MOVE:
+            return a.position == b.position;
+        case Event::Type::MOUSE_LOCK_CHANGED:
+            return a.locked == b.locked;
+        case Event::Type::TOUCH_BEGIN:
+        case Event::Type::TOUCH_MOVE:
+        case Event::Type::TOUCH_END:
+        case Event::Type::TOUCH_CANCEL:
+            return a.touchId == b.touchId && a.position == b.position && a.force == b.force;
+        default:
+            return true;
+    }
+}
+
+static std::vector<Event> getEvents()
+{
+    std::vector<Event> events;
+
+    Event connect(Event::Type::DEVICE_CONNECT);
+    connect.deviceId = 1;
+    connect.deviceType = Controller::Type::TOUCHPAD;
+    connect.screen = true;
+    events.push_back(connect);
+
+    Event button(Event::Type::GAMEPAD_BUTTON_CHANGE);
+    button.deviceId = 2;
+    button.gamepadButton = Gamepad::Button::LEFT_TRIGGER;
+    button.pressed = true;
+    button.value = 0.75F;
+    events.push_back(button);
+
+    Event key(Event::Type::KEY_PRESS);
+    key.deviceId = 3;
+    key.keyboardKey = Keyboard::Key::SPACE;
+    events.push_back(key);
+
+    Event press(Event::Type::MOUSE_PRESS);
+    press.deviceId = 4;
+    press.mouseButton = Mouse::Button::RIGHT;
+    press.position = Vector2F(0.25F, -0.5F);
+    events.push_back(press);
+
+    Event scroll(Event::Type::MOUSE_SCROLL);
+    scroll.deviceId = 4;
+    scroll.scroll = Vector2F(0.0F, -3.0F);
+    scroll.position = Vector2F(0.125F, 0.5F);
+    events.push_back(scroll);
+
+    Event lock(Event::Type::MOUSE_LOCK_CHANGED);
+    lock.deviceId = 4;
+    lock.locked = true;
+    events.push_back(lock);
+
+    Event touch(Event::Type::TOUCH_MOVE);
+    touch.deviceId = 1;
+    touch.touchId = 0x123456789ABCDEF0ULL;
+    touch.position = Vector2F(1.0F, 2.0F);
+    touch.force = 0.5F;
+    events.push_back(touch);
+
+    events.push_back(Event(Event::Type::DEVICE_DISCONNECT));
+
+    return events;
+}
+
+int main()
+{
+    try
+    {
+        const std::vector<Event> events = getEvents();
+        const std::vector<float> deltas = {0.0F, 1.0F / 60.0F, 0.05F};
+
+        // every frame is preceded by the events that were dispatched before it
+        InputLog::Writer writer;
+        uint64_t time = 0;
+
+        for (float delta : deltas)
+        {
+            for (const Event& event : events)
+                writer.writeEvent(time++, event);
+
+            writer.writeFrame(time++, delta);
+        }
+
+        InputLog::Reader reader(writer.getData());
+        bool result = true;
+
+        for (float delta : deltas)
+        {
+            for (const Event& event : events)
+            {
+                if (!check(!reader.isEnd() && reader.getRecord() == InputLog::Record::EVENT, "an event record is read back"))
+                    return EXIT_FAILURE;
+
+                result &= check(isEqual(reader.readEvent(), event), "the replayed event is identical to the recorded one");
+            }
+
+            if (!check(!reader.isEnd() && reader.getRecord() == InputLog::Record::FRAME, "a frame record is read back"))
+                return EXIT_FAILURE;
+
+            result &= check(reader.readFrame() == delta, "the replayed time step is identical to the recorded one");
+        }
+
+        result &= check(reader.isEnd(), "nothing is left after the last frame");
+
+        std::vector<uint8_t> truncated = writer.getData();
+        truncated.pop_back();
+
+        try
+        {
+            InputLog::Reader invalidReader(truncated);
+            result &= check(false, "a truncated log is rejected");
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+
+        return result ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,156 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+#include "utils/ObfSerializer.hpp"
+
+using namespace ouzel;
+
+struct Item final
+{
+    Item() = default;
+    Item(const std::string& initName, int32_t initCount): name(initName), count(initCount) {}
+
+    std::string name;
+    int32_t count = 0;
+
+    template<class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(1, name);
+        archive(2, count);
+    }
+};
+
+struct Player final
+{
+    int8_t level = 0;
+    int32_t offset = 0;
+    int64_t balance = 0;
+    uint32_t score = 0;
+    bool active = false;
+    float speed = 0.0F;
+    double position = 0.0;
+    std::vector<bool> flags;
+    std::vector<Item> items;
+    std::map<std::string, uint16_t> stats;
+
+    template<class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(1, level);
+        archive(2, offset);
+        archive(3, balance);
+        archive(4, score);
+        archive(5, active);
+        archive(6, speed);
+        archive(7, position);
+        archive(8, flags);
+        archive(9, items);
+        archive(10, stats);
+    }
+};
+
+// an older version of Player that has only some of the fields
+struct OldPlayer final
+{
+    int32_t offset = 0;
+    uint32_t score = 0;
+
+    template<class Archive>
+    void serialize(Archive& archive)
+    {
+        archive(2, offset);
+        archive(4, score);
+    }
+};
+
+static bool check(bool condition, const char* message)
+{
+    if (!condition) std::cerr << "Failed: " << message << std::endl;
+    return condition;
+}
+
+int main()
+{
+    try
+    {
+        bool result = true;
+
+        Player player;
+        player.level = -5;
+        player.offset = -1;
+        player.balance = std::numeric_limits<int64_t>::min();
+        player.score = 70000;
+        player.active = true;
+        player.speed = 1.5F;
+        player.position = -0.25;
+        player.flags = {true, false, true};
+        player.items = {Item("sword", 1), Item("arrow", -20)};
+        player.stats = {{"strength", 300}, {"agility", 7}};
+
+        std::vector<uint8_t> data;
+        const uint32_t size = obf::encode(player, data);
+        result &= check(size == data.size(), "the encoded size is returned");
+
+        // serializer to obf::Value
+        obf::Value value;
+        result &= check(value.decode(data) == data.size(), "obf::Value reads the whole struct");
+        result &= check(value[1].as<int8_t>() == -5, "obf::Value reads a negative int8");
+        result &= check(value[2].as<int32_t>() == -1 && value[2].as<int64_t>() == -1, "obf::Value reads a negative int32");
+        result &= check(value[3].as<int64_t>() == std::numeric_limits<int64_t>::min(), "obf::Value reads a negative int64");
+        result &= check(value[4].as<uint32_t>() == 70000, "obf::Value reads an unsigned value");
+        result &= check(value[8].getSize() == 3 && value[8][1].as<bool>() == false, "obf::Value reads a bool array");
+        result &= check(value[9][1][2].as<int32_t>() == -20, "obf::Value reads a nested struct");
+
+        // obf::Value to serializer
+        std::vector<uint8_t> valueData;
+        value.encode(valueData);
+
+        Player decoded;
+        result &= check(obf::decode(decoded, valueData) == valueData.size(), "the decoder reads the whole value");
+        result &= check(decoded.level == player.level &&
+                        decoded.offset == player.offset &&
+                        decoded.balance == player.balance, "negative values are read back unchanged");
+        result &= check(decoded.score == player.score && decoded.active == player.active, "unsigned values are read back unchanged");
+        result &= check(decoded.speed == player.speed && decoded.position == player.position, "floating point values are read back unchanged");
+        result &= check(decoded.flags == player.flags, "a bool array is read back unchanged");
+        result &= check(decoded.items.size() == 2 &&
+                        decoded.items[0].name == "sword" && decoded.items[0].count == 1 &&
+                        decoded.items[1].name == "arrow" && decoded.items[1].count == -20, "nested structs are read back unchanged");
+        result &= check(decoded.stats == player.stats, "a dictionary is read back unchanged");
+
+        OldPlayer oldPlayer;
+        obf::decode(oldPlayer, data);
+        result &= check(oldPlayer.offset == -1 && oldPlayer.score == 70000, "an older struct skips the fields it doesn't have");
+
+        Player newPlayer;
+        newPlayer.level = 3;
+        std::vector<uint8_t> oldData;
+        obf::encode(oldPlayer, oldData);
+        obf::decode(newPlayer, oldData);
+        result &= check(newPlayer.level == 3 && newPlayer.offset == -1, "a newer struct keeps the fields missing in the data");
+
+        data.pop_back();
+
+        try
+        {
+            obf::decode(decoded, data);
+            result &= check(false, "truncated data is rejected");
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+
+        return result ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
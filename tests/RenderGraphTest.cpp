@@ -0,0 +1,55 @@
+// Copyright 2015-2019 Elviss Strazdins. All rights reserved.
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include "graphics/RenderGraph.hpp"
+
+using namespace ouzel;
+using namespace graphics;
+
+static bool check(bool condition, const char* message)
+{
+    if (!condition) std::cerr << "Failed: " << message << std::endl;
+    return condition;
+}
+
+int main()
+{
+    try
+    {
+        bool result = true;
+
+        result &= check(RenderGraph::sortPasses({{}, {}, {}}, {{}, {}, {}}, 0) == std::vector<uint32_t>{0, 1, 2},
+                        "independent passes keep the order they were added in");
+
+        // texture 0 is read by the first pass and written by the second one
+        result &= check(RenderGraph::sortPasses({{0}, {}}, {{1}, {0}}, 2) == std::vector<uint32_t>{1, 0},
+                        "a texture is written before it is read");
+
+        // blur reads and writes texture 0, which is created by the scene pass and read by the composite pass
+        result &= check(RenderGraph::sortPasses({{0}, {0}, {}}, {{1}, {0}, {0}}, 2) == std::vector<uint32_t>{2, 1, 0},
+                        "the passes that modify a texture run between the ones that create and read it");
+
+        // the bloom pass of texture 1 doesn't depend on the shadow pass of texture 2
+        result &= check(RenderGraph::sortPasses({{}, {1}, {}, {2}}, {{1}, {0}, {2}, {0}}, 3) == std::vector<uint32_t>{0, 1, 2, 3},
+                        "the chains of independent textures stay in the order they were added in");
+
+        try
+        {
+            RenderGraph::sortPasses({{0}, {1}}, {{1}, {0}}, 2);
+            result &= check(false, "a cycle is rejected");
+        }
+        catch (const std::runtime_error&)
+        {
+        }
+
+        return result ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
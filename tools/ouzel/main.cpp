@@ -1,6 +1,271 @@
+#include <algorithm>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <stdexcept>
+#include "storage/Compression.hpp"
+#include "storage/Pack.hpp"
+#include "utils/JsonParser.hpp"
+#include "utils/Utils.hpp"
+
+static std::vector<uint8_t> readFile(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Failed to open file " + filename);
+
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static std::string getDirectory(const std::string& filename)
+{
+    const size_t position = filename.find_last_of("/\\");
+    return (position == std::string::npos) ? std::string() : filename.substr(0, position + 1);
+}
+
+static void packBundle(const std::string& manifest, const std::string& output)
+{
+    using ouzel::storage::Pack;
+
+    struct Entry final
+    {
+        std::string name;
+        uint64_t hash;
+        std::vector<uint8_t> data;
+        uint32_t type;
+        uint32_t flags;
+    };
+
+    // filenames in the manifest are relative to its directory, while Bundle::loadAssets looks them up
+    // in the resource paths of the file system, so the manifest should be in the root of the resources
+    const std::string directory = getDirectory(manifest);
+    const std::vector<uint8_t> manifestData = readFile(manifest);
+    ouzel::json::Document document(manifestData);
+    std::vector<Entry> entries;
+
+    const ouzel::json::Node assets = document["assets"];
+    if (assets.getType() != ouzel::json::Node::Type::ARRAY)
+        throw std::runtime_error("Manifest has no assets");
+
+    for (const ouzel::json::Node asset : assets)
+    {
+        Entry entry;
+        const std::string filename = asset["filename"].as<std::string>();
+        entry.name = asset.hasMember("name") ? asset["name"].as<std::string>() : filename;
+        entry.hash = Pack::hash(entry.name);
+        entry.data = readFile(directory + filename);
+        entry.type = asset["type"].as<uint32_t>();
+        entry.flags = (!asset.hasMember("mipmaps") || asset["mipmaps"].as<bool>()) ? Pack::MIPMAPS : 0;
+        entries.push_back(std::move(entry));
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return (a.hash == b.hash) ? a.name < b.name : a.hash < b.hash;
+    });
+
+    for (size_t i = 1; i < entries.size(); ++i)
+        if (entries[i].name == entries[i - 1].name)
+            throw std::runtime_error("Duplicate asset " + entries[i].name);
+
+    // keep the hash table at most half full
+    uint32_t slotCount = 1;
+    while (slotCount <= entries.size() * 2) slotCount <<= 1;
+
+    const uint32_t entryOffset = Pack::HEADER_SIZE;
+    const uint32_t slotOffset = entryOffset + static_cast<uint32_t>(entries.size()) * Pack::ENTRY_SIZE;
+    const uint32_t nameOffset = slotOffset + slotCount * sizeof(uint32_t);
+    uint32_t nameSize = 0;
+    for (const Entry& entry : entries)
+        nameSize += static_cast<uint32_t>(entry.name.size());
+
+    std::vector<uint8_t> result(nameOffset + nameSize);
+
+    ouzel::encodeLittleEndian<uint32_t>(result.data(), Pack::MAGIC);
+    ouzel::encodeLittleEndian<uint32_t>(result.data() + 4, Pack::VERSION);
+    ouzel::encodeLittleEndian<uint32_t>(result.data() + 8, static_cast<uint32_t>(entries.size()));
+    ouzel::encodeLittleEndian<uint32_t>(result.data() + 12, slotCount);
+    ouzel::encodeLittleEndian<uint32_t>(result.data() + 16, entryOffset);
+    ouzel::encodeLittleEndian<uint32_t>(result.data() + 20, slotOffset);
+    ouzel::encodeLittleEndian<uint32_t>(result.data() + 24, nameOffset);
+    ouzel::encodeLittleEndian<uint32_t>(result.data() + 28, nameSize);
+
+    uint32_t entryNameOffset = 0;
+
+    for (uint32_t index = 0; index < entries.size(); ++index)
+    {
+        const Entry& entry = entries[index];
+
+        // align the data, so that it can be used directly from the mapping
+        result.resize((result.size() + Pack::ALIGNMENT - 1) / Pack::ALIGNMENT * Pack::ALIGNMENT);
+        const uint32_t dataOffset = static_cast<uint32_t>(result.size());
+        result.insert(result.end(), entry.data.begin(), entry.data.end());
+
+        uint8_t* entryData = result.data() + entryOffset + index * Pack::ENTRY_SIZE;
+        ouzel::encodeLittleEndian<uint64_t>(entryData, entry.hash);
+        ouzel::encodeLittleEndian<uint32_t>(entryData + 8, entryNameOffset);
+        ouzel::encodeLittleEndian<uint32_t>(entryData + 12, static_cast<uint32_t>(entry.name.size()));
+        ouzel::encodeLittleEndian<uint32_t>(entryData + 16, dataOffset);
+        ouzel::encodeLittleEndian<uint32_t>(entryData + 20, static_cast<uint32_t>(entry.data.size()));
+        ouzel::encodeLittleEndian<uint32_t>(entryData + 24, entry.type);
+        ouzel::encodeLittleEndian<uint32_t>(entryData + 28, entry.flags);
+
+        std::copy(entry.name.begin(), entry.name.end(), result.begin() + nameOffset + entryNameOffset);
+        entryNameOffset += static_cast<uint32_t>(entry.name.size());
+
+        uint32_t slot = static_cast<uint32_t>(entry.hash) & (slotCount - 1);
+        while (ouzel::decodeLittleEndian<uint32_t>(result.data() + slotOffset + slot * sizeof(uint32_t)) != 0)
+            slot = (slot + 1) & (slotCount - 1);
+
+        ouzel::encodeLittleEndian<uint32_t>(result.data() + slotOffset + slot * sizeof(uint32_t), index + 1);
+    }
+
+    std::ofstream file(output, std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("Failed to open file " + output);
+
+    file.write(reinterpret_cast<const char*>(result.data()), static_cast<std::streamsize>(result.size()));
+    if (!file)
+        throw std::runtime_error("Failed to write file " + output);
+}
+
+static uint32_t crc32(const std::vector<uint8_t>& data)
+{
+    uint32_t result = 0xFFFFFFFF;
+
+    for (uint8_t b : data)
+    {
+        result ^= b;
+        for (int i = 0; i < 8; ++i)
+            result = (result >> 1) ^ (0xEDB88320 & (0 - (result & 1)));
+    }
+
+    return ~result;
+}
+
+// writes a ZIP archive that storage::Archive can read, with the entries compressed with LZ4 unless it doesn't make them smaller
+static void archiveFiles(const std::string& manifest, const std::string& output)
+{
+    static constexpr uint16_t METHOD_STORED = 0;
+    static constexpr uint16_t METHOD_LZ4 = 0x4C34; // must match storage/Archive.cpp
+    static constexpr uint16_t VERSION_NEEDED = 20;
+    static constexpr uint16_t DOS_DATE = 0x0021; // 1980-01-01
+    static constexpr size_t LOCAL_HEADER_SIZE = 30;
+    static constexpr size_t CENTRAL_HEADER_SIZE = 46;
+    static constexpr size_t END_RECORD_SIZE = 22;
+
+    struct Entry final
+    {
+        std::string name;
+        uint16_t method;
+        uint32_t crc;
+        uint32_t compressedSize;
+        uint32_t size;
+        uint32_t offset;
+    };
+
+    const std::string directory = getDirectory(manifest);
+    const std::vector<uint8_t> manifestData = readFile(manifest);
+    ouzel::json::Document document(manifestData);
+
+    const ouzel::json::Node assets = document["assets"];
+    if (assets.getType() != ouzel::json::Node::Type::ARRAY)
+        throw std::runtime_error("Manifest has no assets");
+
+    std::vector<Entry> entries;
+    std::vector<uint8_t> result;
+
+    for (const ouzel::json::Node asset : assets)
+    {
+        // the archive is searched with the same paths as the resource directory
+        const std::string filename = asset["filename"].as<std::string>();
+        const std::vector<uint8_t> data = readFile(directory + filename);
+        std::vector<uint8_t> compressed = ouzel::storage::compress(ouzel::storage::Compression::LZ4, data.data(), data.size());
+
+        Entry entry;
+        entry.name = filename;
+        entry.crc = crc32(data);
+        entry.size = static_cast<uint32_t>(data.size());
+        entry.offset = static_cast<uint32_t>(result.size());
+
+        if (compressed.size() < data.size())
+            entry.method = METHOD_LZ4;
+        else
+        {
+            entry.method = METHOD_STORED;
+            compressed = data;
+        }
+
+        entry.compressedSize = static_cast<uint32_t>(compressed.size());
+
+        result.resize(result.size() + LOCAL_HEADER_SIZE);
+        uint8_t* header = result.data() + entry.offset;
+        ouzel::encodeLittleEndian<uint32_t>(header, 0x04034B50);
+        ouzel::encodeLittleEndian<uint16_t>(header + 4, VERSION_NEEDED);
+        ouzel::encodeLittleEndian<uint16_t>(header + 6, 0); // flags
+        ouzel::encodeLittleEndian<uint16_t>(header + 8, entry.method);
+        ouzel::encodeLittleEndian<uint16_t>(header + 10, 0); // modification time
+        ouzel::encodeLittleEndian<uint16_t>(header + 12, DOS_DATE);
+        ouzel::encodeLittleEndian<uint32_t>(header + 14, entry.crc);
+        ouzel::encodeLittleEndian<uint32_t>(header + 18, entry.compressedSize);
+        ouzel::encodeLittleEndian<uint32_t>(header + 22, entry.size);
+        ouzel::encodeLittleEndian<uint16_t>(header + 26, static_cast<uint16_t>(entry.name.size()));
+        ouzel::encodeLittleEndian<uint16_t>(header + 28, 0); // extra field length
+
+        result.insert(result.end(), entry.name.begin(), entry.name.end());
+        result.insert(result.end(), compressed.begin(), compressed.end());
+
+        entries.push_back(std::move(entry));
+    }
+
+    const uint32_t centralDirectoryOffset = static_cast<uint32_t>(result.size());
+
+    for (const Entry& entry : entries)
+    {
+        const size_t offset = result.size();
+        result.resize(offset + CENTRAL_HEADER_SIZE);
+        uint8_t* header = result.data() + offset;
+        ouzel::encodeLittleEndian<uint32_t>(header, 0x02014B50);
+        ouzel::encodeLittleEndian<uint16_t>(header + 4, VERSION_NEEDED); // version made by
+        ouzel::encodeLittleEndian<uint16_t>(header + 6, VERSION_NEEDED);
+        ouzel::encodeLittleEndian<uint16_t>(header + 8, 0); // flags
+        ouzel::encodeLittleEndian<uint16_t>(header + 10, entry.method);
+        ouzel::encodeLittleEndian<uint16_t>(header + 12, 0); // modification time
+        ouzel::encodeLittleEndian<uint16_t>(header + 14, DOS_DATE);
+        ouzel::encodeLittleEndian<uint32_t>(header + 16, entry.crc);
+        ouzel::encodeLittleEndian<uint32_t>(header + 20, entry.compressedSize);
+        ouzel::encodeLittleEndian<uint32_t>(header + 24, entry.size);
+        ouzel::encodeLittleEndian<uint16_t>(header + 28, static_cast<uint16_t>(entry.name.size()));
+        ouzel::encodeLittleEndian<uint16_t>(header + 30, 0); // extra field length
+        ouzel::encodeLittleEndian<uint16_t>(header + 32, 0); // comment length
+        ouzel::encodeLittleEndian<uint16_t>(header + 34, 0); // disk number
+        ouzel::encodeLittleEndian<uint16_t>(header + 36, 0); // internal attributes
+        ouzel::encodeLittleEndian<uint32_t>(header + 38, 0); // external attributes
+        ouzel::encodeLittleEndian<uint32_t>(header + 42, entry.offset);
+
+        result.insert(result.end(), entry.name.begin(), entry.name.end());
+    }
+
+    const size_t endOffset = result.size();
+    result.resize(endOffset + END_RECORD_SIZE);
+    uint8_t* end = result.data() + endOffset;
+    ouzel::encodeLittleEndian<uint32_t>(end, 0x06054B50);
+    ouzel::encodeLittleEndian<uint16_t>(end + 4, 0); // disk number
+    ouzel::encodeLittleEndian<uint16_t>(end + 6, 0); // disk with the central directory
+    ouzel::encodeLittleEndian<uint16_t>(end + 8, static_cast<uint16_t>(entries.size()));
+    ouzel::encodeLittleEndian<uint16_t>(end + 10, static_cast<uint16_t>(entries.size()));
+    ouzel::encodeLittleEndian<uint32_t>(end + 12, static_cast<uint32_t>(endOffset - centralDirectoryOffset));
+    ouzel::encodeLittleEndian<uint32_t>(end + 16, centralDirectoryOffset);
+    ouzel::encodeLittleEndian<uint16_t>(end + 20, 0); // comment length
+
+    std::ofstream file(output, std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("Failed to open file " + output);
+
+    file.write(reinterpret_cast<const char*>(result.data()), static_cast<std::streamsize>(result.size()));
+    if (!file)
+        throw std::runtime_error("Failed to write file " + output);
+}
 
 int main(int argc, const char* argv[])
 {
@@ -8,7 +273,9 @@ int main(int argc, const char* argv[])
     {
         NONE,
         NEW_PROJECT,
-        GENERATE
+        GENERATE,
+        PACK,
+        ARCHIVE
     };
 
     enum class Project
@@ -34,6 +301,7 @@ int main(int argc, const char* argv[])
     Action action = Action::NONE;
     std::string path;
     std::string name;
+    std::string output;
     Project project = Project::ALL;
     Platform platform = Platform::ALL;
 
@@ -42,7 +310,7 @@ int main(int argc, const char* argv[])
         if (std::string(argv[i]) == "--help")
         {
             std::cout << "Usage:" << std::endl;
-            std::cout << argv[0] << " [--help] [--new-project <name>] [--location <location>]" << std::endl;
+            std::cout << argv[0] << " [--help] [--new-project <name>] [--location <location>] [--pack <manifest> --output <bundle>] [--archive <manifest> --output <zip>]" << std::endl;
             return EXIT_SUCCESS;
         }
         else if (std::string(argv[i]) == "--new-project")
@@ -69,6 +337,31 @@ int main(int argc, const char* argv[])
 
             path = std::string(argv[i]);
         }
+        else if (std::string(argv[i]) == "--pack")
+        {
+            action = Action::PACK;
+
+            if (++i >= argc)
+                throw std::runtime_error("Invalid command");
+
+            path = std::string(argv[i]);
+        }
+        else if (std::string(argv[i]) == "--archive")
+        {
+            action = Action::ARCHIVE;
+
+            if (++i >= argc)
+                throw std::runtime_error("Invalid command");
+
+            path = std::string(argv[i]);
+        }
+        else if (std::string(argv[i]) == "--output")
+        {
+            if (++i >= argc)
+                throw std::runtime_error("Invalid command");
+
+            output = std::string(argv[i]);
+        }
         else if (std::string(argv[i]) == "--project")
         {
             if (std::string(argv[i]) == "all")
@@ -115,6 +408,18 @@ int main(int argc, const char* argv[])
                 break;
             case Action::GENERATE:
                 break;
+            case Action::PACK:
+                if (output.empty())
+                    throw std::runtime_error("No output file specified");
+
+                packBundle(path, output);
+                break;
+            case Action::ARCHIVE:
+                if (output.empty())
+                    throw std::runtime_error("No output file specified");
+
+                archiveFiles(path, output);
+                break;
             default:
                 throw std::runtime_error("Invalid action selected");
         }
@@ -122,6 +427,7 @@ int main(int argc, const char* argv[])
     catch (const std::exception& e)
     {
         std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
     }
 
     return EXIT_SUCCESS;